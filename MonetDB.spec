@@ -530,6 +530,7 @@ embedded library (%{name}-embedded).
 %{_libdir}/monetdb5/lib_capi.so
 %endif
 %{_libdir}/monetdb5/lib_csv.so
+%{_libdir}/monetdb5/lib_mcf.so
 %{_libdir}/monetdb5/lib_generator.so
 
 %package -n MonetDB5-server
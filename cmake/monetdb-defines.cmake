@@ -35,6 +35,7 @@ function(monetdb_configure_defines)
   check_include_file("stdatomic.h" HAVE_STDATOMIC_H)
   check_include_file("strings.h" HAVE_STRINGS_H)
   check_include_file("stropts.h" HAVE_STROPTS_H)
+  check_include_file("sys/epoll.h" HAVE_SYS_EPOLL_H)
   check_include_file("sys/file.h" HAVE_SYS_FILE_H)
   check_include_file("sys/ioctl.h" HAVE_SYS_IOCTL_H)
   check_include_file("sys/mman.h" HAVE_SYS_MMAN_H)
@@ -109,6 +110,8 @@ function(monetdb_configure_defines)
   check_function_exists("shutdown" HAVE_SHUTDOWN)
   check_function_exists("sigaction" HAVE_SIGACTION)
   check_function_exists("siglongjmp" HAVE_SIGLONGJMP)
+  # Linux specific
+  check_symbol_exists("splice" "fcntl.h" HAVE_SPLICE)
   check_symbol_exists("stpcpy" "string.h" HAVE_STPCPY)
   check_function_exists("strcasestr" HAVE_STRCASESTR)
   check_symbol_exists("strncasecmp" "strings.h" HAVE_STRNCASECMP)
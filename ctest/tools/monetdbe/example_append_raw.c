@@ -168,6 +168,41 @@ main(void)
 	if ((err = monetdbe_cleanup_result(mdbe, result)) != NULL)
 		error(err)
 
+	// hand malloced buffers over to the database, twice into the same table,
+	// both for a temporary table (kept as is) and a persistent one (copied)
+	static const char *owned[][2] = {
+		{ "CREATE LOCAL TEMPORARY TABLE owned (x bigint) ON COMMIT PRESERVE ROWS", "tmp" },
+		{ "CREATE TABLE owned (x bigint)", "sys" },
+	};
+	for (int t = 0; t < 2; t++) {
+		char q[64];
+
+		if ((err = monetdbe_query(mdbe, (char *) owned[t][0], NULL, NULL)) != NULL)
+			error(err)
+		for (int k = 0; k < 2; k++) {
+			int64_t *vals = malloc(1000 * sizeof(int64_t));
+			if (vals == NULL)
+				error("Allocation failed")
+			for (int64_t v = 0; v < 1000; v++)
+				vals[v] = v;
+			monetdbe_column ocol = { .type = monetdbe_int64_t, .data = vals, .count = 1000 };
+			monetdbe_column* ocols[1] = { &ocol };
+			if ((err = monetdbe_append_owned(mdbe, owned[t][1], "owned", (monetdbe_column**) &ocols, 1)) != NULL)
+				error(err)
+			if (ocol.data != NULL)
+				error("Data was not taken over")
+		}
+		snprintf(q, sizeof(q), "SELECT CAST(SUM(x) AS BIGINT) FROM %s.owned", owned[t][1]);
+		if ((err = monetdbe_query(mdbe, q, &result, NULL)) != NULL)
+			error(err)
+		if ((err = monetdbe_result_fetch(result, rcol, 0)) != NULL)
+			error(err)
+		if (((monetdbe_column_int64_t *) rcol[0])->data[0] != 999000)
+			error("Wrong sum of appended data")
+		if ((err = monetdbe_cleanup_result(mdbe, result)) != NULL)
+			error(err)
+	}
+
 	if (monetdbe_close(mdbe))
 		error("Failed to close database")
 	return 0;
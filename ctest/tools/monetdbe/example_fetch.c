@@ -0,0 +1,111 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/* fetched result columns may share memory with the result, but never
+ * with the tables queried: overwriting fetched data must not change
+ * the database */
+
+#include "monetdbe.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define error(msg) {fprintf(stderr, "Failure: %s\n", msg); return -1;}
+
+/* overwrite the fetched columns of query q (an int and a string column) */
+static char *
+scribble(monetdbe_database mdbe, const char *q)
+{
+	monetdbe_result *result = NULL;
+	monetdbe_column *rcol[2];
+	char *err;
+
+	if ((err = monetdbe_query(mdbe, (char *) q, &result, NULL)) != NULL)
+		return err;
+	for (size_t c = 0; c < 2; c++)
+		if ((err = monetdbe_result_fetch(result, rcol + c, c)) != NULL)
+			return err;
+	monetdbe_column_int32_t *ci = (monetdbe_column_int32_t *) rcol[0];
+	monetdbe_column_str *cs = (monetdbe_column_str *) rcol[1];
+	for (size_t r = 0; r < ci->count; r++) {
+		ci->data[r] = -1;
+		if (cs->data[r])
+			cs->data[r][0] = '#';
+	}
+	return monetdbe_cleanup_result(mdbe, result);
+}
+
+/* the sum of the int column and the number of strings starting with # */
+static char *
+check(monetdbe_database mdbe, const char *t, int64_t *sum, int64_t *cnt)
+{
+	monetdbe_result *result = NULL;
+	monetdbe_column *rcol[2];
+	char q[256], *err;
+
+	snprintf(q, sizeof(q), "SELECT CAST(sum(x) AS BIGINT), CAST(sum(CASE WHEN substring(y, 1, 1) = '#' THEN 1 ELSE 0 END) AS BIGINT) FROM %s", t);
+	if ((err = monetdbe_query(mdbe, q, &result, NULL)) != NULL)
+		return err;
+	for (size_t c = 0; c < 2; c++)
+		if ((err = monetdbe_result_fetch(result, rcol + c, c)) != NULL)
+			return err;
+	*sum = ((monetdbe_column_int64_t *) rcol[0])->data[0];
+	*cnt = ((monetdbe_column_int64_t *) rcol[1])->data[0];
+	return monetdbe_cleanup_result(mdbe, result);
+}
+
+int
+main(void)
+{
+	char *err = NULL;
+	monetdbe_database mdbe = NULL;
+	int64_t sum, cnt;
+	static const char *tables[] = { "test", "tmp.ttest" };
+
+	if (monetdbe_open(&mdbe, NULL, NULL))
+		error("Failed to open database")
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE test (x integer, y string)", NULL, NULL)) != NULL)
+		error(err)
+	if ((err = monetdbe_query(mdbe, "CREATE TEMPORARY TABLE ttest (x integer, y string) ON COMMIT PRESERVE ROWS", NULL, NULL)) != NULL)
+		error(err)
+	for (int i = 0; i < 2; i++) {
+		char q[256];
+		snprintf(q, sizeof(q), "INSERT INTO %s VALUES (1, 'one'), (2, 'two'), (NULL, NULL), (3, 'three')", tables[i]);
+		if ((err = monetdbe_query(mdbe, q, NULL, NULL)) != NULL)
+			error(err)
+	}
+
+	for (int i = 0; i < 2; i++) {
+		char q[256];
+		/* the columns themselves, a view on them and a computed result */
+		snprintf(q, sizeof(q), "SELECT x, y FROM %s", tables[i]);
+		if ((err = scribble(mdbe, q)) != NULL)
+			error(err)
+		snprintf(q, sizeof(q), "SELECT x, y FROM %s WHERE x > 1", tables[i]);
+		if ((err = scribble(mdbe, q)) != NULL)
+			error(err)
+		snprintf(q, sizeof(q), "SELECT x + 1, y || '!' FROM %s", tables[i]);
+		if ((err = scribble(mdbe, q)) != NULL)
+			error(err)
+		if ((err = check(mdbe, tables[i], &sum, &cnt)) != NULL)
+			error(err)
+		if (sum != 6 || cnt != 0) {
+			fprintf(stderr, "Failure: fetched data of %s was not private (sum %lld, %lld strings changed)\n",
+					tables[i], (long long) sum, (long long) cnt);
+			return -1;
+		}
+	}
+
+	if (monetdbe_close(mdbe))
+		error("Failed to close database")
+	return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+#include "monetdbe.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#define error(msg) {fprintf(stderr, "Failure: %s\n", msg); return -1;}
+#define NTHREADS 4
+#define NQUERIES 20
+
+struct worker {
+	monetdbe_database db;
+	int id;
+	char *err;
+	int64_t sum;
+};
+
+static void *
+run_worker(void *arg)
+{
+	struct worker *w = arg;
+	monetdbe_database session = NULL;
+	monetdbe_result *result = NULL;
+	monetdbe_column *rcol;
+	char query[128];
+
+	/* every thread gets its own session on the shared database */
+	if (monetdbe_open_session(w->db, &session) != 0) {
+		w->err = "Failed to open session";
+		return NULL;
+	}
+	for (int i = 0; i < NQUERIES && w->err == NULL; i++) {
+		snprintf(query, sizeof(query), "INSERT INTO t%d VALUES (%d)", w->id, i);
+		w->err = monetdbe_query(session, query, NULL, NULL);
+	}
+	if (w->err == NULL) {
+		snprintf(query, sizeof(query), "SELECT CAST(SUM(x) AS BIGINT) FROM t%d, (SELECT COUNT(*) FROM s) AS c", w->id);
+		w->err = monetdbe_query(session, query, &result, NULL);
+	}
+	if (w->err == NULL && (w->err = monetdbe_result_fetch(result, &rcol, 0)) == NULL)
+		w->sum = ((monetdbe_column_int64_t *) rcol)->data[0];
+	if (result)
+		monetdbe_cleanup_result(session, result);
+	if (monetdbe_close(session) != 0 && w->err == NULL)
+		w->err = "Failed to close session";
+	return NULL;
+}
+
+int
+main(void)
+{
+	char* err = NULL;
+	char query[128];
+	monetdbe_database mdbe = NULL;
+	pthread_t threads[NTHREADS];
+	struct worker workers[NTHREADS];
+
+	if (monetdbe_open(&mdbe, NULL, NULL))
+		error("Failed to open database")
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE s AS SELECT c.id FROM sys.columns c, sys.columns d WITH DATA", NULL, NULL)) != NULL)
+		error(err)
+	for (int i = 0; i < NTHREADS; i++) {
+		snprintf(query, sizeof(query), "CREATE TABLE t%d (x integer)", i);
+		if ((err = monetdbe_query(mdbe, query, NULL, NULL)) != NULL)
+			error(err)
+	}
+
+	for (int i = 0; i < NTHREADS; i++) {
+		workers[i] = (struct worker) {.db = mdbe, .id = i};
+		if (pthread_create(&threads[i], NULL, run_worker, &workers[i]) != 0)
+			error("Failed to start thread")
+	}
+	for (int i = 0; i < NTHREADS; i++) {
+		pthread_join(threads[i], NULL);
+		if (workers[i].err)
+			error(workers[i].err)
+		if (workers[i].sum != NQUERIES * (NQUERIES - 1) / 2)
+			error("Wrong result")
+	}
+
+	if (monetdbe_close(mdbe))
+		error("Failed to close database")
+	return 0;
+}
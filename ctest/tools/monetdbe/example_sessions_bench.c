@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/* query throughput of one session against that of several sessions
+ * used from their own threads; run as example_sessions_bench [threads
+ * [queries]] */
+
+#include "monetdbe.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+
+#define error(msg) {fprintf(stderr, "Failure: %s\n", msg); return -1;}
+#define MAXTHREADS 64
+
+struct worker {
+	monetdbe_database db;
+	int nqueries;
+	int id;
+	char *err;
+	int64_t sum;
+};
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *
+run_worker(void *arg)
+{
+	struct worker *w = arg;
+	monetdbe_database session = NULL;
+	char query[128];
+
+	if (monetdbe_open_session(w->db, &session) != 0) {
+		w->err = "Failed to open session";
+		return NULL;
+	}
+	for (int i = 0; i < w->nqueries && w->err == NULL; i++) {
+		monetdbe_result *result = NULL;
+		monetdbe_column *rcol;
+
+		snprintf(query, sizeof(query), "SELECT CAST(SUM(x) AS BIGINT) FROM b WHERE x BETWEEN %d AND %d", (w->id + i) % 1000, (w->id + i) % 1000 + 10);
+		if ((w->err = monetdbe_query(session, query, &result, NULL)) == NULL &&
+			(w->err = monetdbe_result_fetch(result, &rcol, 0)) == NULL)
+			w->sum += ((monetdbe_column_int64_t *) rcol)->data[0];
+		if (result)
+			monetdbe_cleanup_result(session, result);
+	}
+	if (monetdbe_close(session) != 0 && w->err == NULL)
+		w->err = "Failed to close session";
+	return NULL;
+}
+
+/* run nqueries queries on each of nthreads sessions, return queries/s */
+static double
+run(monetdbe_database mdbe, int nthreads, int nqueries, char **err)
+{
+	pthread_t threads[MAXTHREADS];
+	struct worker workers[MAXTHREADS];
+	double start = now();
+
+	for (int i = 0; i < nthreads; i++) {
+		workers[i] = (struct worker) {.db = mdbe, .nqueries = nqueries, .id = i};
+		if (pthread_create(&threads[i], NULL, run_worker, &workers[i]) != 0) {
+			*err = "Failed to start thread";
+			nthreads = i;
+			break;
+		}
+	}
+	for (int i = 0; i < nthreads; i++) {
+		pthread_join(threads[i], NULL);
+		if (workers[i].err && *err == NULL)
+			*err = workers[i].err;
+	}
+	return (double) nthreads * nqueries / (now() - start);
+}
+
+int
+main(int argc, char **argv)
+{
+	char *err = NULL;
+	monetdbe_database mdbe = NULL;
+	int nthreads = argc > 1 ? atoi(argv[1]) : 4;
+	int nqueries = argc > 2 ? atoi(argv[2]) : 200;
+	double single, multi;
+
+	if (nthreads < 1 || nthreads > MAXTHREADS || nqueries < 1)
+		error("Usage: example_sessions_bench [threads [queries]]")
+	if (monetdbe_open(&mdbe, NULL, NULL))
+		error("Failed to open database")
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE b AS SELECT CAST((c.id * 37 + d.id) % 1000 AS INT) AS x FROM sys.columns c, sys.columns d WITH DATA", NULL, NULL)) != NULL)
+		error(err)
+
+	single = run(mdbe, 1, nqueries, &err);
+	if (err)
+		error(err)
+	multi = run(mdbe, nthreads, nqueries, &err);
+	if (err)
+		error(err)
+	printf("1 session: %.0f queries/s\n", single);
+	printf("%d sessions: %.0f queries/s (%.2fx)\n", nthreads, multi, multi / single);
+
+	if (monetdbe_close(mdbe))
+		error("Failed to close database")
+	return 0;
+}
@@ -554,6 +554,7 @@ typedef struct {
 	size_t free;		/* index where free area starts. */
 	size_t size;		/* size of the heap (bytes) */
 	char *base;		/* base pointer in memory. */
+	size_t asciifree;	/* string heap: strings before this are ASCII */
 #if SIZEOF_VOID_P == 4
 	char filename[32];	/* file containing image of the heap */
 #else
@@ -563,6 +564,7 @@ typedef struct {
 	ATOMIC_TYPE refs;	/* reference count for this heap */
 	bte farmid;		/* id of farm where heap is located */
 	bool cleanhash;		/* string heaps must clean hash */
+	bool notascii;		/* string heap: not all strings are ASCII */
 	bool dirty;		/* specific heap dirty marker */
 	bool remove;		/* remove storage file when freeing */
 	bool wasempty;		/* heap was empty when last saved/created */
@@ -575,6 +577,7 @@ typedef struct {
 typedef struct Hash Hash;
 typedef struct Imprints Imprints;
 typedef struct Strimps Strimps;
+typedef struct Trigrams Trigrams;
 
 #ifdef HAVE_RTREE
 typedef struct RTree RTree;
@@ -744,6 +747,7 @@ typedef struct {
 	Imprints *imprints;	/* column imprints index */
 	Heap *orderidx;		/* order oid index */
 	Strimps *strimps;	/* string imprint index  */
+	Trigrams *trigrams;	/* string trigram index */
 
 	PROPrec *props;		/* list of dynamic properties stored in the bat descriptor */
 } COLrec;
@@ -838,6 +842,7 @@ typedef struct BAT {
 #define timprints	T.imprints
 #define tprops		T.props
 #define tstrimps	T.strimps
+#define ttrigrams	T.trigrams
 #ifdef HAVE_RTREE
 #define trtree		T.rtree
 #endif
@@ -971,6 +976,13 @@ typedef struct {
 	int lrefs;		/* logical references on which the existence of a BAT relies */
 	ATOMIC_TYPE status;	/* status mask used for spin locking */
 	MT_Id pid;		/* creator of this bat while "private" */
+	/* the clock fields below change the size of BBPrec and
+	 * therefore the ABI of libbat: code that uses the BBP
+	 * macros must be recompiled against this header */
+	bat clknext;		/* next loaded bat in buffer manager clock */
+	bat clkprev;		/* previous loaded bat in buffer manager clock */
+	uint8_t clkuse;		/* clock sweeps left before bat may be unloaded */
+	uint8_t clkprio;	/* sweeps granted when bat was used */
 } BBPrec;
 
 gdk_export bat BBPlimit;
@@ -1004,6 +1016,8 @@ gdk_export BBPrec *BBP[N_BBPINIT];
 #define BBP_lrefs(i)	BBP_record(i).lrefs
 #define BBP_status(i)	((unsigned) ATOMIC_GET(&BBP_record(i).status))
 #define BBP_pid(i)	BBP_record(i).pid
+#define BBP_clkuse(i)	BBP_record(i).clkuse
+#define BBP_clkprio(i)	BBP_record(i).clkprio
 #define BATgetId(b)	BBP_logical((b)->batCacheid)
 #define BBPvalid(i)	(BBP_logical(i) != NULL && *BBP_logical(i) != '.')
 
@@ -1016,6 +1030,7 @@ gdk_export void BBPlock(void);
 gdk_export void BBPunlock(void);
 gdk_export void BBPtmlock(void);
 gdk_export void BBPtmunlock(void);
+gdk_export void BBPsyncahead(void);
 
 gdk_export BAT *BBPquickdesc(bat b);
 
@@ -1904,6 +1919,10 @@ gdk_export void STRMPdestroy(BAT *b);
 gdk_export bool BAThasstrimps(BAT *b);
 gdk_export gdk_return BATsetstrimps(BAT *b);
 
+/* Trigram index exported functions */
+gdk_export BAT *TRGMfilter(BAT *b, BAT *s, const char *const *q, int nq, int slack);
+gdk_export void TRGMdestroy(BAT *b);
+
 /* Rtree structure functions */
 #ifdef HAVE_RTREE
 //TODO REMOVE
@@ -1932,6 +1951,10 @@ gdk_export gdk_return BATorderidx(BAT *b, bool stable);
 gdk_export gdk_return GDKmergeidx(BAT *b, BAT**a, int n_ar);
 gdk_export bool BATcheckorderidx(BAT *b);
 
+/* Whether all strings in the string heap are ASCII. */
+
+gdk_export bool BATcheckascii(BATiter *bi);
+
 #include "gdk_delta.h"
 #include "gdk_hash.h"
 #include "gdk_bbp.h"
@@ -1941,6 +1964,8 @@ gdk_export bool BATcheckorderidx(BAT *b);
 gdk_export gdk_return void_inplace(BAT *b, oid id, const void *val, bool force)
 	__attribute__((__warn_unused_result__));
 gdk_export BAT *BATattach(int tt, const char *heapfile, role_t role);
+gdk_export BAT *BATattachrange(int tt, const char *heapfile, size_t off, BUN cnt);
+gdk_export BAT *BATattachmem(int tt, void *data, BUN cnt, bool owned);
 
 #ifdef NATIVE_WIN32
 #ifdef _MSC_VER
@@ -1978,6 +2003,11 @@ VALptr(const ValRecord *v)
 
 typedef struct threadStruct *Thread;
 
+/* process a piece of a job that is split over several threads */
+typedef gdk_return (*GDKpiecefunc)(void *arg, int t, BUN i);
+gdk_export gdk_return GDKparallel(const char *name, int nthreads, BUN npieces, GDKpiecefunc func, void *arg)
+	__attribute__((__warn_unused_result__));
+
 
 gdk_export stream *GDKstdout;
 gdk_export stream *GDKstdin;
@@ -2299,6 +2329,9 @@ gdk_export ValPtr BATsetprop_nolock(BAT *b, enum prop_t idx, int type, const voi
 gdk_export BAT *BATselect(BAT *b, BAT *s, const void *tl, const void *th, bool li, bool hi, bool anti);
 gdk_export BAT *BATthetaselect(BAT *b, BAT *s, const void *val, const char *op);
 
+gdk_export BAT *BATbloom(BAT *b, BAT *s, void *min, void *max);
+gdk_export BAT *BATbloomselect(BAT *b, BAT *s, BAT *f, const void *min, const void *max);
+
 gdk_export BAT *BATconstant(oid hseq, int tt, const void *val, BUN cnt, role_t role);
 gdk_export gdk_return BATsubcross(BAT **r1p, BAT **r2p, BAT *l, BAT *r, BAT *sl, BAT *sr, bool max_one)
 	__attribute__((__warn_unused_result__));
@@ -2334,6 +2367,8 @@ gdk_export BAT *BATunique(BAT *b, BAT *s);
 
 gdk_export gdk_return BATfirstn(BAT **topn, BAT **gids, BAT *b, BAT *cands, BAT *grps, BUN n, bool asc, bool nilslast, bool distinct)
 	__attribute__((__warn_unused_result__));
+gdk_export gdk_return BATfirstnbound(BAT **topn, BAT **b, int nb, BUN n, bool asc, bool nilslast)
+	__attribute__((__warn_unused_result__));
 
 #include "gdk_calc.h"
 
@@ -178,6 +178,63 @@ exchange(double *x, double *y)
 	*y = t;
 }
 
+/* The exact sum of a group of values: the sum of the partials plus
+ * infs times 2**DBL_MAX_EXP. */
+struct fsumgroup {
+	int npartials;
+	int maxpartials;
+	bool valseen;
+	bool nilseen;		/* only used by the parallel sum */
+#ifdef INFINITES_ALLOWED
+	float infs;
+#else
+	int infs;
+#endif
+	double *partials;
+};
+
+/* Add x to the exact sum in pg, returns false if there is no memory
+ * for another partial. */
+static inline bool
+fsumadd(struct fsumgroup *pg, double x, double twopow)
+{
+	double y;
+	volatile double lo, hi;
+	int i = 0;
+
+	for (int parti = 0; parti < pg->npartials; parti++) {
+		y = pg->partials[parti];
+		if (fabs(x) < fabs(y))
+			exchange(&x, &y);
+		twosum(&hi, &lo, x, y);
+		if (isinf(hi)) {
+			int sign = hi > 0 ? 1 : -1;
+			hi = x - twopow * sign;
+			x = hi - twopow * sign;
+			pg->infs += sign;
+			if (fabs(x) < fabs(y))
+				exchange(&x, &y);
+			twosum(&hi, &lo, x, y);
+		}
+		if (lo != 0)
+			pg->partials[i++] = lo;
+		x = hi;
+	}
+	if (x != 0) {
+		if (i == pg->maxpartials) {
+			double *temp;
+			pg->maxpartials += pg->maxpartials ? pg->maxpartials : 2;
+			temp = GDKrealloc(pg->partials, pg->maxpartials * sizeof(double));
+			if (temp == NULL)
+				return false;
+			pg->partials = temp;
+		}
+		pg->partials[i++] = x;
+	}
+	pg->npartials = i;
+	return true;
+}
+
 /* this function was adapted from https://bugs.python.org/file10357/msum4.py */
 BUN
 dofsum(const void *restrict values, oid seqb,
@@ -186,20 +243,8 @@ dofsum(const void *restrict values, oid seqb,
        const oid *restrict gids,
        oid min, oid max, bool skip_nils, bool nil_if_empty)
 {
-	struct pergroup {
-		int npartials;
-		int maxpartials;
-		bool valseen;
-#ifdef INFINITES_ALLOWED
-		float infs;
-#else
-		int infs;
-#endif
-		double *partials;
-	} *pergroup;
+	struct fsumgroup *pergroup;
 	BUN listi;
-	int parti;
-	int i;
 	BUN grp;
 	double x, y;
 	volatile double lo, hi;
@@ -226,7 +271,7 @@ dofsum(const void *restrict values, oid seqb,
 	if (pergroup == NULL)
 		return BUN_NONE;
 	for (grp = 0; grp < ngrp; grp++) {
-		pergroup[grp] = (struct pergroup) {
+		pergroup[grp] = (struct fsumgroup) {
 			.maxpartials = 2,
 			.partials = GDKmalloc(2 * sizeof(double)),
 		};
@@ -269,37 +314,8 @@ dofsum(const void *restrict values, oid seqb,
 			continue;
 		}
 #endif
-		i = 0;
-		for (parti = 0; parti < pergroup[grp].npartials; parti++) {
-			y = pergroup[grp].partials[parti];
-			if (fabs(x) < fabs(y))
-				exchange(&x, &y);
-			twosum(&hi, &lo, x, y);
-			if (isinf(hi)) {
-				int sign = hi > 0 ? 1 : -1;
-				hi = x - twopow * sign;
-				x = hi - twopow * sign;
-				pergroup[grp].infs += sign;
-				if (fabs(x) < fabs(y))
-					exchange(&x, &y);
-				twosum(&hi, &lo, x, y);
-			}
-			if (lo != 0)
-				pergroup[grp].partials[i++] = lo;
-			x = hi;
-		}
-		if (x != 0) {
-			if (i == pergroup[grp].maxpartials) {
-				double *temp;
-				pergroup[grp].maxpartials += pergroup[grp].maxpartials;
-				temp = GDKrealloc(pergroup[grp].partials, pergroup[grp].maxpartials * sizeof(double));
-				if (temp == NULL)
-					goto bailout;
-				pergroup[grp].partials = temp;
-			}
-			pergroup[grp].partials[i++] = x;
-		}
-		pergroup[grp].npartials = i;
+		if (!fsumadd(&pergroup[grp], x, twopow))
+			goto bailout;
 	}
 	TIMEOUT_CHECK(qry_ctx, GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
 	for (grp = 0; grp < ngrp; grp++) {
@@ -427,6 +443,429 @@ dofsum(const void *restrict values, oid seqb,
 	return BUN_NONE;
 }
 
+/* Parallel sums.
+ * A large input with a dense candidate list is cut in pieces of
+ * SUM_PIECE rows that a number of threads claim one at a time.  Each
+ * thread adds the values of its pieces to accumulators of its own,
+ * one per group, that lose nothing: integers are added without any
+ * overflow checks in a type wide enough for the sum of all values,
+ * and floating point values are kept as exact sums (see fsumadd).
+ * When all pieces are done, the accumulators of the threads are
+ * combined.  Since nothing is rounded on the way, the results neither
+ * depend on the thread that did a piece nor on the number of threads,
+ * and they are equal to those of the sequential code. */
+
+#define SUM_MINROWS	((BUN) 1 << 20)	/* smallest input worth splitting */
+#define SUM_PIECE	((BUN) 1 << 16)	/* rows per piece */
+#define SUM_MAXGROUPS	((BUN) 1 << 16)	/* most groups per thread */
+#define SUM_MAXTHREADS	64
+
+#ifdef HAVE_HGE
+#define WIDESUM hge
+#else
+#define WIDESUM lng
+#endif
+
+struct sumjob {
+	const void *values;	/* the value of the first candidate */
+	const oid *gids;	/* the group ids of the candidates, or NULL */
+	oid min;
+	BUN ngrp;
+	BUN ncand;
+	int tp;
+	bool nonil;
+	double twopow;
+	bool (*piece)(struct sumjob *, int, BUN, BUN);
+	/* the accumulators, ngrp per thread */
+	WIDESUM *sums;
+	lng *cnts;
+	bool *nils;
+	struct fsumgroup *fsums;
+	int nthreads;
+};
+
+/* The values of a piece are summed in PTYPE before they are added to
+ * the accumulator of the thread, which is possible without overflow
+ * for the types narrower than lng. */
+#define SUM_PIECE_INT(TYPE, PTYPE)					\
+static bool								\
+sum_piece_##TYPE(struct sumjob *job, int t, BUN lo, BUN hi)		\
+{									\
+	const TYPE *restrict vals = job->values;			\
+	WIDESUM *restrict sums = job->sums + t * job->ngrp;		\
+	lng *restrict cnts = job->cnts + t * job->ngrp;			\
+	bool *restrict nils = job->nils + t * job->ngrp;		\
+									\
+	if (job->gids == NULL) {					\
+		PTYPE s = 0;						\
+		if (job->nonil) {					\
+			for (BUN i = lo; i < hi; i++)			\
+				s += vals[i];				\
+			cnts[0] += (lng) (hi - lo);			\
+		} else {						\
+			lng c = 0;					\
+			for (BUN i = lo; i < hi; i++) {			\
+				bool isnil = is_##TYPE##_nil(vals[i]);	\
+				s += isnil ? 0 : vals[i];		\
+				c += !isnil;				\
+			}						\
+			cnts[0] += c;					\
+			nils[0] |= c < (lng) (hi - lo);			\
+		}							\
+		sums[0] += s;						\
+	} else {							\
+		const oid *restrict gids = job->gids;			\
+		const oid min = job->min;				\
+		const BUN ngrp = job->ngrp;				\
+		for (BUN i = lo; i < hi; i++) {				\
+			oid g = gids[i] - min;				\
+			if (g < ngrp) {					\
+				bool isnil = is_##TYPE##_nil(vals[i]);	\
+				sums[g] += isnil ? 0 : vals[i];		\
+				cnts[g] += !isnil;			\
+				nils[g] |= isnil;			\
+			}						\
+		}							\
+	}								\
+	return true;							\
+}
+
+SUM_PIECE_INT(bte, lng)
+SUM_PIECE_INT(sht, lng)
+SUM_PIECE_INT(int, lng)
+SUM_PIECE_INT(lng, WIDESUM)
+
+#define SUM_PIECE_FLOAT(TYPE)						\
+static bool								\
+sum_piece_##TYPE(struct sumjob *job, int t, BUN lo, BUN hi)		\
+{									\
+	const TYPE *restrict vals = job->values;			\
+	struct fsumgroup *restrict fsums = job->fsums + t * job->ngrp;	\
+	const oid *restrict gids = job->gids;				\
+	oid g = 0;							\
+									\
+	for (BUN i = lo; i < hi; i++) {					\
+		if (gids && (g = gids[i] - job->min) >= job->ngrp)	\
+			continue;					\
+		if (is_##TYPE##_nil(vals[i])) {				\
+			fsums[g].nilseen = true;			\
+			continue;					\
+		}							\
+		fsums[g].valseen = true;				\
+		if (!fsumadd(&fsums[g], vals[i], job->twopow))		\
+			return false;					\
+	}								\
+	return true;							\
+}
+
+SUM_PIECE_FLOAT(flt)
+SUM_PIECE_FLOAT(dbl)
+
+static gdk_return
+sum_worker(void *arg, int t, BUN p)
+{
+	struct sumjob *job = arg;
+
+	if (!job->piece(job, t, p * SUM_PIECE,
+			MIN(job->ncand, (p + 1) * SUM_PIECE)))
+		return GDK_FAIL;
+	return GDK_SUCCEED;
+}
+
+static void
+sumjobfree(struct sumjob *job)
+{
+	if (job->fsums) {
+		for (BUN i = 0; i < job->nthreads * job->ngrp; i++)
+			GDKfree(job->fsums[i].partials);
+		GDKfree(job->fsums);
+	}
+	GDKfree(job->sums);
+	GDKfree(job->cnts);
+	GDKfree(job->nils);
+	GDKfree(job);
+}
+
+/* The number of threads to sum ncand values of type tp in ngrp groups
+ * with, or 0 if that is not worth it or not possible. */
+static int
+sumthreads(int tp, BUN ncand, BUN ngrp)
+{
+	int nthreads = GDKnr_threads;
+
+	if (nthreads > SUM_MAXTHREADS)
+		nthreads = SUM_MAXTHREADS;
+	if (ncand < SUM_MINROWS || nthreads <= 1 ||
+	    ngrp > SUM_MAXGROUPS || ngrp * nthreads > ncand / 16)
+		return 0;
+	switch (tp) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng: {
+		/* the sum of all values must fit in a WIDESUM */
+		if (ATOMsize(tp) >= sizeof(WIDESUM))
+			return 0;
+		int shift = (int) (sizeof(WIDESUM) - ATOMsize(tp)) * 8 - 1;
+		if (shift < (int) sizeof(BUN) * 8 && ncand >= (BUN) 1 << shift)
+			return 0;
+		return nthreads;
+	}
+	case TYPE_flt:
+	case TYPE_dbl:
+		return nthreads;
+	default:
+		return 0;
+	}
+}
+
+/* Sum ncand values of type tp in parallel, the value values[i] in the
+ * group gids[i] - min, or all in one group if gids is NULL.  The
+ * integer sums, counts of non-nil values and whether there were nils
+ * are in the first ngrp accumulators of the returned job, the exact
+ * floating point sums of the threads are to be combined with
+ * fsumcombine.  Returns NULL on failure. */
+static struct sumjob *
+sumparallel(const void *values, bool nonil, const oid *gids, oid min,
+	    BUN ngrp, BUN ncand, int tp, int nthreads)
+{
+	struct sumjob *job;
+	lng t0 = 0;
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+
+	if ((job = GDKmalloc(sizeof(struct sumjob))) == NULL)
+		return NULL;
+	*job = (struct sumjob) {
+		.values = values,
+		.gids = gids,
+		.min = min,
+		.ngrp = ngrp,
+		.ncand = ncand,
+		.tp = tp,
+		.nonil = nonil,
+		.twopow = pow((double) FLT_RADIX, (double) (DBL_MAX_EXP - 1)),
+		.nthreads = nthreads,
+	};
+	switch (tp) {
+	case TYPE_bte:
+		job->piece = sum_piece_bte;
+		break;
+	case TYPE_sht:
+		job->piece = sum_piece_sht;
+		break;
+	case TYPE_int:
+		job->piece = sum_piece_int;
+		break;
+	case TYPE_lng:
+		job->piece = sum_piece_lng;
+		break;
+	case TYPE_flt:
+		job->piece = sum_piece_flt;
+		break;
+	case TYPE_dbl:
+		job->piece = sum_piece_dbl;
+		break;
+	default:
+		MT_UNREACHABLE();
+	}
+	if (tp == TYPE_flt || tp == TYPE_dbl) {
+		/* the partials are allocated by fsumadd when needed */
+		job->fsums = GDKzalloc(nthreads * ngrp * sizeof(struct fsumgroup));
+		if (job->fsums == NULL) {
+			sumjobfree(job);
+			return NULL;
+		}
+	} else {
+		job->sums = GDKzalloc(nthreads * ngrp * sizeof(WIDESUM));
+		job->cnts = GDKzalloc(nthreads * ngrp * sizeof(lng));
+		job->nils = GDKzalloc(nthreads * ngrp * sizeof(bool));
+		if (job->sums == NULL || job->cnts == NULL || job->nils == NULL) {
+			sumjobfree(job);
+			return NULL;
+		}
+	}
+
+	if (GDKparallel("sum", nthreads, (ncand + SUM_PIECE - 1) / SUM_PIECE,
+			sum_worker, job) != GDK_SUCCEED) {
+		sumjobfree(job);
+		return NULL;
+	}
+	if (job->sums) {
+		/* the sum of all of them fits (see sumthreads) */
+		for (int t = 1; t < nthreads; t++) {
+			for (BUN g = 0; g < ngrp; g++) {
+				job->sums[g] += job->sums[t * ngrp + g];
+				job->cnts[g] += job->cnts[t * ngrp + g];
+				job->nils[g] |= job->nils[t * ngrp + g];
+			}
+		}
+	}
+	TRC_DEBUG(ALGO, "sumparallel(tp=%s,ncand=" BUNFMT ",ngrp=" BUNFMT ")"
+		  " " BUNFMT " pieces, %d threads, " LLFMT " usec\n",
+		  ATOMname(tp), ncand, ngrp, (ncand + SUM_PIECE - 1) / SUM_PIECE, nthreads,
+		  GDKusec() - t0);
+	return job;
+}
+
+/* Combine the exact floating point sums of the threads of a job into
+ * results of type tp2: all their partials (and overflows) are summed
+ * per group by dofsum, which gives the correctly rounded sum whatever
+ * their order.  Returns the number of nils, BUN_NONE on failure. */
+static BUN
+fsumcombine(struct sumjob *job, void *restrict results, int tp2,
+	    bool skip_nils, bool nil_if_empty)
+{
+	const BUN ngrp = job->ngrp;
+	const struct fsumgroup *fsums = job->fsums;
+	BUN n = ngrp, nils;
+	double *vals;
+	oid *gids;
+
+	for (BUN i = 0; i < job->nthreads * ngrp; i++)
+		n += fsums[i].npartials + 2 * (BUN) fabs((double) fsums[i].infs);
+	vals = GDKmalloc(n * sizeof(double));
+	gids = GDKmalloc(n * sizeof(oid));
+	if (vals == NULL || gids == NULL) {
+		GDKfree(vals);
+		GDKfree(gids);
+		return BUN_NONE;
+	}
+	n = 0;
+	for (BUN g = 0; g < ngrp; g++) {
+		bool valseen = false, nilseen = false;
+		for (int t = 0; t < job->nthreads; t++) {
+			valseen |= fsums[t * ngrp + g].valseen;
+			nilseen |= fsums[t * ngrp + g].nilseen;
+		}
+		if (nilseen && !skip_nils) {
+			vals[n] = dbl_nil;
+			gids[n++] = g;
+			continue;
+		}
+		if (!valseen)
+			continue;
+		/* so that the group is seen even if it sums to zero */
+		vals[n] = 0;
+		gids[n++] = g;
+		for (int t = 0; t < job->nthreads; t++) {
+			const struct fsumgroup *pg = &fsums[t * ngrp + g];
+			for (int i = 0; i < pg->npartials; i++) {
+				vals[n] = pg->partials[i];
+				gids[n++] = g;
+			}
+			/* each overflow stands for 2 * twopow */
+			for (BUN i = 2 * (BUN) fabs((double) pg->infs); i > 0; i--) {
+				vals[n] = pg->infs > 0 ? job->twopow : -job->twopow;
+				gids[n++] = g;
+			}
+		}
+	}
+	nils = dofsum(vals, 0, &(struct canditer) {.tpe = cand_dense, .ncand = n},
+		      results, ngrp, TYPE_dbl, tp2, gids, 0, ngrp - 1,
+		      false, nil_if_empty);
+	GDKfree(vals);
+	GDKfree(gids);
+	return nils;
+}
+
+#define SUM_RESULTS(TYPE2, OVERFLOW)					\
+	do {								\
+		TYPE2 *restrict sums = results;				\
+		for (BUN g = 0; g < ngrp; g++) {			\
+			WIDESUM s = job->sums[g];			\
+			if (job->nils[g] && !skip_nils) {		\
+				sums[g] = TYPE2##_nil;			\
+				nils++;					\
+			} else if (job->cnts[g] == 0) {			\
+				sums[g] = nil_if_empty ? TYPE2##_nil : 0; \
+				nils += nil_if_empty;			\
+			} else if (OVERFLOW) {				\
+				goto overflow;				\
+			} else {					\
+				sums[g] = (TYPE2) s;			\
+			}						\
+		}							\
+	} while (0)
+
+/* Whether dosumparallel can sum values of type tp1 into tp2. */
+static bool
+sumtypes(int tp1, int tp2)
+{
+	switch (tp2) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+#ifdef HAVE_HGE
+	case TYPE_hge:
+#endif
+		return tp1 != TYPE_flt && tp1 != TYPE_dbl &&
+			ATOMsize(tp1) <= ATOMsize(tp2);
+	case TYPE_flt:
+		return tp1 == TYPE_flt;
+	case TYPE_dbl:
+		return tp1 == TYPE_flt || tp1 == TYPE_dbl;
+	default:
+		return false;
+	}
+}
+
+/* The parallel version of dosum. */
+static BUN
+dosumparallel(const void *restrict values, bool nonil,
+	      void *restrict results, BUN ngrp, int tp1, int tp2,
+	      const oid *restrict gids, oid min, BUN ncand,
+	      bool skip_nils, bool nil_if_empty, int nthreads,
+	      const char **algo)
+{
+	struct sumjob *job;
+	BUN nils = 0;
+
+	job = sumparallel(values, nonil, gids, min, ngrp, ncand, tp1, nthreads);
+	if (job == NULL)
+		return BUN_NONE;
+	if (job->fsums) {
+		*algo = "sum: parallel, floating point";
+		nils = fsumcombine(job, results, tp2, skip_nils, nil_if_empty);
+		sumjobfree(job);
+		return nils;
+	}
+	*algo = "sum: parallel";
+	switch (tp2) {
+	case TYPE_bte:
+		SUM_RESULTS(bte, s > GDK_bte_max || s < -GDK_bte_max);
+		break;
+	case TYPE_sht:
+		SUM_RESULTS(sht, s > GDK_sht_max || s < -GDK_sht_max);
+		break;
+	case TYPE_int:
+		SUM_RESULTS(int, s > GDK_int_max || s < -GDK_int_max);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_lng:
+		SUM_RESULTS(lng, s > GDK_lng_max || s < -GDK_lng_max);
+		break;
+	case TYPE_hge:
+		SUM_RESULTS(hge, false);
+		break;
+#else
+	case TYPE_lng:
+		SUM_RESULTS(lng, false);
+		break;
+#endif
+	default:
+		MT_UNREACHABLE();
+	}
+	sumjobfree(job);
+	return nils;
+
+  overflow:
+	sumjobfree(job);
+	GDKerror("22003!overflow in sum aggregate.\n");
+	return BUN_NONE;
+}
+
 #define AGGR_SUM(TYPE1, TYPE2)						\
 	do {								\
 		TYPE1 x;						\
@@ -437,13 +876,20 @@ dofsum(const void *restrict values, oid seqb,
 			*algo = "sum: no candidates, no groups";	\
 			sum = 0;					\
 			if (nonil) {					\
+				/* look at overflow once per block */	\
+				const BUN nblocks = (ci->ncand + NONIL_BLOCK - 1) / NONIL_BLOCK; \
+				vals += ci->seq - seqb;			\
 				*seen = ci->ncand > 0;			\
-				TIMEOUT_LOOP_IDX(i, ci->ncand, qry_ctx) { \
-					x = vals[ci->seq + i - seqb];	\
-					ADD_WITH_CHECK(x, sum,		\
-						       TYPE2, sum,	\
-						       GDK_##TYPE2##_max, \
-						       goto overflow);	\
+				TIMEOUT_LOOP_IDX(i, nblocks, qry_ctx) {	\
+					const BUN hi = MIN(ci->ncand, (i + 1) * NONIL_BLOCK); \
+					bool ovf = false;		\
+					for (BUN k = i * NONIL_BLOCK; k < hi; k++) \
+						ADDI_WITH_CHECK(vals[k], sum, \
+								TYPE2, sum, \
+								GDK_##TYPE2##_max, \
+								ovf = true); \
+					if (ovf)			\
+						goto overflow;		\
 				}					\
 				TIMEOUT_CHECK(qry_ctx,			\
 					      GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx)); \
@@ -717,10 +1163,21 @@ dosum(const void *restrict values, bool nonil, oid seqb,
 	BUN i;
 	oid gid;
 	unsigned int *restrict seen = NULL; /* bitmask for groups that we've seen */
+	int nthreads;
 
 	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
 	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};
 
+	if (ci->tpe == cand_dense &&
+	    sumtypes(tp1, tp2) &&
+	    (nthreads = sumthreads(tp1, ci->ncand, ngrp)) > 0) {
+		/* a single group does not look at the group ids */
+		return dosumparallel((const char *) values + (ci->seq - seqb) * ATOMsize(tp1),
+				     nonil, results, ngrp, tp1, tp2,
+				     ngrp == 1 ? NULL : gids, min, ci->ncand,
+				     skip_nils, nil_if_empty, nthreads, algo);
+	}
+
 	switch (tp2) {
 	case TYPE_flt:
 		if (tp1 != TYPE_flt)
@@ -1816,6 +2273,7 @@ BATgroupavg(BAT **bnp, BAT **cntsp, BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool
 	const char *err;
 	lng t0 = 0;
 	BATiter bi = {0};
+	int nthreads;
 
 	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
 	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};
@@ -1912,7 +2370,35 @@ BATgroupavg(BAT **bnp, BAT **cntsp, BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool
 		gids = (const oid *) Tloc(g, 0);
 
 	bi = bat_iterator(b);
-	switch (b->ttype) {
+	if (rems != NULL && ci.tpe == cand_dense &&
+	    (gids != NULL || ngrp == 1) &&
+	    (nthreads = sumthreads(bi.type, ci.ncand, ngrp)) > 0) {
+		/* split the exact sums in the average rounded down and
+		 * the remainder, like AVERAGE_ITER does */
+		struct sumjob *job;
+		job = sumparallel((const char *) bi.base + (ci.seq - b->hseqbase) * bi.width,
+				  bi.nonil, gids, min, ngrp, ci.ncand, bi.type,
+				  nthreads);
+		if (job == NULL)
+			goto bailout;
+		for (i = 0; i < ngrp; i++) {
+			if ((job->nils[i] && !skip_nils) || job->cnts[i] == 0) {
+				dbls[i] = dbl_nil;
+				cnts[i] = 0;
+				nils++;
+			} else {
+				WIDESUM a = job->sums[i] / job->cnts[i];
+				WIDESUM r = job->sums[i] % job->cnts[i];
+				if (r < 0) {
+					a--;
+					r += job->cnts[i];
+				}
+				cnts[i] = job->cnts[i];
+				dbls[i] = a + (dbl) r / cnts[i];
+			}
+		}
+		sumjobfree(job);
+	} else switch (b->ttype) {
 	case TYPE_bte:
 		AGGR_AVG(bte);
 		break;
@@ -3001,6 +3487,7 @@ BATcalcavg(BAT *b, BAT *s, dbl *avg, BUN *vals, int scale)
 #endif
 	struct canditer ci;
 	const void *restrict src;
+	int nthreads;
 
 	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
 	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};
@@ -3010,7 +3497,19 @@ BATcalcavg(BAT *b, BAT *s, dbl *avg, BUN *vals, int scale)
 	BATiter bi = bat_iterator(b);
 	src = bi.base;
 
-	switch (b->ttype) {
+	if (ci.tpe == cand_dense && bi.type != TYPE_flt && bi.type != TYPE_dbl &&
+	    (nthreads = sumthreads(bi.type, ci.ncand, 1)) > 0) {
+		/* the exact sum and count, as below but in parallel */
+		struct sumjob *job;
+		job = sumparallel((const char *) src + (ci.seq - b->hseqbase) * bi.width,
+				  bi.nonil, NULL, 0, 1, ci.ncand, bi.type,
+				  nthreads);
+		if (job == NULL)
+			goto bailout;
+		n = job->cnts[0];
+		*avg = n > 0 ? (dbl) job->sums[0] / n : dbl_nil;
+		sumjobfree(job);
+	} else switch (b->ttype) {
 	case TYPE_bte:
 		AVERAGE_TYPE(bte);
 		break;
@@ -345,6 +345,7 @@ VIEWdestroy(BAT *b)
 	IMPSdestroy(b);
 	OIDXdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
 	RTREEdestroy(b);
 
 	MT_lock_set(&b->theaplock);
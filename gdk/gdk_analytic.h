@@ -49,6 +49,11 @@ gdk_export gdk_return GDKanalytical_covariance_pop(BAT *r, BAT *p, BAT *o, BAT *
 gdk_export gdk_return GDKanalytical_covariance_samp(BAT *r, BAT *p, BAT *o, BAT *b1, BAT *b2, BAT *s, BAT *e, int tpe, int frame_type);
 gdk_export gdk_return GDKanalytical_correlation(BAT *r, BAT *p, BAT *o, BAT *b1, BAT *b2, BAT *s, BAT *e, int tpe, int frame_type);
 
+/* Evaluate a window function on pieces of the input in parallel; func
+ * computes one piece with the arguments it was given and arg. */
+typedef gdk_return (*GDKanalyticalpiece)(BAT *r, BAT *p, BAT *o, BAT *b, BAT *b2, BAT *s, BAT *e, const void *arg);
+gdk_export gdk_return GDKanalyticalparallel(BAT *r, BAT *p, BAT *o, BAT *b, BAT *b2, BAT *s, BAT *e, int frame_type, bool positions, GDKanalyticalpiece func, const void *arg);
+
 #define SEGMENT_TREE_FANOUT 16 /* Segment tree fanout size. Later we could do experiments from it */
 #define NOTHING /* used for not used optional arguments for aggregate computation */
 
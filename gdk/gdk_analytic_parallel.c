@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/*
+ * Parallel evaluation of window functions.
+ * The rows are split in pieces that are evaluated by the sequential
+ * implementations on slices of the inputs, each piece by one of a
+ * number of threads, after which the results are copied into place.
+ * Pieces always end at a partition boundary, except when each row
+ * has its own frame: for frames given by explicit bounds (frame types
+ * 0 to 2) a piece inside a partition gets the rows its frames cover,
+ * and frames of the current row only (type 6) can be split anywhere.
+ * So a single huge partition is split as well, and the segment tree of
+ * each piece only covers the rows of that piece.
+ */
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+#include "gdk_analytic.h"
+
+#define ANALYTICAL_MINROWS	((BUN) 1 << 20)	/* smallest input worth splitting */
+#define ANALYTICAL_MINPIECE	((BUN) 1 << 17)	/* smallest piece */
+#define ANALYTICAL_MAXPIECES	256
+
+struct analyticpiece {
+	BUN lo, hi;					/* the rows to compute */
+	BUN blo, bhi;				/* the rows their frames need */
+	bool nil, nonil;
+};
+
+struct analyticjob {
+	BAT *r, *p, *o, *b, *b2, *s, *e;
+	const bit *np;
+	const oid *sp, *ep;
+	bool positions;
+	GDKanalyticalpiece func;
+	const void *arg;
+	struct analyticpiece pieces[ANALYTICAL_MAXPIECES];
+	int npieces;
+};
+
+static gdk_return
+analytic_piece(void *arg, int t, BUN i)
+{
+	struct analyticjob *job = arg;
+	struct analyticpiece *pc = &job->pieces[i];
+	BUN n = pc->bhi - pc->blo;
+	BAT *r = NULL, *p = NULL, *o = NULL, *b = NULL, *b2 = NULL, *s = NULL, *e = NULL;
+	gdk_return res = GDK_FAIL;
+
+	(void) t;
+
+	if (job->p) {
+		/* like for the whole input, the first row does not start
+		 * a new partition */
+		if ((p = COLnew(0, TYPE_bit, n, TRANSIENT)) == NULL)
+			goto bailout;
+		memcpy(Tloc(p, 0), job->np + pc->blo, n);
+		*(bit *) Tloc(p, 0) = 0;
+		BATsetcount(p, n);
+	}
+	if ((job->o && (o = BATslice(job->o, pc->blo, pc->bhi)) == NULL) ||
+	    (b = BATslice(job->b, pc->blo, pc->bhi)) == NULL ||
+	    (job->b2 && (b2 = BATslice(job->b2, pc->blo, pc->bhi)) == NULL) ||
+	    (r = COLnew(0, job->r->ttype, n, TRANSIENT)) == NULL)
+		goto bailout;
+	if (job->s) {
+		/* the bounds relative to the piece; the rows that are
+		 * only there for the frames of others get empty frames */
+		if ((s = COLnew(0, TYPE_oid, n, TRANSIENT)) == NULL ||
+		    (e = COLnew(0, TYPE_oid, n, TRANSIENT)) == NULL)
+			goto bailout;
+		oid *restrict so = Tloc(s, 0), *restrict eo = Tloc(e, 0);
+		for (BUN i = pc->blo; i < pc->bhi; i++) {
+			if (i >= pc->lo && i < pc->hi) {
+				so[i - pc->blo] = job->sp[i] - pc->blo;
+				eo[i - pc->blo] = job->ep[i] - pc->blo;
+			} else {
+				so[i - pc->blo] = eo[i - pc->blo] = i - pc->blo;
+			}
+		}
+		BATsetcount(s, n);
+		BATsetcount(e, n);
+	}
+	if ((res = job->func(r, p, o, b, b2, s, e, job->arg)) != GDK_SUCCEED)
+		goto bailout;
+
+	if (job->positions) {
+		const oid *restrict src = (const oid *) Tloc(r, 0) + (pc->lo - pc->blo);
+		oid *restrict dst = (oid *) Tloc(job->r, 0) + pc->lo;
+		for (BUN i = 0; i < pc->hi - pc->lo; i++)
+			dst[i] = src[i] + pc->blo;
+	} else {
+		memcpy(Tloc(job->r, pc->lo), Tloc(r, pc->lo - pc->blo),
+		       (pc->hi - pc->lo) << r->tshift);
+	}
+	/* the extra rows may be nil where the copied ones are not */
+	pc->nil = r->tnil && pc->blo == pc->lo && pc->bhi == pc->hi;
+	pc->nonil = r->tnonil;
+
+  bailout:
+	BBPreclaim(r);
+	BBPreclaim(p);
+	BBPreclaim(o);
+	BBPreclaim(b);
+	BBPreclaim(b2);
+	BBPreclaim(s);
+	BBPreclaim(e);
+	return res;
+}
+
+/* Split the rows in pieces, returns the number of pieces. */
+static int
+analytic_split(struct analyticjob *job, int npieces, bool within)
+{
+	BUN cnt = BATcount(job->b), lo = 0, hi;
+	const bit *np = job->np;
+	int n = 0;
+
+	for (int t = 1; t <= npieces && lo < cnt; t++) {
+		hi = t == npieces ? cnt : (BUN) ((double) cnt * t / npieces);
+		if (hi <= lo)
+			continue;
+		if (!within) {
+			if (np == NULL)
+				hi = cnt;
+			while (hi < cnt && !np[hi])
+				hi++;
+		}
+		struct analyticpiece *pc = &job->pieces[n++];
+		*pc = (struct analyticpiece) {
+			.lo = lo,
+			.hi = hi,
+			.blo = lo,
+			.bhi = hi,
+		};
+		if (job->sp && within) {
+			for (BUN i = lo; i < hi; i++) {
+				if (job->sp[i] < pc->blo)
+					pc->blo = job->sp[i];
+				if (job->ep[i] > pc->bhi)
+					pc->bhi = job->ep[i];
+			}
+			/* frames much wider than the piece would make us do
+			 * the work several times */
+			if (pc->bhi - pc->blo > 2 * (hi - lo)) {
+				n = -1;
+				break;
+			}
+		}
+		lo = hi;
+	}
+	return n;
+}
+
+/* Evaluate a window function, computing the results with func on
+ * pieces of the input in parallel if the input is large enough.  The
+ * frame_type is that of the window function, or 5 (all rows of the
+ * partition) for computations that need whole partitions.  If
+ * positions is set, the results are positions in b, which are adjusted
+ * for the offset of each piece. */
+gdk_return
+GDKanalyticalparallel(BAT *r, BAT *p, BAT *o, BAT *b, BAT *b2, BAT *s, BAT *e,
+		      int frame_type, bool positions,
+		      GDKanalyticalpiece func, const void *arg)
+{
+	lng t0 = 0;
+	BUN cnt = BATcount(b);
+	int nthreads = GDKnr_threads, npieces;
+	struct analyticjob *job;
+	BATiter pi, si, ei;
+	gdk_return res;
+	bool nil = false, nonil = true;
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+
+	npieces = (int) MIN(cnt / ANALYTICAL_MINPIECE, (BUN) 2 * nthreads);
+	if (npieces > ANALYTICAL_MAXPIECES)
+		npieces = ANALYTICAL_MAXPIECES;
+	if (nthreads <= 1 || cnt < ANALYTICAL_MINROWS || npieces <= 1 ||
+	    ATOMvarsized(r->ttype) || (positions && r->ttype != TYPE_oid) ||
+	    (frame_type < 3 && (s == NULL || e == NULL)) ||
+	    /* the pieces read the partition starts and the frame bounds
+	     * directly */
+	    (p && p->ttype != TYPE_bit) ||
+	    (s && s->ttype != TYPE_oid) || (e && e->ttype != TYPE_oid) ||
+	    (job = GDKmalloc(sizeof(struct analyticjob))) == NULL)
+		return func(r, p, o, b, b2, s, e, arg);
+
+	pi = bat_iterator(p);
+	si = bat_iterator(s);
+	ei = bat_iterator(e);
+	*job = (struct analyticjob) {
+		.r = r,
+		.p = p,
+		.o = o,
+		.b = b,
+		.b2 = b2,
+		.s = s,
+		.e = e,
+		.np = pi.base,
+		.sp = si.base,
+		.ep = ei.base,
+		.positions = positions,
+		.func = func,
+		.arg = arg,
+	};
+	job->npieces = -1;
+	if (frame_type < 3 || frame_type == 6)
+		job->npieces = analytic_split(job, npieces, true);
+	if (job->npieces < 0)
+		job->npieces = analytic_split(job, npieces, false);
+	if (job->npieces <= 1) {
+		bat_iterator_end(&pi);
+		bat_iterator_end(&si);
+		bat_iterator_end(&ei);
+		GDKfree(job);
+		return func(r, p, o, b, b2, s, e, arg);
+	}
+
+	res = GDKparallel("analytic", nthreads, (BUN) job->npieces,
+			  analytic_piece, job);
+	bat_iterator_end(&pi);
+	bat_iterator_end(&si);
+	bat_iterator_end(&ei);
+	if (res != GDK_SUCCEED) {
+		GDKfree(job);
+		return GDK_FAIL;
+	}
+	for (int i = 0; i < job->npieces; i++) {
+		nil |= job->pieces[i].nil;
+		nonil &= job->pieces[i].nonil;
+	}
+	BATsetcount(r, cnt);
+	r->tnil = nil;
+	r->tnonil = nonil;
+	TRC_DEBUG(ALGO, "GDKanalyticalparallel(b=" ALGOBATFMT ",frame_type=%d)"
+		  " %d pieces, %d threads, " LLFMT " usec\n",
+		  ALGOBATPAR(b), frame_type, job->npieces, MIN(nthreads, job->npieces),
+		  GDKusec() - t0);
+	GDKfree(job);
+	return GDK_SUCCEED;
+}
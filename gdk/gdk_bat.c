@@ -464,6 +464,137 @@ BATattach(int tt, const char *heapfile, role_t role)
 	return NULL;
 }
 
+#ifdef NATIVE_WIN32
+#define fseeko(f, o, w)	_fseeki64(f, (__int64) (o), w)
+#endif
+
+/* Create a transient BAT of fixed-width type TT whose tail consists of
+ * the CNT values stored at byte offset OFF of the external file
+ * HEAPFILE.  If OFF is a multiple of the page size, the range is
+ * memory mapped copy-on-write so that no data is copied; the heap is
+ * only converted to allocated memory when it needs to grow.
+ * Otherwise, the data is read into a freshly allocated BAT. */
+BAT *
+BATattachrange(int tt, const char *heapfile, size_t off, BUN cnt)
+{
+	BAT *bn;
+	size_t len;
+	char *p;
+
+	ERRORcheck(tt <= 0 , "bad tail type (<=0)\n", NULL);
+	ERRORcheck(ATOMvarsized(tt) || ATOMstorage(tt) == TYPE_msk, "bad tail type (not fixed width)\n", NULL);
+	ERRORcheck(heapfile == NULL, "bad heapfile name\n", NULL);
+	ERRORcheck(cnt > BUN_MAX, "range too large\n", NULL);
+
+	len = (size_t) cnt * ATOMsize(tt);
+	if (len == 0 || off % MT_pagesize() != 0) {
+		FILE *f;
+
+		if ((bn = COLnew(0, tt, cnt, TRANSIENT)) == NULL)
+			return NULL;
+		if (len > 0) {
+			if ((f = MT_fopen(heapfile, "rb")) == NULL) {
+				GDKsyserror("BATattachrange: cannot open %s\n", heapfile);
+				BBPreclaim(bn);
+				return NULL;
+			}
+			if (fseeko(f, off, SEEK_SET) < 0 ||
+			    fread(Tloc(bn, 0), 1, len, f) != len) {
+				GDKerror("couldn't read the complete range\n");
+				fclose(f);
+				BBPreclaim(bn);
+				return NULL;
+			}
+			fclose(f);
+		}
+	} else {
+		if ((bn = COLnew(0, tt, 0, TRANSIENT)) == NULL)
+			return NULL;
+		if ((p = GDKmmap_range(heapfile, off, len)) == NULL) {
+			BBPreclaim(bn);
+			return NULL;
+		}
+		QryCtx *qc = bn->theap->farmid == 1 ? MT_thread_get_qry_ctx() : NULL;
+		MT_lock_set(&bn->theaplock);
+		HEAPfree(bn->theap, false);
+		bn->theap->base = p;
+		bn->theap->size = len;
+		bn->theap->free = len;
+		bn->theap->storage = STORE_PRIV;
+		bn->theap->newstorage = STORE_MEM;
+		bn->theap->hasfile = false;
+		bn->theap->dirty = false;
+		bn->batCapacity = cnt;
+		MT_lock_unset(&bn->theaplock);
+		if (qc != NULL)
+			ATOMIC_ADD(&qc->datasize, len);
+	}
+	BATsetcount(bn, cnt);
+	bn->tnonil = cnt == 0;
+	bn->tnil = false;
+	bn->tseqbase = oid_nil;
+	if (cnt > 1) {
+		bn->tsorted = false;
+		bn->trevsorted = false;
+		bn->tkey = false;
+	} else {
+		bn->tsorted = ATOMlinear(tt);
+		bn->trevsorted = ATOMlinear(tt);
+		bn->tkey = true;
+	}
+	TRC_DEBUG(ALGO, "%s,%zu," BUNFMT "-> " ALGOBATFMT "\n",
+		  heapfile, off, cnt, ALGOBATPAR(bn));
+	return bn;
+}
+
+/* Create a transient BAT on top of cnt values of type tt at data.  If
+ * owned is set, data was allocated with malloc and the BAT takes it
+ * over, otherwise data is only borrowed and must outlive the BAT.
+ * Either way the memory is replaced by GDKmalloced memory when the BAT
+ * grows. */
+BAT *
+BATattachmem(int tt, void *data, BUN cnt, bool owned)
+{
+	BAT *bn;
+
+	ERRORcheck(tt <= 0 , "bad tail type (<=0)\n", NULL);
+	ERRORcheck(ATOMvarsized(tt) || ATOMstorage(tt) == TYPE_msk, "bad tail type (not fixed width)\n", NULL);
+	ERRORcheck(data == NULL && cnt > 0, "no data\n", NULL);
+
+	if ((bn = COLnew(0, tt, 0, TRANSIENT)) == NULL)
+		return NULL;
+	if (cnt > 0) {
+		MT_lock_set(&bn->theaplock);
+		HEAPfree(bn->theap, false);
+		bn->theap->base = data;
+		bn->theap->size = bn->theap->free = (size_t) cnt * ATOMsize(tt);
+		bn->theap->storage = owned ? STORE_CMEM : STORE_NOWN;
+		bn->theap->newstorage = STORE_MEM;
+		bn->theap->hasfile = false;
+		bn->theap->dirty = true;
+		bn->batCapacity = cnt;
+		MT_lock_unset(&bn->theaplock);
+	} else if (owned) {
+		free(data);
+	}
+	BATsetcount(bn, cnt);
+	bn->tnonil = cnt == 0;
+	bn->tnil = false;
+	bn->tseqbase = oid_nil;
+	if (cnt > 1) {
+		bn->tsorted = false;
+		bn->trevsorted = false;
+		bn->tkey = false;
+	} else {
+		bn->tsorted = ATOMlinear(tt);
+		bn->trevsorted = ATOMlinear(tt);
+		bn->tkey = true;
+	}
+	TRC_DEBUG(ALGO, "%p," BUNFMT ",%d -> " ALGOBATFMT "\n",
+		  data, cnt, owned, ALGOBATPAR(bn));
+	return bn;
+}
+
 /*
  * If the BAT runs out of storage for BUNS it will reallocate space.
  * For memory mapped BATs we simple extend the administration after
@@ -580,6 +711,7 @@ BATclear(BAT *b, bool force)
 	IMPSdestroy(b);
 	OIDXdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
 	RTREEdestroy(b);
 	PROPdestroy(b);
 
@@ -672,6 +804,7 @@ BATfree(BAT *b)
 	IMPSfree(b);
 	OIDXfree(b);
 	STRMPfree(b);
+	TRGMfree(b);
 	RTREEfree(b);
 	MT_lock_set(&b->theaplock);
 	if (nunique != BUN_NONE) {
@@ -894,6 +1027,8 @@ COLcopy(BAT *b, int tt, bool writable, role_t role)
 			if (bn->tvheap) {
 				memcpy(bn->tvheap->base, bi.vh->base, bi.vhfree);
 				bn->tvheap->free = bi.vhfree;
+				bn->tvheap->asciifree = MIN(bi.vh->asciifree, bi.vhfree);
+				bn->tvheap->notascii = bi.vh->notascii;
 				bn->tvheap->dirty = true;
 			}
 
@@ -1514,6 +1649,7 @@ BUNdelete(BAT *b, oid o)
 	MT_lock_unset(&b->theaplock);
 	IMPSdestroy(b);
 	OIDXdestroy(b);
+	TRGMdestroy(b);
 	return GDK_SUCCEED;
 }
 
@@ -1678,6 +1814,7 @@ BUNinplacemulti(BAT *b, const oid *positions, const void *values, BUN count, boo
 		OIDXdestroy(b);
 		IMPSdestroy(b);
 		STRMPdestroy(b);
+		TRGMdestroy(b);
 		RTREEdestroy(b);
 
 		if (b->tvheap && b->ttype) {
@@ -2586,6 +2723,8 @@ BATmode(BAT *b, bool transient)
 				BBP_status_off(bid, BBPDELETED);
 			} else
 				BBP_status_on(bid, BBPNEW);
+			if (BBP_cache(bid))
+				BBPclocklink(bid);
 		} else if (!bi.transient) {
 			if (!(BBP_status(bid) & BBPNEW))
 				BBP_status_on(bid, BBPDELETED);
@@ -146,6 +146,18 @@ insert_string_bat(BAT *b, BATiter *ni, struct canditer *ci, bool force, bool may
 					return GDK_FAIL;
 				}
 				memcpy(b->tvheap->base + toff, ni->vh->base, ni->vhfree);
+				/* the appended heap is only known to be ASCII
+				 * if both are, and it has a hash table in the
+				 * middle which cannot be checked later */
+				if (toff == 0) {
+					b->tvheap->asciifree = MIN(ni->vh->asciifree, ni->vhfree);
+					b->tvheap->notascii = ni->vh->notascii;
+				} else if (b->tvheap->asciifree >= b->tvheap->free &&
+					   ni->vh->asciifree >= ni->vhfree) {
+					b->tvheap->asciifree = toff + ni->vhfree;
+				} else {
+					b->tvheap->notascii = true;
+				}
 				b->tvheap->free = toff + ni->vhfree;
 				b->tvheap->dirty = true;
 				MT_lock_unset(&b->theaplock);
@@ -445,6 +457,8 @@ append_varsized_bat(BAT *b, BATiter *ni, struct canditer *ci, bool mayshare)
 		b->theap->free = ni->hfree;
 		b->theap->dirty = true;
 		b->tvheap->free = ni->vhfree;
+		b->tvheap->asciifree = MIN(ni->vh->asciifree, ni->vhfree);
+		b->tvheap->notascii = ni->vh->notascii;
 		b->tvheap->dirty = true;
 		BATsetcount(b, ni->count);
 		b->tnil = ni->nil;
@@ -728,6 +742,8 @@ BATappend2(BAT *b, BAT *n, BAT *s, bool force, bool mayshare)
 	OIDXdestroy(b);
 	STRMPdestroy(b);	/* TODO: use STRMPappendBitString */
 	RTREEdestroy(b);
+	/* the trigram index covers a prefix of the rows and survives
+	 * appends */
 
 	MT_lock_set(&b->theaplock);
 	const bool notnull = BATgetprop_nolock(b, GDK_NOT_NULL) != NULL;
@@ -1025,6 +1041,7 @@ BATdel(BAT *b, BAT *d)
 	HASHdestroy(b);
 	PROPdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
 	RTREEdestroy(b);
 	if (BATtdense(d)) {
 		oid o = d->tseqbase;
@@ -1221,6 +1238,7 @@ BATappend_or_update(BAT *b, BAT *p, const oid *positions, BAT *n,
 	OIDXdestroy(b);
 	IMPSdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
 	RTREEdestroy(b);
 	/* load hash so that we can maintain it */
 	(void) BATcheckhash(b);
@@ -1253,6 +1253,7 @@ fixhashashbat(BAT *b)
 	OIDXdestroy(b);
 	PROPdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
 	RTREEdestroy(b);
 
 	/* make backup of heaps */
@@ -1534,6 +1535,7 @@ jsonupgradebat(BAT *b, json_storage_conversion fixJSONStorage)
 	OIDXdestroy(b);
 	PROPdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
 	RTREEdestroy(b);
 
 	/* backup the current heaps */
@@ -1741,55 +1743,219 @@ BBPjson_upgrade(json_storage_conversion fixJSONStorage)
 }
 #endif
 
+/*
+ * The buffer manager keeps the loaded persistent bats in a circular
+ * doubly linked list, the clock.  Using a bat (BBPfix) only sets its
+ * BBPHOT bit.  The BBPmanager thread periodically advances the clock
+ * hand over the loaded bats: a hot bat has its bit cleared and gets
+ * as many sweeps of grace as its priority, other bats use up one
+ * sweep of grace, and bats that have none left are unloaded.  When
+ * the memory budget (gdk_bbp_budget) is exceeded, the grace period
+ * and the hot bits are ignored.  BBPclockLock nests inside
+ * GDKswapLock.
+ */
+static MT_Lock BBPclockLock = MT_LOCK_INITIALIZER(BBPclockLock);
+static bat BBPclockhand;	/* 0 if no bats are in the clock */
+static bat BBPclocksize;	/* number of bats in the clock */
+static ATOMIC_TYPE BBPhits = ATOMIC_VAR_INIT(0);
+static ATOMIC_TYPE BBPmisses = ATOMIC_VAR_INIT(0);
+static ATOMIC_TYPE BBPevictions = ATOMIC_VAR_INIT(0);
+static ATOMIC_TYPE BBPsweeps = ATOMIC_VAR_INIT(0);
+static ATOMIC_TYPE BBPbudget = ATOMIC_VAR_INIT(0); /* 0: no explicit budget */
+
+/* add a loaded persistent bat to the clock, just behind the hand */
+void
+BBPclocklink(bat i)
+{
+	MT_lock_set(&BBPclockLock);
+	if (BBP_record(i).clknext == 0) {
+		if (BBPclockhand == 0) {
+			BBP_record(i).clknext = BBP_record(i).clkprev = i;
+			BBPclockhand = i;
+		} else {
+			bat p = BBP_record(BBPclockhand).clkprev;
+			BBP_record(i).clknext = BBPclockhand;
+			BBP_record(i).clkprev = p;
+			BBP_record(p).clknext = i;
+			BBP_record(BBPclockhand).clkprev = i;
+		}
+		BBP_clkuse(i) = BBP_clkprio(i);
+		BBPclocksize++;
+	}
+	MT_lock_unset(&BBPclockLock);
+}
+
+static void
+BBPclockunlink(bat i)
+{
+	MT_lock_set(&BBPclockLock);
+	if (BBP_record(i).clknext != 0) {
+		bat n = BBP_record(i).clknext;
+		bat p = BBP_record(i).clkprev;
+		if (n == i) {
+			BBPclockhand = 0;
+		} else {
+			BBP_record(p).clknext = n;
+			BBP_record(n).clkprev = p;
+			if (BBPclockhand == i)
+				BBPclockhand = n;
+		}
+		BBP_record(i).clknext = BBP_record(i).clkprev = 0;
+		BBPclocksize--;
+	}
+	MT_lock_unset(&BBPclockLock);
+}
+
+gdk_return
+BBPsetpriority(bat i, int prio)
+{
+	if (!BBPcheck(i)) {
+		GDKerror("BBPcheck failed for bat id %d\n", i);
+		return GDK_FAIL;
+	}
+	if (prio < 0 || prio > BBPPINNED) {
+		GDKerror("priority must be between 0 and %d\n", BBPPINNED);
+		return GDK_FAIL;
+	}
+	MT_lock_set(&BBPclockLock);
+	BBP_clkprio(i) = (uint8_t) prio;
+	if (BBP_clkuse(i) < BBP_clkprio(i))
+		BBP_clkuse(i) = BBP_clkprio(i);
+	MT_lock_unset(&BBPclockLock);
+	return GDK_SUCCEED;
+}
+
+void
+BBPclockstats(bat *loaded, lng *hits, lng *misses, lng *evictions, lng *sweeps, lng *budget)
+{
+	MT_lock_set(&BBPclockLock);
+	*loaded = BBPclocksize;
+	MT_lock_unset(&BBPclockLock);
+	*hits = (lng) ATOMIC_GET(&BBPhits);
+	*misses = (lng) ATOMIC_GET(&BBPmisses);
+	*evictions = (lng) ATOMIC_GET(&BBPevictions);
+	*sweeps = (lng) ATOMIC_GET(&BBPsweeps);
+	*budget = (lng) ATOMIC_GET(&BBPbudget);
+}
+
+void
+BBPsetbudget(lng budget)
+{
+	ATOMIC_SET(&BBPbudget, (ATOMIC_BASE_TYPE) (budget > 0 ? budget : 0));
+}
+
 static bool
-BBPtrim(bool aggressive, bat nbat)
+BBPoverbudget(void)
+{
+	size_t budget = (size_t) ATOMIC_GET(&BBPbudget);
+	return budget > 0 && GDKvm_cursize() > budget;
+}
+
+/* unload bat bid if nobody uses it; returns whether it was unloaded */
+static bool
+BBPtrimbat(bat bid, bool aggressive)
 {
-	int n = 0;
-	int waitctr = 0;
-	bool changed = false;
 	unsigned flag = BBPUNLOADING | BBPSYNCING | BBPSAVING;
 	if (!aggressive)
 		flag |= BBPHOT;
-	lng t0 = GDKusec();
-	for (bat bid = 1; bid < nbat && !GDKexiting(); bid++) {
-		/* don't do this during a (sub)commit */
-		BBPtmlock();
-		MT_lock_set(&GDKswapLock(bid));
-		BAT *b = NULL;
-		bool swap = false;
-		if (!(BBP_status(bid) & flag) &&
-		    BBP_refs(bid) == 0 &&
-		    BBP_lrefs(bid) != 0 &&
-		    (b = BBP_cache(bid)) != NULL) {
-			MT_lock_set(&b->theaplock);
-			if (!BATshared(b) &&
-			    !isVIEW(b) &&
-			    (!BATdirty(b) || (aggressive && b->theap->storage == STORE_MMAP && (b->tvheap == NULL || b->tvheap->storage == STORE_MMAP))) &&
-			    (b->batRole == PERSISTENT && BBP_lrefs(bid) <= 2)) {
-				BBP_status_on(bid, BBPUNLOADING);
-				swap = true;
-				waitctr += BATdirty(b) ? 9 : 1;
-			}
-			MT_lock_unset(&b->theaplock);
-		}
-		MT_lock_unset(&GDKswapLock(bid));
-		if (swap) {
-			TRC_DEBUG(BAT_, "unload and free bat %d\n", bid);
-			if (BBPfree(b) != GDK_SUCCEED)
-				GDKerror("unload failed for bat %d", bid);
-			n++;
-			changed = true;
-		}
-		BBPtmunlock();
-		/* every once in a while, give others a chance */
-		if (++waitctr >= 1000) {
-			waitctr = 0;
-			MT_sleep_ms(2);
+	/* don't do this during a (sub)commit */
+	BBPtmlock();
+	MT_lock_set(&GDKswapLock(bid));
+	BAT *b = NULL;
+	bool swap = false;
+	if (!(BBP_status(bid) & flag) &&
+	    BBP_refs(bid) == 0 &&
+	    BBP_lrefs(bid) != 0 &&
+	    (b = BBP_cache(bid)) != NULL) {
+		MT_lock_set(&b->theaplock);
+		if (!BATshared(b) &&
+		    !isVIEW(b) &&
+		    (!BATdirty(b) || (aggressive && b->theap->storage == STORE_MMAP && (b->tvheap == NULL || b->tvheap->storage == STORE_MMAP))) &&
+		    (b->batRole == PERSISTENT && BBP_lrefs(bid) <= 2)) {
+			BBP_status_on(bid, BBPUNLOADING);
+			swap = true;
 		}
+		MT_lock_unset(&b->theaplock);
+	}
+	MT_lock_unset(&GDKswapLock(bid));
+	if (swap) {
+		TRC_DEBUG(BAT_, "unload and free bat %d\n", bid);
+		if (BBPfree(b) != GDK_SUCCEED)
+			GDKerror("unload failed for bat %d", bid);
+		ATOMIC_INC(&BBPevictions);
+	}
+	BBPtmunlock();
+	return swap;
+}
+
+/* the clock hand passes bat i: a used bat gets its grace renewed,
+ * an unused one uses up one sweep of grace; returns whether the bat
+ * may be unloaded */
+static bool
+BBPsweepbat(bat i, bool aggressive)
+{
+	bool unload;
+
+	MT_lock_set(&GDKswapLock(i));
+	MT_lock_set(&BBPclockLock);
+	if (BBP_record(i).clknext == 0) {
+		/* unloaded since we passed it */
+		unload = false;
+	} else if (BBP_status(i) & BBPHOT) {
+		BBP_status_off(i, BBPHOT);
+		BBP_clkuse(i) = BBP_clkprio(i);
+		unload = aggressive;
+	} else if (BBP_clkuse(i) > 0 && !aggressive) {
+		BBP_clkuse(i)--;
+		unload = false;
+	} else {
+		unload = true;
+	}
+	MT_lock_unset(&BBPclockLock);
+	MT_lock_unset(&GDKswapLock(i));
+	return unload;
+}
+
+/* advance the clock hand once around the clock; when aggressive,
+ * unload everything that is not in use until we are within budget */
+static bool
+BBPtrim(bool aggressive)
+{
+	bat cand[256];
+	int n = 0;
+	lng t0 = GDKusec();
+
+	MT_lock_set(&BBPclockLock);
+	bat steps = BBPclocksize;
+	MT_lock_unset(&BBPclockLock);
+	ATOMIC_INC(&BBPsweeps);
+	while (steps > 0 && !GDKexiting()) {
+		int ncand = 0;
+		MT_lock_set(&BBPclockLock);
+		while (steps > 0 && ncand < (int) (sizeof(cand) / sizeof(cand[0])) && BBPclockhand != 0) {
+			bat i = BBPclockhand;
+			BBPclockhand = BBP_record(i).clknext;
+			steps--;
+			if (BBP_refs(i) > 0 || BBP_clkprio(i) == BBPPINNED)
+				continue;
+			cand[ncand++] = i;
+		}
+		if (BBPclockhand == 0)
+			steps = 0;
+		MT_lock_unset(&BBPclockLock);
+		/* the status bits are changed under GDKswapLock, which
+		 * we cannot take while holding BBPclockLock */
+		for (int i = 0; i < ncand && !GDKexiting(); i++)
+			if (BBPsweepbat(cand[i], aggressive))
+				n += BBPtrimbat(cand[i], aggressive);
+		if (aggressive && !BBPoverbudget())
+			break;
+		/* give others a chance */
+		MT_sleep_ms(2);
 	}
 	if (n > 0)
 		TRC_INFO(BAT_, "unloaded %d bats in "LLFMT" usec%s\n", n, GDKusec() - t0, aggressive ? " (also hot)" : "");
-	return changed;
+	return n > 0;
 }
 
 static void
@@ -1797,29 +1963,22 @@ BBPmanager(void *dummy)
 {
 	(void) dummy;
 	bool changed = true;
+	const char *p;
 
+	if ((p = GDKgetenv("gdk_bbp_budget")) != NULL)
+		BBPsetbudget(strtoll(p, NULL, 10));
 	for (;;) {
-		int n = 0;
-		bat nbat = (bat) ATOMIC_GET(&BBPsize);
-		MT_thread_setworking("clearing HOT bits");
-		for (bat bid = 1; bid < nbat; bid++) {
-			MT_lock_set(&GDKswapLock(bid));
-			if (BBP_refs(bid) == 0 && BBP_lrefs(bid) != 0) {
-				n += (BBP_status(bid) & BBPHOT) != 0;
-				BBP_status_off(bid, BBPHOT);
-			}
-			MT_lock_unset(&GDKswapLock(bid));
-		}
-		TRC_DEBUG(BAT_, "cleared HOT bit from %d bats\n", n);
 		size_t cur = GDKvm_cursize();
 		MT_thread_setworking("sleeping");
 		for (int i = 0, n = changed && cur > GDK_vm_maxsize / 2 ? 1 : cur > GDK_vm_maxsize / 4 ? 10 : 100; i < n; i++) {
 			MT_sleep_ms(100);
 			if (GDKexiting())
 				return;
+			if (BBPoverbudget())
+				break;
 		}
 		MT_thread_setworking("BBPtrim");
-		changed = BBPtrim(false, nbat);
+		changed = BBPtrim(BBPoverbudget());
 		MT_thread_setworking("BBPcallbacks");
 		BBPcallbacks();
 		if (GDKexiting())
@@ -2767,6 +2926,8 @@ BBPinsert(BAT *bn)
 	BBP_refs(i) = 1;	/* new bats have 1 pin */
 	BBP_lrefs(i) = 0;	/* ie. no logical refs */
 	BBP_pid(i) = pid;
+	BBP_clkuse(i) = 0;
+	BBP_clkprio(i) = 0;
 	MT_lock_unset(&GDKswapLock(i));
 
 	if (*BBP_bak(i) == 0)
@@ -2805,6 +2966,8 @@ BBPcacheit(BAT *bn, bool lock)
 	BBP_cache(i) = bn;
 
 	BBP_status_set(i, mode);
+	if (mode & BBPPERSISTENT)
+		BBPclocklink(i);
 
 	if (lock)
 		MT_lock_unset(&GDKswapLock(i));
@@ -2835,6 +2998,7 @@ BBPuncacheit(bat i, bool unloaddesc)
 				BBP_status_off(i, BBPLOADED);
 
 				BBP_cache(i) = NULL;
+				BBPclockunlink(i);
 			}
 			if (unloaddesc) {
 				BBP_desc(i) = NULL;
@@ -3365,6 +3529,8 @@ BATdescriptor(bat i)
 					 * compensate for the incref */
 					decref(i, false, false, __func__);
 				}
+			} else if (BBP_status(i) & BBPPERSISTENT) {
+				ATOMIC_INC(&BBPhits);
 			}
 		}
 		if (lock)
@@ -3410,6 +3576,7 @@ getBBPdescriptor(bat i)
 		TRC_DEBUG(IO_, "load %s\n", BBP_logical(i));
 
 		b = BATload_intern(i, false);
+		ATOMIC_INC(&BBPmisses);
 
 		/* clearing bits can be done without the lock */
 		BBP_status_off(i, BBPLOADING);
@@ -4035,6 +4202,133 @@ BBPcheckBBPdir(void)
  *
  * The BBP.dir is also moved into the BAKDIR.
  */
+/* a bat whose heaps are written during BBPsync */
+struct syncjob {
+	BATiter bi;
+	BAT *b;			/* loaded bat to save, or NULL */
+	bat i;
+	BUN size;
+};
+
+struct syncsaver {
+	struct syncjob *jobs;
+	int njobs;
+	ATOMIC_TYPE next;	/* next job to be picked up */
+	ATOMIC_TYPE failed;
+	ATOMIC_TYPE written;	/* bytes written so far */
+};
+
+/* save heaps until there are no jobs left; this runs in several
+ * threads at the same time, each picking up the next job */
+static void
+BBPsyncsaver(void *arg)
+{
+	struct syncsaver *s = arg;
+
+	for (;;) {
+		int idx = (int) ATOMIC_INC(&s->next) - 1;
+		if (idx >= s->njobs)
+			break;
+		struct syncjob *j = &s->jobs[idx];
+		if (j->b == NULL)
+			continue;
+		if (!ATOMIC_GET(&s->failed)) {
+			size_t nbytes = 0;
+			if (!j->bi.copiedtodisk || j->bi.hdirty)
+				nbytes += j->bi.hfree;
+			if (j->bi.vh && (!j->bi.copiedtodisk || j->bi.vhdirty))
+				nbytes += j->bi.vhfree;
+			if (BATsave_iter(j->b, &j->bi, j->size) != GDK_SUCCEED)
+				ATOMIC_SET(&s->failed, 1);
+			ATOMIC_ADD(&s->written, nbytes);
+		}
+		BBP_status_off(j->i, BBPSAVING);
+	}
+}
+
+#define SYNCAHEAD_CHUNK	((size_t) 1 << 20)
+
+/* Write the dirty memory mapped heaps of the persistent bats to disk
+ * at no more than gdk_checkpoint_bandwidth MiB per second.  BBPsync
+ * runs while the SQL store holds the locks that commits need, so it
+ * does not throttle itself; the caller is expected to call this
+ * function first, without those locks, so that BBPsync finds most of
+ * the data already on disk.  Heaps that are not memory mapped are
+ * small and are left to BBPsync.  For tails we start at the part that
+ * was not saved by the previous checkpoint, var-sized heaps do not
+ * record that and are synced as a whole. */
+void
+BBPsyncahead(void)
+{
+	static MT_Lock aheadlock = MT_LOCK_INITIALIZER(aheadlock);
+	const lng bandwidth = (lng) GDKgetenv_int("gdk_checkpoint_bandwidth", 0) << 20;
+
+	if (bandwidth <= 0 || GDKinmemory(0) ||
+	    (ATOMIC_GET(&GDKdebug) & NOSYNCMASK))
+		return;
+
+	MT_lock_set(&aheadlock);
+	lng t0 = GDKusec();
+	lng written = 0;
+	for (bat i = 1; i < (bat) ATOMIC_GET(&BBPsize); i++) {
+		unsigned status = BBP_status(i);
+		if (!(status & BBPPERSISTENT) ||
+		    !(status & BBPLOADED) ||
+		    (status & BBPWAITING) ||
+		    BBP_cache(i) == NULL ||
+		    !BBPfix(i))
+			continue;
+		BAT *b = BBP_desc(i);
+		for (int v = 0; v < 2; v++) {
+			size_t off = 0;
+			if (v == 0) {
+				MT_lock_set(&b->theaplock);
+				if (b->ttype != TYPE_msk)
+					off = (b->batInserted << b->tshift) & ~(GDK_mmap_pagesize - 1);
+				MT_lock_unset(&b->theaplock);
+			}
+			for (;;) {
+				/* don't hold on to the heap while sleeping */
+				BATiter bi = bat_iterator(b);
+				Heap *h = v ? bi.vh : bi.h;
+				size_t len = 0;
+				if (h != NULL &&
+				    h->storage == STORE_MMAP &&
+				    h->base != NULL &&
+				    (v ? bi.vhdirty : bi.hdirty)) {
+					size_t free = v ? bi.vhfree : bi.hfree;
+					if (off < free) {
+						len = free - off;
+						if (len > SYNCAHEAD_CHUNK)
+							len = SYNCAHEAD_CHUNK;
+						if (MT_msync(h->base + off, len) < 0) {
+							/* BBPsync will
+							 * try again */
+							GDKclrerr();
+							len = 0;
+						}
+					}
+				}
+				bat_iterator_end(&bi);
+				if (len == 0)
+					break;
+				off += len;
+				written += (lng) len;
+				/* don't get ahead of the schedule implied
+				 * by the bandwidth */
+				lng due = t0 + (lng) ((dbl) written * 1000000 / bandwidth);
+				lng now = GDKusec();
+				if (due > now)
+					MT_sleep_ms((unsigned int) ((due - now) / 1000));
+			}
+		}
+		BBPunfix(i);
+	}
+	MT_lock_unset(&aheadlock);
+	TRC_DEBUG(PERF, "synced " LLFMT " bytes ahead in " LLFMT " usec\n",
+		  written, GDKusec() - t0);
+}
+
 gdk_return
 BBPsync(int cnt, bat *restrict subcommit, BUN *restrict sizes, lng logno)
 {
@@ -4098,14 +4392,23 @@ BBPsync(int cnt, bat *restrict subcommit, BUN *restrict sizes, lng logno)
 		ret = BBPdir_first(subcommit != NULL, logno, &obbpf, &nbbpf);
 	}
 
+	struct syncjob *jobs = NULL;
+	int njobs = 0, nsave = 0;
+	if (ret == GDK_SUCCEED &&
+	    (jobs = GDKmalloc(cnt * sizeof(struct syncjob))) == NULL) {
+		ret = GDK_FAIL;
+	}
+	/* PHASE 2a: collect the heaps to be saved and mark their bats
+	 * as being saved */
 	for (int idx = 1; ret == GDK_SUCCEED && idx < cnt; idx++) {
 		bat i = subcommit ? subcommit[idx] : idx;
 		/* BBP_desc(i) may be NULL */
 		BUN size = sizes ? sizes[idx] : BUN_NONE;
 		BATiter bi;
+		BAT *b = NULL;
 
 		if (BBP_status(i) & BBPPERSISTENT) {
-			BAT *b = dirty_bat(&i, subcommit != NULL);
+			b = dirty_bat(&i, subcommit != NULL);
 			if (i <= 0) {
 				ret = GDK_FAIL;
 				break;
@@ -4147,20 +4450,64 @@ BBPsync(int cnt, bat *restrict subcommit, BUN *restrict sizes, lng logno)
 				BBP_status_on(i, BBPSAVING);
 				if (lock)
 					MT_lock_unset(&GDKswapLock(i));
-				ret = BATsave_iter(b, &bi, size);
-				BBP_status_off(i, BBPSAVING);
+				nsave++;
+			} else {
+				b = NULL;
 			}
 		} else {
 			bi = bat_iterator(NULL);
 		}
+		jobs[njobs++] = (struct syncjob) {
+			.bi = bi,
+			.b = b,
+			.i = i,
+			.size = size,
+		};
+	}
+
+	/* PHASE 2b: save the heaps, in parallel if there are enough */
+	if (njobs > 0) {
+		struct syncsaver saver = {
+			.jobs = jobs,
+			.njobs = njobs,
+			.next = ATOMIC_VAR_INIT(0),
+			.failed = ATOMIC_VAR_INIT(ret != GDK_SUCCEED),
+			.written = ATOMIC_VAR_INIT(0),
+		};
+		int nthreads = GDKgetenv_int("gdk_checkpoint_threads", GDKnr_threads);
+		MT_Id tids[16];
+		int ntids = 0;
+
+		if (nthreads > (int) (sizeof(tids) / sizeof(tids[0])))
+			nthreads = (int) (sizeof(tids) / sizeof(tids[0]));
+		if (nthreads > nsave)
+			nthreads = nsave;
+		while (ntids < nthreads - 1) {
+			char name[MT_NAME_LEN];
+			snprintf(name, sizeof(name), "bbpsync%d", ntids);
+			if (MT_create_thread(&tids[ntids], BBPsyncsaver, &saver, MT_THR_JOINABLE, name) < 0)
+				break;
+			ntids++;
+		}
+		BBPsyncsaver(&saver);
+		for (int t = 0; t < ntids; t++)
+			MT_join_thread(tids[t]);
+		if (ATOMIC_GET(&saver.failed))
+			ret = GDK_FAIL;
+		TRC_DEBUG(PERF, "saved %d bats (%zu bytes) using %d threads\n", nsave, (size_t) ATOMIC_GET(&saver.written), ntids + 1);
+	}
+
+	/* PHASE 2c: write new BBP.dir file */
+	for (int idx = 0; idx < njobs; idx++) {
 		if (ret == GDK_SUCCEED) {
-			n = BBPdir_step(i, size, n, buf, sizeof(buf), &obbpf, nbbpf, &bi);
+			n = BBPdir_step(jobs[idx].i, jobs[idx].size, n, buf, sizeof(buf), &obbpf, nbbpf, &jobs[idx].bi);
 			if (n < -1)
 				ret = GDK_FAIL;
 		}
-		bat_iterator_end(&bi);
+		bat_iterator_end(&jobs[idx].bi);
 		/* we once again have a saved heap */
 	}
+	GDKfree(jobs);
 
 	TRC_DEBUG(PERF, "write time "LLFMT" usec\n", (t0 = GDKusec()) - t1);
 
@@ -4403,6 +4750,7 @@ BBPrecover(int farmid)
 			GDKunlink(farmid, dstpath, path, "timprints");
 			GDKunlink(farmid, dstpath, path, "torderidx");
 			GDKunlink(farmid, dstpath, path, "tstrimps");
+			GDKunlink(farmid, dstpath, path, "ttrigram");
 		}
 	}
 	closedir(dirp);
@@ -4662,6 +5010,11 @@ BBPdiskscan(const char *parent, size_t baseoff)
 				delete = b == NULL;
 				if (!delete)
 					b->tstrimps = (Strimps *)1;
+			} else if (strncmp(p + 1, "ttrigram", 8) == 0) {
+				BAT *b = getdesc(bid);
+				delete = b == NULL;
+				if (!delete)
+					b->ttrigrams = (Trigrams *) 1;
 			} else if (strncmp(p + 1, "new", 3) != 0) {
 				ok = false;
 			}
@@ -4924,4 +5277,10 @@ BBPprintinfo(void)
 	printf("%d persistent bats using %zu virtual memory (%zu malloced)\n", pn, pvm, pmem);
 	printf("%d transient bats using %zu virtual memory (%zu malloced)\n", tn, tvm, tmem);
 	printf("%d bats are \"hot\" (i.e. currently or recently used)\n", nh);
+	printf("%d bats in buffer manager clock, %zu hits, %zu misses, %zu evictions in %zu sweeps\n",
+	       (int) BBPclocksize,
+	       (size_t) ATOMIC_GET(&BBPhits),
+	       (size_t) ATOMIC_GET(&BBPmisses),
+	       (size_t) ATOMIC_GET(&BBPevictions),
+	       (size_t) ATOMIC_GET(&BBPsweeps));
 }
@@ -92,6 +92,16 @@ gdk_export int BBPrelease(bat b);
 gdk_export void BBPkeepref(BAT *b)
 	__attribute__((__nonnull__(1)));
 gdk_export void BBPcold(bat i);
+
+/* buffer manager: a bat with priority p survives p clock sweeps
+ * without being used before it is unloaded; BBPPINNED keeps it
+ * loaded */
+#define BBPPINNED	255
+gdk_export gdk_return BBPsetpriority(bat i, int prio);
+gdk_export void BBPclockstats(bat *loaded, lng *hits, lng *misses, lng *evictions, lng *sweeps, lng *budget);
+/* above this many bytes of memory (0: no limit), all bats that are not
+ * in use and not pinned are unloaded; initially gdk_bbp_budget */
+gdk_export void BBPsetbudget(lng budget);
 #ifdef GDKLIBRARY_JSON
 typedef gdk_return ((*json_storage_conversion)(char **, const char **));
 gdk_export gdk_return BBPjson_upgrade(json_storage_conversion);
@@ -0,0 +1,338 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+#include "gdk_cand.h"
+
+/* ---------------------------------------------------------------------- */
+/* Bloom filters for sideways information passing in joins
+ *
+ * BATbloom summarizes the (candidate) values of the build side of an
+ * equi-join in a blocked Bloom filter plus their minimum and maximum.
+ * BATbloomselect uses that summary to select the rows of the probe
+ * side that may have a match, so that the join, and everything that
+ * is computed on its probe side before it, only deal with those.  The
+ * filter has no false negatives, so a join restricted to the selected
+ * candidates produces the same result as the unrestricted one.
+ *
+ * The filter is a bat of lng words.  Each value sets three bits in a
+ * single word, so a probe touches one cache line only.  The filter is
+ * sized at about BLOOM_BITS bits per value, which gives a false
+ * positive rate of a few percent.  Nil values never match in an
+ * equi-join without nil_matches, so they are not entered and never
+ * selected.  Only integer types are supported: their values are equal
+ * if and only if their bit patterns are. */
+
+#define BLOOM_BITS	8	/* filter bits per value */
+#define BLOOM_SAMPLE	4096	/* probes before judging the filter */
+
+static inline ulng
+bloom_hash(ulng v)
+{
+	/* the splitmix64 finalizer, all bits depend on all bits */
+	v ^= v >> 30;
+	v *= (ulng) LL_CONSTANT(0xbf58476d1ce4e5b9);
+	v ^= v >> 27;
+	v *= (ulng) LL_CONSTANT(0x94d049bb133111eb);
+	v ^= v >> 31;
+	return v;
+}
+
+static inline ulng
+bloom_mask(ulng h)
+{
+	return ((ulng) 1 << (h & 63)) |
+		((ulng) 1 << ((h >> 6) & 63)) |
+		((ulng) 1 << ((h >> 12) & 63));
+}
+
+#define BLOOM_KEY(v)	((ulng) (lng) (v))
+#ifdef HAVE_HGE
+#define BLOOM_KEYhge(v)	((ulng) (v) ^ (ulng) ((v) >> 64))
+#endif
+
+static bool
+bloom_type(int tpe)
+{
+	switch (ATOMbasetype(tpe)) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+#ifdef HAVE_HGE
+	case TYPE_hge:
+#endif
+		return true;
+	default:
+		return false;
+	}
+}
+
+#define BLOOM_BUILD(TYPE, KEY)						\
+	do {								\
+		const TYPE *restrict vals = (const TYPE *) bi.base;	\
+		TYPE mn = TYPE##_nil, mx = TYPE##_nil;			\
+		TIMEOUT_LOOP(ci.ncand, qry_ctx) {			\
+			TYPE v = vals[canditer_next(&ci) - b->hseqbase]; \
+			if (is_##TYPE##_nil(v))				\
+				continue;				\
+			if (is_##TYPE##_nil(mn) || v < mn)		\
+				mn = v;					\
+			if (is_##TYPE##_nil(mx) || v > mx)		\
+				mx = v;					\
+			ulng h = bloom_hash(KEY(v));			\
+			words[(h >> 32) & mask] |= bloom_mask(h);	\
+		}							\
+		TIMEOUT_CHECK(qry_ctx,					\
+			      GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx)); \
+		*(TYPE *) min = mn;					\
+		*(TYPE *) max = mx;					\
+	} while (0)
+
+/* Build a filter for the values of b selected by candidate list s.
+ * The smallest and largest value are stored in min and max, which
+ * must have room for a value of b's type; they are nil if there are
+ * no non-nil values.  Returns a bat of type lng. */
+BAT *
+BATbloom(BAT *b, BAT *s, void *min, void *max)
+{
+	struct canditer ci;
+	BUN nwords = 1;
+	BAT *bn;
+	ulng *words, mask;
+	lng t0 = 0;
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+
+	BATcheck(b, NULL);
+	if (!bloom_type(b->ttype) || BATtvoid(b)) {
+		GDKerror("type %s not supported.\n", ATOMname(b->ttype));
+		return NULL;
+	}
+	canditer_init(&ci, b, s);
+	while (nwords * 64 < ci.ncand * BLOOM_BITS && nwords < ((BUN) 1 << 32))
+		nwords <<= 1;
+	bn = COLnew(0, TYPE_lng, nwords, TRANSIENT);
+	if (bn == NULL)
+		return NULL;
+	words = (ulng *) Tloc(bn, 0);
+	memset(words, 0, nwords * sizeof(ulng));
+	mask = nwords - 1;
+
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};
+
+	BATiter bi = bat_iterator(b);
+	switch (ATOMbasetype(bi.type)) {
+	case TYPE_bte:
+		BLOOM_BUILD(bte, BLOOM_KEY);
+		break;
+	case TYPE_sht:
+		BLOOM_BUILD(sht, BLOOM_KEY);
+		break;
+	case TYPE_int:
+		BLOOM_BUILD(int, BLOOM_KEY);
+		break;
+	case TYPE_lng:
+		BLOOM_BUILD(lng, BLOOM_KEY);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		BLOOM_BUILD(hge, BLOOM_KEYhge);
+		break;
+#endif
+	default:
+		MT_UNREACHABLE();
+	}
+	bat_iterator_end(&bi);
+
+	BATsetcount(bn, nwords);
+	bn->tsorted = bn->trevsorted = nwords <= 1;
+	bn->tkey = nwords <= 1;
+	bn->tnil = false;
+	bn->tnonil = false;	/* a word may well look like lng_nil */
+
+	TRC_DEBUG(ALGO, "b=" ALGOBATFMT ",s=" ALGOOPTBATFMT
+		  " -> " ALGOBATFMT " (" LLFMT " usec)\n",
+		  ALGOBATPAR(b), ALGOOPTBATPAR(s),
+		  ALGOBATPAR(bn), GDKusec() - t0);
+	return bn;
+
+  bailout:
+	bat_iterator_end(&bi);
+	BBPreclaim(bn);
+	return NULL;
+}
+
+#define BLOOM_PROBE(TYPE, KEY)						\
+	do {								\
+		const TYPE *restrict vals = (const TYPE *) bi.base;	\
+		const TYPE mn = *(const TYPE *) min;			\
+		const TYPE mx = *(const TYPE *) max;			\
+		TIMEOUT_LOOP_IDX_DECL(i, ci.ncand, qry_ctx) {		\
+			if (i == BLOOM_SAMPLE && cnt * 4 > i * 3) {	\
+				useless = true;				\
+				TIMEOUT_LOOP_BREAK;			\
+			}						\
+			oid o = canditer_next(&ci);			\
+			TYPE v = vals[o - b->hseqbase];			\
+			if (is_##TYPE##_nil(v) || v < mn || v > mx)	\
+				continue;				\
+			ulng h = bloom_hash(KEY(v));			\
+			ulng m = bloom_mask(h);				\
+			if ((words[(h >> 32) & mask] & m) == m)		\
+				dst[cnt++] = o;				\
+		}							\
+		TIMEOUT_CHECK(qry_ctx,					\
+			      GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx)); \
+	} while (0)
+
+/* Whether the join will rather use a hash table on b: b, or the bat
+ * it is a view of, already has one, or b is persistent, in which case
+ * the join considers creating one free (see joincost).  A view of all
+ * of a bat counts as that bat, as in BATjoin.  The join then probes
+ * the other side into that hash, which is cheaper than filtering b
+ * first. */
+static bool
+bloom_hashed(BAT *b)
+{
+	bat parent;
+	BAT *pb = NULL;
+	bool hashed;
+
+	if (BATcheckhash(b))
+		return true;
+	if ((parent = VIEWtparent(b)) != 0) {
+		if ((pb = BATdescriptor(parent)) == NULL)
+			return false;
+		if (BATcheckhash(pb)) {
+			BBPunfix(pb->batCacheid);
+			return true;
+		}
+		if (b->hseqbase == pb->hseqbase && BATcount(b) == BATcount(pb))
+			b = pb;
+	}
+#ifdef PERSISTENTHASH
+	MT_lock_set(&b->theaplock);
+	hashed = b->batRole == PERSISTENT && !GDKinmemory(b->theap->farmid);
+	MT_lock_unset(&b->theaplock);
+#else
+	hashed = false;
+#endif
+	BBPreclaim(pb);
+	return hashed;
+}
+
+/* Select the candidates of b (restricted by s) whose value may be
+ * present in the filter f built by BATbloom with bounds min and max.
+ * If the first BLOOM_SAMPLE probes show that the filter lets almost
+ * everything through, probing stops and all candidates are returned,
+ * since that is cheaper than continuing.  The same happens right away
+ * if b is sorted or has a hash table. */
+BAT *
+BATbloomselect(BAT *b, BAT *s, BAT *f, const void *min, const void *max)
+{
+	struct canditer ci;
+	BAT *bn;
+	BUN cnt = 0;
+	oid *restrict dst;
+	const ulng *words;
+	ulng mask;
+	bool useless = false;
+	lng t0 = 0;
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+
+	BATcheck(b, NULL);
+	BATcheck(f, NULL);
+	if (!bloom_type(b->ttype) || BATtvoid(b) || f->ttype != TYPE_lng) {
+		GDKerror("type %s not supported.\n", ATOMname(b->ttype));
+		return NULL;
+	}
+	canditer_init(&ci, b, s);
+	if (ci.ncand == 0 || BATcount(f) == 0 ||
+	    ATOMcmp(b->ttype, min, ATOMnilptr(b->ttype)) == 0)
+		return BATdense(0, 0, 0);
+	/* a sorted or hashed column lets the join find matches without
+	 * looking at every row; don't take that away */
+	if (b->tsorted || b->trevsorted || bloom_hashed(b)) {
+		TRC_DEBUG(ALGO, "b=" ALGOBATFMT ",s=" ALGOOPTBATFMT
+			  " -> all candidates (sorted or hashed)\n",
+			  ALGOBATPAR(b), ALGOOPTBATPAR(s));
+		return canditer_slice(&ci, 0, ci.ncand);
+	}
+	/* the filter is a power of two words */
+	assert((BATcount(f) & (BATcount(f) - 1)) == 0);
+	bn = COLnew(0, TYPE_oid, ci.ncand, TRANSIENT);
+	if (bn == NULL)
+		return NULL;
+	dst = (oid *) Tloc(bn, 0);
+	mask = BATcount(f) - 1;
+
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};
+
+	BATiter fi = bat_iterator(f);
+	BATiter bi = bat_iterator(b);
+	words = (const ulng *) fi.base;
+	switch (ATOMbasetype(bi.type)) {
+	case TYPE_bte:
+		BLOOM_PROBE(bte, BLOOM_KEY);
+		break;
+	case TYPE_sht:
+		BLOOM_PROBE(sht, BLOOM_KEY);
+		break;
+	case TYPE_int:
+		BLOOM_PROBE(int, BLOOM_KEY);
+		break;
+	case TYPE_lng:
+		BLOOM_PROBE(lng, BLOOM_KEY);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		BLOOM_PROBE(hge, BLOOM_KEYhge);
+		break;
+#endif
+	default:
+		MT_UNREACHABLE();
+	}
+	bat_iterator_end(&bi);
+	bat_iterator_end(&fi);
+
+	if (useless) {
+		BBPreclaim(bn);
+		bn = canditer_slice(&ci, 0, ci.ncand);
+	} else {
+		BATsetcount(bn, cnt);
+		bn->tsorted = true;
+		bn->trevsorted = cnt <= 1;
+		bn->tkey = true;
+		bn->tnil = false;
+		bn->tnonil = true;
+		bn = virtualize(bn);
+	}
+
+	TRC_DEBUG(ALGO, "b=" ALGOBATFMT ",s=" ALGOOPTBATFMT
+		  ",f=" ALGOBATFMT " -> " ALGOOPTBATFMT "%s (" LLFMT " usec)\n",
+		  ALGOBATPAR(b), ALGOOPTBATPAR(s), ALGOBATPAR(f),
+		  ALGOOPTBATPAR(bn), useless ? " (filter not selective)" : "",
+		  GDKusec() - t0);
+	return bn;
+
+  bailout:
+	bat_iterator_end(&bi);
+	bat_iterator_end(&fi);
+	BBPreclaim(bn);
+	return NULL;
+}
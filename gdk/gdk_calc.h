@@ -93,6 +93,7 @@ gdk_export BAT *BATcalcifthenelse(BAT *b, BAT *b1, BAT *b2);
 gdk_export BAT *BATcalcifthenelsecst(BAT *b, BAT *b1, const ValRecord *c2);
 gdk_export BAT *BATcalcifthencstelse(BAT *b, const ValRecord *c1, BAT *b2);
 gdk_export BAT *BATcalcifthencstelsecst(BAT *b, const ValRecord *c1, const ValRecord *c2);
+gdk_export BAT *BATcalcexpr(const char *expr, BAT *const *bats, const ValRecord *vals, int nargs, int tp);
 
 gdk_export gdk_return VARcalcnot(ValPtr ret, const ValRecord *v);
 gdk_export gdk_return VARcalcnegate(ValPtr ret, const ValRecord *v);
@@ -136,6 +137,10 @@ gdk_export BAT *BATgroupmedian(BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool skip
 gdk_export BAT *BATgroupquantile(BAT *b, BAT *g, BAT *e, BAT *s, int tp, double quantile, bool skip_nils);
 gdk_export BAT *BATgroupmedian_avg(BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool skip_nils);
 gdk_export BAT *BATgroupquantile_avg(BAT *b, BAT *g, BAT *e, BAT *s, int tp, double quantile, bool skip_nils);
+gdk_export BAT *BATgroupapprox_count_distinct(BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool skip_nils);
+gdk_export BAT *BATgrouphll(BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool skip_nils);
+gdk_export BAT *BATgrouphllmerge(BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool skip_nils);
+gdk_export gdk_return HLLestimate(lng *res, const blob *sketch);
 
 /* helper function for grouped aggregates */
 gdk_export const char *BATgroupaggrinit(
@@ -314,6 +314,22 @@ ADD_3TYPE(dbl, hge, dbl, F)
 ADD_3TYPE(dbl, flt, dbl, F)
 ADD_3TYPE(dbl, dbl, dbl, F)
 
+NONIL_3TYPE(add, int, int, int, ADDI_WITH_CHECK)
+NONIL_3TYPE(add, int, int, lng, ADD_NOCHECK)
+NONIL_3TYPE(add, int, lng, lng, ADDI_WITH_CHECK)
+NONIL_3TYPE(add, lng, int, lng, ADDI_WITH_CHECK)
+NONIL_3TYPE(add, lng, lng, lng, ADDI_WITH_CHECK)
+#ifdef HAVE_HGE
+NONIL_3TYPE(add, int, hge, hge, ADDI_WITH_CHECK)
+NONIL_3TYPE(add, hge, int, hge, ADDI_WITH_CHECK)
+NONIL_3TYPE(add, lng, lng, hge, ADD_NOCHECK)
+NONIL_3TYPE(add, lng, hge, hge, ADDI_WITH_CHECK)
+NONIL_3TYPE(add, hge, lng, hge, ADDI_WITH_CHECK)
+NONIL_3TYPE(add, hge, hge, hge, ADDI_WITH_CHECK)
+#endif
+
+NONIL_TYPESWITCH(add)
+
 static BUN
 add_typeswitchloop(const void *lft, int tp1, bool incr1,
 		   const void *rgt, int tp2, bool incr2,
@@ -1509,6 +1525,12 @@ BATcalcadd(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp)
 	BATiter b2i = bat_iterator(b2);
 	if (b1i.type == TYPE_str && b2i.type == TYPE_str && tp == TYPE_str) {
 		nils = addstr_loop(b1, NULL, b2, NULL, bn, &b1i, &b2i, &ci1, &ci2);
+	} else if (b1i.nonil && b2i.nonil &&
+	    ci1.tpe == cand_dense && ci2.tpe == cand_dense &&
+	    add_nonil(b1i.base, ci1.seq - b1->hseqbase, b1i.type, true,
+		      b2i.base, ci2.seq - b2->hseqbase, b2i.type, true,
+		      Tloc(bn, 0), tp, ci1.ncand)) {
+		nils = 0;
 	} else {
 		nils = add_typeswitchloop(b1i.base, b1i.type, true,
 					  b2i.base, b2i.type, true,
@@ -1571,6 +1593,11 @@ BATcalcaddcst(BAT *b, const ValRecord *v, BAT *s, int tp)
 	BATiter bi = bat_iterator(b);
 	if (bi.type == TYPE_str && v->vtype == TYPE_str && tp == TYPE_str) {
 		nils = addstr_loop(b, NULL, NULL, v->val.sval, bn, &bi, &(BATiter){0}, &ci, &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand});
+	} else if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    add_nonil(bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      VALptr(v), 0, v->vtype, false,
+		      Tloc(bn, 0), tp, ci.ncand)) {
+		nils = 0;
 	} else {
 		nils = add_typeswitchloop(bi.base, bi.type, true,
 					  VALptr(v), v->vtype, false,
@@ -1630,6 +1657,11 @@ BATcalccstadd(const ValRecord *v, BAT *b, BAT *s, int tp)
 	BATiter bi = bat_iterator(b);
 	if (bi.type == TYPE_str && v->vtype == TYPE_str && tp == TYPE_str) {
 		nils = addstr_loop(NULL, v->val.sval, b, NULL, bn, &(BATiter){0}, &bi, &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand}, &ci);
+	} else if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    add_nonil(VALptr(v), 0, v->vtype, false,
+		      bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      Tloc(bn, 0), tp, ci.ncand)) {
+		nils = 0;
 	} else {
 		nils = add_typeswitchloop(VALptr(v), v->vtype, false,
 					  bi.base, bi.type, true,
@@ -2058,6 +2090,22 @@ SUB_3TYPE(dbl, hge, dbl, F)
 SUB_3TYPE(dbl, flt, dbl, F)
 SUB_3TYPE(dbl, dbl, dbl, F)
 
+NONIL_3TYPE(sub, int, int, int, SUBI_WITH_CHECK)
+NONIL_3TYPE(sub, int, int, lng, SUB_NOCHECK)
+NONIL_3TYPE(sub, int, lng, lng, SUBI_WITH_CHECK)
+NONIL_3TYPE(sub, lng, int, lng, SUBI_WITH_CHECK)
+NONIL_3TYPE(sub, lng, lng, lng, SUBI_WITH_CHECK)
+#ifdef HAVE_HGE
+NONIL_3TYPE(sub, int, hge, hge, SUBI_WITH_CHECK)
+NONIL_3TYPE(sub, hge, int, hge, SUBI_WITH_CHECK)
+NONIL_3TYPE(sub, lng, lng, hge, SUB_NOCHECK)
+NONIL_3TYPE(sub, lng, hge, hge, SUBI_WITH_CHECK)
+NONIL_3TYPE(sub, hge, lng, hge, SUBI_WITH_CHECK)
+NONIL_3TYPE(sub, hge, hge, hge, SUBI_WITH_CHECK)
+#endif
+
+NONIL_TYPESWITCH(sub)
+
 static BUN
 sub_typeswitchloop(const void *lft, int tp1, bool incr1,
 		   const void *rgt, int tp2, bool incr2,
@@ -3193,11 +3241,18 @@ BATcalcsub(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp)
 
 	BATiter b1i = bat_iterator(b1);
 	BATiter b2i = bat_iterator(b2);
-	nils = sub_typeswitchloop(b1i.base, b1i.type, true,
-				  b2i.base, b2i.type, true,
-				  Tloc(bn, 0), tp,
-				  &ci1, &ci2,
-				  b1->hseqbase, b2->hseqbase, __func__);
+	if (b1i.nonil && b2i.nonil &&
+	    ci1.tpe == cand_dense && ci2.tpe == cand_dense &&
+	    sub_nonil(b1i.base, ci1.seq - b1->hseqbase, b1i.type, true,
+		      b2i.base, ci2.seq - b2->hseqbase, b2i.type, true,
+		      Tloc(bn, 0), tp, ci1.ncand))
+		nils = 0;
+	else
+		nils = sub_typeswitchloop(b1i.base, b1i.type, true,
+					  b2i.base, b2i.type, true,
+					  Tloc(bn, 0), tp,
+					  &ci1, &ci2,
+					  b1->hseqbase, b2->hseqbase, __func__);
 	bat_iterator_end(&b1i);
 	bat_iterator_end(&b2i);
 
@@ -3245,12 +3300,18 @@ BATcalcsubcst(BAT *b, const ValRecord *v, BAT *s, int tp)
 		return bn;
 
 	BATiter bi = bat_iterator(b);
-	nils = sub_typeswitchloop(bi.base, bi.type, true,
-				  VALptr(v), v->vtype, false,
-				  Tloc(bn, 0), tp,
-				  &ci,
-				  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
-				  b->hseqbase, 0, __func__);
+	if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    sub_nonil(bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      VALptr(v), 0, v->vtype, false,
+		      Tloc(bn, 0), tp, ci.ncand))
+		nils = 0;
+	else
+		nils = sub_typeswitchloop(bi.base, bi.type, true,
+					  VALptr(v), v->vtype, false,
+					  Tloc(bn, 0), tp,
+					  &ci,
+					  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
+					  b->hseqbase, 0, __func__);
 
 	if (nils == BUN_NONE) {
 		bat_iterator_end(&bi);
@@ -3300,12 +3361,18 @@ BATcalccstsub(const ValRecord *v, BAT *b, BAT *s, int tp)
 		return bn;
 
 	BATiter bi = bat_iterator(b);
-	nils = sub_typeswitchloop(VALptr(v), v->vtype, false,
-				  bi.base, bi.type, true,
-				  Tloc(bn, 0), tp,
-				  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
-				  &ci,
-				  0, b->hseqbase, __func__);
+	if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    sub_nonil(VALptr(v), 0, v->vtype, false,
+		      bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      Tloc(bn, 0), tp, ci.ncand))
+		nils = 0;
+	else
+		nils = sub_typeswitchloop(VALptr(v), v->vtype, false,
+					  bi.base, bi.type, true,
+					  Tloc(bn, 0), tp,
+					  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
+					  &ci,
+					  0, b->hseqbase, __func__);
 
 	if (nils == BUN_NONE) {
 		bat_iterator_end(&bi);
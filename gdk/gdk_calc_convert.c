@@ -668,6 +668,111 @@ convertimpl_msk(hge)
 convertimpl_msk(flt)
 convertimpl_msk(dbl)
 
+/* Nil-free conversion between integer types to the same or a larger
+ * scale, which is how decimals are brought to a common scale before
+ * they are added, subtracted or divided.  As for the arithmetic (see
+ * NONIL_3TYPE), the range checks of a block of values are merged and
+ * only looked at once per block; on failure the caller redoes the
+ * conversion with the checking loop, which reports the value. */
+#define convertimpl_nonil(TYPE1, TYPE2)					\
+static bool								\
+convert_nonil_##TYPE1##_##TYPE2(const TYPE1 *restrict src,		\
+				TYPE2 *restrict dst, BUN ncand,		\
+				uint8_t scale1, uint8_t scale2,		\
+				uint8_t precision)			\
+{									\
+	const BUN nblocks = (ncand + NONIL_BLOCK - 1) / NONIL_BLOCK;	\
+	const TYPE2 mul = (TYPE2) scales[scale2 - scale1];		\
+	const TYPE2 prec = (TYPE2) scales[precision] / mul;		\
+	TYPE2 min = GDK_##TYPE2##_min / mul;				\
+	TYPE2 max = GDK_##TYPE2##_max / mul;				\
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();			\
+	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};		\
+									\
+	if (precision) {						\
+		/* values must be strictly between -prec and prec */	\
+		if (min < 1 - prec)					\
+			min = 1 - prec;					\
+		if (max > prec - 1)					\
+			max = prec - 1;					\
+	}								\
+	TIMEOUT_LOOP_IDX_DECL(b, nblocks, qry_ctx) {			\
+		const BUN lo = b * NONIL_BLOCK;				\
+		const BUN hi = MIN(ncand, lo + NONIL_BLOCK);		\
+		bool ovf = false;					\
+		for (BUN k = lo; k < hi; k++) {				\
+			const TYPE1 v = src[k];				\
+			ovf |= v < min || v > max;			\
+			/* unsigned, values out of range must not trap */ \
+			dst[k] = (TYPE2) ((u##TYPE2) (TYPE2) v * (u##TYPE2) mul); \
+		}							\
+		if (ovf)						\
+			return false;					\
+	}								\
+	TIMEOUT_CHECK(qry_ctx, return false);				\
+	return true;							\
+}
+
+convertimpl_nonil(int, int)
+convertimpl_nonil(int, lng)
+convertimpl_nonil(lng, lng)
+#ifdef HAVE_HGE
+convertimpl_nonil(int, hge)
+convertimpl_nonil(lng, hge)
+convertimpl_nonil(hge, hge)
+#endif
+
+static bool
+convert_nonil(const void *src, BUN off, int stp, void *restrict dst, int dtp,
+	      BUN ncand, uint8_t scale1, uint8_t scale2, uint8_t precision)
+{
+	if (scale1 > scale2)
+		return false;
+	switch (stp) {
+	case TYPE_int:
+		switch (dtp) {
+		case TYPE_int:
+			return convert_nonil_int_int((const int *) src + off, dst,
+						     ncand, scale1, scale2,
+						     precision);
+		case TYPE_lng:
+			return convert_nonil_int_lng((const int *) src + off, dst,
+						     ncand, scale1, scale2,
+						     precision);
+#ifdef HAVE_HGE
+		case TYPE_hge:
+			return convert_nonil_int_hge((const int *) src + off, dst,
+						     ncand, scale1, scale2,
+						     precision);
+#endif
+		}
+		break;
+	case TYPE_lng:
+		switch (dtp) {
+		case TYPE_lng:
+			return convert_nonil_lng_lng((const lng *) src + off, dst,
+						     ncand, scale1, scale2,
+						     precision);
+#ifdef HAVE_HGE
+		case TYPE_hge:
+			return convert_nonil_lng_hge((const lng *) src + off, dst,
+						     ncand, scale1, scale2,
+						     precision);
+#endif
+		}
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		if (dtp == TYPE_hge)
+			return convert_nonil_hge_hge((const hge *) src + off, dst,
+						     ncand, scale1, scale2,
+						     precision);
+		break;
+#endif
+	}
+	return false;
+}
+
 static BUN
 convert_any_str(BATiter *bi, BAT *bn, struct canditer *restrict ci)
 {
@@ -1512,6 +1617,11 @@ BATconvert(BAT *b, BAT *s, int tp,
 		   ATOMstorage(tp) == TYPE_msk) {
 		if (BATappend(bn, b, s, false) != GDK_SUCCEED)
 			nils = BUN_NONE + 2;
+	} else if (bi.nonil && ci.tpe == cand_dense &&
+		   convert_nonil(bi.base, ci.seq - b->hseqbase, bi.type,
+				 Tloc(bn, 0), tp, ci.ncand,
+				 scale1, scale2, precision)) {
+		nils = 0;
 	} else {
 		nils = convert_typeswitchloop(bi.base, bi.type,
 					      Tloc(bn, 0), tp,
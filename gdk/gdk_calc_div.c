@@ -468,6 +468,32 @@ DIV_3TYPE(dbl, hge, dbl)
 DIV_3TYPE_float(dbl, flt, dbl)
 DIV_3TYPE_float(dbl, dbl, dbl)
 
+/* a zero divisor counts as an overflow (the checking loop reports it);
+ * the divisor is then replaced by 1 so that the division is always
+ * safe to do */
+#define DIV_NONIL_CHECK(lft, rgt, TYPE3, dst, max, on_overflow)	\
+	do {								\
+		if ((rgt) == 0)						\
+			on_overflow;					\
+		(dst) = (TYPE3) ((lft) / ((rgt) + ((rgt) == 0)));	\
+	} while (0)
+
+NONIL_3TYPE(div, int, int, int, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, int, int, lng, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, int, lng, lng, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, lng, int, lng, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, lng, lng, lng, DIV_NONIL_CHECK)
+#ifdef HAVE_HGE
+NONIL_3TYPE(div, int, hge, hge, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, hge, int, hge, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, lng, lng, hge, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, lng, hge, hge, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, hge, lng, hge, DIV_NONIL_CHECK)
+NONIL_3TYPE(div, hge, hge, hge, DIV_NONIL_CHECK)
+#endif
+
+NONIL_TYPESWITCH(div)
+
 static BUN
 div_typeswitchloop(const void *lft, int tp1, bool incr1,
 		   const void *rgt, int tp2, bool incr2,
@@ -1948,7 +1974,7 @@ BAT *
 BATcalcdiv(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp)
 {
 	return BATcalcmuldivmod(b1, b2, s1, s2, tp,
-				div_typeswitchloop, __func__);
+				div_typeswitchloop, div_nonil, __func__);
 }
 
 BAT *
@@ -1972,12 +1998,18 @@ BATcalcdivcst(BAT *b, const ValRecord *v, BAT *s, int tp)
 		return bn;
 
 	BATiter bi = bat_iterator(b);
-	nils = div_typeswitchloop(bi.base, bi.type, true,
-				  VALptr(v), v->vtype, false,
-				  Tloc(bn, 0), tp,
-				  &ci,
-				  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
-				  b->hseqbase, 0, __func__);
+	if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    div_nonil(bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      VALptr(v), 0, v->vtype, false,
+		      Tloc(bn, 0), tp, ci.ncand))
+		nils = 0;
+	else
+		nils = div_typeswitchloop(bi.base, bi.type, true,
+					  VALptr(v), v->vtype, false,
+					  Tloc(bn, 0), tp,
+					  &ci,
+					  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
+					  b->hseqbase, 0, __func__);
 
 	if (nils >= BUN_NONE) {
 		BBPunfix(bn->batCacheid);
@@ -2036,12 +2068,18 @@ BATcalccstdiv(const ValRecord *v, BAT *b, BAT *s, int tp)
 		return NULL;
 
 	BATiter bi = bat_iterator(b);
-	nils = div_typeswitchloop(VALptr(v), v->vtype, false,
-				  bi.base, bi.type, true,
-				  Tloc(bn, 0), tp,
-				  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
-				  &ci,
-				  0, b->hseqbase, __func__);
+	if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    div_nonil(VALptr(v), 0, v->vtype, false,
+		      bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      Tloc(bn, 0), tp, ci.ncand))
+		nils = 0;
+	else
+		nils = div_typeswitchloop(VALptr(v), v->vtype, false,
+					  bi.base, bi.type, true,
+					  Tloc(bn, 0), tp,
+					  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
+					  &ci,
+					  0, b->hseqbase, __func__);
 	bat_iterator_end(&bi);
 
 	if (nils >= BUN_NONE) {
@@ -0,0 +1,697 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+#include "gdk_calc_private.h"
+
+/* ---------------------------------------------------------------------- */
+/* fused evaluation of arithmetic and comparison expressions
+ *
+ * BATcalcexpr evaluates a tree of arithmetic, comparison and
+ * conversion operators over fixed width numeric columns in one pass.
+ * The expression is given in postfix notation, the tokens separated
+ * by semicolons:
+ *	$N	push operand N, a column if bats[N] is set, else vals[N]
+ *	+:T -:T *:T /:T
+ *		arithmetic producing type T
+ *	< <= > >= == !=
+ *		comparison producing bit
+ *	conv:T	conversion to type T
+ * The operators are evaluated on vectors of EXPR_VECTOR values, so
+ * the intermediates stay in the CPU cache and no column sized
+ * temporaries are created.  Each operator is a loop specialized for
+ * one type, and computes the same results, nils and errors as the
+ * corresponding BATcalc function.  To keep it that way, only
+ * conversions that do not change values are supported: integer
+ * operands of arithmetic may be narrower than the result, floating
+ * point arithmetic and division require operands of the result type,
+ * and comparisons require operands of the same type. */
+
+#define EXPR_VECTOR	1024
+#define EXPR_MAXSTEPS	64
+#define EXPR_REGSIZE	(EXPR_VECTOR * 2 * sizeof(lng)) /* room for hge */
+
+enum exprop {
+	EXPR_ARG,
+	EXPR_ADD,
+	EXPR_SUB,
+	EXPR_MUL,
+	EXPR_DIV,
+	EXPR_LT,
+	EXPR_LE,
+	EXPR_GT,
+	EXPR_GE,
+	EXPR_EQ,
+	EXPR_NE,
+	EXPR_CONV,
+};
+
+struct exprstep {
+	enum exprop op;
+	int tpe;		/* result type */
+	int arg;		/* operand of EXPR_ARG */
+};
+
+struct exprreg {
+	int tpe;
+	bool scalar;		/* a single value for all rows */
+	const void *val;	/* the values of the current vector */
+	void *buf;		/* owned buffer of EXPR_VECTOR values */
+};
+
+#define EXPR_OVERFLOW(TYPE, OP)						\
+	do {								\
+		GDKerror("22003!overflow in calculation "		\
+			 FMT##TYPE OP FMT##TYPE ".\n",			\
+			 CST##TYPE l, CST##TYPE r);			\
+		return BUN_NONE;					\
+	} while (0)
+
+#define EXPR_BINARY(TYPE, NAME, OP, CHECK)				\
+static BUN								\
+expr_##NAME##_##TYPE(const TYPE *lft, size_t li,			\
+		     const TYPE *rgt, size_t ri,			\
+		     TYPE *restrict dst, BUN n)				\
+{									\
+	BUN nils = 0;							\
+									\
+	for (BUN k = 0; k < n; k++) {					\
+		TYPE l = lft[k * li], r = rgt[k * ri];			\
+		if (is_##TYPE##_nil(l) || is_##TYPE##_nil(r)) {	\
+			dst[k] = TYPE##_nil;				\
+			nils++;						\
+		} else {						\
+			CHECK(l, r, TYPE, dst[k], GDK_##TYPE##_max,	\
+			      EXPR_OVERFLOW(TYPE, OP));			\
+		}							\
+	}								\
+	return nils;							\
+}
+
+#define EXPR_COMPARE(TYPE, NAME, OP)					\
+static BUN								\
+expr_##NAME##_##TYPE(const TYPE *lft, size_t li,			\
+		     const TYPE *rgt, size_t ri,			\
+		     bit *restrict dst, BUN n)				\
+{									\
+	BUN nils = 0;							\
+									\
+	for (BUN k = 0; k < n; k++) {					\
+		TYPE l = lft[k * li], r = rgt[k * ri];			\
+		if (is_##TYPE##_nil(l) || is_##TYPE##_nil(r)) {	\
+			dst[k] = bit_nil;				\
+			nils++;						\
+		} else {						\
+			dst[k] = (bit) (l OP r);			\
+		}							\
+	}								\
+	return nils;							\
+}
+
+#define EXPR_CONVERT(TYPE1, TYPE2)					\
+static BUN								\
+expr_conv_##TYPE1##_##TYPE2(const TYPE1 *src, TYPE2 *restrict dst, BUN n) \
+{									\
+	BUN nils = 0;							\
+									\
+	for (BUN k = 0; k < n; k++) {					\
+		if (is_##TYPE1##_nil(src[k])) {				\
+			dst[k] = TYPE2##_nil;				\
+			nils++;						\
+		} else {						\
+			dst[k] = (TYPE2) src[k];			\
+		}							\
+	}								\
+	return nils;							\
+}
+
+/* same checks as the BATcalc kernels */
+#define EXPR_MUL_bte(l, r, T, d, m, o)	MULI4_WITH_CHECK(l, r, T, d, m, sht, o)
+#define EXPR_MUL_sht(l, r, T, d, m, o)	MULI4_WITH_CHECK(l, r, T, d, m, int, o)
+#define EXPR_MUL_int(l, r, T, d, m, o)	MULI4_WITH_CHECK(l, r, T, d, m, lng, o)
+#define EXPR_MUL_lng(l, r, T, d, m, o)	LNGMUL_CHECK(l, r, d, m, o)
+#ifdef HAVE_HGE
+#define EXPR_MUL_hge(l, r, T, d, m, o)	HGEMUL_CHECK(l, r, d, m, o)
+#endif
+#define EXPR_MUL_F(l, r, T, d, m, o)					\
+	do {								\
+		/* only check for overflow, not for underflow */	\
+		(d) = (T) ((l) * (r));					\
+		if (isinf(d) || ABSOLUTE(d) > (m))			\
+			o;						\
+	} while (0)
+#define EXPR_DIV_I(l, r, T, d, m, o)					\
+	do {								\
+		if ((r) == 0) {						\
+			GDKerror("22012!division by zero.\n");		\
+			return BUN_NONE;				\
+		}							\
+		(d) = (T) ((l) / (r));					\
+		if ((d) < -(m) || (d) > (m))				\
+			o;						\
+	} while (0)
+#define EXPR_DIV_F(l, r, T, d, m, o)					\
+	do {								\
+		if ((r) == 0) {						\
+			GDKerror("22012!division by zero.\n");		\
+			return BUN_NONE;				\
+		}							\
+		/* only check for overflow, not for underflow */	\
+		if (ABSOLUTE(r) < 1 && (m) * ABSOLUTE(r) < ABSOLUTE(l)) \
+			o;						\
+		(d) = (T) (l) / (r);					\
+		if ((d) < -(m) || (d) > (m))				\
+			o;						\
+	} while (0)
+
+#define EXPR_INTEGER(TYPE)						\
+	EXPR_BINARY(TYPE, add, "+", ADDI_WITH_CHECK)			\
+	EXPR_BINARY(TYPE, sub, "-", SUBI_WITH_CHECK)			\
+	EXPR_BINARY(TYPE, mul, "*", EXPR_MUL_##TYPE)			\
+	EXPR_BINARY(TYPE, div, "/", EXPR_DIV_I)				\
+	EXPR_COMPARE(TYPE, lt, <)					\
+	EXPR_COMPARE(TYPE, le, <=)					\
+	EXPR_COMPARE(TYPE, gt, >)					\
+	EXPR_COMPARE(TYPE, ge, >=)					\
+	EXPR_COMPARE(TYPE, eq, ==)					\
+	EXPR_COMPARE(TYPE, ne, !=)
+
+#define EXPR_FLOAT(TYPE)						\
+	EXPR_BINARY(TYPE, add, "+", ADDF_WITH_CHECK)			\
+	EXPR_BINARY(TYPE, sub, "-", SUBF_WITH_CHECK)			\
+	EXPR_BINARY(TYPE, mul, "*", EXPR_MUL_F)				\
+	EXPR_BINARY(TYPE, div, "/", EXPR_DIV_F)				\
+	EXPR_COMPARE(TYPE, lt, <)					\
+	EXPR_COMPARE(TYPE, le, <=)					\
+	EXPR_COMPARE(TYPE, gt, >)					\
+	EXPR_COMPARE(TYPE, ge, >=)					\
+	EXPR_COMPARE(TYPE, eq, ==)					\
+	EXPR_COMPARE(TYPE, ne, !=)
+
+EXPR_INTEGER(bte)
+EXPR_INTEGER(sht)
+EXPR_INTEGER(int)
+EXPR_INTEGER(lng)
+#ifdef HAVE_HGE
+EXPR_INTEGER(hge)
+#endif
+EXPR_FLOAT(flt)
+EXPR_FLOAT(dbl)
+
+EXPR_CONVERT(bte, sht)
+EXPR_CONVERT(bte, int)
+EXPR_CONVERT(bte, lng)
+EXPR_CONVERT(bte, flt)
+EXPR_CONVERT(bte, dbl)
+EXPR_CONVERT(sht, int)
+EXPR_CONVERT(sht, lng)
+EXPR_CONVERT(sht, flt)
+EXPR_CONVERT(sht, dbl)
+EXPR_CONVERT(int, lng)
+EXPR_CONVERT(int, flt)
+EXPR_CONVERT(int, dbl)
+EXPR_CONVERT(lng, flt)
+EXPR_CONVERT(lng, dbl)
+#ifdef HAVE_HGE
+EXPR_CONVERT(bte, hge)
+EXPR_CONVERT(sht, hge)
+EXPR_CONVERT(int, hge)
+EXPR_CONVERT(lng, hge)
+EXPR_CONVERT(hge, flt)
+EXPR_CONVERT(hge, dbl)
+#endif
+EXPR_CONVERT(flt, dbl)
+
+static inline bool
+expr_integer(int tp)
+{
+	switch (tp) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+#ifdef HAVE_HGE
+	case TYPE_hge:
+#endif
+		return true;
+	default:
+		return false;
+	}
+}
+
+static inline bool
+expr_numeric(int tp)
+{
+	return expr_integer(tp) || tp == TYPE_flt || tp == TYPE_dbl;
+}
+
+/* can values of type tp1 be converted to tp2 without changing them
+ * (other than the rounding of integers to floating point) */
+static inline bool
+expr_widens(int tp1, int tp2)
+{
+	if (tp1 == tp2)
+		return expr_numeric(tp1);
+	if (expr_integer(tp1))
+		return (expr_integer(tp2) && ATOMsize(tp1) < ATOMsize(tp2))
+			|| tp2 == TYPE_flt || tp2 == TYPE_dbl;
+	return tp1 == TYPE_flt && tp2 == TYPE_dbl;
+}
+
+#define EXPR_CONV_CASE(TYPE1, TYPE2)					\
+	case TYPE_##TYPE2:						\
+		return expr_conv_##TYPE1##_##TYPE2(src, dst, n)
+
+static BUN
+expr_convert(const void *src, int tp1, void *restrict dst, int tp2, BUN n)
+{
+	switch (tp1) {
+	case TYPE_bte:
+		switch (tp2) {
+		EXPR_CONV_CASE(bte, sht);
+		EXPR_CONV_CASE(bte, int);
+		EXPR_CONV_CASE(bte, lng);
+#ifdef HAVE_HGE
+		EXPR_CONV_CASE(bte, hge);
+#endif
+		EXPR_CONV_CASE(bte, flt);
+		EXPR_CONV_CASE(bte, dbl);
+		}
+		break;
+	case TYPE_sht:
+		switch (tp2) {
+		EXPR_CONV_CASE(sht, int);
+		EXPR_CONV_CASE(sht, lng);
+#ifdef HAVE_HGE
+		EXPR_CONV_CASE(sht, hge);
+#endif
+		EXPR_CONV_CASE(sht, flt);
+		EXPR_CONV_CASE(sht, dbl);
+		}
+		break;
+	case TYPE_int:
+		switch (tp2) {
+		EXPR_CONV_CASE(int, lng);
+#ifdef HAVE_HGE
+		EXPR_CONV_CASE(int, hge);
+#endif
+		EXPR_CONV_CASE(int, flt);
+		EXPR_CONV_CASE(int, dbl);
+		}
+		break;
+	case TYPE_lng:
+		switch (tp2) {
+#ifdef HAVE_HGE
+		EXPR_CONV_CASE(lng, hge);
+#endif
+		EXPR_CONV_CASE(lng, flt);
+		EXPR_CONV_CASE(lng, dbl);
+		}
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		switch (tp2) {
+		EXPR_CONV_CASE(hge, flt);
+		EXPR_CONV_CASE(hge, dbl);
+		}
+		break;
+#endif
+	case TYPE_flt:
+		switch (tp2) {
+		EXPR_CONV_CASE(flt, dbl);
+		}
+		break;
+	}
+	GDKerror("type combination (convert(%s)->%s) not supported.\n",
+		 ATOMname(tp1), ATOMname(tp2));
+	return BUN_NONE;
+}
+
+#define EXPR_OP_CASES(TYPE)						\
+	case TYPE_##TYPE:						\
+		switch (op) {						\
+		case EXPR_ADD:						\
+			return expr_add_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_SUB:						\
+			return expr_sub_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_MUL:						\
+			return expr_mul_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_DIV:						\
+			return expr_div_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_LT:						\
+			return expr_lt_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_LE:						\
+			return expr_le_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_GT:						\
+			return expr_gt_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_GE:						\
+			return expr_ge_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_EQ:						\
+			return expr_eq_##TYPE(lft, li, rgt, ri, dst, n); \
+		case EXPR_NE:						\
+			return expr_ne_##TYPE(lft, li, rgt, ri, dst, n); \
+		default:						\
+			break;						\
+		}							\
+		break
+
+/* apply binary operator op to operands of type tp */
+static BUN
+expr_operator(enum exprop op, int tp,
+	      const void *lft, size_t li, const void *rgt, size_t ri,
+	      void *restrict dst, BUN n)
+{
+	switch (tp) {
+	EXPR_OP_CASES(bte);
+	EXPR_OP_CASES(sht);
+	EXPR_OP_CASES(int);
+	EXPR_OP_CASES(lng);
+#ifdef HAVE_HGE
+	EXPR_OP_CASES(hge);
+#endif
+	EXPR_OP_CASES(flt);
+	EXPR_OP_CASES(dbl);
+	}
+	GDKerror("type %s not supported.\n", ATOMname(tp));
+	return BUN_NONE;
+}
+
+/* bring register r to type tp, using *scratch as the new buffer */
+static BUN
+expr_coerce(struct exprreg *r, int tp, BUN n, void **scratch)
+{
+	void *buf;
+	BUN nils;
+
+	if (r->tpe == tp)
+		return 0;
+	nils = expr_convert(r->val, r->tpe, *scratch, tp, r->scalar ? 1 : n);
+	if (nils == BUN_NONE)
+		return nils;
+	buf = r->buf;
+	r->buf = *scratch;
+	*scratch = buf;
+	r->val = r->buf;
+	r->tpe = tp;
+	return nils;
+}
+
+/* parse and type check the expression */
+static int
+expr_parse(const char *expr, struct exprstep *steps, int *depth,
+	   BAT *const *bats, const ValRecord *vals, int nargs)
+{
+	int types[EXPR_MAXSTEPS];
+	int nsteps = 0, sp = 0;
+	const char *p = expr;
+
+	*depth = 0;
+	while (*p) {
+		struct exprstep *s = &steps[nsteps];
+		size_t len = strcspn(p, ";:");
+		bool binary = true;
+
+		if (nsteps == EXPR_MAXSTEPS) {
+			GDKerror("expression too long.\n");
+			return -1;
+		}
+		s->tpe = TYPE_bit;
+		s->arg = -1;
+		if (*p == '$') {
+			char *e;
+			long a = strtol(p + 1, &e, 10);
+			if (e == p + 1 || a < 0 || a >= nargs
+			    || (size_t) (e - p) != len) {
+				GDKerror("illegal operand in expression.\n");
+				return -1;
+			}
+			s->op = EXPR_ARG;
+			s->arg = (int) a;
+			s->tpe = bats[a] ? ATOMtype(bats[a]->ttype) : vals[a].vtype;
+			if (!expr_numeric(s->tpe)) {
+				GDKerror("type %s not supported.\n",
+					 ATOMname(s->tpe));
+				return -1;
+			}
+			binary = false;
+		} else if (len == 1 && *p == '+')
+			s->op = EXPR_ADD;
+		else if (len == 1 && *p == '-')
+			s->op = EXPR_SUB;
+		else if (len == 1 && *p == '*')
+			s->op = EXPR_MUL;
+		else if (len == 1 && *p == '/')
+			s->op = EXPR_DIV;
+		else if (len == 1 && *p == '<')
+			s->op = EXPR_LT;
+		else if (len == 2 && strncmp(p, "<=", 2) == 0)
+			s->op = EXPR_LE;
+		else if (len == 1 && *p == '>')
+			s->op = EXPR_GT;
+		else if (len == 2 && strncmp(p, ">=", 2) == 0)
+			s->op = EXPR_GE;
+		else if (len == 2 && strncmp(p, "==", 2) == 0)
+			s->op = EXPR_EQ;
+		else if (len == 2 && strncmp(p, "!=", 2) == 0)
+			s->op = EXPR_NE;
+		else if (len == 4 && strncmp(p, "conv", 4) == 0) {
+			s->op = EXPR_CONV;
+			binary = false;
+		} else {
+			GDKerror("unknown operator in expression.\n");
+			return -1;
+		}
+		p += len;
+		if (s->op == EXPR_CONV
+		    || (s->op >= EXPR_ADD && s->op <= EXPR_DIV)) {
+			char name[16];
+			if (*p != ':'
+			    || (len = strcspn(++p, ";")) >= sizeof(name)) {
+				GDKerror("missing type in expression.\n");
+				return -1;
+			}
+			strcpy_len(name, p, len + 1);
+			s->tpe = ATOMindex(name);
+			p += len;
+			if (!expr_numeric(s->tpe)) {
+				GDKerror("type %s not supported.\n", name);
+				return -1;
+			}
+		}
+		if (*p == ';')
+			p++;
+		else if (*p) {
+			GDKerror("syntax error in expression.\n");
+			return -1;
+		}
+
+		/* check the operand types */
+		if (s->op == EXPR_ARG) {
+			types[sp++] = s->tpe;
+			if (sp > *depth)
+				*depth = sp;
+		} else if (!binary) {
+			if (sp < 1 || types[sp - 1] == s->tpe
+			    || !expr_widens(types[sp - 1], s->tpe))
+				goto unsupported;
+			types[sp - 1] = s->tpe;
+		} else {
+			int tp1, tp2;
+			if (sp < 2)
+				goto unsupported;
+			tp1 = types[sp - 2];
+			tp2 = types[sp - 1];
+			if (s->op >= EXPR_LT) {
+				if (tp1 != tp2)
+					goto unsupported;
+			} else if (!expr_integer(s->tpe) || s->op == EXPR_DIV) {
+				if (tp1 != s->tpe || tp2 != s->tpe)
+					goto unsupported;
+			} else if (!expr_integer(tp1) || !expr_integer(tp2)
+				   || !expr_widens(tp1, s->tpe)
+				   || !expr_widens(tp2, s->tpe)) {
+				goto unsupported;
+			}
+			types[--sp - 1] = s->tpe;
+		}
+		nsteps++;
+	}
+	if (sp != 1 || nsteps == 0 || steps[nsteps - 1].op == EXPR_ARG) {
+		GDKerror("malformed expression.\n");
+		return -1;
+	}
+	return nsteps;
+
+  unsupported:
+	GDKerror("type combination not supported in expression.\n");
+	return -1;
+}
+
+BAT *
+BATcalcexpr(const char *expr, BAT *const *bats, const ValRecord *vals,
+	    int nargs, int tp)
+{
+	lng t0 = 0;
+	struct exprstep steps[EXPR_MAXSTEPS];
+	struct exprreg *regs = NULL;
+	BATiter *bis = NULL;
+	BAT *bn = NULL, *b = NULL;
+	char *mem = NULL;
+	void *scratch;
+	int nsteps, depth, i;
+	BUN ncand, nils = 0, lo, width;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+
+	for (i = 0; i < nargs; i++) {
+		if (bats[i] == NULL)
+			continue;
+		if (b == NULL)
+			b = bats[i];
+		else if (BATcount(bats[i]) != BATcount(b)
+			 || bats[i]->hseqbase != b->hseqbase) {
+			GDKerror("inputs not the same size.\n");
+			return NULL;
+		}
+	}
+	if (b == NULL) {
+		GDKerror("at least one column required.\n");
+		return NULL;
+	}
+	if ((nsteps = expr_parse(expr, steps, &depth, bats, vals, nargs)) < 0)
+		return NULL;
+	if (ATOMtype(tp) != steps[nsteps - 1].tpe) {
+		GDKerror("expression does not produce type %s.\n", ATOMname(tp));
+		return NULL;
+	}
+
+	ncand = BATcount(b);
+	bn = COLnew(b->hseqbase, tp, ncand, TRANSIENT);
+	if (bn == NULL)
+		return NULL;
+	if (ncand == 0)
+		return bn;
+
+	width = (BUN) ATOMsize(tp);
+	regs = GDKzalloc(depth * sizeof(struct exprreg));
+	bis = GDKzalloc(nargs * sizeof(BATiter));
+	/* one buffer per register plus one to convert into */
+	mem = GDKmalloc((depth + 1) * EXPR_REGSIZE);
+	if (regs == NULL || bis == NULL || mem == NULL)
+		goto bailout;
+	for (i = 0; i < depth; i++)
+		regs[i].buf = mem + i * EXPR_REGSIZE;
+	scratch = mem + depth * EXPR_REGSIZE;
+	for (i = 0; i < nargs; i++)
+		if (bats[i])
+			bis[i] = bat_iterator(bats[i]);
+
+	for (lo = 0; lo < ncand; lo += EXPR_VECTOR) {
+		BUN n = ncand - lo < EXPR_VECTOR ? ncand - lo : EXPR_VECTOR;
+		struct exprreg *r = NULL;
+		int sp = 0;
+
+		if (TIMEOUT_TEST(qry_ctx)) {
+			TIMEOUT_ERROR(qry_ctx, __FILE__, __func__, __LINE__);
+			goto bailout1;
+		}
+		for (i = 0; i < nsteps; i++) {
+			const struct exprstep *s = &steps[i];
+			struct exprreg *l;
+			BUN m;
+
+			switch (s->op) {
+			case EXPR_ARG:
+				r = &regs[sp++];
+				r->tpe = s->tpe;
+				if (bats[s->arg]) {
+					r->scalar = false;
+					r->val = (const char *) bis[s->arg].base + lo * bis[s->arg].width;
+				} else {
+					r->scalar = true;
+					r->val = VALptr(&vals[s->arg]);
+				}
+				continue;
+			case EXPR_CONV:
+				r = &regs[sp - 1];
+				nils = expr_coerce(r, s->tpe, n, &scratch);
+				m = r->scalar ? 1 : n;
+				break;
+			default:
+				l = &regs[sp - 2];
+				r = &regs[sp - 1];
+				if (s->op < EXPR_LT
+				    && (expr_coerce(l, s->tpe, n, &scratch) == BUN_NONE
+					|| expr_coerce(r, s->tpe, n, &scratch) == BUN_NONE))
+					goto bailout1;
+				m = l->scalar && r->scalar ? 1 : n;
+				nils = expr_operator(s->op, l->tpe,
+						     l->val, !l->scalar,
+						     r->val, !r->scalar,
+						     scratch, m);
+				if (nils == BUN_NONE)
+					goto bailout1;
+				l->scalar &= r->scalar;
+				r = l;
+				r->val = scratch;
+				scratch = r->buf;
+				r->buf = (void *) r->val;
+				r->tpe = s->tpe;
+				sp--;
+				break;
+			}
+			if (nils == BUN_NONE)
+				goto bailout1;
+		}
+		/* nils now counts the nils of the last operator */
+		assert(sp == 1 && r == &regs[0]);
+		if (r->scalar) {
+			for (BUN k = 0; k < n; k++)
+				memcpy(Tloc(bn, lo + k), r->val, width);
+		} else {
+			memcpy(Tloc(bn, lo), r->val, n * width);
+		}
+		if (nils != 0)
+			bn->tnil = true;
+	}
+	for (i = 0; i < nargs; i++)
+		if (bats[i])
+			bat_iterator_end(&bis[i]);
+
+	BATsetcount(bn, ncand);
+	bn->tnonil = !bn->tnil;
+	bn->tsorted = bn->trevsorted = ncand <= 1;
+	bn->tkey = ncand <= 1;
+	GDKfree(regs);
+	GDKfree(bis);
+	GDKfree(mem);
+
+	TRC_DEBUG(ALGO, "expr=%s,b=" ALGOBATFMT
+		  " -> " ALGOOPTBATFMT " " LLFMT "usec\n",
+		  expr, ALGOBATPAR(b), ALGOOPTBATPAR(bn), GDKusec() - t0);
+
+	return bn;
+
+  bailout1:
+	for (i = 0; i < nargs; i++)
+		if (bats[i])
+			bat_iterator_end(&bis[i]);
+  bailout:
+	GDKfree(regs);
+	GDKfree(bis);
+	GDKfree(mem);
+	BBPreclaim(bn);
+	return NULL;
+}
@@ -1181,7 +1181,7 @@ BAT *
 BATcalcmod(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp)
 {
 	return BATcalcmuldivmod(b1, b2, s1, s2, tp,
-				mod_typeswitchloop, __func__);
+				mod_typeswitchloop, NULL, __func__);
 }
 
 BAT *
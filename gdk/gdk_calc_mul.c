@@ -597,6 +597,31 @@ MUL_2TYPE_float(dbl, hge, dbl)
 MUL_2TYPE_float(dbl, flt, dbl)
 MUL_2TYPE_float(dbl, dbl, dbl)
 
+/* multiplication with the overflow checks of MUL_4TYPE and
+ * MUL_2TYPE_lng/MUL_2TYPE_hge */
+#define MULINT_CHECK(lft, rgt, TYPE3, dst, max, on_overflow)		\
+	MULI4_WITH_CHECK(lft, rgt, TYPE3, dst, max, lng, on_overflow)
+#define MULLNG_CHECK(lft, rgt, TYPE3, dst, max, on_overflow)		\
+	LNGMUL_CHECK(lft, rgt, dst, max, on_overflow)
+#define MULHGE_CHECK(lft, rgt, TYPE3, dst, max, on_overflow)		\
+	HGEMUL_CHECK(lft, rgt, dst, max, on_overflow)
+
+NONIL_3TYPE(mul, int, int, int, MULINT_CHECK)
+NONIL_3TYPE(mul, int, int, lng, MUL_NOCHECK)
+NONIL_3TYPE(mul, int, lng, lng, MULLNG_CHECK)
+NONIL_3TYPE(mul, lng, int, lng, MULLNG_CHECK)
+NONIL_3TYPE(mul, lng, lng, lng, MULLNG_CHECK)
+#ifdef HAVE_HGE
+NONIL_3TYPE(mul, int, hge, hge, MULHGE_CHECK)
+NONIL_3TYPE(mul, hge, int, hge, MULHGE_CHECK)
+NONIL_3TYPE(mul, lng, lng, hge, MUL_NOCHECK)
+NONIL_3TYPE(mul, lng, hge, hge, MULHGE_CHECK)
+NONIL_3TYPE(mul, hge, lng, hge, MULHGE_CHECK)
+NONIL_3TYPE(mul, hge, hge, hge, MULHGE_CHECK)
+#endif
+
+NONIL_TYPESWITCH(mul)
+
 static BUN
 mul_typeswitchloop(const void *lft, int tp1, bool incr1,
 		   const void *rgt, int tp2, bool incr2,
@@ -2030,6 +2055,9 @@ BATcalcmuldivmod(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp,
 				       struct canditer *restrict,
 				       struct canditer *restrict,
 				       oid, oid, const char *),
+		 bool (*noniloop)(const void *, BUN, int, bool,
+				  const void *, BUN, int, bool,
+				  void *restrict, int, BUN),
 		 const char *func)
 {
 	lng t0 = 0;
@@ -2057,10 +2085,17 @@ BATcalcmuldivmod(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp,
 
 	BATiter b1i = bat_iterator(b1);
 	BATiter b2i = bat_iterator(b2);
-	nils = (*typeswitchloop)(b1i.base, b1i.type, true,
-				 b2i.base, b2i.type, true,
-				 Tloc(bn, 0), tp,
-				 &ci1, &ci2, b1->hseqbase, b2->hseqbase, func);
+	if (noniloop && b1i.nonil && b2i.nonil &&
+	    ci1.tpe == cand_dense && ci2.tpe == cand_dense &&
+	    (*noniloop)(b1i.base, ci1.seq - b1->hseqbase, b1i.type, true,
+			b2i.base, ci2.seq - b2->hseqbase, b2i.type, true,
+			Tloc(bn, 0), tp, ci1.ncand))
+		nils = 0;
+	else
+		nils = (*typeswitchloop)(b1i.base, b1i.type, true,
+					 b2i.base, b2i.type, true,
+					 Tloc(bn, 0), tp,
+					 &ci1, &ci2, b1->hseqbase, b2->hseqbase, func);
 	bat_iterator_end(&b1i);
 	bat_iterator_end(&b2i);
 
@@ -2091,7 +2126,7 @@ BAT *
 BATcalcmul(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp)
 {
 	return BATcalcmuldivmod(b1, b2, s1, s2, tp,
-				mul_typeswitchloop, __func__);
+				mul_typeswitchloop, mul_nonil, __func__);
 }
 
 BAT *
@@ -2115,12 +2150,18 @@ BATcalcmulcst(BAT *b, const ValRecord *v, BAT *s, int tp)
 		return bn;
 
 	BATiter bi = bat_iterator(b);
-	nils = mul_typeswitchloop(bi.base, bi.type, true,
-				  VALptr(v), v->vtype, false,
-				  Tloc(bn, 0), tp,
-				  &ci,
-				  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
-				  b->hseqbase, 0, __func__);
+	if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    mul_nonil(bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      VALptr(v), 0, v->vtype, false,
+		      Tloc(bn, 0), tp, ci.ncand))
+		nils = 0;
+	else
+		nils = mul_typeswitchloop(bi.base, bi.type, true,
+					  VALptr(v), v->vtype, false,
+					  Tloc(bn, 0), tp,
+					  &ci,
+					  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
+					  b->hseqbase, 0, __func__);
 
 	if (nils == BUN_NONE) {
 		BBPunfix(bn->batCacheid);
@@ -2176,12 +2217,18 @@ BATcalccstmul(const ValRecord *v, BAT *b, BAT *s, int tp)
 		return bn;
 
 	BATiter bi = bat_iterator(b);
-	nils = mul_typeswitchloop(VALptr(v), v->vtype, false,
-				  bi.base, bi.type, true,
-				  Tloc(bn, 0), tp,
-				  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
-				  &ci,
-				  0, b->hseqbase, __func__);
+	if (bi.nonil && ci.tpe == cand_dense && !VALisnil(v) &&
+	    mul_nonil(VALptr(v), 0, v->vtype, false,
+		      bi.base, ci.seq - b->hseqbase, bi.type, true,
+		      Tloc(bn, 0), tp, ci.ncand))
+		nils = 0;
+	else
+		nils = mul_typeswitchloop(VALptr(v), v->vtype, false,
+					  bi.base, bi.type, true,
+					  Tloc(bn, 0), tp,
+					  &(struct canditer){.tpe=cand_dense, .ncand=ci.ncand},
+					  &ci,
+					  0, b->hseqbase, __func__);
 
 	if (nils == BUN_NONE) {
 		BBPunfix(bn->batCacheid);
@@ -229,6 +229,105 @@
 #endif	/* HAVE___BUILTIN_ADD_OVERFLOW */
 #endif	/* HAVE_HGE */
 
+/* Nil-free arithmetic.  When none of the inputs can be nil (tnonil)
+ * and there are no candidate lists, the functions generated below are
+ * used instead of the loops that look at every value for nil and
+ * overflow.  The overflow checks of a block of NONIL_BLOCK values are
+ * merged into a single flag that is only tested at the end of the
+ * block, so that the loop over a block has no data dependent branches
+ * and can be vectorized by the compiler.  The functions return false
+ * on overflow (or timeout), after which the caller redoes the
+ * calculation with the checking loop, which reports the values that
+ * overflowed.  The CHECK macros have the same signature as the
+ * *_WITH_CHECK macros above; the _NOCHECK ones are for result types
+ * that are large enough for any result. */
+#define NONIL_BLOCK	1024
+
+#define ADD_NOCHECK(lft, rgt, TYPE3, dst, max, on_overflow)	\
+	((dst) = (TYPE3) (lft) + (rgt))
+#define SUB_NOCHECK(lft, rgt, TYPE3, dst, max, on_overflow)	\
+	((dst) = (TYPE3) (lft) - (rgt))
+#define MUL_NOCHECK(lft, rgt, TYPE3, dst, max, on_overflow)	\
+	((dst) = (TYPE3) (lft) * (rgt))
+
+#define NONIL_3TYPE(NAME, TYPE1, TYPE2, TYPE3, CHECK)			\
+static bool								\
+NAME##_nonil_##TYPE1##_##TYPE2##_##TYPE3(const TYPE1 *restrict lft, bool incr1, \
+					 const TYPE2 *restrict rgt, bool incr2, \
+					 TYPE3 *restrict dst, TYPE3 max, \
+					 BUN ncand)			\
+{									\
+	const BUN nblocks = (ncand + NONIL_BLOCK - 1) / NONIL_BLOCK;	\
+	const TYPE1 l = *lft;						\
+	const TYPE2 r = *rgt;						\
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();			\
+	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};		\
+									\
+	(void) max;							\
+	TIMEOUT_LOOP_IDX_DECL(b, nblocks, qry_ctx) {			\
+		const BUN lo = b * NONIL_BLOCK;				\
+		const BUN hi = MIN(ncand, lo + NONIL_BLOCK);		\
+		bool ovf = false;					\
+		if (incr1 && incr2) {					\
+			for (BUN k = lo; k < hi; k++)			\
+				CHECK(lft[k], rgt[k], TYPE3, dst[k],	\
+				      max, ovf = true);			\
+		} else if (incr1) {					\
+			for (BUN k = lo; k < hi; k++)			\
+				CHECK(lft[k], r, TYPE3, dst[k],		\
+				      max, ovf = true);			\
+		} else {						\
+			for (BUN k = lo; k < hi; k++)			\
+				CHECK(l, rgt[k], TYPE3, dst[k],		\
+				      max, ovf = true);			\
+		}							\
+		if (ovf)						\
+			return false;					\
+	}								\
+	TIMEOUT_CHECK(qry_ctx, return false);				\
+	return true;							\
+}
+
+/* Generate the function that chooses one of the above for the types
+ * of the operands and the result; the values of the operands start at
+ * index off1 and off2 respectively. */
+#define NONIL_CASE(NAME, TYPE1, TYPE2, TYPE3)				\
+	if (tp1 == TYPE_##TYPE1 && tp2 == TYPE_##TYPE2 && tp == TYPE_##TYPE3) \
+		return NAME##_nonil_##TYPE1##_##TYPE2##_##TYPE3(	\
+			(const TYPE1 *) lft + off1, incr1,		\
+			(const TYPE2 *) rgt + off2, incr2,		\
+			dst, GDK_##TYPE3##_max, ncand)
+
+#ifdef HAVE_HGE
+#define NONIL_CASES_hge(NAME)						\
+	NONIL_CASE(NAME, int, hge, hge);				\
+	NONIL_CASE(NAME, hge, int, hge);				\
+	NONIL_CASE(NAME, lng, lng, hge);				\
+	NONIL_CASE(NAME, lng, hge, hge);				\
+	NONIL_CASE(NAME, hge, lng, hge);				\
+	NONIL_CASE(NAME, hge, hge, hge)
+#else
+#define NONIL_CASES_hge(NAME)
+#endif
+
+#define NONIL_TYPESWITCH(NAME)						\
+static bool								\
+NAME##_nonil(const void *lft, BUN off1, int tp1, bool incr1,		\
+	     const void *rgt, BUN off2, int tp2, bool incr2,		\
+	     void *restrict dst, int tp, BUN ncand)			\
+{									\
+	tp1 = ATOMbasetype(tp1);					\
+	tp2 = ATOMbasetype(tp2);					\
+	tp = ATOMbasetype(tp);						\
+	NONIL_CASE(NAME, int, int, int);				\
+	NONIL_CASE(NAME, int, int, lng);				\
+	NONIL_CASE(NAME, int, lng, lng);				\
+	NONIL_CASE(NAME, lng, int, lng);				\
+	NONIL_CASE(NAME, lng, lng, lng);				\
+	NONIL_CASES_hge(NAME);						\
+	return false;							\
+}
+
 #define AVERAGE_ITER(TYPE, x, a, r, n)					\
 	do {								\
 		TYPE an, xn, z1;					\
@@ -654,4 +753,7 @@ BATcalcmuldivmod(BAT *b1, BAT *b2, BAT *s1, BAT *s2, int tp,
 				       struct canditer *restrict,
 				       struct canditer *restrict,
 				       oid, oid, const char *),
+		 bool (*noniloop)(const void *, BUN, int, bool,
+				  const void *, BUN, int, bool,
+				  void *restrict, int, BUN),
 		 const char *func);
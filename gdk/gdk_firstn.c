@@ -1329,3 +1329,167 @@ BATfirstn(BAT **topn, BAT **gids, BAT *b, BAT *s, BAT *g, BUN n, bool asc, bool
 	bat_iterator_end(&bi);
 	return rc;
 }
+
+/* BATfirstnbound computes BATfirstn without candidates or groups on
+ * each of the nb pieces b[0..nb) of a column, after which the results
+ * are combined.  The pieces are done by a number of threads that
+ * share the value that the pieces done so far have proven to be good
+ * enough: each piece that finds n values stores the "last" one of them
+ * if it is better than the one there is, since no value worse than it
+ * can be in the first n of the whole column.  The pieces that come
+ * after skip those values before doing their own work using
+ * BATthetaselect, so that ordered pieces and imprints skip them a block
+ * at a time.  Values equal to the bound are kept, so the combined
+ * results still contain the first n.  The bound is never nil, so when
+ * nils come first, it is only used on pieces without nils. */
+#define FIRSTN_MAXTHREADS	64
+
+struct firstnjob {
+	BAT **b, **topn;
+	int nb;
+	BUN n;
+	bool asc, nilslast;
+	MT_Lock lock;			/* protects bound and have */
+	bool have;
+	ValRecord bound;
+};
+
+static BAT *
+firstnbound_piece(struct firstnjob *job, BAT *b)
+{
+	lng t0 = 0;
+	int tpe = b->ttype;
+	ValRecord v;
+	bool have, tightened = false;
+	BAT *c = NULL, *bn;
+	oid last = oid_nil;
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+
+	MT_lock_set(&job->lock);
+	have = job->have;
+	v = job->bound;
+	MT_lock_unset(&job->lock);
+
+	if (have && (job->nilslast || b->tnonil)) {
+		c = BATthetaselect(b, NULL, &v.val, job->asc ? "<=" : ">=");
+		if (c == NULL)
+			return NULL;
+	}
+
+	(void) BATordered(b);
+	(void) BATordered_rev(b);
+	BATiter bi = bat_iterator(b);
+	if (job->n == 0 || bi.count == 0 || (c && BATcount(c) == 0))
+		bn = BATdense(0, 0, 0);
+	else
+		bn = BATfirstn_unique(&bi, c, job->n, job->asc, job->nilslast, &last, t0);
+	if (bn != NULL && !is_oid_nil(last)) {
+		const void *lv = BUNtloc(bi, last - b->hseqbase);
+		int r;
+
+		if (ATOMcmp(tpe, lv, ATOMnilptr(tpe)) != 0) {
+			MT_lock_set(&job->lock);
+			if (!job->have ||
+			    ((r = ATOMcmp(tpe, lv, &job->bound.val)) != 0 &&
+			     (r < 0) == job->asc)) {
+				memcpy(&job->bound.val, lv, ATOMsize(tpe));
+				job->have = true;
+				tightened = true;
+			}
+			MT_lock_unset(&job->lock);
+		}
+	}
+	bat_iterator_end(&bi);
+	TRC_DEBUG(ALGO, "b=" ALGOBATFMT ",n=" BUNFMT
+		  ",bound=%s -> " ALGOOPTBATFMT " (%s" LLFMT " usec)\n",
+		  ALGOBATPAR(b), job->n,
+		  c ? "used" : "none", ALGOOPTBATPAR(bn),
+		  tightened ? "tightened -- " : "", GDKusec() - t0);
+	BBPreclaim(c);
+	return bn;
+}
+
+static gdk_return
+firstnbound_worker(void *arg, int t, BUN i)
+{
+	struct firstnjob *job = arg;
+
+	(void) t;
+	/* the result BATs belong to the calling thread, so the result
+	 * of the piece is copied into one of them */
+	BAT *bn = firstnbound_piece(job, job->b[i]), *r = job->topn[i];
+	if (bn == NULL)
+		return GDK_FAIL;
+	oid *restrict o = Tloc(r, 0);
+	BUN cnt = BATcount(bn);
+	assert(cnt <= BATcapacity(r));
+	for (BUN j = 0; j < cnt; j++)
+		o[j] = BUNtoid(bn, j);
+	BATsetcount(r, cnt);
+	r->tsorted = bn->tsorted;
+	r->trevsorted = bn->trevsorted;
+	r->tkey = bn->tkey;
+	r->tnil = false;
+	r->tnonil = true;
+	BBPreclaim(bn);
+	return GDK_SUCCEED;
+}
+
+gdk_return
+BATfirstnbound(BAT **topn, BAT **b, int nb, BUN n, bool asc, bool nilslast)
+{
+	struct firstnjob *job;
+	int nthreads = MIN(GDKnr_threads, nb);
+	int tpe = nb > 0 ? b[0]->ttype : TYPE_void;
+	gdk_return res;
+
+	for (int i = 0; i < nb; i++) {
+		topn[i] = NULL;
+		if (b[i]->ttype != tpe)
+			tpe = TYPE_void;
+	}
+	if (tpe == TYPE_void || tpe == TYPE_msk || ATOMvarsized(tpe) ||
+	    (job = GDKmalloc(sizeof(struct firstnjob))) == NULL) {
+		/* without a bound */
+		for (int i = 0; i < nb; i++) {
+			if (BATfirstn(&topn[i], NULL, b[i], NULL, NULL, n, asc, nilslast, false) != GDK_SUCCEED) {
+				while (--i >= 0)
+					BBPreclaim(topn[i]);
+				return GDK_FAIL;
+			}
+		}
+		return GDK_SUCCEED;
+	}
+	for (int i = 0; i < nb; i++) {
+		if ((topn[i] = COLnew(0, TYPE_oid, MIN(n, BATcount(b[i])), TRANSIENT)) == NULL) {
+			while (--i >= 0)
+				BBPreclaim(topn[i]);
+			GDKfree(job);
+			return GDK_FAIL;
+		}
+	}
+	*job = (struct firstnjob) {
+		.b = b,
+		.topn = topn,
+		.nb = nb,
+		.n = n,
+		.asc = asc,
+		.nilslast = nilslast,
+	};
+	MT_lock_init(&job->lock, "firstnbound");
+
+	if (nthreads > FIRSTN_MAXTHREADS)
+		nthreads = FIRSTN_MAXTHREADS;
+	res = GDKparallel("firstn", nthreads, (BUN) nb, firstnbound_worker, job);
+	MT_lock_destroy(&job->lock);
+
+	if (res != GDK_SUCCEED) {
+		for (int i = 0; i < nb; i++)
+			BBPreclaim(topn[i]);
+		GDKfree(job);
+		return GDK_FAIL;
+	}
+	GDKfree(job);
+	return GDK_SUCCEED;
+}
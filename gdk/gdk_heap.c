@@ -112,6 +112,8 @@ HEAPgrow(Heap **hp, size_t size, bool mayshare)
 			ATOMIC_INIT(&new->refs, 1 | (refs & HEAPREMOVE));
 			new->free = old->free;
 			new->cleanhash = old->cleanhash;
+			new->asciifree = old->asciifree;
+			new->notascii = old->notascii;
 			if (old->free > 0 &&
 			    (new->storage == STORE_MEM || old->storage == STORE_MEM))
 				memcpy(new->base, old->base, old->free);
@@ -155,6 +157,8 @@ HEAPalloc(Heap *h, size_t nitems, size_t itemsize)
 	}
 	h->free = 0;
 	h->cleanhash = false;
+	h->asciifree = 0;
+	h->notascii = false;
 
 #ifdef SIZE_CHECK_IN_HEAPS_ONLY
 	if (GDKvm_cursize() + h->size >= GDK_vm_maxsize &&
@@ -271,7 +275,42 @@ HEAPextend(Heap *h, size_t size, bool mayshare)
 	}
 #endif
 
-	if (h->storage != STORE_MEM) {
+	if (h->storage != STORE_MEM && !h->hasfile) {
+		/* privately mapped range of an external file (see
+		 * BATattachrange), or memory allocated or owned by the
+		 * caller: switch over to allocated memory */
+		char *p;
+
+		assert(h->storage == STORE_PRIV || h->storage == STORE_CMEM || h->storage == STORE_NOWN);
+		/* only private maps were accounted for */
+		xsize = h->storage == STORE_PRIV ? size - osize : size;
+		if (qc != NULL) {
+			ATOMIC_BASE_TYPE sz = ATOMIC_ADD(&qc->datasize, xsize);
+			sz += xsize;
+			if (qc->maxmem > 0 && sz > qc->maxmem) {
+				GDKerror("Query using too much memory.\n");
+				ATOMIC_SUB(&qc->datasize, xsize);
+				return GDK_FAIL;
+			}
+		}
+		p = GDKmalloc(size);
+		if (p != NULL) {
+			memcpy(p, h->base, h->free);
+			if (h->storage == STORE_CMEM)
+				free(h->base);
+			else if (h->storage == STORE_PRIV &&
+				 GDKmunmap(h->base, MMAP_COPY | MMAP_READ | MMAP_WRITE, h->size) != GDK_SUCCEED)
+				GDKsyserror("HEAPextend: %s was not mapped\n", h->filename);
+			TRC_DEBUG(HEAP, "Converting heap %s to malloced heap %zu->%zu %p\n", h->filename, osize, size, p);
+			h->base = p;
+			h->size = size;
+			h->newstorage = h->storage = STORE_MEM;
+			return GDK_SUCCEED;
+		}
+		if (qc != NULL)
+			ATOMIC_SUB(&qc->datasize, xsize);
+		failure = "h->storage != STORE_MEM && !h->hasfile && !GDKmalloc()";
+	} else if (h->storage != STORE_MEM) {
 		char *p;
 		char *path;
 
@@ -663,6 +702,10 @@ HEAPcopy(Heap *dst, Heap *src, size_t offset)
 		dst->free = src->free - offset;
 		memcpy(dst->base, src->base + offset, src->free - offset);
 		dst->cleanhash = src->cleanhash;
+		if (offset == 0) {
+			dst->asciifree = MIN(src->asciifree, dst->free);
+			dst->notascii = src->notascii;
+		}
 		dst->dirty = true;
 		return GDK_SUCCEED;
 	}
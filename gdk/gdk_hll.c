@@ -0,0 +1,570 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+#include "gdk_calc_private.h"
+
+/* ---------------------------------------------------------------------- */
+/* HyperLogLog sketches for approximate distinct counts
+ *
+ * A sketch of precision p consists of 2**p registers of one byte.
+ * Each non-nil value is hashed to 64 bits, the top p bits of the hash
+ * select a register, and the register keeps the largest position of
+ * the first 1 bit in the remaining bits seen so far.  The number of
+ * distinct values is estimated from the histogram of the registers
+ * with the estimator of O. Ertl, "New cardinality estimation
+ * algorithms for HyperLogLog sketches" (2017), which needs no bias
+ * correction tables and is good from the smallest to the largest
+ * counts.  The relative standard error is about 1.04/sqrt(2**p), so
+ * 0.8% for the default precision HLL_PREC.
+ *
+ * The sketch of a union of sets is the register-wise maximum of their
+ * sketches, so sketches of pieces of a column (the mitosis slices, or
+ * the partitions of a table on other servers) can be merged into the
+ * sketch of the whole.  As a value, a sketch is a blob holding the
+ * precision followed by the registers.
+ *
+ * Equal values must hash equally: integer types (and the types based
+ * on them) hash their value, floating point zeros are normalized, and
+ * all other types use their atom hash function. */
+
+#define HLL_PREC	14	/* precision of sketches that are returned */
+#define HLL_MINPREC	4
+#define HLL_MAXPREC	18
+
+static inline ulng
+hll_mix(ulng v)
+{
+	/* the splitmix64 finalizer, all bits depend on all bits */
+	v ^= v >> 30;
+	v *= (ulng) LL_CONSTANT(0xbf58476d1ce4e5b9);
+	v ^= v >> 27;
+	v *= (ulng) LL_CONSTANT(0x94d049bb133111eb);
+	v ^= v >> 31;
+	return v;
+}
+
+/* the value of the register for hash h at precision p */
+static inline uint8_t
+hll_rank(ulng h, int p)
+{
+	h <<= p;
+	if (h == 0)
+		return (uint8_t) (64 - p + 1);
+#if defined(__GNUC__)
+	return (uint8_t) (__builtin_clzll((unsigned long long) h) + 1);
+#else
+	uint8_t r = 1;
+	while ((h & ((ulng) 1 << 63)) == 0) {
+		h <<= 1;
+		r++;
+	}
+	return r;
+#endif
+}
+
+/* Where the hashes of the values go: into the registers of the sketch
+ * of precision p of their group, or, if next is set, only so for the
+ * groups g for which next[g] is BUN_NONE, the registers of which start
+ * at first[g] << p.  For the other (small) groups, the register and its
+ * new value are appended to codes at next[g] (see HLL_CODE). */
+struct hll_dest {
+	uint8_t *regs;
+	int p;
+	BUN *first;
+	BUN *next;
+	uint32_t *codes;
+};
+
+/* a register number and a value for it in one integer, in the order
+ * of the registers and then the values */
+#define HLL_CODE(j, r)	((uint32_t) (j) << 6 | (r))
+
+static inline void
+hll_put(struct hll_dest *restrict d, oid g, ulng h)
+{
+	BUN j = (BUN) (h >> (64 - d->p));
+	uint8_t r = hll_rank(h, d->p);
+
+	if (d->next) {
+		if (d->next[g] != BUN_NONE) {
+			d->codes[d->next[g]++] = HLL_CODE(j, r);
+			return;
+		}
+		g = d->first[g];
+	}
+	uint8_t *reg = &d->regs[(g << d->p) + j];
+	if (*reg < r)
+		*reg = r;
+}
+
+#define HLL_KEY(v)	((ulng) (lng) (v))
+#ifdef HAVE_HGE
+#define HLL_KEYhge(v)	((ulng) (v) ^ hll_mix((ulng) ((v) >> 64)))
+#endif
+/* -0.0 and 0.0 are equal, there are no other equal values with
+ * different bits (the nils have been skipped) */
+#define HLL_KEYflt(v)	((ulng) ((union { flt f; uint32_t u; }) {.f = (v) == 0 ? 0 : (v)}).u)
+#define HLL_KEYdbl(v)	((ulng) ((union { dbl d; ulng u; }) {.d = (v) == 0 ? 0 : (v)}).u)
+
+#define HLL_ADD(TYPE, KEY)						\
+	do {								\
+		const TYPE *restrict vals = (const TYPE *) bi.base;	\
+		TIMEOUT_LOOP(ci->ncand, qry_ctx) {			\
+			BUN i = canditer_next(ci) - b->hseqbase;	\
+			TYPE v = vals[i];				\
+			oid g = gids ? gids[i] - min : dense ? i : 0;	\
+			if (g >= ngrp || is_##TYPE##_nil(v))		\
+				continue;				\
+			hll_put(d, g, hll_mix(KEY(v)));			\
+		}							\
+		TIMEOUT_CHECK(qry_ctx,					\
+			      GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx)); \
+	} while (0)
+
+/* Add the values of b selected by ci to d, the value at position i to
+ * the sketch of group gids[i] - min, of group i if the groups are
+ * dense, or all to the first if there are no groups. */
+static gdk_return
+hll_add(struct hll_dest *restrict d, BAT *b, struct canditer *ci,
+	const oid *restrict gids, bool dense, oid min, BUN ngrp)
+{
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+	qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0};
+
+	BATiter bi = bat_iterator(b);
+	switch (ATOMbasetype(bi.type)) {
+	case TYPE_bte:
+		HLL_ADD(bte, HLL_KEY);
+		break;
+	case TYPE_sht:
+		HLL_ADD(sht, HLL_KEY);
+		break;
+	case TYPE_int:
+		HLL_ADD(int, HLL_KEY);
+		break;
+	case TYPE_lng:
+		HLL_ADD(lng, HLL_KEY);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		HLL_ADD(hge, HLL_KEYhge);
+		break;
+#endif
+	case TYPE_flt:
+		HLL_ADD(flt, HLL_KEYflt);
+		break;
+	case TYPE_dbl:
+		HLL_ADD(dbl, HLL_KEYdbl);
+		break;
+	default: {
+		int (*atomcmp)(const void *, const void *) = ATOMcompare(bi.type);
+		BUN (*atomhash)(const void *) = BATatoms[bi.type].atomHash;
+		const void *nil = ATOMnilptr(bi.type);
+		TIMEOUT_LOOP(ci->ncand, qry_ctx) {
+			BUN i = canditer_next(ci) - b->hseqbase;
+			const void *v = BUNtail(bi, i);
+			oid g = gids ? gids[i] - min : dense ? i : 0;
+			if (g >= ngrp || (!bi.nonil && atomcmp(v, nil) == 0))
+				continue;
+			hll_put(d, g, hll_mix((ulng) atomhash(v)));
+		}
+		TIMEOUT_CHECK(qry_ctx,
+			      GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
+		break;
+	}
+	}
+	bat_iterator_end(&bi);
+	return GDK_SUCCEED;
+
+  bailout:
+	bat_iterator_end(&bi);
+	return GDK_FAIL;
+}
+
+static double
+hll_sigma(double x)
+{
+	double y = 1, z = x, zp;
+
+	if (x == 1)
+		return INFINITY;
+	do {
+		x *= x;
+		zp = z;
+		z += x * y;
+		y += y;
+	} while (z != zp);
+	return z;
+}
+
+static double
+hll_tau(double x)
+{
+	double y = 1, z = 1 - x, zp;
+
+	if (x == 0 || x == 1)
+		return 0;
+	do {
+		x = sqrt(x);
+		zp = z;
+		y *= 0.5;
+		z -= (1 - x) * (1 - x) * y;
+	} while (z != zp);
+	return z / 3;
+}
+
+/* the estimated number of distinct values in a sketch of precision p
+ * with hist[k] registers of value k */
+static lng
+hll_estimate_hist(const BUN *hist, int p)
+{
+	const int q = 64 - p;
+	const BUN m = (BUN) 1 << p;
+	double z;
+
+	if (hist[0] == m)
+		return 0;
+	z = m * hll_tau(1 - (double) hist[q + 1] / m);
+	for (int k = q; k >= 1; k--)
+		z = 0.5 * (z + hist[k]);
+	z += m * hll_sigma((double) hist[0] / m);
+	return (lng) llround((double) m * m / (2 * log(2) * z));
+}
+
+/* the estimated number of distinct values in a sketch */
+static lng
+hll_estimate(const uint8_t *regs, int p)
+{
+	BUN hist[64 + 2] = {0};
+
+	for (BUN j = 0, m = (BUN) 1 << p; j < m; j++)
+		hist[regs[j]]++;
+	return hll_estimate_hist(hist, p);
+}
+
+/* the estimated number of distinct values in the sketch of precision p
+ * in which the n codes (see HLL_CODE) were set; the codes are sorted */
+static lng
+hll_estimate_codes(uint32_t *codes, BUN n, int p)
+{
+	BUN hist[64 + 2] = {0};
+	BUN used = 0;
+
+	GDKqsort(codes, NULL, NULL, n, sizeof(uint32_t), 0, TYPE_int, false, false);
+	for (BUN k = 0; k < n; k++) {
+		/* the last code of a register has its final value */
+		if (k + 1 == n || codes[k + 1] >> 6 != codes[k] >> 6) {
+			hist[codes[k] & 63]++;
+			used++;
+		}
+	}
+	hist[0] = ((BUN) 1 << p) - used;
+	return hll_estimate_hist(hist, p);
+}
+
+/* the precision of a sketch, or -1 if it is not one */
+static int
+hll_precision(const blob *sk)
+{
+	int p;
+
+	if (is_blob_nil(sk) || sk->nitems < 1)
+		return -1;
+	p = (uint8_t) sk->data[0];
+	if (p < HLL_MINPREC || p > HLL_MAXPREC ||
+	    sk->nitems != ((size_t) 1 << p) + 1)
+		return -1;
+	return p;
+}
+
+/* Return a bat with the sketches in regs of precision p as blobs, nil
+ * for the groups for which seen is false. */
+static BAT *
+hll_sketches(const uint8_t *regs, int p, const bool *seen, oid min, BUN ngrp)
+{
+	const size_t m = (size_t) 1 << p;
+	BAT *bn;
+	blob *sk;
+
+	if ((bn = COLnew(min, TYPE_blob, ngrp, TRANSIENT)) == NULL)
+		return NULL;
+	if ((sk = GDKmalloc(blobsize(m + 1))) == NULL) {
+		BBPreclaim(bn);
+		return NULL;
+	}
+	sk->nitems = m + 1;
+	sk->data[0] = (char) p;
+	for (BUN g = 0; g < ngrp; g++) {
+		const void *v = sk;
+		if (seen && !seen[g])
+			v = ATOMnilptr(TYPE_blob);
+		else
+			memcpy(sk->data + 1, regs + (g << p), m);
+		if (BUNappend(bn, v, false) != GDK_SUCCEED) {
+			GDKfree(sk);
+			BBPreclaim(bn);
+			return NULL;
+		}
+	}
+	GDKfree(sk);
+	bn->tkey = ngrp <= 1;
+	bn->tsorted = ngrp <= 1;
+	bn->trevsorted = ngrp <= 1;
+	return bn;
+}
+
+/* Groups with at most this many values do not get a sketch, they
+ * keep a list of the registers their values set instead.  Either way,
+ * the registers take at most four bytes per value, however many groups
+ * there are. */
+#define HLL_SMALL	((BUN) 1 << (HLL_PREC - 2))
+
+/* Estimate the number of distinct non-nil values per group.  Empty
+ * groups have no distinct values.  All groups are estimated with
+ * sketches of precision HLL_PREC, so a group gets the same estimate as
+ * the ungrouped aggregate on its values.  Small groups set the
+ * registers of their sketch in a list, so the memory used depends on
+ * the number of values, not on the number of groups. */
+BAT *
+BATgroupapprox_count_distinct(BAT *b, BAT *g, BAT *e, BAT *s, int tp,
+			      bool skip_nils)
+{
+	const oid *gids = NULL;
+	oid min, max;
+	BUN ngrp, nlarge = 0, nsmall = 0;
+	struct canditer ci;
+	const char *err;
+	struct hll_dest d = {.p = HLL_PREC};
+	BAT *bn = NULL;
+	lng *cnts;
+	lng t0 = 0;
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+
+	assert(tp == TYPE_lng);
+	(void) tp;
+	(void) skip_nils;	/* nils are never counted */
+
+	if ((err = BATgroupaggrinit(b, g, e, s, &min, &max, &ngrp, &ci)) != NULL) {
+		GDKerror("%s\n", err);
+		return NULL;
+	}
+	if (ci.ncand == 0 || ngrp == 0) {
+		lng zero = 0;
+		return BATconstant(ngrp == 0 ? 0 : min, TYPE_lng, &zero, ngrp, TRANSIENT);
+	}
+	if (g && !BATtdense(g))
+		gids = (const oid *) Tloc(g, 0);
+	if (ngrp == 1) {
+		nlarge = 1;
+	} else {
+		/* the number of rows of a group bounds the number of
+		 * codes it can add */
+		if ((d.first = GDKzalloc(ngrp * sizeof(BUN))) == NULL ||
+		    (d.next = GDKmalloc(ngrp * sizeof(BUN))) == NULL)
+			goto bailout;
+		for (BUN n = 0; n < ci.ncand; n++) {
+			BUN i = canditer_next(&ci) - b->hseqbase;
+			oid gid = gids ? gids[i] - min : (oid) i;
+			if (gid < ngrp)
+				d.first[gid]++;
+		}
+		canditer_reset(&ci);
+		for (BUN i = 0; i < ngrp; i++) {
+			if (d.first[i] > HLL_SMALL) {
+				d.next[i] = BUN_NONE;
+				d.first[i] = nlarge++;
+			} else {
+				d.next[i] = nsmall;
+				nsmall += d.first[i];
+				d.first[i] = d.next[i];
+			}
+		}
+		if (nsmall > 0 &&
+		    (d.codes = GDKmalloc(nsmall * sizeof(uint32_t))) == NULL)
+			goto bailout;
+	}
+	if (nlarge > 0 && (d.regs = GDKzalloc(nlarge << d.p)) == NULL)
+		goto bailout;
+	if (hll_add(&d, b, &ci, gids, g != NULL, min, ngrp) != GDK_SUCCEED ||
+	    (bn = COLnew(min, TYPE_lng, ngrp, TRANSIENT)) == NULL)
+		goto bailout;
+	cnts = (lng *) Tloc(bn, 0);
+	for (BUN i = 0; i < ngrp; i++) {
+		if (d.next == NULL)
+			cnts[i] = hll_estimate(d.regs, d.p);
+		else if (d.next[i] == BUN_NONE)
+			cnts[i] = hll_estimate(d.regs + (d.first[i] << d.p), d.p);
+		else
+			cnts[i] = hll_estimate_codes(d.codes + d.first[i],
+						     d.next[i] - d.first[i], d.p);
+	}
+	BATsetcount(bn, ngrp);
+	bn->tkey = ngrp <= 1;
+	bn->tsorted = ngrp <= 1;
+	bn->trevsorted = ngrp <= 1;
+	bn->tnil = false;
+	bn->tnonil = true;
+
+	TRC_DEBUG(ALGO, "b=" ALGOBATFMT ",g=" ALGOOPTBATFMT ","
+		  "e=" ALGOOPTBATFMT ",s=" ALGOOPTBATFMT " -> " ALGOOPTBATFMT
+		  "; " BUNFMT " sketches, " BUNFMT " codes (" LLFMT " usec)\n",
+		  ALGOBATPAR(b), ALGOOPTBATPAR(g), ALGOOPTBATPAR(e),
+		  ALGOOPTBATPAR(s), ALGOOPTBATPAR(bn), nlarge, nsmall,
+		  GDKusec() - t0);
+
+  bailout:
+	GDKfree(d.regs);
+	GDKfree(d.codes);
+	GDKfree(d.first);
+	GDKfree(d.next);
+	return bn;
+}
+
+/* whether the registers of ngrp sketches of precision p, and the blobs
+ * made of them, fit in memory */
+#define HLL_FITS(ngrp, p)	((ngrp) <= (BUN) (GDK_mem_maxsize >> ((p) + 1)))
+
+/* Return the sketches of the non-nil values per group as blobs, all of
+ * precision HLL_PREC, so that they can be merged. */
+BAT *
+BATgrouphll(BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool skip_nils)
+{
+	const oid *gids = NULL;
+	oid min, max;
+	BUN ngrp;
+	struct canditer ci;
+	const char *err;
+	struct hll_dest d = {.p = HLL_PREC};
+	BAT *bn;
+
+	assert(tp == TYPE_blob);
+	(void) tp;
+	(void) skip_nils;
+
+	if ((err = BATgroupaggrinit(b, g, e, s, &min, &max, &ngrp, &ci)) != NULL) {
+		GDKerror("%s\n", err);
+		return NULL;
+	}
+	if (g && !BATtdense(g))
+		gids = (const oid *) Tloc(g, 0);
+	if (!HLL_FITS(ngrp, HLL_PREC)) {
+		GDKerror("too many groups (" BUNFMT ") for HyperLogLog sketches.\n", ngrp);
+		return NULL;
+	}
+	if ((d.regs = GDKzalloc(ngrp << HLL_PREC)) == NULL)
+		return NULL;
+	if (hll_add(&d, b, &ci, gids, g != NULL, min, ngrp) != GDK_SUCCEED) {
+		GDKfree(d.regs);
+		return NULL;
+	}
+	bn = hll_sketches(d.regs, HLL_PREC, NULL, min, ngrp);
+	GDKfree(d.regs);
+	return bn;
+}
+
+/* Merge the sketches in b (a bat of blobs) per group.  Nil sketches
+ * are skipped; a group without any sketch gets nil. */
+BAT *
+BATgrouphllmerge(BAT *b, BAT *g, BAT *e, BAT *s, int tp, bool skip_nils)
+{
+	const oid *gids = NULL;
+	oid min, max;
+	BUN ngrp;
+	struct canditer ci;
+	const char *err;
+	uint8_t *regs = NULL;
+	bool *seen = NULL;
+	int p = -1;
+	BAT *bn = NULL;
+
+	assert(tp == TYPE_blob);
+	(void) tp;
+	(void) skip_nils;
+
+	if (b->ttype != TYPE_blob) {
+		GDKerror("type %s not supported.\n", ATOMname(b->ttype));
+		return NULL;
+	}
+	if ((err = BATgroupaggrinit(b, g, e, s, &min, &max, &ngrp, &ci)) != NULL) {
+		GDKerror("%s\n", err);
+		return NULL;
+	}
+	if (g && !BATtdense(g))
+		gids = (const oid *) Tloc(g, 0);
+	if ((seen = GDKzalloc(ngrp * sizeof(bool))) == NULL)
+		return NULL;
+
+	BATiter bi = bat_iterator(b);
+	for (BUN n = 0; n < ci.ncand; n++) {
+		BUN i = canditer_next(&ci) - b->hseqbase;
+		const blob *sk = BUNtvar(bi, i);
+		oid gid = gids ? gids[i] - min : g ? i : 0;
+		if (gid >= ngrp || is_blob_nil(sk))
+			continue;
+		if (p < 0) {
+			if ((p = hll_precision(sk)) < 0) {
+				GDKerror("not a HyperLogLog sketch.\n");
+				goto bailout;
+			}
+			if (!HLL_FITS(ngrp, p)) {
+				GDKerror("too many groups (" BUNFMT ") for HyperLogLog sketches.\n", ngrp);
+				goto bailout;
+			}
+			if ((regs = GDKzalloc(ngrp << p)) == NULL)
+				goto bailout;
+		} else if (hll_precision(sk) != p) {
+			GDKerror("sketches of different precision cannot be merged.\n");
+			goto bailout;
+		}
+		const uint8_t *src = (const uint8_t *) sk->data + 1;
+		uint8_t *restrict dst = regs + (gid << p);
+		for (BUN j = 0, m = (BUN) 1 << p; j < m; j++)
+			if (dst[j] < src[j])
+				dst[j] = src[j];
+		seen[gid] = true;
+	}
+	if (p < 0) {
+		/* no sketches at all */
+		bn = BATconstant(ngrp == 0 ? 0 : min, TYPE_blob, ATOMnilptr(TYPE_blob), ngrp, TRANSIENT);
+	} else {
+		bn = hll_sketches(regs, p, seen, min, ngrp);
+	}
+
+  bailout:
+	bat_iterator_end(&bi);
+	GDKfree(regs);
+	GDKfree(seen);
+	return bn;
+}
+
+/* The estimated number of distinct values in a sketch, nil for a nil
+ * sketch. */
+gdk_return
+HLLestimate(lng *res, const blob *sketch)
+{
+	int p;
+
+	if (is_blob_nil(sketch)) {
+		*res = lng_nil;
+		return GDK_SUCCEED;
+	}
+	if ((p = hll_precision(sketch)) < 0) {
+		GDKerror("not a HyperLogLog sketch.\n");
+		return GDK_FAIL;
+	}
+	*res = hll_estimate((const uint8_t *) sketch->data + 1, p);
+	return GDK_SUCCEED;
+}
@@ -716,87 +716,81 @@ la_bat_update_count(logger *lg, log_id id, lng cnt, int tid)
 	return GDK_FAIL;
 }
 
+/* apply the changes in la to b, b is the BAT with id la->cid */
 static gdk_return
-la_bat_updates(logger *lg, logaction *la, int tid)
+la_bat_apply(logaction *la, BAT *b)
 {
-	log_bid bid = internal_find_bat(lg, la->cid, tid);
-	BAT *b = NULL;
+	BUN cnt;
 
-	if (bid < 0)
-		return GDK_FAIL;
-	if (!bid) {
-		/* object already gone, nothing needed */
-		return GDK_SUCCEED;
-	}
-
-	if (!lg->flushing) {
-		b = BATdescriptor(bid);
-		if (b == NULL)
-			return GDK_FAIL;
-	}
-	BUN cnt = 0;
 	if (la->type == LOG_UPDATE_BULK) {
-		if (!lg->flushing) {
-			cnt = BATcount(b);
-			int is_msk = (b->ttype == TYPE_msk);
-			/* handle offset 0 ie clear */
-			if ( /* DISABLES CODE */ (0) && la->offset == 0 && cnt)
-				BATclear(b, true);
-			/* handle offset */
-			if (cnt <= (BUN) la->offset) {
-				msk t = 1;
-				if (cnt < (BUN) la->offset) {	/* insert nils */
-					const void *tv = (is_msk) ? &t : ATOMnilptr(b->ttype);
-					lng i, d = la->offset - BATcount(b);
-					for (i = 0; i < d; i++) {
-						if (BUNappend(b, tv, true) != GDK_SUCCEED) {
-							logbat_destroy(b);
-							return GDK_FAIL;
-						}
-					}
+		cnt = BATcount(b);
+		int is_msk = (b->ttype == TYPE_msk);
+		/* handle offset 0 ie clear */
+		if ( /* DISABLES CODE */ (0) && la->offset == 0 && cnt)
+			BATclear(b, true);
+		/* handle offset */
+		if (cnt <= (BUN) la->offset) {
+			msk t = 1;
+			if (cnt < (BUN) la->offset) {	/* insert nils */
+				const void *tv = (is_msk) ? &t : ATOMnilptr(b->ttype);
+				lng i, d = la->offset - BATcount(b);
+				for (i = 0; i < d; i++) {
+					if (BUNappend(b, tv, true) != GDK_SUCCEED)
+						return GDK_FAIL;
 				}
-				if (BATcount(b) == (BUN) la->offset && BATappend(b, la->b, NULL, true) != GDK_SUCCEED) {
-					logbat_destroy(b);
-					return GDK_FAIL;
-				}
-			} else {
-				BATiter vi = bat_iterator(la->b);
-				BUN p, q;
+			}
+			if (BATcount(b) == (BUN) la->offset && BATappend(b, la->b, NULL, true) != GDK_SUCCEED)
+				return GDK_FAIL;
+		} else {
+			BATiter vi = bat_iterator(la->b);
+			BUN p, q;
 
-				for (p = 0, q = (BUN) la->offset; p < (BUN) la->nr; p++, q++) {
-					const void *t = BUNtail(vi, p);
+			for (p = 0, q = (BUN) la->offset; p < (BUN) la->nr; p++, q++) {
+				const void *t = BUNtail(vi, p);
 
-					if (q < cnt) {
-						if (BUNreplace(b, q, t, true) != GDK_SUCCEED) {
-							logbat_destroy(b);
-							bat_iterator_end(&vi);
-							return GDK_FAIL;
-						}
-					} else {
-						if (BUNappend(b, t, true) != GDK_SUCCEED) {
-							logbat_destroy(b);
-							bat_iterator_end(&vi);
-							return GDK_FAIL;
-						}
+				if (q < cnt) {
+					if (BUNreplace(b, q, t, true) != GDK_SUCCEED) {
+						bat_iterator_end(&vi);
+						return GDK_FAIL;
+					}
+				} else {
+					if (BUNappend(b, t, true) != GDK_SUCCEED) {
+						bat_iterator_end(&vi);
+						return GDK_FAIL;
 					}
 				}
-				bat_iterator_end(&vi);
 			}
+			bat_iterator_end(&vi);
 		}
 	} else if (la->type == LOG_UPDATE) {
-		if (!lg->flushing && BATupdate(b, la->uid, la->b, true) != GDK_SUCCEED) {
+		if (BATupdate(b, la->uid, la->b, true) != GDK_SUCCEED)
 			return GDK_FAIL;
-		}
 	}
-	cnt = (BUN) (la->offset + la->nr);
-	if (la_bat_update_count(lg, la->cid, cnt, tid) != GDK_SUCCEED) {
-		if (b)
-			logbat_destroy(b);
+	return GDK_SUCCEED;
+}
+
+static gdk_return
+la_bat_updates(logger *lg, logaction *la, int tid)
+{
+	log_bid bid = internal_find_bat(lg, la->cid, tid);
+
+	if (bid < 0)
 		return GDK_FAIL;
+	if (!bid) {
+		/* object already gone, nothing needed */
+		return GDK_SUCCEED;
 	}
-	if (b)
+
+	if (!lg->flushing) {
+		BAT *b = BATdescriptor(bid);
+		if (b == NULL)
+			return GDK_FAIL;
+		gdk_return rc = la_bat_apply(la, b);
 		logbat_destroy(b);
-	return GDK_SUCCEED;
+		if (rc != GDK_SUCCEED)
+			return GDK_FAIL;
+	}
+	return la_bat_update_count(lg, la->cid, (lng) (la->offset + la->nr), tid);
 }
 
 static log_return
@@ -994,6 +988,196 @@ tr_destroy(trans *tr)
 	return r;
 }
 
+/* Parallel replay.  While reading a log file at startup, the changes
+ * to the contents of BATs are handed to a number of worker threads,
+ * so that reading and decoding the log continues while the changes
+ * are applied.  All changes to the same BAT go to the same worker,
+ * which applies them in the order in which they were read.  Creating
+ * and destroying BATs are applied by the reading thread after all
+ * queued changes have been applied. */
+#define REPLAY_QUEUED	256	/* max changes queued per worker */
+
+typedef struct replay_action {
+	struct replay_action *next;
+	log_bid bid;
+	logaction la;
+} replay_action;
+
+typedef struct replay_worker {
+	struct replay *rp;
+	MT_Id tid;
+	MT_Cond cv;		/* new work or time to stop */
+	replay_action *head, *tail;
+} replay_worker;
+
+typedef struct replay {
+	MT_Lock lock;
+	MT_Cond done_cv;	/* a change has been applied */
+	int nworkers;
+	int queued;		/* changes not yet applied */
+	bool stop;
+	bool failed;
+	replay_worker workers[];
+} replay;
+
+static void
+replay_worker_thread(void *arg)
+{
+	replay_worker *w = arg;
+	replay *rp = w->rp;
+
+	MT_lock_set(&rp->lock);
+	for (;;) {
+		while (w->head == NULL && !rp->stop)
+			MT_cond_wait(&w->cv, &rp->lock);
+		replay_action *a = w->head;
+		if (a == NULL)
+			break;
+		if ((w->head = a->next) == NULL)
+			w->tail = NULL;
+		bool skip = rp->failed;
+		MT_lock_unset(&rp->lock);
+
+		gdk_return rc = GDK_SUCCEED;
+		if (!skip) {
+			BAT *b = BATdescriptor(a->bid);
+			if (b == NULL) {
+				rc = GDK_FAIL;
+			} else {
+				rc = la_bat_apply(&a->la, b);
+				logbat_destroy(b);
+			}
+			if (rc != GDK_SUCCEED)
+				TRC_CRITICAL(GDK, "replaying changes to bat %d failed\n", a->bid);
+		}
+		if (a->la.b)
+			BBPrelease(a->la.b->batCacheid);
+		if (a->la.uid)
+			BBPrelease(a->la.uid->batCacheid);
+		la_destroy(&a->la);
+		GDKfree(a);
+
+		MT_lock_set(&rp->lock);
+		if (rc != GDK_SUCCEED)
+			rp->failed = true;
+		rp->queued--;
+		MT_cond_signal(&rp->done_cv);
+	}
+	MT_lock_unset(&rp->lock);
+}
+
+/* wait until all queued changes have been applied */
+static gdk_return
+replay_wait(replay *rp)
+{
+	MT_lock_set(&rp->lock);
+	while (rp->queued > 0)
+		MT_cond_wait(&rp->done_cv, &rp->lock);
+	bool failed = rp->failed;
+	MT_lock_unset(&rp->lock);
+	return failed ? GDK_FAIL : GDK_SUCCEED;
+}
+
+static void
+replay_destroy(replay *rp)
+{
+	MT_lock_set(&rp->lock);
+	rp->stop = true;
+	for (int i = 0; i < rp->nworkers; i++)
+		MT_cond_signal(&rp->workers[i].cv);
+	MT_lock_unset(&rp->lock);
+	for (int i = 0; i < rp->nworkers; i++) {
+		MT_join_thread(rp->workers[i].tid);
+		MT_cond_destroy(&rp->workers[i].cv);
+	}
+	MT_lock_destroy(&rp->lock);
+	MT_cond_destroy(&rp->done_cv);
+	GDKfree(rp);
+}
+
+static replay *
+replay_create(int nworkers)
+{
+	replay *rp = GDKmalloc(offsetof(replay, workers) + nworkers * sizeof(replay_worker));
+
+	if (rp == NULL)
+		return NULL;
+	*rp = (replay) {
+		.nworkers = 0,
+	};
+	MT_lock_init(&rp->lock, "replay");
+	MT_cond_init(&rp->done_cv);
+	for (int i = 0; i < nworkers; i++) {
+		char name[MT_NAME_LEN];
+		replay_worker *w = &rp->workers[i];
+
+		*w = (replay_worker) {
+			.rp = rp,
+		};
+		MT_cond_init(&w->cv);
+		snprintf(name, sizeof(name), "logreplay%d", i);
+		if (MT_create_thread(&w->tid, replay_worker_thread, w, MT_THR_JOINABLE, name) < 0) {
+			MT_cond_destroy(&w->cv);
+			break;
+		}
+		rp->nworkers++;
+	}
+	if (rp->nworkers < 2) {
+		/* not worth it */
+		replay_destroy(rp);
+		return NULL;
+	}
+	return rp;
+}
+
+/* queue the changes in la for application by a worker, on success
+ * the worker owns la->b and la->uid */
+static gdk_return
+replay_updates(logger *lg, replay *rp, logaction *la, int tid)
+{
+	log_bid bid = internal_find_bat(lg, la->cid, tid);
+
+	if (bid < 0)
+		return GDK_FAIL;
+	if (!bid) {
+		/* object already gone, nothing needed */
+		return GDK_SUCCEED;
+	}
+	if (la_bat_update_count(lg, la->cid, (lng) (la->offset + la->nr), tid) != GDK_SUCCEED)
+		return GDK_FAIL;
+
+	replay_action *a = GDKmalloc(sizeof(replay_action));
+	if (a == NULL)
+		return GDK_FAIL;
+	*a = (replay_action) {
+		.bid = bid,
+		.la = *la,
+	};
+	/* the temporary BATs are private to this thread, a logical
+	 * reference makes them accessible to the worker */
+	if (la->b)
+		BBPretain(la->b->batCacheid);
+	if (la->uid)
+		BBPretain(la->uid->batCacheid);
+	la->b = NULL;
+	la->uid = NULL;
+
+	replay_worker *w = &rp->workers[bid % rp->nworkers];
+	MT_lock_set(&rp->lock);
+	while (rp->queued >= REPLAY_QUEUED * rp->nworkers && !rp->failed)
+		MT_cond_wait(&rp->done_cv, &rp->lock);
+	if (w->tail)
+		w->tail->next = a;
+	else
+		w->head = a;
+	w->tail = a;
+	rp->queued++;
+	MT_cond_signal(&w->cv);
+	bool failed = rp->failed;
+	MT_lock_unset(&rp->lock);
+	return failed ? GDK_FAIL : GDK_SUCCEED;
+}
+
 static trans *
 tr_abort_(logger *lg, trans *tr, int s)
 {
@@ -1015,14 +1199,23 @@ tr_abort(logger *lg, trans *tr)
 }
 
 static trans *
-tr_commit(logger *lg, trans *tr)
+tr_commit(logger *lg, trans *tr, replay *rp)
 {
 	int i;
 
 	TRC_DEBUG(WAL, "commit");
 
 	for (i = 0; i < tr->nr; i++) {
-		if (la_apply(lg, &tr->changes[i], tr->tid) != GDK_SUCCEED) {
+		logaction *la = &tr->changes[i];
+		gdk_return rc;
+
+		if (rp == NULL)
+			rc = la_apply(lg, la, tr->tid);
+		else if (la->type == LOG_UPDATE || la->type == LOG_UPDATE_BULK)
+			rc = replay_updates(lg, rp, la, tr->tid);
+		else if ((rc = replay_wait(rp)) == GDK_SUCCEED)
+			rc = la_apply(lg, la, tr->tid);
+		if (rc != GDK_SUCCEED) {
 			TRC_CRITICAL(GDK, "aborting transaction\n");
 			do {
 				tr = tr_abort_(lg, tr, i);
@@ -1031,6 +1224,10 @@ tr_commit(logger *lg, trans *tr)
 		}
 		la_destroy(&tr->changes[i]);
 	}
+	if (!lg->flushing) {
+		lg->replay_trans++;
+		lg->replay_changes += tr->nr;
+	}
 	lg->saved_tid = tr->tid;
 	return tr_destroy(tr);
 }
@@ -1171,13 +1368,44 @@ log_close_input(logger *lg)
 	lg->input_log = NULL;
 }
 
+#define flush_lock(lg)		MT_lock_set(&(lg)->flush_lock)
+#define flush_unlock(lg)	MT_lock_unset(&(lg)->flush_lock)
+
+static inline gdk_return
+range_sync(logged_range *range)
+{
+	/* assumes flush lock */
+	stream *output_log = range->output_log;
+	ulng ts = ATOMIC_GET(&range->last_ts);
+
+	if (mnstr_flush(output_log, MNSTR_FLUSH_DATA) ||
+	    (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK) && mnstr_fsync(output_log)))
+		return GDK_FAIL;
+	ATOMIC_SET(&range->flushed_ts, ts);
+	return GDK_SUCCEED;
+}
+
+/* close the log file of a range, after writing the transactions that
+ * committed without waiting for the flush to disk */
+static void
+range_close(logger *lg, logged_range *range)
+{
+	TRC_INFO(WAL, "closing output log %s", mnstr_name(range->output_log));
+	if ((ulng) ATOMIC_GET(&range->flushed_ts) < (ulng) ATOMIC_GET(&range->last_ts)) {
+		flush_lock(lg);
+		if (range_sync(range) != GDK_SUCCEED)
+			TRC_CRITICAL(GDK, "syncing log file failed\n");
+		flush_unlock(lg);
+	}
+	close_stream(range->output_log);
+	range->output_log = NULL;
+}
+
 static inline void
 log_close_output(logger *lg)
 {
-	if (!LOG_DISABLED(lg) && lg->current->output_log) {
-		TRC_INFO(WAL, "closing output log %s", mnstr_name(lg->current->output_log));
-		close_stream(lg->current->output_log);
-	}
+	if (!LOG_DISABLED(lg) && lg->current->output_log)
+		range_close(lg, lg->current);
 	lg->current->output_log = NULL;
 }
 
@@ -1230,6 +1458,12 @@ log_read_transaction(logger *lg, uint32_t *updated, BUN maxupdated)
 		ATOMIC_AND(&GDKdebug, ~CHECKMASK);
 
 	BAT *cands = NULL;	/* used in case of LOG_BAT_GROUP */
+	replay *rp = NULL;	/* apply changes in parallel */
+
+	if (!lg->flushing && GDKnr_threads > 1 &&
+	    (rp = replay_create(GDKnr_threads)) != NULL &&
+	    rp->nworkers > lg->replay_workers)
+		lg->replay_workers = rp->nworkers;
 
 	while (err == LOG_OK && (ok = log_read_format(lg, &l))) {
 		if (l.flag == 0 && l.id == 0) {
@@ -1318,7 +1552,7 @@ log_read_transaction(logger *lg, uint32_t *updated, BUN maxupdated)
 			else if (tr->tid != l.id)	/* abort record */
 				tr = tr_abort(lg, tr);
 			else
-				tr = tr_commit(lg, tr);
+				tr = tr_commit(lg, tr, rp);
 			break;
 		case LOG_SEQ:
 			err = log_read_seq(lg, &l);
@@ -1382,6 +1616,11 @@ log_read_transaction(logger *lg, uint32_t *updated, BUN maxupdated)
 		TRC_WARNING(GDK, "aborting transaction\n");
 		tr = tr_abort(lg, tr);
 	}
+	if (rp) {
+		if (replay_wait(rp) != GDK_SUCCEED)
+			err = LOG_ERR;
+		replay_destroy(rp);
+	}
 	if (!lg->flushing)
 		ATOMIC_SET(&GDKdebug, dbg);
 
@@ -1464,6 +1703,7 @@ log_readlogs(logger *lg, const char *filename)
 	char log_filename[FILENAME_MAX];
 	if (lg->saved_id >= lg->id) {
 		bool filemissing = false;
+		lng t0 = GDKusec();
 
 		lg->id = lg->saved_id + 1;
 		while (res == GDK_SUCCEED && !filemissing) {
@@ -1475,8 +1715,10 @@ log_readlogs(logger *lg, const char *filename)
 			if (!filemissing) {
 				lg->saved_id++;
 				lg->id++;
+				lg->replay_files++;
 			}
 		}
+		lg->replay_time += GDKusec() - t0;
 	}
 	return res;
 }
@@ -2318,6 +2560,7 @@ log_load(const char *fn, const char *logdir, logger *lg, char filename[FILENAME_
 	logbat_destroy(lg->dseqs);
 	ATOMIC_DESTROY(&lg->current->refcount);
 	ATOMIC_DESTROY(&lg->nr_flushers);
+	ATOMIC_DESTROY(&lg->nr_syncers);
 	MT_lock_destroy(&lg->lock);
 	MT_lock_destroy(&lg->rotation_lock);
 	GDKfree(lg->fn);
@@ -2345,6 +2588,9 @@ log_new(int debug, const char *fn, const char *logdir, int version, preversionfi
 	lng max_dropped = GDKgetenv_int("wal_max_dropped", 100000);
 	lng max_file_age = GDKgetenv_int("wal_max_file_age", 600);
 	lng max_file_size = 0;
+	lng group_commit_delay = GDKgetenv_int("wal_group_commit_delay", 200);
+	lng group_commit_size = GDKgetenv_int("wal_group_commit_size", 64);
+	lng sync_interval = GDKgetenv_int("wal_sync_interval", 200);
 
 	if (GDKdebug & FORCEMITOMASK) {
 		max_file_size = 2048; /* 2 KiB */
@@ -2376,6 +2622,9 @@ log_new(int debug, const char *fn, const char *logdir, int version, preversionfi
 		.file_age = 0,
 		.max_file_age = max_file_age >= 0 ? max_file_age * 1000000 : 600000000,
 		.max_file_size = max_file_size >= 0 ? max_file_size : 2147483648,
+		.group_commit_delay = group_commit_delay >= 0 ? group_commit_delay : 200,
+		.group_commit_size = group_commit_size > 0 ? group_commit_size : 64,
+		.sync_interval = sync_interval > 0 ? sync_interval * 1000 : 200000,
 
 		.id = 0,
 		.saved_id = getBBPlogno(),	/* get saved log numer from bbp */
@@ -2411,7 +2660,11 @@ log_new(int debug, const char *fn, const char *logdir, int version, preversionfi
 	MT_lock_init(&lg->rotation_lock, "rotation_lock");
 	MT_lock_init(&lg->flush_lock, "flush_lock");
 	MT_cond_init(&lg->excl_flush_cv);
+	MT_cond_init(&lg->gc_join_cv);
+	MT_cond_init(&lg->gc_done_cv);
+	MT_cond_init(&lg->sync_cv);
 	ATOMIC_INIT(&lg->nr_flushers, 0);
+	ATOMIC_INIT(&lg->nr_syncers, 0);
 
 	if (log_load(fn, logdir, lg, filename) == GDK_SUCCEED) {
 		return lg;
@@ -2440,11 +2693,8 @@ do_flush_range_cleanup(logger *lg)
 
 	for (frange = first; frange && frange != flast; frange = frange->next) {
 		ATOMIC_DEC(&frange->refcount);
-		if (!LOG_DISABLED(lg) && frange->output_log) {
-			TRC_INFO(WAL, "closing output log %s", mnstr_name(frange->output_log));
-			close_stream(frange->output_log);
-			frange->output_log = NULL;
-		}
+		if (!LOG_DISABLED(lg) && frange->output_log)
+			range_close(lg, frange);
 	}
 	return flast;
 }
@@ -2452,6 +2702,14 @@ do_flush_range_cleanup(logger *lg)
 void
 log_destroy(logger *lg)
 {
+	rotation_lock(lg);
+	bool syncer_running = lg->syncer_running;
+	lg->syncer_stop = true;
+	MT_cond_signal(&lg->sync_cv);
+	rotation_unlock(lg);
+	if (syncer_running)
+		MT_join_thread(lg->syncer);
+
 	log_close_input(lg);
 	logged_range *last = do_flush_range_cleanup(lg);
 	(void) last;
@@ -2497,7 +2755,11 @@ log_destroy(logger *lg)
 	MT_lock_destroy(&lg->lock);
 	MT_lock_destroy(&lg->rotation_lock);
 	MT_lock_destroy(&lg->flush_lock);
+	MT_cond_destroy(&lg->gc_join_cv);
+	MT_cond_destroy(&lg->gc_done_cv);
+	MT_cond_destroy(&lg->sync_cv);
 	ATOMIC_DESTROY(&lg->nr_flushers);
+	ATOMIC_DESTROY(&lg->nr_syncers);
 	GDKfree(lg->fn);
 	GDKfree(lg->dir);
 	GDKfree(lg->rbuf);
@@ -2585,10 +2847,8 @@ do_rotate(logger *lg)
 	if (next) {
 		assert(ATOMIC_GET(&next->refcount) == 1);
 		lg->current = next;
-		if (!LOG_DISABLED(lg) && ATOMIC_GET(&cur->refcount) == 1 && cur->output_log) {
-			close_stream(cur->output_log);
-			cur->output_log = NULL;
-		}
+		if (!LOG_DISABLED(lg) && ATOMIC_GET(&cur->refcount) == 1 && cur->output_log)
+			range_close(lg, cur);
 	}
 }
 
@@ -3194,7 +3454,7 @@ check_rotation_conditions(logger *lg)
 }
 
 gdk_return
-log_tend(logger *lg)
+log_tend(logger *lg, bool sync)
 {
 	TRC_DEBUG(WAL, "tend %d\n", lg->tid);
 
@@ -3206,28 +3466,61 @@ log_tend(logger *lg)
 	l.flag = LOG_END;
 	l.id = lg->tid;
 
-	if ((result = log_write_format(lg, &l)) == GDK_SUCCEED)
+	if ((result = log_write_format(lg, &l)) == GDK_SUCCEED) {
 		ATOMIC_INC(&lg->nr_flushers);
+		/* only these will join a group commit */
+		if (sync)
+			ATOMIC_INC(&lg->nr_syncers);
+	}
 	return result;
 }
 
-#define flush_lock(lg)		MT_lock_set(&(lg)->flush_lock)
-#define flush_unlock(lg)	MT_lock_unset(&(lg)->flush_lock)
-
 static inline gdk_return
-do_flush(logged_range *range)
+do_flush(logger *lg, logged_range *range)
 {
-	/* assumes flush lock */
-	stream *output_log = range->output_log;
-	ulng ts = ATOMIC_GET(&range->last_ts);
+	/* assumes flush lock and rotation lock */
+	lng t0 = GDKusec();
 
-	if (mnstr_flush(output_log, MNSTR_FLUSH_DATA) ||
-	    (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK) && mnstr_fsync(output_log)))
+	if (range_sync(range) != GDK_SUCCEED)
 		return GDK_FAIL;
-	ATOMIC_SET(&range->flushed_ts, ts);
+
+	t0 = GDKusec() - t0;
+	lg->gc_synctime = lg->gc_synctime ? (7 * lg->gc_synctime + t0) / 8 : t0;
+	lg->gc_flushes++;
+	if (lg->gc_pending > lg->gc_maxbatch)
+		lg->gc_maxbatch = lg->gc_pending;
+	TRC_DEBUG(WAL, "flushed " LLFMT " commits in " LLFMT " usec\n", lg->gc_pending, t0);
 	return GDK_SUCCEED;
 }
 
+/* Group commit: wait until the other transactions that have written
+ * their log records join us, so that a single flush serves all of
+ * them.  We only wait if there are such transactions that wait for
+ * the flush (the others leave it to the syncer), for at most
+ * group_commit_delay usec, and never longer than a flush takes on
+ * average, since waiting any longer costs more than it saves. */
+static void
+log_group_collect(logger *lg)
+{
+	/* assumes rotation lock */
+	lng delay = lg->group_commit_delay;
+
+	if (delay == 0 ||
+	    (ATOMIC_GET(&GDKdebug) & NOSYNCMASK) ||
+	    ATOMIC_GET(&lg->nr_syncers) == 0)
+		return;
+	if (lg->gc_synctime > 0 && lg->gc_synctime < delay)
+		delay = lg->gc_synctime;
+
+	lng deadline = GDKusec() + delay, now;
+	lg->gc_collecting = true;
+	while (ATOMIC_GET(&lg->nr_syncers) > 0 &&
+	       lg->gc_pending < lg->group_commit_size &&
+	       (now = GDKusec()) < deadline)
+		(void) MT_cond_timedwait(&lg->gc_join_cv, &lg->rotation_lock, deadline - now);
+	lg->gc_collecting = false;
+}
+
 static inline void
 log_tdone(logger *lg, logged_range *range, ulng commit_ts)
 {
@@ -3238,8 +3531,49 @@ log_tdone(logger *lg, logged_range *range, ulng commit_ts)
 		ATOMIC_SET(&range->last_ts, commit_ts);
 }
 
+/* Write the transactions that committed without waiting for the
+ * flush to disk every sync_interval.  Only the transactions committed
+ * since the last sync can be lost in a crash, replay stops at the
+ * first incomplete transaction. */
+static void
+log_syncer(void *arg)
+{
+	logger *lg = arg;
+
+	rotation_lock(lg);
+	while (!lg->syncer_stop) {
+		(void) MT_cond_timedwait(&lg->sync_cv, &lg->rotation_lock, lg->sync_interval);
+		for (logged_range *p = lg->flush_ranges, *next; p; p = next) {
+			next = p->next;
+			if (p->output_log &&
+			    (ulng) ATOMIC_GET(&p->flushed_ts) < (ulng) ATOMIC_GET(&p->last_ts)) {
+				/* the reference keeps the range and its
+				 * log file, so rotation and committers
+				 * need not wait for the sync; as a
+				 * flusher we hold off an exclusive
+				 * flusher (log_tstart) until done */
+				ATOMIC_INC(&p->refcount);
+				ATOMIC_INC(&lg->nr_flushers);
+				rotation_unlock(lg);
+				flush_lock(lg);
+				if ((ulng) ATOMIC_GET(&p->flushed_ts) < (ulng) ATOMIC_GET(&p->last_ts) &&
+				    range_sync(p) != GDK_SUCCEED)
+					TRC_CRITICAL(GDK, "syncing log file failed\n");
+				flush_unlock(lg);
+				rotation_lock(lg);
+				next = p->next;
+				if (ATOMIC_DEC(&p->refcount) == 1 && p != lg->current && p->output_log)
+					range_close(lg, p);
+				if (ATOMIC_DEC(&lg->nr_flushers) == 0)
+					MT_cond_signal(&lg->excl_flush_cv);
+			}
+		}
+	}
+	rotation_unlock(lg);
+}
+
 gdk_return
-log_tflush(logger *lg, ulng file_id, ulng commit_ts)
+log_tflush(logger *lg, ulng file_id, ulng commit_ts, bool sync)
 {
 	if (lg->flushnow) {
 		rotation_lock(lg);
@@ -3262,7 +3596,14 @@ log_tflush(logger *lg, ulng file_id, ulng commit_ts)
 	if (LOG_DISABLED(lg))
 		return GDK_SUCCEED;
 
+	lng t0 = GDKusec();
 	rotation_lock(lg);
+	if (sync) {
+		/* we arrived, see log_tend */
+		ATOMIC_DEC(&lg->nr_syncers);
+		if (lg->gc_collecting)
+			MT_cond_signal(&lg->gc_join_cv);
+	}
 	logged_range *frange = do_flush_range_cleanup(lg);
 
 	while (frange->next && frange->id < file_id) {
@@ -3272,22 +3613,47 @@ log_tflush(logger *lg, ulng file_id, ulng commit_ts)
 
 	log_tdone(lg, frange, commit_ts);
 
-	if ((ulng) ATOMIC_GET(&frange->flushed_ts) < commit_ts) {
-		/* delay needed ? */
+	if (!sync && !lg->syncer_running && !lg->syncer_stop) {
+		if (MT_create_thread(&lg->syncer, log_syncer, lg, MT_THR_JOINABLE, "logsyncer") == 0)
+			lg->syncer_running = true;
+		else
+			sync = true;
+	}
+
+	/* if !sync, the syncer writes our transaction to disk */
+	if (sync && (ulng) ATOMIC_GET(&frange->flushed_ts) < commit_ts) {
+		bool leader = !lg->gc_collecting;
+
+		lg->gc_pending++;
+		if (leader) {
+			log_group_collect(lg);
+		} else {
+			/* join the group, its leader flushes for us */
+			ulng group = lg->gc_group;
+			MT_cond_signal(&lg->gc_join_cv);
+			while (lg->gc_group == group)
+				MT_cond_wait(&lg->gc_done_cv, &lg->rotation_lock);
+		}
 
 		flush_lock(lg);
 		/* check it one more time */
 		if ((ulng) ATOMIC_GET(&frange->flushed_ts) < commit_ts)
-			do_flush(frange);
+			do_flush(lg, frange);
 		flush_unlock(lg);
+
+		if (leader) {
+			/* the group is done, whether or not a flush
+			 * was needed and succeeded */
+			lg->gc_pending = 0;
+			lg->gc_group++;
+			MT_cond_broadcast(&lg->gc_done_cv);
+		}
 	}
 	/* else somebody else has flushed our log file */
 
 	if (ATOMIC_DEC(&frange->refcount) == 1 && !LOG_DISABLED(lg)) {
-		if (frange != lg->current && frange->output_log) {
-			close_stream(frange->output_log);
-			frange->output_log = NULL;
-		}
+		if (frange != lg->current && frange->output_log)
+			range_close(lg, frange);
 	}
 
 	if (ATOMIC_DEC(&lg->nr_flushers) == 0) {
@@ -3297,6 +3663,11 @@ log_tflush(logger *lg, ulng file_id, ulng commit_ts)
 		/* rotation_lock is still being held */
 		MT_cond_signal(&lg->excl_flush_cv);
 	}
+	t0 = GDKusec() - t0;
+	lg->gc_commits++;
+	lg->gc_latency += t0;
+	if (t0 > lg->gc_maxlatency)
+		lg->gc_maxlatency = t0;
 	rotation_unlock(lg);
 
 	return GDK_SUCCEED;
@@ -3517,6 +3888,18 @@ log_printinfo(logger *lg)
 	printf("current transaction id %d, saved transaction id %d\n",
 	       lg->tid, lg->saved_tid);
 	printf("number of flushers: %d\n", (int) ATOMIC_GET(&lg->nr_flushers));
+	rotation_lock(lg);
+	printf("group commit: delay " LLFMT " usec, size " LLFMT ", average flush " LLFMT " usec, sync interval " LLFMT " usec%s\n",
+	       lg->group_commit_delay, lg->group_commit_size, lg->gc_synctime,
+	       lg->sync_interval, lg->syncer_running ? " (syncer running)" : "");
+	printf("commits " LLFMT ", flushes " LLFMT ", largest batch " LLFMT ", commit latency average " LLFMT " usec, max " LLFMT " usec\n",
+	       lg->gc_commits, lg->gc_flushes, lg->gc_maxbatch,
+	       lg->gc_commits ? lg->gc_latency / lg->gc_commits : 0,
+	       lg->gc_maxlatency);
+	rotation_unlock(lg);
+	printf("replayed " LLFMT " files, " LLFMT " transactions, " LLFMT " changes in " LLFMT " usec, %d threads\n",
+	       lg->replay_files, lg->replay_trans, lg->replay_changes,
+	       lg->replay_time, lg->replay_workers);
 	printf("number of catalog entries "BUNFMT", of which "BUNFMT" deleted\n",
 	       lg->catalog_bid->batCount, lg->dcatalog->batCount);
 	for (logged_range *p = lg->pending; p; p = p->next) {
@@ -3527,3 +3910,23 @@ log_printinfo(logger *lg)
 		printf("pending range "ULLFMT": drops %"PRIu64", last_ts %"PRIu64", flushed_ts %"PRIu64", refcount %"PRIu64"%s%s\n", p->id, (uint64_t) ATOMIC_GET(&p->drops), (uint64_t) ATOMIC_GET(&p->last_ts), (uint64_t) ATOMIC_GET(&p->flushed_ts), (uint64_t) ATOMIC_GET(&p->refcount), buf, p == lg->current ? " (current)" : "");
 	}
 }
+
+void
+log_statistics(logger *lg, log_stats *st)
+{
+	rotation_lock(lg);
+	*st = (log_stats) {
+		.commits = lg->gc_commits,
+		.flushes = lg->gc_flushes,
+		.maxbatch = lg->gc_maxbatch,
+		.avglatency = lg->gc_commits ? lg->gc_latency / lg->gc_commits : 0,
+		.maxlatency = lg->gc_maxlatency,
+		.avgflush = lg->gc_synctime,
+		.replayfiles = lg->replay_files,
+		.replaytrans = lg->replay_trans,
+		.replaychanges = lg->replay_changes,
+		.replaytime = lg->replay_time,
+		.replayworkers = lg->replay_workers,
+	};
+	rotation_unlock(lg);
+}
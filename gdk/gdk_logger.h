@@ -74,12 +74,28 @@ gdk_export gdk_return log_bat_group_end(logger *lg, log_id id);
 //gdk_export gdk_return log_batgroup_end(logger *lg, oid id);
 
 gdk_export gdk_return log_tstart(logger *lg, bool flushnow, ulng *log_file_id);
-gdk_export gdk_return log_tend(logger *lg);
-gdk_export gdk_return log_tflush(logger *lg, ulng log_file_id, ulng commit_ts); /* Flush the WAL to disk using group commit */
+gdk_export gdk_return log_tend(logger *lg, bool sync);
+gdk_export gdk_return log_tflush(logger *lg, ulng log_file_id, ulng commit_ts, bool sync); /* Flush the WAL to disk using group commit, or leave that to the syncer if !sync */
 
 gdk_export gdk_return log_tsequence(logger *lg, int seq, lng id);
 gdk_export log_bid log_find_bat(logger *lg, log_id id);
 
 gdk_export void log_printinfo(logger *lg);
 
+/* group commit and replay statistics, times in usec */
+typedef struct log_stats {
+	lng commits;		/* committed transactions */
+	lng flushes;		/* flushes of the log to disk */
+	lng maxbatch;		/* largest number of commits in one flush */
+	lng avglatency;		/* average time spent committing */
+	lng maxlatency;		/* longest time spent committing */
+	lng avgflush;		/* running average duration of a flush */
+	lng replayfiles;	/* log files replayed at startup */
+	lng replaytrans;	/* transactions replayed at startup */
+	lng replaychanges;	/* changes replayed at startup */
+	lng replaytime;		/* time spent replaying */
+	int replayworkers;	/* threads that applied replayed changes */
+} log_stats;
+gdk_export void log_statistics(logger *lg, log_stats *st);
+
 #endif /*_LOGGER_H_*/
@@ -68,6 +68,37 @@ struct logger {
 
 	// atomic
 	ATOMIC_TYPE nr_flushers;
+	ATOMIC_TYPE nr_syncers;	/* flushers that will wait for their flush
+				 * but have not reached log_tflush yet */
+
+	// synchronized by rotation_lock
+	/* group commit: the first committer that needs a flush waits
+	 * a little for other committers so that a single flush
+	 * serves them all */
+	lng group_commit_delay;	/* max time to wait in usec, 0 disables */
+	lng group_commit_size;	/* stop waiting when this many have joined */
+	bool gc_collecting;	/* a committer is waiting for others */
+	ulng gc_group;		/* incremented after each group flush */
+	lng gc_pending;		/* committers waiting for the next flush */
+	lng gc_synctime;	/* running average duration of a flush (usec) */
+	/* statistics, see log_printinfo and log_statistics */
+	lng gc_commits;		/* number of committed transactions */
+	lng gc_flushes;		/* number of flushes */
+	lng gc_maxbatch;	/* largest number of commits in one flush */
+	lng gc_latency;		/* total time spent in log_tflush (usec) */
+	lng gc_maxlatency;	/* longest time spent in log_tflush (usec) */
+	/* replay at startup */
+	lng replay_files;	/* number of log files replayed */
+	lng replay_trans;	/* number of transactions replayed */
+	lng replay_changes;	/* number of changes replayed */
+	lng replay_time;	/* time spent replaying (usec) */
+	int replay_workers;	/* largest number of replay threads */
+	/* transactions committed without waiting for the flush are
+	 * written to disk by the syncer thread */
+	lng sync_interval;	/* time between syncs (usec) */
+	bool syncer_running;
+	bool syncer_stop;
+	MT_Id syncer;
 
 	// synchronized by store->flush
 	bool flushnow;
@@ -91,6 +122,9 @@ struct logger {
 	MT_Lock lock;
 	MT_Lock flush_lock; /* so only one transaction can flush to disk at any given time */
 	MT_Cond excl_flush_cv;
+	MT_Cond gc_join_cv;	/* signalled when a committer joins a group */
+	MT_Cond gc_done_cv;	/* broadcast when a group has been flushed */
+	MT_Cond sync_cv;	/* signalled to stop the syncer */
 };
 
 struct old_logger {
@@ -347,6 +347,36 @@ MT_mmap(const char *path, int mode, size_t len)
 	return ret;
 }
 
+/* map LEN bytes of the existing file PATH starting at file offset OFF
+ * (which must be a multiple of the page size) as a private,
+ * copy-on-write region; the file itself is never written */
+void *
+MT_mmap_range(const char *path, size_t off, size_t len)
+{
+	int fd;
+	void *ret;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		GDKsyserror("open %s failed\n", path);
+		return NULL;
+	}
+	ret = mmap(NULL,
+		   len,
+		   PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_NORESERVE,
+		   fd,
+		   (off_t) off);
+	if (ret == MAP_FAILED) {
+		GDKsyserror("mmap(%s,%zu,%zu) failed\n", path, off, len);
+		ret = NULL;
+	} else {
+		VALGRIND_MALLOCLIKE_BLOCK(ret, len, 0, 1);
+	}
+	close(fd);
+	return ret;
+}
+
 int
 MT_munmap(void *p, size_t len)
 {
@@ -784,6 +814,50 @@ MT_mmap(const char *path, int mode, size_t len)
 	return ret;
 }
 
+/* map LEN bytes of the existing file PATH starting at file offset OFF
+ * (which must be a multiple of the allocation granularity) as a
+ * private, copy-on-write region; the file itself is never written */
+void *
+MT_mmap_range(const char *path, size_t off, size_t len)
+{
+	SECURITY_ATTRIBUTES sa;
+	HANDLE h1, h2;
+	void *ret;
+	wchar_t *wpath = utf8towchar(path);
+	if (wpath == NULL)
+		return NULL;
+
+	sa.nLength = sizeof(SECURITY_ATTRIBUTES);
+	sa.bInheritHandle = TRUE;
+	sa.lpSecurityDescriptor = 0;
+
+	h1 = CreateFileW(wpath, FILE_READ_ATTRIBUTES | FILE_READ_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NOT_CONTENT_INDEXED, NULL);
+	free(wpath);
+	if (h1 == INVALID_HANDLE_VALUE) {
+		GDKwinerror("CreateFile('%s') failed\n", path);
+		return NULL;
+	}
+
+	h2 = CreateFileMapping(h1, &sa, PAGE_WRITECOPY, 0, 0, NULL);
+	if (h2 == NULL) {
+		GDKwinerror("CreateFileMapping(%p, &sa, %lu, 0, 0, NULL) failed\n",
+			    h1, (unsigned long) PAGE_WRITECOPY);
+		CloseHandle(h1);
+		return NULL;
+	}
+	CloseHandle(h1);
+
+	ret = MapViewOfFileEx(h2, FILE_MAP_COPY,
+			      (DWORD) (((__int64) off >> 32) & LL_CONSTANT(0xFFFFFFFF)),
+			      (DWORD) (off & LL_CONSTANT(0xFFFFFFFF)),
+			      len, NULL);
+	if (ret == NULL)
+		errno = winerror(GetLastError());
+	CloseHandle(h2);
+
+	return ret;
+}
+
 int
 MT_munmap(void *p, size_t dummy)
 {
@@ -37,6 +37,7 @@ enum heaptype {
 	imprintsheap,
 	orderidxheap,
 	strimpheap,
+	trigramheap,
 	dataheap
 };
 
@@ -101,6 +102,8 @@ gdk_return BBPchkfarms(void)
 	__attribute__((__visibility__("hidden")));
 void BBPclear(bat bid)
 	__attribute__((__visibility__("hidden")));
+void BBPclocklink(bat i)
+	__attribute__((__visibility__("hidden")));
 void BBPdump(void)		/* never called: for debugging only */
 	__attribute__((__cold__));
 void BBPexit(void)
@@ -162,6 +165,9 @@ void GDKlog(_In_z_ _Printf_format_string_ FILE * fl, const char *format, ...)
 gdk_return GDKmove(int farmid, const char *dir1, const char *nme1, const char *ext1, const char *dir2, const char *nme2, const char *ext2, bool report)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
+void *GDKmmap_range(const char *path, size_t off, size_t len)
+	__attribute__((__warn_unused_result__))
+	__attribute__((__visibility__("hidden")));
 void *GDKmremap(const char *path, int mode, void *old_address, size_t old_size, size_t *new_size)
 	__attribute__((__visibility__("hidden")));
 gdk_return GDKremovedir(int farmid, const char *nme)
@@ -254,10 +260,18 @@ void STRMPdecref(Strimps *strimps, bool remove)
 	__attribute__((__visibility__("hidden")));
 void STRMPfree(BAT *b)
 	__attribute__((__visibility__("hidden")));
+void TRGMdecref(Trigrams *t, bool remove)
+	__attribute__((__visibility__("hidden")));
+void TRGMfree(BAT *b)
+	__attribute__((__visibility__("hidden")));
+void TRGMincref(Trigrams *t)
+	__attribute__((__visibility__("hidden")));
 void MT_init_posix(void)
 	__attribute__((__visibility__("hidden")));
 void *MT_mmap(const char *path, int mode, size_t len)
 	__attribute__((__visibility__("hidden")));
+void *MT_mmap_range(const char *path, size_t off, size_t len)
+	__attribute__((__visibility__("hidden")));
 void *MT_mremap(const char *path, int mode, void *old_address, size_t old_size, size_t *new_size)
 	__attribute__((__visibility__("hidden")));
 int MT_msync(void *p, size_t len)
@@ -461,6 +475,11 @@ struct Strimps {
 				 * bitstring construction */
 };
 
+struct Trigrams {
+	Heap heap;
+	BUN count;		/* number of rows indexed */
+};
+
 #ifdef HAVE_RTREE
 struct RTree {
 	ATOMIC_TYPE refs; 	/* counter for logical references to the rtree */
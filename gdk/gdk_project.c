@@ -409,6 +409,13 @@ project_str(BATiter *restrict li, struct canditer *restrict ci, int tpe,
 #endif
 		memcpy(bn->tvheap->base + h1off, r2i->vh->base, r2i->vhfree);
 		bn->tvheap->free = h1off + r2i->vhfree;
+		/* with the second hash table in the middle, the heap
+		 * cannot be checked later */
+		if (r1i->vh->asciifree >= r1i->vhfree &&
+		    r2i->vh->asciifree >= r2i->vhfree)
+			bn->tvheap->asciifree = bn->tvheap->free;
+		else
+			bn->tvheap->notascii = true;
 		bn->tvheap->dirty = true;
 	}
 
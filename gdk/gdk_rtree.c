@@ -188,6 +188,91 @@ RTREEexists_bid(bat *bid)
 	return ret;
 }
 
+/* The MBRs are added to the rtree in Sort-Tile-Recursive order: sorted
+ * on the x coordinate of their centers, cut into vertical slices of
+ * about the same number of MBRs, and each slice sorted on the y
+ * coordinate.  MBRs that are close together are then added one after
+ * the other.  That gives compact nodes that overlap little, and the
+ * inserts are cheap because they keep going down the same path of the
+ * tree.  librtree has no way to build the tree bottom-up, so we only
+ * choose the order.  The slices are sorted in parallel. */
+#define RTREE_NODESIZE	32		/* about the number of MBRs in a node */
+#define RTREE_MINSLICE	((BUN) 1 << 16)	/* smallest slice sorted by a thread */
+
+struct rtreeitem {
+	float x, y;					/* the center of the MBR */
+	BUN id;						/* its position in the candidates */
+};
+
+struct rtreeslices {
+	struct rtreeitem *items;
+	BUN n, size;
+};
+
+static int
+rtreeitem_xcmp(const void *a, const void *b)
+{
+	float x = ((const struct rtreeitem *) a)->x, y = ((const struct rtreeitem *) b)->x;
+	return (x > y) - (x < y);
+}
+
+static int
+rtreeitem_ycmp(const void *a, const void *b)
+{
+	float x = ((const struct rtreeitem *) a)->y, y = ((const struct rtreeitem *) b)->y;
+	return (x > y) - (x < y);
+}
+
+static gdk_return
+rtree_sortslice(void *arg, int t, BUN i)
+{
+	struct rtreeslices *sl = arg;
+	BUN lo = i * sl->size, hi = MIN(lo + sl->size, sl->n);
+
+	(void) t;
+	qsort(sl->items + lo, hi - lo, sizeof(struct rtreeitem), rtreeitem_ycmp);
+	return GDK_SUCCEED;
+}
+
+static struct rtreeitem *
+RTREEstrorder(BATiter *bi, struct canditer *ci)
+{
+	struct rtreeslices sl;
+	struct rtreeitem *items;
+	BUN nslices;
+	int nthreads = GDKnr_threads;
+
+	if ((items = GDKmalloc(MAX(ci->ncand, 1) * sizeof(struct rtreeitem))) == NULL)
+		return NULL;
+	for (BUN i = 0; i < ci->ncand; i++) {
+		const mbr_t *m = BUNtail(*bi, canditer_next(ci) - bi->b->hseqbase);
+		items[i] = (struct rtreeitem) {
+			/* nil MBRs (no coordinates) go first */
+			.x = is_flt_nil(m->xmin) ? -GDK_flt_max : m->xmin / 2 + m->xmax / 2,
+			.y = is_flt_nil(m->ymin) ? -GDK_flt_max : m->ymin / 2 + m->ymax / 2,
+			.id = i,
+		};
+	}
+	canditer_reset(ci);
+	qsort(items, ci->ncand, sizeof(struct rtreeitem), rtreeitem_xcmp);
+
+	nslices = (BUN) ceil(sqrt((double) ci->ncand / RTREE_NODESIZE));
+	if (nslices == 0)
+		nslices = 1;
+	sl = (struct rtreeslices) {
+		.items = items,
+		.n = ci->ncand,
+		.size = (ci->ncand + nslices - 1) / nslices,
+	};
+	if ((BUN) nthreads > ci->ncand / RTREE_MINSLICE)
+		nthreads = (int) (ci->ncand / RTREE_MINSLICE);
+	if (GDKparallel("rtreesort", nthreads, nslices, rtree_sortslice, &sl) != GDK_SUCCEED) {
+		GDKfree(items);
+		return NULL;
+	}
+	return items;
+}
+
 gdk_return
 BATrtree(BAT *wkb, BAT *mbr)
 {
@@ -195,6 +280,7 @@ BATrtree(BAT *wkb, BAT *mbr)
 	BATiter bi;
 	rtree_t *rtree = NULL;
 	struct canditer ci;
+	struct rtreeitem *order;
 
 	//Check for a parent BAT of wkb, load if exists
 	if (VIEWtparent(wkb)) {
@@ -219,16 +305,23 @@ BATrtree(BAT *wkb, BAT *mbr)
 		//Second arg are flags: split strategy and nodes-per-page
 		if ((rtree = rtree_new(2, RTREE_DEFAULT)) == NULL) {
 			GDKerror("rtree_new failed\n");
+			MT_lock_unset(&pb->batIdxLock);
 			return GDK_FAIL;
 		}
 		bi = bat_iterator(mbr);
 		canditer_init(&ci, mbr,NULL);
 
+		if ((order = RTREEstrorder(&bi, &ci)) == NULL) {
+			bat_iterator_end(&bi);
+			rtree_destroy(rtree);
+			MT_lock_unset(&pb->batIdxLock);
+			return GDK_FAIL;
+		}
 		for (BUN i = 0; i < ci.ncand; i++) {
-			oid p = canditer_next(&ci) - mbr->hseqbase;
+			oid p = canditer_idx(&ci, order[i].id) - mbr->hseqbase;
 			mbr_t *inMBR = (mbr_t *)BUNtail(bi, p);
 
-			rtree_id_t rtree_id = i;
+			rtree_id_t rtree_id = order[i].id;
 			rtree_coord_t rect[4];
 			rect[0] = inMBR->xmin;
 			rect[1] = inMBR->ymin;
@@ -237,6 +330,7 @@ BATrtree(BAT *wkb, BAT *mbr)
 			rtree_add_rect(rtree,rtree_id,rect);
 		}
 		bat_iterator_end(&bi);
+		GDKfree(order);
 		pb->trtree = GDKmalloc(sizeof(struct RTree));
 		pb->trtree->rtree = rtree;
 		pb->trtree->destroy = false;
@@ -894,6 +894,7 @@ BATdelete(BAT *b)
 	OIDXdestroy(b);
 	PROPdestroy_nolock(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
 	RTREEdestroy(b);
 	if (b->theap) {
 		HEAPfree(b->theap, true);
@@ -149,6 +149,125 @@ strCleanHash(Heap *h, bool rebuild)
 	h->cleanhash = false;
 }
 
+/* Whether the len bytes at s are all ASCII, looking at eight bytes at
+ * a time. */
+static inline bool
+strASCII(const char *s, size_t len)
+{
+	uint64_t w;
+
+	for (; len >= 8; s += 8, len -= 8) {
+		memcpy(&w, s, 8);
+		if (w & UINT64_C(0x8080808080808080))
+			return false;
+	}
+	while (len > 0) {
+		if ((unsigned char) s[--len] & 0x80)
+			return false;
+	}
+	return true;
+}
+
+/* Whether the part [pos, end) of a string heap that contains no
+ * links, only strings and padding, has only ASCII strings.  The nil
+ * string is the only string consisting of byte 0x80. */
+static bool
+strASCIIbytes(const char *base, size_t pos, size_t end)
+{
+	while (pos < end) {
+		if (strASCII(base + pos, MIN(end - pos, 4096))) {
+			pos += MIN(end - pos, 4096);
+			continue;
+		}
+		for (size_t e = MIN(end, pos + 4096); pos < e; pos++) {
+			if ((base[pos] & 0x80) &&
+			    (base[pos] != '\200' || base[pos - 1] != 0 ||
+			     pos + 1 >= end || base[pos + 1] != 0))
+				return false;
+		}
+	}
+	return true;
+}
+
+/* Whether the strings in the part [pos, end) of a string heap, where
+ * pos is the end of a string (or of the hash table), are all ASCII.
+ * The strings in the first GDK_ELIMLIMIT bytes are preceded by the
+ * link of their hash list, so there we follow the layout that strPut
+ * creates; if that doesn't work out, *valid is cleared. */
+static bool
+strASCIIheap(const Heap *h, size_t pos, size_t end, bool *valid)
+{
+	const char *base = h->base;
+
+	*valid = true;
+	while (pos < end) {
+		size_t pad = GDK_VARALIGN - (pos & (GDK_VARALIGN - 1));
+		if (GDK_ELIMBASE(pos + pad) != 0)
+			break;
+		if (pad < sizeof(stridx_t))
+			pad += GDK_VARALIGN;
+		if (pos + pad >= GDK_ELIMLIMIT)
+			break;
+		if (pos + pad >= end) {
+			*valid = false;
+			return false;
+		}
+		stridx_t link = *(const stridx_t *) (base + pos + pad - sizeof(stridx_t));
+		if (link != 0 &&
+		    (link < GDK_STRHASHSIZE || link >= pos + pad - sizeof(stridx_t))) {
+			*valid = false;
+			return false;
+		}
+		pos += pad;
+		size_t len = strnlen(base + pos, end - pos);
+		if (len == end - pos) {
+			*valid = false;
+			return false;
+		}
+		if (!strNil(base + pos) && !strASCII(base + pos, len))
+			return false;
+		pos += len + 1;
+	}
+	return strASCIIbytes(base, pos, end);
+}
+
+bool
+BATcheckascii(BATiter *bi)
+{
+	Heap *h = bi->vh;
+	size_t end = bi->vhfree, pos;
+	bool ascii, valid;
+	lng t0 = 0;
+
+	if (ATOMstorage(bi->type) != TYPE_str)
+		return false;
+	if (end <= GDK_STRHASHSIZE || h->asciifree >= end)
+		return true;
+	if (h->notascii)
+		return false;
+
+	TRC_DEBUG_IF(ALGO) t0 = GDKusec();
+	pos = MAX(h->asciifree, GDK_STRHASHSIZE);
+	ascii = strASCIIheap(h, pos, end, &valid);
+	/* the strings that were there stay there, so what we found is
+	 * true for the heap, whatever got added since; a view shares
+	 * the heap of its parent, so it is the parent's lock that
+	 * protects it */
+	BAT *pb = BBP_desc(h->parentid);
+	MT_lock_set(&pb->theaplock);
+	if (ascii) {
+		if (h->asciifree < end)
+			h->asciifree = end;
+	} else {
+		h->notascii = true;
+	}
+	MT_lock_unset(&pb->theaplock);
+	TRC_DEBUG(ALGO, "BATcheckascii(" ALGOBATFMT ") %s%s, " LLFMT " usec\n",
+		  ALGOBATPAR(bi->b), ascii ? "ascii" : "not ascii",
+		  valid ? "" : " (unknown layout)", GDKusec() - t0);
+	return ascii;
+}
+
 /*
  * The strPut routine. The routine strLocate can be used to identify
  * the location of a string in the heap if it exists. Otherwise it
@@ -199,6 +318,8 @@ strPut(BAT *b, var_t *dst, const void *V)
 			h = b->tvheap;
 		}
 		h->free = GDK_STRHASHTABLE * sizeof(stridx_t);
+		h->asciifree = h->free;
+		h->notascii = false;
 		h->dirty = true;
 #ifdef NDEBUG
 		memset(h->base, 0, h->free);
@@ -294,12 +415,18 @@ strPut(BAT *b, var_t *dst, const void *V)
 		bucket = ((stridx_t *) h->base) + off;
 	}
 
-	/* insert string */
+	/* insert string, keeping track of whether the heap is all ASCII */
 	pos = h->free + pad;
 	*dst = (var_t) pos;
 	if (pad > 0)
 		memset(h->base + h->free, 0, pad);
 	memcpy(h->base + pos, v, len);
+	if (!h->notascii) {
+		if (!strNil(v) && !strASCII(v, len - 1))
+			h->notascii = true;
+		else if (h->asciifree == h->free)
+			h->asciifree = h->free + pad + len;
+	}
 	h->free += pad + len;
 	h->dirty = true;
 
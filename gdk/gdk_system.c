@@ -1192,6 +1192,38 @@ MT_cond_wait(MT_Cond *cond, MT_Lock *lock)
 	MT_thread_setcondwait(NULL);
 }
 
+/* wait at most usec microseconds, return whether we were woken up
+ * before the time ran out */
+bool
+MT_cond_timedwait(MT_Cond *cond, MT_Lock *lock, lng usec)
+{
+	bool woken;
+
+	MT_thread_setcondwait(cond);
+#if !defined(HAVE_PTHREAD_H) && defined(WIN32)
+	woken = SleepConditionVariableCS(&cond->cv, &lock->lock, (DWORD) ((usec + 999) / 1000));
+#else
+	struct timespec ts;
+#ifdef HAVE_CLOCK_GETTIME
+	(void) clock_gettime(CLOCK_REALTIME, &ts);
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	ts.tv_sec = tv.tv_sec;
+	ts.tv_nsec = tv.tv_usec * 1000;
+#endif
+	ts.tv_sec += (time_t) (usec / 1000000);
+	ts.tv_nsec += (long) (usec % 1000000) * 1000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+	woken = pthread_cond_timedwait(&cond->cv, &lock->lock, &ts) == 0;
+#endif
+	MT_thread_setcondwait(NULL);
+	return woken;
+}
+
 void
 MT_cond_signal(MT_Cond *cond)
 {
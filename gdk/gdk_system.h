@@ -829,6 +829,7 @@ typedef struct MT_Cond {
 gdk_export void MT_cond_init(MT_Cond *cond);
 gdk_export void MT_cond_destroy(MT_Cond *cond);
 gdk_export void MT_cond_wait(MT_Cond *cond, MT_Lock *lock);
+gdk_export bool MT_cond_timedwait(MT_Cond *cond, MT_Lock *lock, lng usec);
 gdk_export void MT_cond_signal(MT_Cond *cond);
 gdk_export void MT_cond_broadcast(MT_Cond *cond);
 
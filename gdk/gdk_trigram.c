@@ -0,0 +1,659 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/*
+ * A trigram index is an inverted index from the byte trigrams of the
+ * strings in a BAT to the positions of the strings containing them.
+ * It is used to find the candidates of substring searches (LIKE
+ * '%abc%') and similarity searches before the exact predicate is
+ * evaluated on them.
+ *
+ * Trigrams are taken over the bytes of the strings, with ASCII
+ * letters folded to lower case, and hashed into TRIGRAM_BUCKETS
+ * buckets.  Each bucket has a posting list of the positions of the
+ * strings containing one of its trigrams, in ascending order.  The
+ * posting lists are compressed: every position is stored as the
+ * difference with the previous one in a variable length (7 bits per
+ * byte) encoding.  Nil strings and strings shorter than 3 bytes have
+ * no trigrams and so are never candidates.
+ *
+ * The index is stored in a Heap of the BAT, aligned in 8 byte words:
+ *
+ * | version/persist | rows indexed | posting bytes |  3 words
+ * | offset of the posting list of bucket 0 .. TRIGRAM_BUCKETS |
+ * | last position + 1 in bucket 0 .. TRIGRAM_BUCKETS - 1      |
+ * | posting lists                                             |
+ *
+ * The least significant byte of the first word is the version, bit 32
+ * is set once the heap has been written to disk (the same convention
+ * as for strimps).
+ *
+ * The index covers the first "rows indexed" rows of the BAT.  Appends
+ * do not invalidate it: the rows after those are always returned as
+ * candidates, and when there are enough of them, the index is
+ * extended by appending their positions to the posting lists, which
+ * only needs the last position in each bucket.  All other updates
+ * destroy the index.
+ *
+ * The index is created on demand, for persistent BATs only, the first
+ * time TRGMfilter is asked to filter such a BAT (or a view on it), and
+ * it is persisted like the other auxiliary heaps.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+
+#define TRIGRAM_VERSION		(uint64_t) 1
+#define TRIGRAM_BITS		16
+#define TRIGRAM_BUCKETS		((size_t) 1 << TRIGRAM_BITS)
+#define TRIGRAM_HEADER		(3 + (TRIGRAM_BUCKETS + 1) + TRIGRAM_BUCKETS)
+#define TRIGRAM_MAXLISTS	8	/* posting lists to intersect for LIKE */
+#define TRIGRAM_CREATION_THRESHOLD					\
+	((BUN) ((ATOMIC_GET(&GDKdebug) & FORCEMITOMASK)? 100 : 1 << 20))
+
+#define trigram_fold(c)		((uint8_t) ('A' <= (c) && (c) <= 'Z' ? (c) + 'a' - 'A' : (c)))
+#define trigram_bucket(a, b, c)						\
+	((size_t) (((uint32_t) trigram_fold(a) << 16 |			\
+		    (uint32_t) trigram_fold(b) << 8 |			\
+		    (uint32_t) trigram_fold(c)) * 0x9E3779B1U >> (32 - TRIGRAM_BITS)))
+
+#define trigram_offsets(t)	((uint64_t *) (t)->heap.base + 3)
+#define trigram_last(t)		(trigram_offsets(t) + TRIGRAM_BUCKETS + 1)
+#define trigram_postings(t)	((uint8_t *) (t)->heap.base + TRIGRAM_HEADER * sizeof(uint64_t))
+
+static inline size_t
+trigram_varlen(BUN v)
+{
+	size_t n = 1;
+	while (v >= 0x80) {
+		v >>= 7;
+		n++;
+	}
+	return n;
+}
+
+static inline uint8_t *
+trigram_encode(uint8_t *p, BUN v)
+{
+	while (v >= 0x80) {
+		*p++ = (uint8_t) (v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (uint8_t) v;
+	return p;
+}
+
+static inline const uint8_t *
+trigram_decode(const uint8_t *p, BUN *v)
+{
+	BUN r = 0;
+	int shift = 0;
+	while (*p & 0x80) {
+		r |= (BUN) (*p++ & 0x7F) << shift;
+		shift += 7;
+	}
+	*v = r | (BUN) *p++ << shift;
+	return p;
+}
+
+/* Go over the trigrams of the strings at positions [start, end) of b
+ * and count the bytes their postings need (add != NULL) or write them
+ * (post != NULL).  The array last contains the last position + 1 that
+ * was entered into each bucket, it also serves to count every bucket
+ * only once per string. */
+static void
+trigram_scan(BAT *b, BUN start, BUN end, uint64_t *restrict last,
+	     uint64_t *restrict add, uint8_t *restrict post,
+	     uint64_t *restrict cur)
+{
+	BATiter bi = bat_iterator(b);
+
+	for (BUN p = start; p < end; p++) {
+		const uint8_t *s = (const uint8_t *) BUNtvar(bi, p);
+		if (s[0] == 0 || s[1] == 0 || s[2] == 0)
+			continue;	/* also skips nil */
+		for (; s[2]; s++) {
+			size_t h = trigram_bucket(s[0], s[1], s[2]);
+			if (last[h] == p + 1)
+				continue;
+			if (add)
+				add[h] += trigram_varlen(p - last[h]);
+			else
+				cur[h] = (uint64_t) (trigram_encode(post + cur[h], p - last[h]) - post);
+			last[h] = p + 1;
+		}
+	}
+	bat_iterator_end(&bi);
+}
+
+/* Build the index of b, or extend the index old (b->ttrigrams) with
+ * the rows appended to b since it was built.  The old index is
+ * dropped (and b->ttrigrams cleared) once the new one is laid out. */
+static Trigrams *
+trigram_build(BAT *b, Trigrams *old)
+{
+	lng t0 = GDKusec();
+	BUN start = old ? old->count : 0, end = BATcount(b);
+	uint64_t *last, *add, *offsets;
+	uint64_t *oldoff = old ? trigram_offsets(old) : NULL;
+	uint8_t *base = NULL, *post;
+	size_t total = 0, hdr = TRIGRAM_HEADER * sizeof(uint64_t);
+	Trigrams *t;
+	const char *nme;
+
+	MT_thread_setalgorithm(old ? "extend trigram index" : "create trigram index");
+	last = GDKmalloc(TRIGRAM_BUCKETS * sizeof(uint64_t));
+	add = GDKzalloc(TRIGRAM_BUCKETS * sizeof(uint64_t));
+	if (last == NULL || add == NULL) {
+		GDKfree(last);
+		GDKfree(add);
+		return NULL;
+	}
+	if (old)
+		memcpy(last, trigram_last(old), TRIGRAM_BUCKETS * sizeof(uint64_t));
+	else
+		memset(last, 0, TRIGRAM_BUCKETS * sizeof(uint64_t));
+	trigram_scan(b, start, end, last, add, NULL, NULL);
+	for (size_t h = 0; h < TRIGRAM_BUCKETS; h++)
+		total += add[h] + (old ? oldoff[h + 1] - oldoff[h] : 0);
+
+	nme = GDKinmemory(b->theap->farmid) ? ":memory:" : BBP_physical(b->batCacheid);
+	if ((t = GDKzalloc(sizeof(Trigrams))) == NULL ||
+	    (t->heap.farmid = BBPselectfarm(b->batRole, b->ttype, trigramheap)) < 0 ||
+	    strconcat_len(t->heap.filename, sizeof(t->heap.filename),
+			  nme, ".ttrigram", NULL) >= sizeof(t->heap.filename)) {
+		GDKfree(t);
+		GDKfree(last);
+		GDKfree(add);
+		return NULL;
+	}
+	t->heap.parentid = b->batCacheid;
+	if (old) {
+		/* the new heap gets the file name of the old one, so
+		 * build it in memory first */
+		base = GDKmalloc(hdr + total);
+	} else if (HEAPalloc(&t->heap, hdr + total, 1) == GDK_SUCCEED) {
+		base = (uint8_t *) t->heap.base;
+	}
+	if (base == NULL) {
+		GDKfree(t);
+		GDKfree(last);
+		GDKfree(add);
+		return NULL;
+	}
+
+	/* lay out the posting lists: the old list of each bucket
+	 * followed by the new positions */
+	offsets = (uint64_t *) base + 3;
+	post = base + hdr;
+	offsets[0] = 0;
+	for (size_t h = 0; h < TRIGRAM_BUCKETS; h++) {
+		uint64_t oldlen = old ? oldoff[h + 1] - oldoff[h] : 0;
+		offsets[h + 1] = offsets[h] + oldlen + add[h];
+		if (oldlen > 0)
+			memcpy(post + offsets[h], trigram_postings(old) + oldoff[h], oldlen);
+		add[h] = offsets[h] + oldlen;	/* write cursor */
+	}
+	if (old)
+		memcpy(last, trigram_last(old), TRIGRAM_BUCKETS * sizeof(uint64_t));
+	else
+		memset(last, 0, TRIGRAM_BUCKETS * sizeof(uint64_t));
+	trigram_scan(b, start, end, last, NULL, post, add);
+	memcpy((uint64_t *) base + 3 + TRIGRAM_BUCKETS + 1, last,
+	       TRIGRAM_BUCKETS * sizeof(uint64_t));
+	((uint64_t *) base)[0] = TRIGRAM_VERSION;
+	((uint64_t *) base)[1] = (uint64_t) end;
+	((uint64_t *) base)[2] = (uint64_t) total;
+	GDKfree(last);
+	GDKfree(add);
+
+	if (old) {
+		/* drop the old index (including its file) before the
+		 * new heap takes its place */
+		b->ttrigrams = NULL;
+		TRGMdecref(old, true);
+		if (HEAPalloc(&t->heap, hdr + total, 1) != GDK_SUCCEED) {
+			GDKfree(base);
+			GDKfree(t);
+			return NULL;
+		}
+		memcpy(t->heap.base, base, hdr + total);
+		GDKfree(base);
+	}
+	t->heap.free = hdr + total;
+	t->heap.dirty = true;
+	t->count = end;
+	ATOMIC_INIT(&t->heap.refs, 1);
+	TRC_DEBUG(ACCELERATOR, "trigram_build(" ALGOBATFMT "): " BUNFMT
+		  " rows, %zu bytes of postings, " LLFMT " usec\n",
+		  ALGOBATPAR(b), end - start, total, GDKusec() - t0);
+	return t;
+}
+
+/* Write the index to disk if b is persistent and saved. */
+static void
+trigram_persist(BAT *b, Trigrams *t)
+{
+	Heap *hp = &t->heap;
+	int fd;
+
+	if (!(BBP_status(b->batCacheid) & BBPEXISTING)
+	    || b->batInserted != b->batCount
+	    || b->theap->dirty
+	    || GDKinmemory(hp->farmid)) {
+		TRC_DEBUG(ACCELERATOR, "trigram_persist(" ALGOBATFMT "): NOT persisting trigram index\n", ALGOBATPAR(b));
+		return;
+	}
+	if (HEAPsave(hp, hp->filename, NULL, true, hp->free, NULL) != GDK_SUCCEED) {
+		GDKclrerr();
+		return;
+	}
+	((uint64_t *) hp->base)[0] |= (uint64_t) 1 << 32;
+	if (hp->storage == STORE_MEM) {
+		if ((fd = GDKfdlocate(hp->farmid, hp->filename, "rb+", NULL)) >= 0) {
+			if (write(fd, hp->base, sizeof(uint64_t)) >= 0) {
+				if (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK)) {
+#if defined(NATIVE_WIN32)
+					_commit(fd);
+#elif defined(HAVE_FDATASYNC)
+					fdatasync(fd);
+#elif defined(HAVE_FSYNC)
+					fsync(fd);
+#endif
+				}
+				hp->dirty = false;
+			} else {
+				((uint64_t *) hp->base)[0] &= ~((uint64_t) 1 << 32);
+				perror("write trigram index");
+			}
+			close(fd);
+		}
+	} else if (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK) &&
+		   MT_msync(hp->base, sizeof(uint64_t)) < 0) {
+		((uint64_t *) hp->base)[0] &= ~((uint64_t) 1 << 32);
+	} else {
+		hp->dirty = false;
+	}
+	TRC_DEBUG(ACCELERATOR, "trigram_persist(" ALGOBATFMT "): trigram index %spersisted\n",
+		  ALGOBATPAR(b), hp->dirty ? "NOT " : "");
+}
+
+/* Read the index of b from disk (b->ttrigrams == 1). */
+static void
+trigram_load(BAT *b)
+{
+	Trigrams *t;
+	const char *nme = BBP_physical(b->batCacheid);
+	uint64_t desc[3];
+	struct stat st;
+	int fd;
+
+	b->ttrigrams = NULL;
+	if ((t = GDKzalloc(sizeof(Trigrams))) == NULL ||
+	    (t->heap.farmid = BBPselectfarm(b->batRole, b->ttype, trigramheap)) < 0) {
+		GDKfree(t);
+		GDKclrerr();
+		return;
+	}
+	strconcat_len(t->heap.filename, sizeof(t->heap.filename),
+		      nme, ".ttrigram", NULL);
+	t->heap.parentid = b->batCacheid;
+	if ((fd = GDKfdlocate(t->heap.farmid, nme, "rb", "ttrigram")) >= 0) {
+		if (read(fd, desc, sizeof(desc)) == (ssize_t) sizeof(desc)
+		    && (desc[0] & 0xff) == TRIGRAM_VERSION
+		    && ((desc[0] >> 32) & 0xff) == 1
+		    && desc[1] <= (uint64_t) BATcount(b)
+		    && fstat(fd, &st) == 0
+		    && st.st_size >= (off_t) (t->heap.free = t->heap.size =
+					      TRIGRAM_HEADER * sizeof(uint64_t) + desc[2])
+		    && HEAPload(&t->heap, nme, "ttrigram", false) == GDK_SUCCEED) {
+			close(fd);
+			t->count = (BUN) desc[1];
+			t->heap.hasfile = true;
+			ATOMIC_INIT(&t->heap.refs, 1);
+			b->ttrigrams = t;
+			TRC_DEBUG(ACCELERATOR, "trigram_load(" ALGOBATFMT "): reusing persisted trigram index\n", ALGOBATPAR(b));
+			return;
+		}
+		close(fd);
+		/* unlink unusable file */
+		GDKunlink(t->heap.farmid, BATDIR, nme, "ttrigram");
+	}
+	GDKfree(t);
+	GDKclrerr();
+}
+
+/* Get the index of the parent BAT b (with its batIdxLock held),
+ * creating or extending it if needed. */
+static Trigrams *
+trigram_get(BAT *b)
+{
+	Trigrams *t;
+	BUN cnt = BATcount(b);
+
+	if (b->ttrigrams == (Trigrams *) 1)
+		trigram_load(b);
+	if ((t = b->ttrigrams) != NULL && t->count > cnt) {
+		/* the BAT shrunk behind our back */
+		b->ttrigrams = NULL;
+		TRGMdecref(t, true);
+		t = NULL;
+	}
+	if (t == NULL) {
+		if (b->batRole != PERSISTENT || cnt < TRIGRAM_CREATION_THRESHOLD)
+			return NULL;
+		if ((t = trigram_build(b, NULL)) == NULL) {
+			GDKclrerr();
+			return NULL;
+		}
+		b->ttrigrams = t;
+		trigram_persist(b, t);
+	} else if (cnt - t->count >= TRIGRAM_CREATION_THRESHOLD
+		   && cnt - t->count >= t->count / 8
+		   && (ATOMIC_GET(&t->heap.refs) & HEAPREFS) == 1) {
+		/* enough rows were appended, and nobody is using
+		 * the index */
+		Trigrams *n = trigram_build(b, t);
+		if (n == NULL) {
+			GDKclrerr();
+			return b->ttrigrams;
+		}
+		b->ttrigrams = t = n;
+		trigram_persist(b, t);
+	}
+	return t;
+}
+
+static int
+trigram_cmp(const void *a, const void *b)
+{
+	size_t x = *(const size_t *) a, y = *(const size_t *) b;
+	return (x > y) - (x < y);
+}
+
+/* Filter the rows of b selected by s down to the ones that may contain
+ * the strings q[0..nq-1].  With slack > 0, rows may miss up to slack
+ * of the trigram buckets of the q strings; only the rarest buckets
+ * are used then.  Returns NULL (without error) if there is no index
+ * or the q strings have too few trigrams to filter with. */
+BAT *
+TRGMfilter(BAT *b, BAT *s, const char *const *q, int nq, int slack)
+{
+	lng t0 = 0;
+	BAT *pb, *bn = NULL, *r;
+	Trigrams *t;
+	size_t *buckets = NULL, nb = 0, len = 0;
+	BUN lo, hi, ihi, npos = 0, *pos = NULL;
+	uint8_t *counts = NULL;
+	const uint64_t *offsets;
+	const uint8_t *post;
+
+	TRC_DEBUG_IF(ACCELERATOR) t0 = GDKusec();
+
+	if (ATOMstorage(b->ttype) != TYPE_str || BATcount(b) == 0 || slack < 0)
+		return NULL;
+	for (int i = 0; i < nq; i++)
+		len += strlen(q[i]);
+	if (len < 3)
+		return NULL;
+
+	if (VIEWtparent(b)) {
+		pb = BATdescriptor(VIEWtparent(b));
+		if (pb == NULL) {
+			GDKclrerr();
+			return NULL;
+		}
+	} else {
+		pb = b;
+	}
+	MT_lock_set(&pb->batIdxLock);
+	if ((t = trigram_get(pb)) != NULL)
+		TRGMincref(t);
+	MT_lock_unset(&pb->batIdxLock);
+	if (t == NULL) {
+		if (pb != b)
+			BBPunfix(pb->batCacheid);
+		return NULL;
+	}
+
+	/* the distinct buckets of the query strings */
+	if ((buckets = GDKmalloc(len * sizeof(size_t))) == NULL)
+		goto bailout;
+	for (int i = 0; i < nq; i++)
+		for (const uint8_t *p = (const uint8_t *) q[i]; p[0] && p[1] && p[2]; p++)
+			buckets[nb++] = trigram_bucket(p[0], p[1], p[2]);
+	qsort(buckets, nb, sizeof(size_t), trigram_cmp);
+	len = nb;
+	nb = 0;
+	for (size_t i = 0; i < len; i++)
+		if (nb == 0 || buckets[nb - 1] != buckets[i])
+			buckets[nb++] = buckets[i];
+	if (nb <= (size_t) slack) {
+		GDKfree(buckets);
+		TRGMdecref(t, false);
+		if (pb != b)
+			BBPunfix(pb->batCacheid);
+		return NULL;
+	}
+
+	/* start with the shortest posting lists */
+	offsets = trigram_offsets(t);
+	post = trigram_postings(t);
+	for (size_t i = 1; i < nb; i++) {
+		size_t h = buckets[i], j = i;
+		for (; j > 0 && offsets[buckets[j - 1] + 1] - offsets[buckets[j - 1]] > offsets[h + 1] - offsets[h]; j--)
+			buckets[j] = buckets[j - 1];
+		buckets[j] = h;
+	}
+
+	/* the range of parent positions covered by b, split in the
+	 * indexed part [lo, ihi) and the rest [ihi, hi) */
+	lo = (BUN) (b->tbaseoff - pb->tbaseoff);
+	hi = lo + BATcount(b);
+	ihi = MAX(lo, MIN(hi, t->count));
+
+	if (slack == 0 && offsets[buckets[0] + 1] - offsets[buckets[0]] >= t->count / 4) {
+		/* even the rarest trigram is too common to be worth it */
+		GDKfree(buckets);
+		TRGMdecref(t, false);
+		if (pb != b)
+			BBPunfix(pb->batCacheid);
+		return NULL;
+	}
+
+	if (slack == 0) {
+		size_t first = buckets[0];
+		const uint8_t *p = post + offsets[first], *e = post + offsets[first + 1];
+		BUN v = 0, o;
+
+		if (nb > TRIGRAM_MAXLISTS)
+			nb = TRIGRAM_MAXLISTS;
+		if ((pos = GDKmalloc(MAX(1, MIN(ihi - lo, (BUN) (e - p))) * sizeof(BUN))) == NULL)
+			goto bailout;
+		while (p < e) {
+			p = trigram_decode(p, &o);
+			v += o;
+			if (v >= ihi)
+				break;
+			if (v >= lo)
+				pos[npos++] = v;
+			v++;
+		}
+		for (size_t i = 1; i < nb && npos > 0; i++) {
+			size_t h = buckets[i];
+			BUN j = 0, k = 0;
+			/* stop when decoding the list (its part in our
+			 * range) costs more than checking the candidates */
+			if ((double) (offsets[h + 1] - offsets[h]) * (ihi - lo) / t->count > 8.0 * npos) {
+				nb = i;
+				break;
+			}
+			p = post + offsets[h];
+			e = post + offsets[h + 1];
+			v = 0;
+			while (p < e && j < npos) {
+				p = trigram_decode(p, &o);
+				v += o;
+				while (j < npos && pos[j] < v)
+					j++;
+				if (j < npos && pos[j] == v)
+					pos[k++] = pos[j++];
+				v++;
+			}
+			npos = k;
+		}
+	} else {
+		BUN need, n = ihi - lo;
+		uint64_t bytes = 0;
+		size_t used = 0;
+
+		/* count the rarest lists that together are not longer
+		 * than the column; a row that misses at most slack of
+		 * the buckets appears in all but slack of them */
+		while (used < nb && used < 255 &&
+		       bytes + offsets[buckets[used] + 1] - offsets[buckets[used]] < t->count) {
+			bytes += offsets[buckets[used] + 1] - offsets[buckets[used]];
+			used++;
+		}
+		nb = used;
+		if (nb <= (size_t) slack) {
+			GDKfree(buckets);
+			TRGMdecref(t, false);
+			if (pb != b)
+				BBPunfix(pb->batCacheid);
+			return NULL;
+		}
+		need = (BUN) (nb - slack);
+		if ((counts = GDKzalloc(MAX(1, n))) == NULL ||
+		    (pos = GDKmalloc(MAX(1, n) * sizeof(BUN))) == NULL)
+			goto bailout;
+		for (size_t i = 0; i < nb; i++) {
+			size_t h = buckets[i];
+			const uint8_t *p = post + offsets[h], *e = post + offsets[h + 1];
+			BUN v = 0, o;
+			while (p < e) {
+				p = trigram_decode(p, &o);
+				v += o;
+				if (v >= ihi)
+					break;
+				if (v >= lo)
+					counts[v - lo]++;
+				v++;
+			}
+		}
+		for (BUN i = 0; i < n; i++)
+			if (counts[i] >= need)
+				pos[npos++] = i + lo;
+		GDKfree(counts);
+		counts = NULL;
+	}
+
+	/* the candidates: the matching indexed rows followed by all
+	 * rows that are not indexed */
+	if ((bn = COLnew(0, TYPE_oid, npos + (hi - ihi), TRANSIENT)) == NULL)
+		goto bailout;
+	oid *restrict o = Tloc(bn, 0);
+	for (BUN i = 0; i < npos; i++)
+		o[i] = pos[i] - lo + b->hseqbase;
+	for (BUN i = ihi; i < hi; i++)
+		o[npos++] = i - lo + b->hseqbase;
+	BATsetcount(bn, npos);
+	bn->tkey = true;
+	bn->tsorted = true;
+	bn->trevsorted = npos <= 1;
+	bn->tnil = false;
+	bn->tnonil = true;
+	GDKfree(pos);
+	GDKfree(buckets);
+	TRGMdecref(t, false);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	bn = virtualize(bn);
+	if (bn && s) {
+		r = BATintersectcand(bn, s);
+		BBPunfix(bn->batCacheid);
+		bn = r;
+	}
+	TRC_DEBUG(ACCELERATOR, "TRGMfilter(" ALGOBATFMT ",s=" ALGOOPTBATFMT
+		  ",nq=%d,slack=%d)=" ALGOOPTBATFMT " using %zu lists, "
+		  LLFMT " usec\n", ALGOBATPAR(b), ALGOOPTBATPAR(s), nq, slack,
+		  ALGOOPTBATPAR(bn), nb, GDKusec() - t0);
+	return bn;
+
+  bailout:
+	GDKfree(counts);
+	GDKfree(pos);
+	GDKfree(buckets);
+	TRGMdecref(t, false);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	GDKclrerr();
+	return NULL;
+}
+
+void
+TRGMdecref(Trigrams *t, bool remove)
+{
+	if (remove)
+		ATOMIC_OR(&t->heap.refs, HEAPREMOVE);
+	ATOMIC_BASE_TYPE refs = ATOMIC_DEC(&t->heap.refs);
+	if ((refs & HEAPREFS) == 0) {
+		ATOMIC_DESTROY(&t->heap.refs);
+		HEAPfree(&t->heap, (bool) (refs & HEAPREMOVE));
+		GDKfree(t);
+	}
+}
+
+void
+TRGMincref(Trigrams *t)
+{
+	(void) ATOMIC_INC(&t->heap.refs);
+}
+
+void
+TRGMdestroy(BAT *b)
+{
+	if (b && b->ttrigrams) {
+		MT_lock_set(&b->batIdxLock);
+		if (b->ttrigrams == (Trigrams *) 1) {
+			GDKunlink(BBPselectfarm(b->batRole, b->ttype, trigramheap),
+				  BATDIR,
+				  BBP_physical(b->batCacheid),
+				  "ttrigram");
+		} else if (b->ttrigrams != NULL) {
+			TRGMdecref(b->ttrigrams, b->ttrigrams->heap.parentid == b->batCacheid);
+		}
+		b->ttrigrams = NULL;
+		MT_lock_unset(&b->batIdxLock);
+	}
+}
+
+void
+TRGMfree(BAT *b)
+{
+	if (b && b->ttrigrams) {
+		Trigrams *t;
+		MT_lock_set(&b->batIdxLock);
+		if ((t = b->ttrigrams) != NULL && t != (Trigrams *) 1) {
+			if (GDKinmemory(t->heap.farmid) || t->heap.dirty) {
+				/* not (completely) on disk */
+				b->ttrigrams = NULL;
+				TRGMdecref(t, t->heap.parentid == b->batCacheid);
+			} else {
+				b->ttrigrams = t->heap.parentid == b->batCacheid ? (Trigrams *) 1 : NULL;
+				TRGMdecref(t, false);
+			}
+		}
+		MT_lock_unset(&b->batIdxLock);
+	}
+}
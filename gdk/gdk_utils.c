@@ -1644,6 +1644,104 @@ THRinit(void)
 	return 0;
 }
 
+/* a job for GDKparallel */
+struct parallel {
+	GDKpiecefunc func;
+	void *arg;
+	BUN npieces;
+	const QryCtx *qry_ctx;
+	ATOMIC_TYPE next;	/* next piece to be claimed */
+	ATOMIC_TYPE nthreads;	/* threads that have started */
+	ATOMIC_TYPE failed;
+	char err[GDKMAXERRLEN];	/* error of the first failing piece */
+};
+
+static void
+parallel_worker(void *arg)
+{
+	struct parallel *job = arg;
+	int t = (int) ATOMIC_INC(&job->nthreads) - 1;
+	const QryCtx *qc = job->qry_ctx;
+	char *buf = NULL;
+	BUN i;
+
+	if (GDKerrbuf == NULL && (buf = GDKmalloc(GDKMAXERRLEN)) != NULL)
+		GDKsetbuf(buf);
+	while (!ATOMIC_GET(&job->failed) &&
+	       (i = (BUN) ATOMIC_INC(&job->next) - 1) < job->npieces) {
+		/* we only look at the query context here, the thread
+		 * that started the job reports a timeout */
+		if (GDKexiting() || qc->endtime < 0 ||
+		    (qc->endtime > 0 && GDKusec() > qc->endtime)) {
+			ATOMIC_INC(&job->failed);
+			break;
+		}
+		if (job->func(job->arg, t, i) != GDK_SUCCEED) {
+			if (ATOMIC_INC(&job->failed) == 1) {
+				const char *eb = GDKerrbuf;
+				strcpy_len(job->err, eb ? eb : "", sizeof(job->err));
+			}
+			break;
+		}
+	}
+	if (buf) {
+		GDKsetbuf(NULL);
+		GDKfree(buf);
+	}
+}
+
+/* Call func(arg, t, i) for each piece i from 0 up to npieces, in at
+ * most nthreads threads, the calling thread included.  Each thread
+ * claims the next piece when it is done with one.  The threads are
+ * numbered from 0, so that t can select state of their own.  After a
+ * failure, or when the query times out or is interrupted, no more
+ * pieces are started, and GDK_FAIL is returned with the error in the
+ * calling thread. */
+gdk_return
+GDKparallel(const char *name, int nthreads, BUN npieces,
+	    GDKpiecefunc func, void *arg)
+{
+	MT_Id tids[THREADS];
+	int ntids = 0;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+	struct parallel job = {
+		.func = func,
+		.arg = arg,
+		.npieces = npieces,
+		.qry_ctx = qry_ctx ? qry_ctx : &(QryCtx) {.endtime = 0},
+		.next = ATOMIC_VAR_INIT(0),
+		.nthreads = ATOMIC_VAR_INIT(0),
+		.failed = ATOMIC_VAR_INIT(0),
+	};
+
+	if ((BUN) nthreads > npieces)
+		nthreads = (int) npieces;
+	if (nthreads > THREADS)
+		nthreads = THREADS;
+	while (ntids < nthreads - 1) {
+		char tname[MT_NAME_LEN];
+		snprintf(tname, sizeof(tname), "%s%d", name, ntids);
+		if (MT_create_thread(&tids[ntids], parallel_worker, &job, MT_THR_JOINABLE, tname) < 0)
+			break;
+		ntids++;
+	}
+	parallel_worker(&job);
+	for (int t = 0; t < ntids; t++)
+		MT_join_thread(tids[t]);
+
+	if (ATOMIC_GET(&job.failed)) {
+		char *eb = GDKerrbuf;
+		if (job.err[0]) {
+			if (eb && *eb == 0)
+				strcpy_len(eb, job.err, GDKMAXERRLEN);
+		} else if (GDKexiting() || TIMEOUT_TEST(qry_ctx)) {
+			TIMEOUT_ERROR(qry_ctx, __FILE__, __func__, __LINE__);
+		}
+		return GDK_FAIL;
+	}
+	return GDK_SUCCEED;
+}
+
 const char *
 GDKversion(void)
 {
@@ -1987,6 +2085,28 @@ GDKmmap(const char *path, int mode, size_t len)
 	return ret;
 }
 
+/* map part of an external (read-only) file copy-on-write into memory;
+ * the result must be released using GDKmunmap with MMAP_COPY */
+void *
+GDKmmap_range(const char *path, size_t off, size_t len)
+{
+	void *ret;
+
+#ifndef SIZE_CHECK_IN_HEAPS_ONLY
+	if (GDKvm_cursize() + len >= GDK_vm_maxsize &&
+	    !MT_thread_override_limits()) {
+		GDKerror("requested too much virtual memory; memory requested: %zu, memory in use: %zu, virtual memory in use: %zu\n", len, GDKmem_cursize(), GDKvm_cursize());
+		return NULL;
+	}
+#endif
+	ret = MT_mmap_range(path, off, len);
+	if (ret != NULL)
+		heapinc(len);
+	else
+		GDKerror("requesting virtual memory failed; memory requested: %zu, memory in use: %zu, virtual memory in use: %zu\n", len, GDKmem_cursize(), GDKvm_cursize());
+	return ret;
+}
+
 #undef GDKmunmap
 gdk_return
 GDKmunmap(void *addr, int mode, size_t size)
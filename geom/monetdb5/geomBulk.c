@@ -261,6 +261,325 @@ wkbDWithinSelectNoIndex(bat* outid, const bat *bid , const bat *sid, wkb **wkb_c
 	return filterSelectNoIndex(outid,bid,sid,*wkb_const,*distance,*anti,GEOSDistanceWithin_r,"geom.wkbIntersectsSelectNoIndex");
 }
 
+/* Joins of many geometries with many others are done on a grid.  The
+ * right geometries are put in the cells of the grid that their bounding
+ * boxes overlap, and a left geometry is only compared with those in the
+ * cells that its bounding box overlaps, once extended by the distance.
+ * The functions used for joins are all distance tests, and geometries
+ * within the distance of each other have boxes that are, so the result
+ * is the same as that of comparing all pairs.  The left geometries are
+ * cut in chunks that a number of threads claim one at a time, and each
+ * left geometry is compared with its right ones in their order, so the
+ * pairs also come out in the same order. */
+#define GRID_MINPAIRS	((BUN) 1 << 20)	/* smallest join done on a grid */
+#define GRID_CHUNK		1024	/* left geometries per chunk */
+#define GRID_MAXCELLS	((BUN) 1 << 20)
+#define GRID_MAXTHREADS	64
+
+typedef struct {
+	double xmin, ymin, xmax, ymax;
+} gridbox;
+
+typedef struct {
+	BUN *pairs;					/* left and right position, interleaved */
+	BUN npairs, size;
+} gridchunk;
+
+typedef struct {
+	const GEOSGeom *l_geoms, *r_geoms;
+	gridbox *l_boxes, *r_boxes;
+	BUN lcnt, rcnt;
+	double distance;
+	char (*func) (GEOSContextHandle_t handle, const GEOSGeometry *, const GEOSGeometry *, double);
+	/* the grid on the right geometries */
+	double x0, y0, cw, ch;		/* origin and size of the cells */
+	BUN nx, ny;
+	BUN *cells;					/* first entry of each cell */
+	BUN *entries;				/* right geometries by cell */
+	/* the chunks of the left geometries */
+	gridchunk *chunks;
+	BUN nchunks;
+	/* the candidates of the probes of each thread */
+	BUN *stamps[GRID_MAXTHREADS], *cands[GRID_MAXTHREADS];
+} gridjoin;
+
+/* the bounding box of a geometry, empty for nil; false if it has none */
+static bool
+gridBox(const GEOSGeometry *geom, gridbox *box)
+{
+	if (geom == NULL) {
+		*box = (gridbox) {.xmin = 1, .xmax = 0, .ymin = 1, .ymax = 0};
+		return true;
+	}
+	return GEOSGeom_getXMin_r(geoshandle, geom, &box->xmin) == 1 &&
+		GEOSGeom_getYMin_r(geoshandle, geom, &box->ymin) == 1 &&
+		GEOSGeom_getXMax_r(geoshandle, geom, &box->xmax) == 1 &&
+		GEOSGeom_getYMax_r(geoshandle, geom, &box->ymax) == 1;
+}
+
+static inline BUN
+gridCell(double v, double v0, double size, BUN n)
+{
+	double c = floor((v - v0) / size);
+	if (!(c > 0))
+		return 0;
+	if (c >= (double) n)
+		return n - 1;
+	return (BUN) c;
+}
+
+/* put the right geometries in the cells, false if they span so many
+ * cells that the grid is too large */
+static bool
+gridFill(gridjoin *g, BUN *counts)
+{
+	BUN ncells = g->nx * g->ny, total = 0;
+
+	memset(counts, 0, (ncells + 1) * sizeof(BUN));
+	for (BUN j = 0; j < g->rcnt; j++) {
+		const gridbox *b = &g->r_boxes[j];
+		if (b->xmin > b->xmax)
+			continue;
+		BUN x1 = gridCell(b->xmin, g->x0, g->cw, g->nx), x2 = gridCell(b->xmax, g->x0, g->cw, g->nx);
+		BUN y1 = gridCell(b->ymin, g->y0, g->ch, g->ny), y2 = gridCell(b->ymax, g->y0, g->ch, g->ny);
+		total += (x2 - x1 + 1) * (y2 - y1 + 1);
+		if (total > 16 * g->rcnt + ncells)
+			return false;
+		for (BUN y = y1; y <= y2; y++)
+			for (BUN x = x1; x <= x2; x++)
+				counts[y * g->nx + x + 1]++;
+	}
+	for (BUN c = 0; c < ncells; c++)
+		counts[c + 1] += counts[c];
+	if ((g->entries = GDKmalloc(MAX(total, 1) * sizeof(BUN))) == NULL)
+		return true;
+	memcpy(g->cells, counts, (ncells + 1) * sizeof(BUN));
+	for (BUN j = 0; j < g->rcnt; j++) {
+		const gridbox *b = &g->r_boxes[j];
+		if (b->xmin > b->xmax)
+			continue;
+		BUN x1 = gridCell(b->xmin, g->x0, g->cw, g->nx), x2 = gridCell(b->xmax, g->x0, g->cw, g->nx);
+		BUN y1 = gridCell(b->ymin, g->y0, g->ch, g->ny), y2 = gridCell(b->ymax, g->y0, g->ch, g->ny);
+		for (BUN y = y1; y <= y2; y++)
+			for (BUN x = x1; x <= x2; x++)
+				g->entries[counts[y * g->nx + x]++] = j;
+	}
+	return true;
+}
+
+static int
+gridBUNcmp(const void *a, const void *b)
+{
+	BUN x = *(const BUN *) a, y = *(const BUN *) b;
+	return (x > y) - (x < y);
+}
+
+static gdk_return
+gridProbe(gridjoin *g, gridchunk *c, BUN lo, BUN hi, BUN *stamps, BUN *cands)
+{
+	for (BUN i = lo; i < hi; i++) {
+		const gridbox *b = &g->l_boxes[i];
+		BUN ncands = 0;
+
+		if (b->xmin > b->xmax)
+			continue;
+		/* a little extra for rounding errors */
+		double d = g->distance + 1e-9 * (1 + MAX(MAX(fabs(b->xmin), fabs(b->xmax)), MAX(fabs(b->ymin), fabs(b->ymax))));
+		double xmin = b->xmin - d, xmax = b->xmax + d;
+		double ymin = b->ymin - d, ymax = b->ymax + d;
+		BUN x1 = gridCell(xmin, g->x0, g->cw, g->nx), x2 = gridCell(xmax, g->x0, g->cw, g->nx);
+		BUN y1 = gridCell(ymin, g->y0, g->ch, g->ny), y2 = gridCell(ymax, g->y0, g->ch, g->ny);
+		for (BUN y = y1; y <= y2; y++) {
+			for (BUN x = x1; x <= x2; x++) {
+				BUN cell = y * g->nx + x;
+				for (BUN e = g->cells[cell]; e < g->cells[cell + 1]; e++) {
+					BUN j = g->entries[e];
+					const gridbox *rb = &g->r_boxes[j];
+					if (stamps[j] == i + 1 ||
+						rb->xmin > xmax || rb->xmax < xmin ||
+						rb->ymin > ymax || rb->ymax < ymin)
+						continue;
+					stamps[j] = i + 1;
+					cands[ncands++] = j;
+				}
+			}
+		}
+		qsort(cands, ncands, sizeof(BUN), gridBUNcmp);
+		for (BUN k = 0; k < ncands; k++) {
+			if ((*g->func)(geoshandle, g->l_geoms[i], g->r_geoms[cands[k]], g->distance) != 1)
+				continue;
+			if (c->npairs == c->size) {
+				BUN size = c->size == 0 ? 64 : 2 * c->size;
+				BUN *pairs = GDKrealloc(c->pairs, 2 * size * sizeof(BUN));
+				if (pairs == NULL)
+					return GDK_FAIL;
+				c->pairs = pairs;
+				c->size = size;
+			}
+			c->pairs[2 * c->npairs] = i;
+			c->pairs[2 * c->npairs + 1] = cands[k];
+			c->npairs++;
+		}
+	}
+	return GDK_SUCCEED;
+}
+
+/* Probe a chunk, with the buffers of thread t, which are allocated
+ * when it gets its first chunk. */
+static gdk_return
+gridWorker(void *arg, int t, BUN i)
+{
+	gridjoin *g = arg;
+
+	if (g->cands[t] == NULL) {
+		g->stamps[t] = GDKzalloc(MAX(g->rcnt, 1) * sizeof(BUN));
+		g->cands[t] = GDKmalloc(MAX(g->rcnt, 1) * sizeof(BUN));
+		if (g->stamps[t] == NULL || g->cands[t] == NULL)
+			return GDK_FAIL;
+	}
+	return gridProbe(g, &g->chunks[i], i * GRID_CHUNK,
+					 MIN((i + 1) * GRID_CHUNK, g->lcnt), g->stamps[t], g->cands[t]);
+}
+
+/* Join on a grid if that can be done, setting *done. */
+static str
+filterJoinGrid(BAT *lres, BAT *rres, struct canditer *l_ci, struct canditer *r_ci, const GEOSGeom *l_geoms, const GEOSGeom *r_geoms, double distance, char (*func) (GEOSContextHandle_t handle, const GEOSGeometry *, const GEOSGeometry *, double), const char *name, bool *done)
+{
+	gridjoin g = {
+		.l_geoms = l_geoms,
+		.r_geoms = r_geoms,
+		.lcnt = l_ci->ncand,
+		.rcnt = r_ci->ncand,
+		.distance = distance,
+		.func = func,
+	};
+	BUN *counts = NULL, n = 0;
+	double xmin = GDK_dbl_max, ymin = GDK_dbl_max, xmax = -GDK_dbl_max, ymax = -GDK_dbl_max;
+	int srid = 0;
+	bool have_srid = false;
+	int nthreads = GDKnr_threads;
+	str msg = MAL_SUCCEED;
+
+	*done = false;
+	if (g.lcnt == 0 || g.rcnt == 0 || g.lcnt * g.rcnt < GRID_MINPAIRS ||
+		is_dbl_nil(distance) || distance < 0)
+		return MAL_SUCCEED;
+	if ((g.l_boxes = GDKmalloc(g.lcnt * sizeof(gridbox))) == NULL ||
+		(g.r_boxes = GDKmalloc(g.rcnt * sizeof(gridbox))) == NULL) {
+		msg = createException(MAL, name, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	/* geometries without a box, or of different SRIDs (an error),
+	 * are left to the nested loop */
+	for (BUN i = 0; i < g.lcnt + g.rcnt; i++) {
+		const GEOSGeometry *geom = i < g.lcnt ? l_geoms[i] : r_geoms[i - g.lcnt];
+		gridbox *box = i < g.lcnt ? &g.l_boxes[i] : &g.r_boxes[i - g.lcnt];
+		if (!gridBox(geom, box))
+			goto bailout;
+		if (geom == NULL)
+			continue;
+		if (!have_srid) {
+			srid = GEOSGetSRID_r(geoshandle, geom);
+			have_srid = true;
+		} else if (GEOSGetSRID_r(geoshandle, geom) != srid)
+			goto bailout;
+		if (i >= g.lcnt) {
+			xmin = MIN(xmin, box->xmin);
+			ymin = MIN(ymin, box->ymin);
+			xmax = MAX(xmax, box->xmax);
+			ymax = MAX(ymax, box->ymax);
+		}
+	}
+	*done = true;
+	if (xmin > xmax)
+		goto bailout;			/* all right geometries are nil */
+
+	/* about one right geometry per cell, in the shape of their extent */
+	BUN ncells = MIN(g.rcnt, GRID_MAXCELLS);
+	if (xmax > xmin && ymax > ymin) {
+		double nx = sqrt((double) ncells * (xmax - xmin) / (ymax - ymin));
+		g.nx = nx < 1 ? 1 : nx > (double) ncells ? ncells : (BUN) nx;
+		g.ny = MAX(ncells / g.nx, 1);
+	} else if (xmax > xmin) {
+		g.nx = ncells;
+		g.ny = 1;
+	} else {
+		g.nx = 1;
+		g.ny = ymax > ymin ? ncells : 1;
+	}
+	if ((g.cells = GDKmalloc((g.nx * g.ny + 1) * sizeof(BUN))) == NULL ||
+		(counts = GDKmalloc((g.nx * g.ny + 1) * sizeof(BUN))) == NULL) {
+		msg = createException(MAL, name, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	for (;;) {
+		g.x0 = xmin;
+		g.y0 = ymin;
+		g.cw = xmax > xmin ? (xmax - xmin) / g.nx : 1;
+		g.ch = ymax > ymin ? (ymax - ymin) / g.ny : 1;
+		if (gridFill(&g, counts))
+			break;
+		/* the boxes are large compared to the cells */
+		g.nx = (g.nx + 1) / 2;
+		g.ny = (g.ny + 1) / 2;
+	}
+	if (g.entries == NULL) {
+		msg = createException(MAL, name, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+
+	g.nchunks = (g.lcnt + GRID_CHUNK - 1) / GRID_CHUNK;
+	if ((g.chunks = GDKzalloc(g.nchunks * sizeof(gridchunk))) == NULL) {
+		msg = createException(MAL, name, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	if (nthreads > GRID_MAXTHREADS)
+		nthreads = GRID_MAXTHREADS;
+	if (GDKparallel("gridjoin", nthreads, g.nchunks, gridWorker, &g) != GDK_SUCCEED) {
+		msg = createException(MAL, name, GDK_EXCEPTION);
+		goto bailout;
+	}
+
+	for (BUN i = 0; i < g.nchunks; i++)
+		n += g.chunks[i].npairs;
+	if (BATextend(lres, BATcount(lres) + n) != GDK_SUCCEED ||
+		BATextend(rres, BATcount(rres) + n) != GDK_SUCCEED) {
+		msg = createException(MAL, name, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	oid *lo = Tloc(lres, BATcount(lres)), *ro = Tloc(rres, BATcount(rres));
+	for (BUN i = 0; i < g.nchunks; i++) {
+		const BUN *p = g.chunks[i].pairs;
+		for (BUN j = 0; j < g.chunks[i].npairs; j++, p += 2) {
+			*lo++ = canditer_idx(l_ci, p[0]);
+			*ro++ = canditer_idx(r_ci, p[1]);
+		}
+	}
+	BATsetcount(lres, BATcount(lres) + n);
+	BATsetcount(rres, BATcount(rres) + n);
+	lres->tsorted = lres->trevsorted = lres->tkey = false;
+	rres->tsorted = rres->trevsorted = rres->tkey = false;
+	lres->tnil = rres->tnil = false;
+	lres->tnonil = rres->tnonil = true;
+
+  bailout:
+	for (int t = 0; t < GRID_MAXTHREADS; t++) {
+		GDKfree(g.stamps[t]);
+		GDKfree(g.cands[t]);
+	}
+	if (g.chunks) {
+		for (BUN i = 0; i < g.nchunks; i++)
+			GDKfree(g.chunks[i].pairs);
+		GDKfree(g.chunks);
+	}
+	GDKfree(g.l_boxes);
+	GDKfree(g.r_boxes);
+	GDKfree(g.cells);
+	GDKfree(g.entries);
+	GDKfree(counts);
+	return msg;
+}
+
 static str
 filterJoinNoIndex(bat *lres_id, bat *rres_id, const bat *l_id, const bat *r_id, double double_flag, const bat *ls_id, const bat *rs_id, bit nil_matches, lng estimate, bit anti, char (*func) (GEOSContextHandle_t handle, const GEOSGeometry *, const GEOSGeometry *, double), const char *name)
 {
@@ -330,6 +649,19 @@ filterJoinNoIndex(bat *lres_id, bat *rres_id, const bat *l_id, const bat *r_id,
 		r_geoms[j] = wkb2geos((const wkb*)BUNtvar(r_iter, r_oid - r->hseqbase));
 	}
 
+	if (!anti && !nil_matches) {
+		bool done;
+		canditer_reset(&l_ci);
+		canditer_reset(&r_ci);
+		if ((msg = filterJoinGrid(lres, rres, &l_ci, &r_ci, l_geoms, r_geoms, double_flag, func, name, &done)) != MAL_SUCCEED) {
+			bat_iterator_end(&l_iter);
+			bat_iterator_end(&r_iter);
+			goto free;
+		}
+		if (done)
+			goto joined;
+	}
+
 	canditer_reset(&l_ci);
 	for (BUN i = 0; i < l_ci.ncand; i++) {
 		oid l_oid = canditer_next(&l_ci);
@@ -371,6 +703,7 @@ filterJoinNoIndex(bat *lres_id, bat *rres_id, const bat *l_id, const bat *r_id,
 			}
 		}
 	}
+  joined:
 	if (l_geoms) {
 		for (BUN i = 0; i < l_ci.ncand; i++) {
 			GEOSGeom_destroy_r(geoshandle, l_geoms[i]);
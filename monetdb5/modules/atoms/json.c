@@ -953,30 +953,15 @@ JSONmatch(JSON *jt, int ji, pattern *terms, int ti, bool accumulate)
 	return res;
 }
 
+/* Apply the compiled path expression terms to the parsed document jt. */
 static str
-JSONfilterInternal(json *ret, json *js, str *expr, str other)
+JSONfilterParsed(json *ret, JSON *jt, pattern *terms)
 {
-	pattern terms[MAXTERMS];
 	int tidx = 0;
-	JSON *jt;
-	str j = *js, msg = MAL_SUCCEED, s;
+	str msg = MAL_SUCCEED, s;
 	json result = 0;
 	size_t l;
 
-	(void) other;
-	if (strNil(j)) {
-		*ret = GDKstrdup(j);
-		if (*ret == NULL)
-			throw(MAL, "JSONfilterInternal", SQLSTATE(HY013) MAL_MALLOC_FAIL);
-		return MAL_SUCCEED;
-	}
-	jt = JSONparse(j);
-	CHECK_JSON(jt);
-	memset(terms, 0, sizeof(terms));
-	msg = JSONcompile(*expr, terms);
-	if (msg)
-		goto bailout;
-
 	bool accumulate = terms[tidx].token == ANY_STEP || (terms[tidx].name && terms[tidx].name[0] == '*');
 	result = s = JSONmatch(jt, 0, terms, tidx, accumulate);
 	if (s == (char *) -1) {
@@ -1049,9 +1034,38 @@ JSONfilterInternal(json *ret, json *js, str *expr, str other)
 	*ret = s;
 
   bailout:
-	for (l = 0; l < MAXTERMS; l++)
-		if (terms[l].name)
-			GDKfree(terms[l].name);
+	return msg;
+}
+
+static void
+JSONfreeTerms(pattern *terms)
+{
+	for (int i = 0; i < MAXTERMS; i++)
+		if (terms[i].name)
+			GDKfree(terms[i].name);
+}
+
+static str
+JSONfilterInternal(json *ret, json *js, str *expr, str other)
+{
+	pattern terms[MAXTERMS];
+	JSON *jt;
+	str j = *js, msg;
+
+	(void) other;
+	if (strNil(j)) {
+		*ret = GDKstrdup(j);
+		if (*ret == NULL)
+			throw(MAL, "JSONfilterInternal", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		return MAL_SUCCEED;
+	}
+	jt = JSONparse(j);
+	CHECK_JSON(jt);
+	memset(terms, 0, sizeof(terms));
+	msg = JSONcompile(*expr, terms);
+	if (msg == MAL_SUCCEED)
+		msg = JSONfilterParsed(ret, jt, terms);
+	JSONfreeTerms(terms);
 	JSONfree(jt);
 	return msg;
 }
@@ -1472,21 +1486,30 @@ JSONtoken(JSON *jt, const char *j, const char **next)
 }
 
 
-static JSON *
-JSONparse(const char *j)
+/* Parse j into the (possibly used) tree jt. */
+static void
+JSONparseInto(JSON *jt, const char *j)
 {
-	JSON *jt = JSONnewtree();
-
-	if (jt == NULL)
-		return NULL;
+	memset(jt->elm, 0, jt->free * sizeof(JSONterm));
+	jt->free = 0;
 	skipblancs(j);
 	JSONtoken(jt, j, &j);
 	if (jt->error)
-		return jt;
+		return;
 	skipblancs(j);
 	if (*j)
 		jt->error = createException(MAL, "json.parser",
 									"JSON syntax error: json parse failed");
+}
+
+static JSON *
+JSONparse(const char *j)
+{
+	JSON *jt = JSONnewtree();
+
+	if (jt == NULL)
+		return NULL;
+	JSONparseInto(jt, j);
 	return jt;
 }
 
@@ -1649,6 +1672,99 @@ JSONfilter(json *ret, json *js, str *expr)
 	return JSONfilterInternal(ret, js, expr, 0);
 }
 
+/* Evaluate several path expressions over a column of documents,
+ * parsing each document once: the i-th result holds the matches of
+ * the i-th path expression. */
+static str
+JSONbatfilter(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int n = pci->retc;
+	bat *bid = getArgReference_bat(stk, pci, n);
+	BAT *b, **bn = NULL;
+	BATiter bi;
+	JSON *jt = NULL;
+	pattern *terms = NULL;
+	bool nils = false;
+	str msg = MAL_SUCCEED;
+
+	(void) cntxt;
+	(void) mb;
+	if (pci->argc != 2 * n + 1)
+		throw(MAL, "batjson.filter", SQLSTATE(42000) "Number of path expressions and results differ");
+	if ((b = BATdescriptor(*bid)) == NULL)
+		throw(MAL, "batjson.filter", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	if ((bn = GDKzalloc(n * sizeof(BAT *))) == NULL
+		|| (terms = GDKzalloc(n * MAXTERMS * sizeof(pattern))) == NULL
+		|| (jt = JSONnewtree()) == NULL) {
+		msg = createException(MAL, "batjson.filter", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	for (int i = 0; i < n; i++) {
+		str *expr = getArgReference_str(stk, pci, n + 1 + i);
+		if (strNil(*expr))
+			nils = true;
+		else if ((msg = JSONcompile(*expr, terms + i * MAXTERMS)) != MAL_SUCCEED)
+			goto bailout;
+		if ((bn[i] = COLnew(b->hseqbase, TYPE_json, BATcount(b), TRANSIENT)) == NULL) {
+			msg = createException(MAL, "batjson.filter", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+			goto bailout;
+		}
+	}
+
+	bi = bat_iterator(b);
+	for (BUN p = 0; p < bi.count && msg == MAL_SUCCEED; p++) {
+		const char *j = BUNtvar(bi, p);
+		bool isnil = strNil(j);
+
+		if (!isnil) {
+			JSONparseInto(jt, j);
+			if (jt->error) {
+				msg = jt->error;
+				jt->error = NULL;
+				break;
+			}
+		}
+		for (int i = 0; i < n; i++) {
+			str r = NULL;
+			if (isnil || strNil(*getArgReference_str(stk, pci, n + 1 + i))) {
+				if (BUNappend(bn[i], str_nil, false) != GDK_SUCCEED)
+					msg = createException(MAL, "batjson.filter", GDK_EXCEPTION);
+			} else if ((msg = JSONfilterParsed(&r, jt, terms + i * MAXTERMS)) == MAL_SUCCEED) {
+				if (BUNappend(bn[i], r, false) != GDK_SUCCEED)
+					msg = createException(MAL, "batjson.filter", GDK_EXCEPTION);
+				GDKfree(r);
+			}
+			if (msg)
+				break;
+		}
+	}
+	bat_iterator_end(&bi);
+	if (msg == MAL_SUCCEED) {
+		for (int i = 0; i < n; i++) {
+			bn[i]->tnil = false;
+			bn[i]->tnonil = !nils && b->tnonil;
+			*getArgReference_bat(stk, pci, i) = bn[i]->batCacheid;
+			BBPkeepref(bn[i]);
+			bn[i] = NULL;
+		}
+	}
+
+  bailout:
+	if (bn) {
+		for (int i = 0; i < n; i++)
+			BBPreclaim(bn[i]);
+		GDKfree(bn);
+	}
+	if (terms) {
+		for (int i = 0; i < n; i++)
+			JSONfreeTerms(terms + i * MAXTERMS);
+		GDKfree(terms);
+	}
+	JSONfree(jt);
+	BBPunfix(b->batCacheid);
+	return msg;
+}
+
 // glue all values together with an optional separator
 // The json string should be valid
 
@@ -3208,6 +3324,7 @@ static mel_func json_init_funcs[] = {
  command("json", "filter", JSONfilterArray_hge, false, "", args(1,3, arg("",json),arg("name",json),arg("idx",hge))),
  command("json", "filter", JSONfilterArrayDefault_hge, false, "Extract a single array element", args(1,4, arg("",json),arg("name",json),arg("idx",hge),arg("other",str))),
 #endif
+ pattern("batjson", "filter", JSONbatfilter, false, "Filter the documents of a column by one or more path expressions, parsing each document once.", args(1,3, batvararg("",json),batarg("name",json),vararg("pathexpr",str))),
  command("json", "isobject", JSONisobject, false, "Validate the string as a valid JSON object", args(1,2, arg("",bit),arg("val",json))),
  command("json", "isarray", JSONisarray, false, "Validate the string as a valid JSON array", args(1,2, arg("",bit),arg("val",json))),
  command("json", "isvalid", JSONisvalid, false, "Validate the string as a valid JSON document", args(1,2, arg("",bit),arg("val",str))),
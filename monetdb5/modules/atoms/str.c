@@ -4915,9 +4915,152 @@ STRprefix(str *res, const str *arg1, const int *ll)
 
 str
 str_suffix(str *buf, size_t *buflen, const char *s, int l)
+{
+	int len = UTF8_strlen(s);
+
+	/* a negative start would be counted from the end again */
+	if (l > len)
+		l = len;
+	return str_Sub_String(buf, buflen, s, len - l, l);
+}
+
+/*
+ * Versions of the above for strings that consist of ASCII characters
+ * only, e.g. all strings of a BAT for which BATcheckascii holds.  There
+ * every byte is a codepoint, so positions and lengths are in bytes, and
+ * the loops over the bytes can be vectorized.
+ */
+static inline bool
+ascii_space(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+str
+str_ascii_lower(str *buf, size_t *buflen, const char *s)
+{
+	size_t len = strlen(s);
+
+	CHECK_STR_BUFFER_LENGTH(buf, buflen, len + 1, "str.lower");
+	char *restrict dst = *buf;
+	for (size_t i = 0; i < len; i++)
+		dst[i] = (char) (s[i] + (((unsigned char) (s[i] - 'A') < 26) << 5));
+	dst[len] = 0;
+	return MAL_SUCCEED;
+}
+
+str
+str_ascii_upper(str *buf, size_t *buflen, const char *s)
+{
+	size_t len = strlen(s);
+
+	CHECK_STR_BUFFER_LENGTH(buf, buflen, len + 1, "str.upper");
+	char *restrict dst = *buf;
+	for (size_t i = 0; i < len; i++)
+		dst[i] = (char) (s[i] - (((unsigned char) (s[i] - 'a') < 26) << 5));
+	dst[len] = 0;
+	return MAL_SUCCEED;
+}
+
+static inline str
+ascii_copy(str *buf, size_t *buflen, const char *s, size_t n, const char *malfunc)
+{
+	CHECK_STR_BUFFER_LENGTH(buf, buflen, n + 1, malfunc);
+	memcpy(*buf, s, n);
+	(*buf)[n] = 0;
+	return MAL_SUCCEED;
+}
+
+str
+str_ascii_strip(str *buf, size_t *buflen, const char *s)
+{
+	size_t len = strlen(s);
+
+	while (len > 0 && ascii_space(*s)) {
+		s++;
+		len--;
+	}
+	while (len > 0 && ascii_space(s[len - 1]))
+		len--;
+	return ascii_copy(buf, buflen, s, len, "str.strip");
+}
+
+str
+str_ascii_ltrim(str *buf, size_t *buflen, const char *s)
+{
+	while (ascii_space(*s))
+		s++;
+	return ascii_copy(buf, buflen, s, strlen(s), "str.ltrim");
+}
+
+str
+str_ascii_rtrim(str *buf, size_t *buflen, const char *s)
+{
+	size_t len = strlen(s);
+
+	while (len > 0 && ascii_space(s[len - 1]))
+		len--;
+	return ascii_copy(buf, buflen, s, len, "str.rtrim");
+}
+
+str
+str_ascii_tail(str *buf, size_t *buflen, const char *s, int off)
+{
+	size_t len = strlen(s);
+
+	if (off < 0) {
+		off += (int) len;
+		if (off < 0)
+			off = 0;
+	}
+	if ((size_t) off > len)
+		off = (int) len;
+	return ascii_copy(buf, buflen, s + off, len - off, "str.tail");
+}
+
+str
+str_ascii_Sub_String(str *buf, size_t *buflen, const char *s, int off, int l)
+{
+	size_t len = strlen(s);
+
+	if (off < 0) {
+		off += (int) len;
+		if (off < 0) {
+			l += off;
+			off = 0;
+		}
+	}
+	if (l < 0)
+		l = 0;
+	if ((size_t) off > len)
+		off = (int) len;
+	return ascii_copy(buf, buflen, s + off, MIN((size_t) l, len - off),
+					  "str.substring");
+}
+
+str
+str_ascii_substring_tail(str *buf, size_t *buflen, const char *s, int start)
+{
+	if (start < 1)
+		start = 1;
+	start--;
+	return str_ascii_tail(buf, buflen, s, start);
+}
+
+str
+str_ascii_sub_string(str *buf, size_t *buflen, const char *s, int start, int l)
+{
+	if (start < 1)
+		start = 1;
+	start--;
+	return str_ascii_Sub_String(buf, buflen, s, start, l);
+}
+
+str
+str_ascii_suffix(str *buf, size_t *buflen, const char *s, int l)
 {
 	int start = (int) (strlen(s) - l);
-	return str_Sub_String(buf, buflen, s, start, l);
+	return str_ascii_Sub_String(buf, buflen, s, start, l);
 }
 
 static str
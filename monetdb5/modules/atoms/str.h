@@ -185,6 +185,31 @@ extern str str_suffix(str *buf, size_t *buflen, const char *s, int l)
 extern str str_repeat(str *buf, size_t *buflen, const char *s, int c)
 		__attribute__((__visibility__("hidden")));
 
+/* For strings of ASCII characters only */
+extern str str_ascii_lower(str *buf, size_t *buflen, const char *s)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_upper(str *buf, size_t *buflen, const char *s)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_strip(str *buf, size_t *buflen, const char *s)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_ltrim(str *buf, size_t *buflen, const char *s)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_rtrim(str *buf, size_t *buflen, const char *s)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_tail(str *buf, size_t *buflen, const char *s, int off)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_Sub_String(str *buf, size_t *buflen, const char *s,
+								int off, int l)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_substring_tail(str *buf, size_t *buflen, const char *s,
+									int start)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_sub_string(str *buf, size_t *buflen, const char *s,
+								int start, int l)
+		__attribute__((__visibility__("hidden")));
+extern str str_ascii_suffix(str *buf, size_t *buflen, const char *s, int l)
+		__attribute__((__visibility__("hidden")));
+
 extern str str_case_hash_lock(bool upper)
 		__attribute__((__visibility__("hidden")));
 extern void str_case_hash_unlock(bool upper)
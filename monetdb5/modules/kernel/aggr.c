@@ -1107,6 +1107,115 @@ AGGRsubquantilecand_avg(bat *retval, const bat *bid, const bat *quantile,
 					   quantile, "aggr.subquantile_avg");
 }
 
+static str
+AGGRapprox_count_distinct(lng *retval, const bat *bid)
+{
+	str err;
+	bat rval;
+	if ((err = AGGRgrouped(&rval, NULL, bid, NULL, NULL, NULL, true,
+						   0, TYPE_lng, BATgroupapprox_count_distinct, NULL,
+						   NULL, NULL,
+						   "aggr.approx_count_distinct")) == MAL_SUCCEED) {
+		oid pos = 0;
+		err = ALGfetchoid(retval, &rval, &pos);
+		BBPrelease(rval);
+	}
+	return err;
+}
+
+static str
+AGGRsubapprox_count_distinct(bat *retval, const bat *bid, const bat *gid,
+							 const bat *eid, const bit *skip_nils)
+{
+	return AGGRgrouped(retval, NULL, bid, gid, eid, NULL, *skip_nils,
+					   0, TYPE_lng, BATgroupapprox_count_distinct, NULL,
+					   NULL, NULL, "aggr.subapprox_count_distinct");
+}
+
+static str
+AGGRsubapprox_count_distinctcand(bat *retval, const bat *bid, const bat *gid,
+								 const bat *eid, const bat *sid,
+								 const bit *skip_nils)
+{
+	return AGGRgrouped(retval, NULL, bid, gid, eid, sid, *skip_nils,
+					   0, TYPE_lng, BATgroupapprox_count_distinct, NULL,
+					   NULL, NULL, "aggr.subapprox_count_distinct");
+}
+
+static str
+AGGRhll_sketch(blob **retval, const bat *bid)
+{
+	str err;
+	bat rval;
+	if ((err = AGGRgrouped(&rval, NULL, bid, NULL, NULL, NULL, true,
+						   0, TYPE_blob, BATgrouphll, NULL,
+						   NULL, NULL, "aggr.hll_sketch")) == MAL_SUCCEED) {
+		oid pos = 0;
+		err = ALGfetchoid(retval, &rval, &pos);
+		BBPrelease(rval);
+	}
+	return err;
+}
+
+static str
+AGGRsubhll_sketch(bat *retval, const bat *bid, const bat *gid, const bat *eid,
+				  const bit *skip_nils)
+{
+	return AGGRgrouped(retval, NULL, bid, gid, eid, NULL, *skip_nils,
+					   0, TYPE_blob, BATgrouphll, NULL,
+					   NULL, NULL, "aggr.subhll_sketch");
+}
+
+static str
+AGGRsubhll_sketchcand(bat *retval, const bat *bid, const bat *gid,
+					  const bat *eid, const bat *sid, const bit *skip_nils)
+{
+	return AGGRgrouped(retval, NULL, bid, gid, eid, sid, *skip_nils,
+					   0, TYPE_blob, BATgrouphll, NULL,
+					   NULL, NULL, "aggr.subhll_sketch");
+}
+
+static str
+AGGRhll_merge(blob **retval, const bat *bid)
+{
+	str err;
+	bat rval;
+	if ((err = AGGRgrouped(&rval, NULL, bid, NULL, NULL, NULL, true,
+						   0, TYPE_blob, BATgrouphllmerge, NULL,
+						   NULL, NULL, "aggr.hll_merge")) == MAL_SUCCEED) {
+		oid pos = 0;
+		err = ALGfetchoid(retval, &rval, &pos);
+		BBPrelease(rval);
+	}
+	return err;
+}
+
+static str
+AGGRsubhll_merge(bat *retval, const bat *bid, const bat *gid, const bat *eid,
+				 const bit *skip_nils)
+{
+	return AGGRgrouped(retval, NULL, bid, gid, eid, NULL, *skip_nils,
+					   0, TYPE_blob, BATgrouphllmerge, NULL,
+					   NULL, NULL, "aggr.subhll_merge");
+}
+
+static str
+AGGRsubhll_mergecand(bat *retval, const bat *bid, const bat *gid,
+					 const bat *eid, const bat *sid, const bit *skip_nils)
+{
+	return AGGRgrouped(retval, NULL, bid, gid, eid, sid, *skip_nils,
+					   0, TYPE_blob, BATgrouphllmerge, NULL,
+					   NULL, NULL, "aggr.subhll_merge");
+}
+
+static str
+AGGRhll_estimate(lng *retval, const blob *const *sketch)
+{
+	if (HLLestimate(retval, *sketch) != GDK_SUCCEED)
+		throw(MAL, "aggr.hll_estimate", GDK_EXCEPTION);
+	return MAL_SUCCEED;
+}
+
 static str
 AGGRgroup_str_concat(bat *retval1, const bat *bid, const bat *gid,
 					 const bat *eid, const bat *sid, bool skip_nils,
@@ -1633,6 +1742,16 @@ mel_func aggr_init_funcs[] = {
  command("aggr", "quantile_avg", AGGRquantile_avg_cst, false, "Quantile aggregate", args(1,3, arg("",dbl),batargany("b",1),arg("q",dbl))),
  command("aggr", "subquantile_avg", AGGRsubquantile_avg, false, "Grouped quantile aggregate", args(1,6, batarg("",dbl),batargany("b",1),batarg("q",dbl),batarg("g",oid),batargany("e",2),arg("skip_nils",bit))),
  command("aggr", "subquantile_avg", AGGRsubquantilecand_avg, false, "Grouped quantile aggregate with candidate list", args(1,7, batarg("",dbl),batargany("b",1),batarg("q",dbl),batarg("g",oid),batargany("e",2),batarg("s",oid),arg("skip_nils",bit))),
+ command("aggr", "approx_count_distinct", AGGRapprox_count_distinct, false, "Approximate number of distinct values", args(1,2, arg("",lng),batargany("b",1))),
+ command("aggr", "subapprox_count_distinct", AGGRsubapprox_count_distinct, false, "Grouped approximate number of distinct values", args(1,5, batarg("",lng),batargany("b",1),batarg("g",oid),batargany("e",2),arg("skip_nils",bit))),
+ command("aggr", "subapprox_count_distinct", AGGRsubapprox_count_distinctcand, false, "Grouped approximate number of distinct values with candidate list", args(1,6, batarg("",lng),batargany("b",1),batarg("g",oid),batargany("e",2),batarg("s",oid),arg("skip_nils",bit))),
+ command("aggr", "hll_sketch", AGGRhll_sketch, false, "HyperLogLog sketch of the distinct values", args(1,2, arg("",blob),batargany("b",1))),
+ command("aggr", "subhll_sketch", AGGRsubhll_sketch, false, "Grouped HyperLogLog sketch of the distinct values", args(1,5, batarg("",blob),batargany("b",1),batarg("g",oid),batargany("e",2),arg("skip_nils",bit))),
+ command("aggr", "subhll_sketch", AGGRsubhll_sketchcand, false, "Grouped HyperLogLog sketch of the distinct values with candidate list", args(1,6, batarg("",blob),batargany("b",1),batarg("g",oid),batargany("e",2),batarg("s",oid),arg("skip_nils",bit))),
+ command("aggr", "hll_merge", AGGRhll_merge, false, "Merge HyperLogLog sketches", args(1,2, arg("",blob),batarg("b",blob))),
+ command("aggr", "subhll_merge", AGGRsubhll_merge, false, "Grouped merge of HyperLogLog sketches", args(1,5, batarg("",blob),batarg("b",blob),batarg("g",oid),batargany("e",1),arg("skip_nils",bit))),
+ command("aggr", "subhll_merge", AGGRsubhll_mergecand, false, "Grouped merge of HyperLogLog sketches with candidate list", args(1,6, batarg("",blob),batarg("b",blob),batarg("g",oid),batargany("e",1),batarg("s",oid),arg("skip_nils",bit))),
+ command("aggr", "hll_estimate", AGGRhll_estimate, false, "Approximate number of distinct values in a HyperLogLog sketch", args(1,2, arg("",lng),arg("s",blob))),
  command("aggr", "str_group_concat", AGGRstr_group_concat, false, "Grouped string tail concat", args(1,4, batarg("",str),batarg("b",str),batarg("g",oid),batargany("e",1))),
  command("aggr", "substr_group_concat", AGGRsubstr_group_concat, false, "Grouped string concat", args(1,5, batarg("",str),batarg("b",str),batarg("g",oid),batargany("e",1),arg("skip_nils",bit))),
  command("aggr", "substr_group_concat", AGGRsubstr_group_concatcand, false, "Grouped string concat with candidates list", args(1,6, batarg("",str),batarg("b",str),batarg("g",oid),batargany("e",1),batarg("s",oid),arg("skip_nils",bit))),
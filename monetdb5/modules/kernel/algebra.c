@@ -256,41 +256,38 @@ ALGcard(lng *result, const bat *bid)
 	return MAL_SUCCEED;
 }
 
-static str
-ALGselect2(bat *result, const bat *bid, const bat *sid, const void *low,
-		   const void *high, const bit *li, const bit *hi, const bit *anti)
+/* The common part of the algebra.select variants: dereference string
+ * bounds, apply the nil semantics requested by unknown and select. */
+BAT *
+ALGselectbat(BAT *b, BAT *s, const void *low, const void *high, bit li,
+			 bit hi, bit anti, bit unknown)
 {
-	BAT *b, *s = NULL, *bn;
 	const void *nilptr;
 
-	if ((*li != 0 && *li != 1) ||
-		(*hi != 0 && *hi != 1) || (*anti != 0 && *anti != 1)) {
-		throw(MAL, "algebra.select", ILLEGAL_ARGUMENT);
-	}
-	if ((b = BATdescriptor(*bid)) == NULL) {
-		throw(MAL, "algebra.select", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
-	}
-	if (sid && !is_bat_nil(*sid) && (s = BATdescriptor(*sid)) == NULL) {
-		BBPunfix(b->batCacheid);
-		throw(MAL, "algebra.select", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
-	}
 	derefStr(b, low);
 	derefStr(b, high);
 	nilptr = ATOMnilptr(b->ttype);
-	if (*li == 1 && *hi == 1 && nilptr != NULL &&
-		ATOMcmp(b->ttype, low, nilptr) == 0 &&
-		ATOMcmp(b->ttype, high, nilptr) == 0) {
-		/* special case: equi-select for NIL */
-		high = NULL;
+	if (!unknown) {
+		if (li == 1 && hi == 1 && nilptr != NULL &&
+			ATOMcmp(b->ttype, low, nilptr) == 0 &&
+			ATOMcmp(b->ttype, high, nilptr) == 0) {
+			/* special case: equi-select for NIL */
+			high = NULL;
+		}
+	} else if (!anti && nilptr) {
+		/* here we don't need open ended parts with nil */
+		if (li == 1 && ATOMcmp(b->ttype, low, nilptr) == 0) {
+			low = high;
+			li = 0;
+		}
+		if (hi == 1 && ATOMcmp(b->ttype, high, nilptr) == 0) {
+			high = low;
+			hi = 0;
+		}
+		if (ATOMcmp(b->ttype, low, high) == 0 && ATOMcmp(b->ttype, high, nilptr) == 0)	/* ugh sql nil != nil */
+			anti = 1;
 	}
-	bn = BATselect(b, s, low, high, *li, *hi, *anti);
-	BBPunfix(b->batCacheid);
-	BBPreclaim(s);
-	if (bn == NULL)
-		throw(MAL, "algebra.select", GDK_EXCEPTION);
-	*result = bn->batCacheid;
-	BBPkeepref(bn);
-	return MAL_SUCCEED;
+	return BATselect(b, s, low, high, li, hi, anti);
 }
 
 static str
@@ -299,13 +296,9 @@ ALGselect2nil(bat *result, const bat *bid, const bat *sid, const void *low,
 			  const bit *unknown)
 {
 	BAT *b, *s = NULL, *bn;
-	bit nanti = *anti, nli = *li, nhi = *hi;
-
-	if (!*unknown)
-		return ALGselect2(result, bid, sid, low, high, li, hi, anti);
 
-	if ((nli != 0 && nli != 1) ||
-		(nhi != 0 && nhi != 1) || (nanti != 0 && nanti != 1)) {
+	if ((*li != 0 && *li != 1) ||
+		(*hi != 0 && *hi != 1) || (*anti != 0 && *anti != 1)) {
 		throw(MAL, "algebra.select", ILLEGAL_ARGUMENT);
 	}
 	if ((b = BATdescriptor(*bid)) == NULL) {
@@ -315,26 +308,7 @@ ALGselect2nil(bat *result, const bat *bid, const bat *sid, const void *low,
 		BBPunfix(b->batCacheid);
 		throw(MAL, "algebra.select", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
 	}
-	derefStr(b, low);
-	derefStr(b, high);
-	/* here we don't need open ended parts with nil */
-	if (!nanti) {
-		const void *nilptr = ATOMnilptr(b->ttype);
-		if (nilptr) {
-			if (nli == 1 && ATOMcmp(b->ttype, low, nilptr) == 0) {
-				low = high;
-				nli = 0;
-			}
-			if (nhi == 1 && ATOMcmp(b->ttype, high, nilptr) == 0) {
-				high = low;
-				nhi = 0;
-			}
-			if (ATOMcmp(b->ttype, low, high) == 0 && ATOMcmp(b->ttype, high, nilptr) == 0)	/* ugh sql nil != nil */
-				nanti = 1;
-		}
-	}
-
-	bn = BATselect(b, s, low, high, nli, nhi, nanti);
+	bn = ALGselectbat(b, s, low, high, *li, *hi, *anti, *unknown);
 	BBPunfix(b->batCacheid);
 	BBPreclaim(s);
 	if (bn == NULL)
@@ -344,6 +318,14 @@ ALGselect2nil(bat *result, const bat *bid, const bat *sid, const void *low,
 	return MAL_SUCCEED;
 }
 
+static str
+ALGselect2(bat *result, const bat *bid, const bat *sid, const void *low,
+		   const void *high, const bit *li, const bit *hi, const bit *anti)
+{
+	return ALGselect2nil(result, bid, sid, low, high, li, hi, anti,
+						 &(bit) { 0 });
+}
+
 static str
 ALGselect1(bat *result, const bat *bid, const void *low, const void *high,
 		   const bit *li, const bit *hi, const bit *anti)
@@ -358,6 +340,13 @@ ALGselect1nil(bat *result, const bat *bid, const void *low, const void *high,
 	return ALGselect2nil(result, bid, NULL, low, high, li, hi, anti, unknown);
 }
 
+BAT *
+ALGthetaselectbat(BAT *b, BAT *s, const void *val, const char *op)
+{
+	derefStr(b, val);
+	return BATthetaselect(b, s, val, op);
+}
+
 static str
 ALGthetaselect2(bat *result, const bat *bid, const bat *sid, const void *val,
 				const char **op)
@@ -373,8 +362,7 @@ ALGthetaselect2(bat *result, const bat *bid, const bat *sid, const void *val,
 		throw(MAL, "algebra.thetaselect",
 			  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
 	}
-	derefStr(b, val);
-	bn = BATthetaselect(b, s, val, *op);
+	bn = ALGthetaselectbat(b, s, val, *op);
 	BBPunfix(b->batCacheid);
 	BBPreclaim(s);
 	if (bn == NULL)
@@ -384,6 +372,65 @@ ALGthetaselect2(bat *result, const bat *bid, const bat *sid, const void *val,
 	return MAL_SUCCEED;
 }
 
+static str
+ALGbloom(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	bat *ret = getArgReference_bat(stk, pci, 0);
+	bat bid = *getArgReference_bat(stk, pci, 3);
+	bat *sid = getArgReference_bat(stk, pci, 4);
+	ValRecord mn, mx;
+	BAT *b, *s = NULL, *bn;
+
+	(void) cntxt;
+	if ((b = BATdescriptor(bid)) == NULL)
+		throw(MAL, "algebra.bloom", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	if (!is_bat_nil(*sid) && (s = BATdescriptor(*sid)) == NULL) {
+		BBPunfix(b->batCacheid);
+		throw(MAL, "algebra.bloom", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	bn = BATbloom(b, s, &mn.val, &mx.val);
+	BBPunfix(b->batCacheid);
+	BBPreclaim(s);
+	if (bn == NULL)
+		throw(MAL, "algebra.bloom", GDK_EXCEPTION);
+	if (VALinit(&stk->stk[getArg(pci, 1)], getArgType(mb, pci, 1), &mn.val) == NULL ||
+		VALinit(&stk->stk[getArg(pci, 2)], getArgType(mb, pci, 2), &mx.val) == NULL) {
+		BBPreclaim(bn);
+		throw(MAL, "algebra.bloom", GDK_EXCEPTION);
+	}
+	*ret = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
+static str
+ALGbloomselect(bat *result, const bat *bid, const bat *sid, const bat *fid,
+			   const void *min, const void *max)
+{
+	BAT *b, *s = NULL, *f, *bn;
+
+	if ((b = BATdescriptor(*bid)) == NULL)
+		throw(MAL, "algebra.bloomselect", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	if ((f = BATdescriptor(*fid)) == NULL) {
+		BBPunfix(b->batCacheid);
+		throw(MAL, "algebra.bloomselect", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	if (sid && !is_bat_nil(*sid) && (s = BATdescriptor(*sid)) == NULL) {
+		BBPunfix(b->batCacheid);
+		BBPunfix(f->batCacheid);
+		throw(MAL, "algebra.bloomselect", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	bn = BATbloomselect(b, s, f, min, max);
+	BBPunfix(b->batCacheid);
+	BBPunfix(f->batCacheid);
+	BBPreclaim(s);
+	if (bn == NULL)
+		throw(MAL, "algebra.bloomselect", GDK_EXCEPTION);
+	*result = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
 static str
 ALGmarkselect(bat *r1, bat *r2, const bat *gid, const bat *mid, const bat *pid, const bit *Any)
 {
@@ -1013,6 +1060,52 @@ ALGfirstn(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return MAL_SUCCEED;
 }
 
+static str
+ALGfirstnbound(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int nb = pci->retc;
+	BAT **b, **bn;
+	lng n;
+	bit asc, nilslast;
+	str msg = MAL_SUCCEED;
+
+	(void) cntxt;
+	(void) mb;
+
+	if (pci->argc != 2 * nb + 3)
+		throw(MAL, "algebra.firstnbound", SQLSTATE(42000) "Number of pieces and results differ");
+	n = *getArgReference_lng(stk, pci, nb);
+	asc = *getArgReference_bit(stk, pci, nb + 1);
+	nilslast = *getArgReference_bit(stk, pci, nb + 2);
+	if (n < 0)
+		throw(MAL, "algebra.firstnbound", ILLEGAL_ARGUMENT);
+	if (n > (lng) BUN_MAX)
+		n = BUN_MAX;
+	if ((b = GDKzalloc(2 * nb * sizeof(BAT *))) == NULL)
+		throw(MAL, "algebra.firstnbound", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	bn = b + nb;
+	for (int i = 0; i < nb; i++) {
+		if ((b[i] = BATdescriptor(*getArgReference_bat(stk, pci, nb + 3 + i))) == NULL) {
+			msg = createException(MAL, "algebra.firstnbound",
+								  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+			goto bailout;
+		}
+	}
+	if (BATfirstnbound(bn, b, nb, (BUN) n, asc, nilslast) != GDK_SUCCEED) {
+		msg = createException(MAL, "algebra.firstnbound", GDK_EXCEPTION);
+		goto bailout;
+	}
+	for (int i = 0; i < nb; i++) {
+		*getArgReference_bat(stk, pci, i) = bn[i]->batCacheid;
+		BBPkeepref(bn[i]);
+	}
+  bailout:
+	for (int i = 0; i < nb; i++)
+		BBPreclaim(b[i]);
+	GDKfree(b);
+	return msg;
+}
+
 static str
 ALGunary(bat *result, const bat *bid, BAT *(*func)(BAT *), const char *name)
 {
@@ -1321,6 +1414,23 @@ ALGsort11(bat *result, const bat *bid, const bit *reverse, const bit *nilslast,
 					 stable);
 }
 
+lng
+ALGcountbat(BAT *b, BAT *s, bool ignore_nils)
+{
+	lng result = 0;
+
+	if (b->ttype == TYPE_msk || mask_cand(b)) {
+		BATsum(&result, TYPE_lng, b, s, ignore_nils, false);
+	} else if (ignore_nils) {
+		result = (lng) BATcount_no_nil(b, s);
+	} else {
+		struct canditer ci;
+		canditer_init(&ci, b, s);
+		result = (lng) ci.ncand;
+	}
+	return result;
+}
+
 static str
 ALGcountCND_nil(lng *result, const bat *bid, const bat *cnd,
 				const bit *ignore_nils)
@@ -1334,15 +1444,7 @@ ALGcountCND_nil(lng *result, const bat *bid, const bat *cnd,
 		BBPunfix(b->batCacheid);
 		throw(MAL, "aggr.count", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
 	}
-	if (b->ttype == TYPE_msk || mask_cand(b)) {
-		BATsum(result, TYPE_lng, b, s, *ignore_nils, false);
-	} else if (*ignore_nils) {
-		*result = (lng) BATcount_no_nil(b, s);
-	} else {
-		struct canditer ci;
-		canditer_init(&ci, b, s);
-		*result = (lng) ci.ncand;
-	}
+	*result = ALGcountbat(b, s, *ignore_nils);
 	BBPreclaim(s);
 	BBPunfix(b->batCacheid);
 	return MAL_SUCCEED;
@@ -1805,6 +1907,8 @@ mel_func algebra_init_funcs[] = {
  command("algebra", "crossproduct", ALGcrossproduct3, false, "Compute the cross product of both input bats", args(2,7, batarg("l",oid),batarg("r",oid),batargany("left",1),batargany("right",2),batarg("sl",oid),batarg("sr",oid),arg("max_one",bit))),
  command("algebra", "crossproduct", ALGcrossproduct4, false, "Compute the cross product of both input bats; but only produce left output", args(1,6, batarg("",oid),batargany("left",1),batargany("right",2),batarg("sl",oid),batarg("sr",oid),arg("max_one",bit))),
  command("algebra", "outercrossproduct", ALGoutercrossproduct3, false, "Compute the outer cross product of both input bats", args(2,7, batarg("l",oid),batarg("r",oid),batargany("left",1),batargany("right",2),batarg("sl",oid),batarg("sr",oid),arg("max_one",bit))),
+ pattern("algebra", "bloom", ALGbloom, false, "Summarize the values of b selected by s in a Bloom filter\nand their minimum and maximum, for use by algebra.bloomselect.", args(3,5, batarg("",lng),argany("min",1),argany("max",1),batargany("b",1),batarg("s",oid))),
+ command("algebra", "bloomselect", ALGbloomselect, false, "Select the candidates of b in s whose value may occur in the\nBloom filter f with bounds min and max.  Values that do occur are\nalways selected, nil values never.", args(1,6, batarg("",oid),batargany("b",1),batarg("s",oid),batarg("f",lng),argany("min",1),argany("max",1))),
  command("algebra", "join", ALGjoin, false, "Join", args(2,8, batarg("",oid),batarg("",oid),batargany("l",1),batargany("r",1),batarg("sl",oid),batarg("sr",oid),arg("nil_matches",bit),arg("estimate",lng))),
  command("algebra", "join", ALGjoin1, false, "Join; only produce left output", args(1,7, batarg("",oid),batargany("l",1),batargany("r",1),batarg("sl",oid),batarg("sr",oid),arg("nil_matches",bit),arg("estimate",lng))),
  command("algebra", "leftjoin", ALGleftjoin, false, "Left join with candidate lists", args(2,8, batarg("",oid),batarg("",oid),batargany("l",1),batargany("r",1),batarg("sl",oid),batarg("sr",oid),arg("nil_matches",bit),arg("estimate",lng))),
@@ -1824,6 +1928,7 @@ mel_func algebra_init_funcs[] = {
  command("algebra", "intersect", ALGintersect, false, "Intersection of l and r with candidate lists (i.e. half of semi-join)", args(1,8, batarg("",oid),batargany("l",1),batargany("r",1),batarg("sl",oid),batarg("sr",oid),arg("nil_matches",bit),arg("max_one",bit),arg("estimate",lng))),
  pattern("algebra", "firstn", ALGfirstn, false, "Calculate first N values of B with candidate list S", args(1,8, batarg("",oid),batargany("b",0),batarg("s",oid),batarg("g",oid),arg("n",lng),arg("asc",bit),arg("nilslast",bit),arg("distinct",bit))),
  pattern("algebra", "firstn", ALGfirstn, false, "Calculate first N values of B with candidate list S", args(2,9, batarg("",oid),batarg("",oid),batargany("b",0),batarg("s",oid),batarg("g",oid),arg("n",lng),arg("asc",bit),arg("nilslast",bit),arg("distinct",bit))),
+ pattern("algebra", "firstnbound", ALGfirstnbound, false, "Calculate first N values of each of the pieces B of a column, skipping\nthe values of a piece that are worse than the N-th value found in others.", args(1,5, batvararg("",oid),arg("n",lng),arg("asc",bit),arg("nilslast",bit),batvarargany("b",1))),
  command("algebra", "reuse", ALGreuse, false, "Reuse a temporary BAT if you can. Otherwise,\nallocate enough storage to accept result of an\noperation (not involving the heap)", args(1,2, batargany("",1),batargany("b",1))),
  command("algebra", "slice", ALGslice_oid, false, "Return the slice based on head oid x till y (exclusive).", args(1,4, batargany("",1),batargany("b",1),arg("x",oid),arg("y",oid))),
  command("algebra", "slice", ALGslice_int, false, "Return the slice with the BUNs at position x till y.", args(1,4, batargany("",1),batargany("b",1),arg("x",int),arg("y",int))),
@@ -19,5 +19,9 @@
 
 extern str ALGprojection(bat *result, const bat *lid, const bat *rid);
 extern str ALGfetchoid(ptr ret, const bat *bid, const oid *pos);
+extern BAT *ALGselectbat(BAT *b, BAT *s, const void *low, const void *high,
+						 bit li, bit hi, bit anti, bit unknown);
+extern BAT *ALGthetaselectbat(BAT *b, BAT *s, const void *val, const char *op);
+extern lng ALGcountbat(BAT *b, BAT *s, bool ignore_nils);
 
 #endif
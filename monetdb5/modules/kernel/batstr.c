@@ -76,9 +76,16 @@ str_prefix(str *buf, size_t *buflen, const char *s, int l)
 	return str_Sub_String(buf, buflen, s, 0, l);
 }
 
+static inline str
+str_ascii_prefix(str *buf, size_t *buflen, const char *s, int l)
+{
+	return str_ascii_Sub_String(buf, buflen, s, 0, l);
+}
+
 static str
 do_batstr_int(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
-			  const char *name, int (*func)(const char *))
+			  const char *name, int (*func)(const char *),
+			  int (*asciifunc)(const char *))
 {
 	BATiter bi;
 	BAT *bn = NULL, *b = NULL, *bs = NULL;
@@ -111,6 +118,8 @@ do_batstr_int(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 
 	off1 = b->hseqbase;
 	bi = bat_iterator(b);
+	if (asciifunc && BATcheckascii(&bi))
+		func = asciifunc;
 	vals = Tloc(bn, 0);
 	if (ci1.tpe == cand_dense) {
 		for (BUN i = 0; i < ci1.ncand; i++) {
@@ -147,13 +156,14 @@ do_batstr_int(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 static str
 STRbatLength(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_int(cntxt, mb, stk, pci, "batstr.length", UTF8_strlen);
+	return do_batstr_int(cntxt, mb, stk, pci, "batstr.length", UTF8_strlen,
+						 str_strlen);
 }
 
 static str
 STRbatBytes(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_int(cntxt, mb, stk, pci, "batstr.bytes", str_strlen);
+	return do_batstr_int(cntxt, mb, stk, pci, "batstr.bytes", str_strlen, NULL);
 }
 
 static str
@@ -418,7 +428,8 @@ STRbatSpace(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 
 static str
 do_batstr_str(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
-			  const char *name, str (*func)(str *, size_t *, const char *))
+			  const char *name, str (*func)(str *, size_t *, const char *),
+			  str (*asciifunc)(str *, size_t *, const char *))
 {
 	BATiter bi;
 	BAT *bn = NULL, *b = NULL, *bs = NULL;
@@ -455,6 +466,8 @@ do_batstr_str(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 
 	off1 = b->hseqbase;
 	bi = bat_iterator(b);
+	if (BATcheckascii(&bi))
+		func = asciifunc;
 	if (ci1.tpe == cand_dense) {
 		for (BUN i = 0; i < ci1.ncand; i++) {
 			oid p1 = (canditer_next_dense(&ci1) - off1);
@@ -1603,7 +1616,8 @@ STRbatLower(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 
 	if ((msg = str_case_hash_lock(false)))
 		return msg;
-	msg = do_batstr_str(cntxt, mb, stk, pci, "batstr.lower", str_lower);
+	msg = do_batstr_str(cntxt, mb, stk, pci, "batstr.lower", str_lower,
+						str_ascii_lower);
 	str_case_hash_unlock(false);
 	return msg;
 }
@@ -1615,7 +1629,8 @@ STRbatUpper(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 
 	if ((msg = str_case_hash_lock(true)))
 		return msg;
-	msg = do_batstr_str(cntxt, mb, stk, pci, "batstr.upper", str_upper);
+	msg = do_batstr_str(cntxt, mb, stk, pci, "batstr.upper", str_upper,
+						str_ascii_upper);
 	str_case_hash_unlock(true);
 	return msg;
 }
@@ -1623,19 +1638,22 @@ STRbatUpper(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 static str
 STRbatStrip(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_str(cntxt, mb, stk, pci, "batstr.strip", str_strip);
+	return do_batstr_str(cntxt, mb, stk, pci, "batstr.strip", str_strip,
+						 str_ascii_strip);
 }
 
 static str
 STRbatLtrim(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_str(cntxt, mb, stk, pci, "batstr.ltrim", str_ltrim);
+	return do_batstr_str(cntxt, mb, stk, pci, "batstr.ltrim", str_ltrim,
+						 str_ascii_ltrim);
 }
 
 static str
 STRbatRtrim(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_str(cntxt, mb, stk, pci, "batstr.rtrim", str_rtrim);
+	return do_batstr_str(cntxt, mb, stk, pci, "batstr.rtrim", str_rtrim,
+						 str_ascii_rtrim);
 }
 
 static str
@@ -2787,7 +2805,8 @@ STRbatWChrAt_strcst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 static str
 do_batstr_str_int_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 					  const char *name, str (*func)(str *, size_t *,
-													const char *, int))
+													const char *, int),
+					  str (*asciifunc)(str *, size_t *, const char *, int))
 {
 	BATiter bi;
 	BAT *bn = NULL, *b = NULL, *bs = NULL;
@@ -2825,6 +2844,8 @@ do_batstr_str_int_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 
 	off1 = b->hseqbase;
 	bi = bat_iterator(b);
+	if (BATcheckascii(&bi))
+		func = asciifunc;
 	if (ci1.tpe == cand_dense) {
 		for (BUN i = 0; i < ci1.ncand; i++) {
 			oid p1 = (canditer_next_dense(&ci1) - off1);
@@ -2883,27 +2904,28 @@ static str
 STRbatprefixcst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
 	return do_batstr_str_int_cst(cntxt, mb, stk, pci, "batstr.prefix",
-								 str_prefix);
+								 str_prefix, str_ascii_prefix);
 }
 
 static str
 STRbatsuffixcst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
 	return do_batstr_str_int_cst(cntxt, mb, stk, pci, "batstr.suffix",
-								 str_suffix);
+								 str_suffix, str_ascii_suffix);
 }
 
 static str
 STRbatTailcst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_str_int_cst(cntxt, mb, stk, pci, "batstr.tail", str_tail);
+	return do_batstr_str_int_cst(cntxt, mb, stk, pci, "batstr.tail", str_tail,
+								 str_ascii_tail);
 }
 
 static str
 STRbatsubstringTailcst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
 	return do_batstr_str_int_cst(cntxt, mb, stk, pci, "batstr.substring",
-								 str_substring_tail);
+								 str_substring_tail, str_ascii_substring_tail);
 }
 
 static str
@@ -3224,7 +3246,8 @@ STRbatrepeat_strcst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 static str
 do_batstr_str_int(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 				  const char *name, str (*func)(str *, size_t *, const char *,
-												int))
+												int),
+				  str (*asciifunc)(str *, size_t *, const char *, int))
 {
 	BATiter lefti;
 	BAT *bn = NULL, *left = NULL, *lefts = NULL, *right = NULL, *rights = NULL;
@@ -3274,6 +3297,8 @@ do_batstr_str_int(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 	off1 = left->hseqbase;
 	off2 = right->hseqbase;
 	lefti = bat_iterator(left);
+	if (BATcheckascii(&lefti))
+		func = asciifunc;
 	bi = bat_iterator(right);
 	righti = bi.base;
 	if (ci1.tpe == cand_dense && ci2.tpe == cand_dense) {
@@ -3338,26 +3363,29 @@ do_batstr_str_int(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 static str
 STRbatprefix(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_str_int(cntxt, mb, stk, pci, "batstr.prefix", str_prefix);
+	return do_batstr_str_int(cntxt, mb, stk, pci, "batstr.prefix", str_prefix,
+							 str_ascii_prefix);
 }
 
 static str
 STRbatsuffix(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_str_int(cntxt, mb, stk, pci, "batstr.suffix", str_suffix);
+	return do_batstr_str_int(cntxt, mb, stk, pci, "batstr.suffix", str_suffix,
+							 str_ascii_suffix);
 }
 
 static str
 STRbatTail(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
-	return do_batstr_str_int(cntxt, mb, stk, pci, "batstr.tail", str_tail);
+	return do_batstr_str_int(cntxt, mb, stk, pci, "batstr.tail", str_tail,
+							 str_ascii_tail);
 }
 
 static str
 STRbatsubstringTail(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
 	return do_batstr_str_int(cntxt, mb, stk, pci, "batstr.substring",
-							 str_substring_tail);
+							 str_substring_tail, str_ascii_substring_tail);
 }
 
 static str
@@ -4591,6 +4619,8 @@ STRbatsubstring_2nd_3rd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 
 	off1 = b->hseqbase;
 	bi = bat_iterator(b);
+	str (*sub)(str *, size_t *, const char *, int, int) =
+		BATcheckascii(&bi) ? str_ascii_sub_string : str_sub_string;
 	if (ci1.tpe == cand_dense) {
 		for (BUN i = 0; i < ci1.ncand; i++) {
 			oid p1 = (canditer_next_dense(&ci1) - off1);
@@ -4604,7 +4634,7 @@ STRbatsubstring_2nd_3rd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -4626,7 +4656,7 @@ STRbatsubstring_2nd_3rd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -5011,6 +5041,8 @@ STRbatsubstring_2nd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	off2 = lb->hseqbase;
 	bi = bat_iterator(b);
 	lbi = bat_iterator(lb);
+	str (*sub)(str *, size_t *, const char *, int, int) =
+		BATcheckascii(&bi) ? str_ascii_sub_string : str_sub_string;
 	len = lbi.base;
 	if (ci1.tpe == cand_dense && ci2.tpe == cand_dense) {
 		for (BUN i = 0; i < ci1.ncand; i++) {
@@ -5027,7 +5059,7 @@ STRbatsubstring_2nd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -5051,7 +5083,7 @@ STRbatsubstring_2nd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -5124,6 +5156,8 @@ STRbatsubstring_3rd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	off2 = lb->hseqbase;
 	bi = bat_iterator(b);
 	lbi = bat_iterator(lb);
+	str (*sub)(str *, size_t *, const char *, int, int) =
+		BATcheckascii(&bi) ? str_ascii_sub_string : str_sub_string;
 	start = lbi.base;
 	if (ci1.tpe == cand_dense && ci2.tpe == cand_dense) {
 		for (BUN i = 0; i < ci1.ncand; i++) {
@@ -5140,7 +5174,7 @@ STRbatsubstring_3rd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -5164,7 +5198,7 @@ STRbatsubstring_3rd_cst(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -5246,6 +5280,8 @@ STRbatsubstring(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	lefti = bat_iterator(left);
 	starti = bat_iterator(start);
 	lengthi = bat_iterator(length);
+	str (*sub)(str *, size_t *, const char *, int, int) =
+		BATcheckascii(&lefti) ? str_ascii_sub_string : str_sub_string;
 	svals = starti.base;
 	lvals = lengthi.base;
 	if (ci1.tpe == cand_dense && ci2.tpe == cand_dense && ci3.tpe == cand_dense) {
@@ -5265,7 +5301,7 @@ STRbatsubstring(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -5291,7 +5327,7 @@ STRbatsubstring(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 				}
 				nils = true;
 			} else {
-				if ((msg = str_sub_string(&buf, &buflen, x, y, z)) != MAL_SUCCEED)
+				if ((msg = (*sub) (&buf, &buflen, x, y, z)) != MAL_SUCCEED)
 					goto bailout1;
 				if (tfastins_nocheckVAR(bn, i, buf) != GDK_SUCCEED) {
 					msg = createException(MAL, "batstr.substring",
@@ -0,0 +1,513 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/*
+ * Fused execution of select/projection/calc chains ending in an
+ * aggregate.
+ *
+ * The fusion optimizer replaces a chain such as
+ *	C1 := algebra.select(X, S, ...);
+ *	C2 := algebra.thetaselect(Y, C1, ...);
+ *	Z1 := algebra.projection(C2, Z);
+ *	W1 := batcalc.*(Z1, 2, nil);
+ *	R  := aggr.sum(W1);
+ * by a single instruction
+ *	R := algebra.fused("select(a,c,a,a,a,a,a);thetaselect(a,$0,a,a);"
+ *			"projection($1,a);*:lng($2,a,a);sum($3)", vectorsize, X, S,
+ *			X, ..., Y, ..., Z, 2, nil);
+ * that runs the chain over vectors of (at most) vectorsize candidates
+ * of the driving input (X and S) and combines the partial aggregates.
+ * The intermediates of each vector are small enough to stay in the
+ * CPU caches, so they are no longer written to and read back from
+ * main memory as full size BATs.
+ *
+ * The operands of a step are encoded as
+ *	a	the next argument of the instruction, used as is
+ *	v	the next argument of the instruction, a BAT that is sliced to
+ *		the positions of the current vector
+ *	c	the candidates of the current vector
+ *	$k	the result of step k
+ * Each step is evaluated with the same GDK function as the instruction
+ * it replaces, so the results are those of the unfused plan.
+ */
+#include "monetdb_config.h"
+#include "algebra.h"
+#include "mal_exception.h"
+
+#define FUSEDMAXOPS 8			/* max number of operands of a step */
+
+enum fusedop {
+	FUSED_SELECT,
+	FUSED_THETASELECT,
+	FUSED_PROJECTION,
+	FUSED_ADD,
+	FUSED_SUB,
+	FUSED_MUL,
+	FUSED_DIV,
+	FUSED_SUM,
+	FUSED_COUNT,
+	FUSED_MIN,
+	FUSED_MAX,
+};
+
+struct fusedarg {
+	char kind;					/* 'a', 'v', 'c' or '$' */
+	int idx;					/* argument index or step number */
+};
+
+struct fusedstep {
+	enum fusedop op;
+	int tpe;					/* result type of calc steps */
+	int nargs;
+	struct fusedarg args[FUSEDMAXOPS];
+};
+
+static const struct {
+	const char *name;
+	enum fusedop op;
+	int minargs, maxargs;
+} fusedops[] = {
+	{"select", FUSED_SELECT, 7, 8},
+	{"thetaselect", FUSED_THETASELECT, 4, 4},
+	{"projection", FUSED_PROJECTION, 2, 2},
+	{"+", FUSED_ADD, 2, 4},
+	{"-", FUSED_SUB, 2, 4},
+	{"*", FUSED_MUL, 2, 4},
+	{"/", FUSED_DIV, 2, 4},
+	{"sum", FUSED_SUM, 1, 2},
+	{"count", FUSED_COUNT, 1, 2},
+	{"min", FUSED_MIN, 1, 2},
+	{"max", FUSED_MAX, 1, 2},
+};
+
+#define isaggr(op)	((op) >= FUSED_SUM)
+#define iscalc(op)	((op) >= FUSED_ADD && (op) <= FUSED_DIV)
+
+/* parse the program into steps, the arguments of the instruction that
+ * are referenced start at position first */
+static str
+fusedparse(const char *prog, struct fusedstep **stepsp, int *nstepsp,
+		   int first, int argc)
+{
+	struct fusedstep *steps;
+	int nsteps = 1, argnr = first;
+	const char *p;
+
+	for (p = prog; *p; p++)
+		nsteps += *p == ';';
+	steps = GDKmalloc(nsteps * sizeof(struct fusedstep));
+	if (steps == NULL)
+		throw(MAL, "algebra.fused", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+
+	p = prog;
+	for (int k = 0; k < nsteps; k++) {
+		struct fusedstep *st = &steps[k];
+		size_t len = strcspn(p, ":(");
+		int i;
+
+		for (i = 0; i < (int) (sizeof(fusedops) / sizeof(fusedops[0])); i++)
+			if (strlen(fusedops[i].name) == len
+				&& strncmp(fusedops[i].name, p, len) == 0)
+				break;
+		if (i == (int) (sizeof(fusedops) / sizeof(fusedops[0])))
+			goto illegal;
+		st->op = fusedops[i].op;
+		st->tpe = TYPE_any;
+		st->nargs = 0;
+		p += len;
+		if (*p == ':') {
+			char tpe[IDLENGTH];
+
+			len = strcspn(++p, "(");
+			if (!iscalc(st->op) || len == 0 || len >= sizeof(tpe))
+				goto illegal;
+			strcpy_len(tpe, p, len + 1);
+			if ((st->tpe = ATOMindex(tpe)) < 0)
+				goto illegal;
+			p += len;
+		} else if (iscalc(st->op))
+			goto illegal;
+		if (*p++ != '(')
+			goto illegal;
+		while (*p != ')') {
+			struct fusedarg *a;
+
+			if (st->nargs == FUSEDMAXOPS)
+				goto illegal;
+			a = &st->args[st->nargs++];
+			a->kind = *p++;
+			switch (a->kind) {
+			case 'a':
+			case 'v':
+				if (argnr >= argc)
+					goto illegal;
+				a->idx = argnr++;
+				break;
+			case 'c':
+				a->idx = 0;
+				break;
+			case '$': {
+				char *e;
+				long l = strtol(p, &e, 10);
+				if (e == p || l < 0 || l >= k)
+					goto illegal;
+				a->idx = (int) l;
+				p = e;
+				break;
+			}
+			default:
+				goto illegal;
+			}
+			if (*p == ',')
+				p++;
+			else if (*p != ')')
+				goto illegal;
+		}
+		p++;
+		if (st->nargs < fusedops[i].minargs || st->nargs > fusedops[i].maxargs)
+			goto illegal;
+		/* only the last step is an aggregate, all others produce a BAT */
+		if (isaggr(st->op) != (k == nsteps - 1))
+			goto illegal;
+		if (*p != (k == nsteps - 1 ? 0 : ';'))
+			goto illegal;
+		p++;
+	}
+	if (argnr != argc)
+		goto illegal;
+	*stepsp = steps;
+	*nstepsp = nsteps;
+	return MAL_SUCCEED;
+
+  illegal:
+	GDKfree(steps);
+	throw(MAL, "algebra.fused", SQLSTATE(42000) "Illegal program '%s'", prog);
+}
+
+struct fusedstate {
+	MalStkPtr stk;
+	InstrPtr pci;
+	BAT **bats;					/* BAT arguments of the instruction */
+	BAT **res;					/* results of the steps */
+	BAT *cand;					/* candidates of the current vector */
+	BUN lo, hi;					/* positions of the current vector */
+};
+
+/* get a BAT operand, if it had to be created *tofree is set */
+static BAT *
+fusedbat(struct fusedstate *fs, const struct fusedarg *a, BAT **tofree)
+{
+	switch (a->kind) {
+	case 'c':
+		return fs->cand;
+	case '$':
+		return fs->res[a->idx];
+	case 'v':
+		if (fs->bats[a->idx] == NULL)
+			return NULL;
+		return *tofree = BATslice(fs->bats[a->idx], fs->lo, fs->hi);
+	default:
+		return fs->bats[a->idx];
+	}
+}
+
+#define isfusedbat(fs, a)												\
+	((a)->kind != 'a' || (fs)->bats[(a)->idx] != NULL)
+
+static inline bit
+fusedbit(struct fusedstate *fs, const struct fusedstep *st, int i, bit dflt)
+{
+	if (i >= st->nargs)
+		return dflt;
+	return *getArgReference_bit(fs->stk, fs->pci, st->args[i].idx);
+}
+
+/* evaluate a step that produces a BAT for the current vector */
+static BAT *
+fusedeval(struct fusedstate *fs, const struct fusedstep *st)
+{
+	BAT *b1, *b2, *f1 = NULL, *f2 = NULL, *bn = NULL;
+	const ValRecord *v1 = NULL, *v2 = NULL;
+
+	switch (st->op) {
+	case FUSED_SELECT: {
+		bit li = fusedbit(fs, st, 4, 0), hi = fusedbit(fs, st, 5, 0);
+		bit anti = fusedbit(fs, st, 6, 0), unknown = fusedbit(fs, st, 7, 0);
+		if ((li != 0 && li != 1) || (hi != 0 && hi != 1)
+			|| (anti != 0 && anti != 1)) {
+			GDKerror(ILLEGAL_ARGUMENT "\n");
+			return NULL;
+		}
+		b1 = fusedbat(fs, &st->args[0], &f1);
+		b2 = fusedbat(fs, &st->args[1], &f2);
+		if (b1)
+			bn = ALGselectbat(b1, b2,
+							  getArgReference(fs->stk, fs->pci, st->args[2].idx),
+							  getArgReference(fs->stk, fs->pci, st->args[3].idx),
+							  li, hi, anti, unknown);
+		break;
+	}
+	case FUSED_THETASELECT:
+		b1 = fusedbat(fs, &st->args[0], &f1);
+		b2 = fusedbat(fs, &st->args[1], &f2);
+		if (b1)
+			bn = ALGthetaselectbat(b1, b2,
+								   getArgReference(fs->stk, fs->pci, st->args[2].idx),
+								   *getArgReference_str(fs->stk, fs->pci, st->args[3].idx));
+		break;
+	case FUSED_PROJECTION:
+		b1 = fusedbat(fs, &st->args[0], &f1);
+		b2 = fusedbat(fs, &st->args[1], &f2);
+		if (b1 && b2)
+			bn = BATproject(b1, b2);
+		break;
+	default:
+		assert(iscalc(st->op));
+		/* candidate lists of the calc steps are always nil */
+		b1 = b2 = NULL;
+		if (isfusedbat(fs, &st->args[0])) {
+			if ((b1 = fusedbat(fs, &st->args[0], &f1)) == NULL)
+				break;
+		} else
+			v1 = &fs->stk->stk[getArg(fs->pci, st->args[0].idx)];
+		if (isfusedbat(fs, &st->args[1])) {
+			if ((b2 = fusedbat(fs, &st->args[1], &f2)) == NULL)
+				break;
+		} else
+			v2 = &fs->stk->stk[getArg(fs->pci, st->args[1].idx)];
+		switch (st->op) {
+		case FUSED_ADD:
+			bn = b1 && b2 ? BATcalcadd(b1, b2, NULL, NULL, st->tpe)
+				: b1 ? BATcalcaddcst(b1, v2, NULL, st->tpe)
+				: BATcalccstadd(v1, b2, NULL, st->tpe);
+			break;
+		case FUSED_SUB:
+			bn = b1 && b2 ? BATcalcsub(b1, b2, NULL, NULL, st->tpe)
+				: b1 ? BATcalcsubcst(b1, v2, NULL, st->tpe)
+				: BATcalccstsub(v1, b2, NULL, st->tpe);
+			break;
+		case FUSED_MUL:
+			bn = b1 && b2 ? BATcalcmul(b1, b2, NULL, NULL, st->tpe)
+				: b1 ? BATcalcmulcst(b1, v2, NULL, st->tpe)
+				: BATcalccstmul(v1, b2, NULL, st->tpe);
+			break;
+		case FUSED_DIV:
+			bn = b1 && b2 ? BATcalcdiv(b1, b2, NULL, NULL, st->tpe)
+				: b1 ? BATcalcdivcst(b1, v2, NULL, st->tpe)
+				: BATcalccstdiv(v1, b2, NULL, st->tpe);
+			break;
+		default:
+			MT_UNREACHABLE();
+		}
+		break;
+	}
+	BBPreclaim(f1);
+	BBPreclaim(f2);
+	return bn;
+}
+
+static str
+ALGfused(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	const char *prog = *getArgReference_str(stk, pci, 1);
+	int vectorsize = *getArgReference_int(stk, pci, 2);
+	ValPtr ret = &stk->stk[getArg(pci, 0)];
+	struct fusedstep *steps = NULL, *aggr;
+	struct fusedstate fs = { .stk = stk, .pci = pci };
+	BAT *b = NULL, *s = NULL, *part = NULL;
+	struct canditer ci;
+	bit flag = 0;
+	lng cnt = 0;
+	str msg;
+	int nsteps;
+
+	(void) cntxt;
+	if ((msg = fusedparse(prog, &steps, &nsteps, 5, pci->argc)) != MAL_SUCCEED)
+		return msg;
+	aggr = &steps[nsteps - 1];
+	if (vectorsize <= 0)
+		vectorsize = 1;
+
+	fs.bats = GDKzalloc(pci->argc * sizeof(BAT *));
+	fs.res = GDKzalloc(nsteps * sizeof(BAT *));
+	if (fs.bats == NULL || fs.res == NULL) {
+		msg = createException(MAL, "algebra.fused", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	for (int i = 3; i < pci->argc; i++) {
+		int tpe = getArgType(mb, pci, i);
+		if (tpe == TYPE_bat || isaBatType(tpe)) {
+			bat bid = *getArgReference_bat(stk, pci, i);
+			if (!is_bat_nil(bid) && (fs.bats[i] = BATdescriptor(bid)) == NULL) {
+				msg = createException(MAL, "algebra.fused",
+									  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+				goto bailout;
+			}
+		}
+	}
+	b = fs.bats[3];
+	s = fs.bats[4];
+	if (b == NULL && s == NULL) {
+		msg = createException(MAL, "algebra.fused",
+							  SQLSTATE(42000) "Missing driving input");
+		goto bailout;
+	}
+	canditer_init(&ci, b, s);
+	for (int k = 0; k < nsteps; k++) {
+		for (int i = 0; i < steps[k].nargs; i++) {
+			const struct fusedarg *a = &steps[k].args[i];
+			if (a->kind == 'v'
+				&& (fs.bats[a->idx] == NULL || s != NULL
+					|| BATcount(fs.bats[a->idx]) != ci.ncand)) {
+				msg = createException(MAL, "algebra.fused",
+									  SQLSTATE(42000) "inputs not the same size");
+				goto bailout;
+			}
+			if (iscalc(steps[k].op) && i >= 2
+				&& (a->kind != 'a' || fs.bats[a->idx] != NULL)) {
+				msg = createException(MAL, "algebra.fused",
+									  SQLSTATE(42000) "candidate lists not supported");
+				goto bailout;
+			}
+		}
+	}
+
+	switch (aggr->op) {
+	case FUSED_SUM:
+	case FUSED_MIN:
+	case FUSED_MAX:
+		if (ATOMextern(ret->vtype)
+			|| (aggr->op != FUSED_SUM && !ATOMlinear(ret->vtype))) {
+			msg = createException(MAL, "algebra.fused",
+								  "atom '%s' not supported",
+								  ATOMname(ret->vtype));
+			goto bailout;
+		}
+		part = COLnew(0, ret->vtype, ci.ncand / vectorsize + 1, TRANSIENT);
+		if (part == NULL) {
+			msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+			goto bailout;
+		}
+		/* nil_if_empty respectively skipnil */
+		flag = fusedbit(&fs, aggr, 1, 1);
+		break;
+	case FUSED_COUNT:
+		/* ignore_nils */
+		flag = fusedbit(&fs, aggr, 1, 0);
+		break;
+	default:
+		MT_UNREACHABLE();
+	}
+
+	for (fs.lo = 0; fs.lo < ci.ncand; fs.lo = fs.hi) {
+		BAT *w, *f = NULL;
+		ValRecord v = { .vtype = ret->vtype };
+
+		fs.hi = fs.lo + (BUN) vectorsize < ci.ncand ? fs.lo + (BUN) vectorsize : ci.ncand;
+		if ((fs.cand = canditer_slice(&ci, fs.lo, fs.hi)) == NULL) {
+			msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+			goto bailout;
+		}
+		for (int k = 0; k < nsteps - 1; k++) {
+			if ((fs.res[k] = fusedeval(&fs, &steps[k])) == NULL) {
+				msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+				goto bailout;
+			}
+		}
+		if ((w = fusedbat(&fs, &aggr->args[0], &f)) == NULL) {
+			msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+			goto bailout;
+		}
+		/* empty vectors do not contribute, in particular they must
+		 * not add a nil to the partial results */
+		if (BATcount(w) > 0) {
+			gdk_return rc = GDK_SUCCEED;
+			switch (aggr->op) {
+			case FUSED_SUM:
+				rc = BATsum(VALget(&v), v.vtype, w, NULL, true, true);
+				break;
+			case FUSED_MIN:
+				if (BATmin_skipnil(w, VALget(&v), flag) == NULL)
+					rc = GDK_FAIL;
+				break;
+			case FUSED_MAX:
+				if (BATmax_skipnil(w, VALget(&v), flag) == NULL)
+					rc = GDK_FAIL;
+				break;
+			default:
+				cnt += ALGcountbat(w, NULL, flag);
+				break;
+			}
+			if (rc == GDK_SUCCEED && part)
+				rc = BUNappend(part, VALget(&v), false);
+			if (rc != GDK_SUCCEED) {
+				BBPreclaim(f);
+				msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+				goto bailout;
+			}
+		}
+		BBPreclaim(f);
+		for (int k = 0; k < nsteps - 1; k++) {
+			BBPreclaim(fs.res[k]);
+			fs.res[k] = NULL;
+		}
+		BBPreclaim(fs.cand);
+		fs.cand = NULL;
+	}
+
+	switch (aggr->op) {
+	case FUSED_SUM:
+		if (BATsum(VALget(ret), ret->vtype, part, NULL, true, flag) != GDK_SUCCEED)
+			msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+		break;
+	case FUSED_MIN:
+		if (BATmin_skipnil(part, VALget(ret), flag) == NULL)
+			msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+		break;
+	case FUSED_MAX:
+		if (BATmax_skipnil(part, VALget(ret), flag) == NULL)
+			msg = createException(MAL, "algebra.fused", GDK_EXCEPTION);
+		break;
+	default:
+		ret->val.lval = cnt;
+		break;
+	}
+
+  bailout:
+	if (fs.res) {
+		for (int k = 0; k < nsteps; k++)
+			BBPreclaim(fs.res[k]);
+		GDKfree(fs.res);
+	}
+	if (fs.bats) {
+		for (int i = 0; i < pci->argc; i++)
+			BBPreclaim(fs.bats[i]);
+		GDKfree(fs.bats);
+	}
+	BBPreclaim(fs.cand);
+	BBPreclaim(part);
+	GDKfree(steps);
+	return msg;
+}
+
+#include "mel.h"
+mel_func fusion_init_funcs[] = {
+ pattern("algebra", "fused", ALGfused, false, "Evaluate a chain of selections, projections and calculations ending in an aggregate vector at a time.", args(1,6, argany("",0),arg("prog",str),arg("vectorsize",int),batargany("b",1),batarg("s",oid),varargany("arg",0))),
+ { .imp=NULL }
+};
+#include "mal_import.h"
+#ifdef _MSC_VER
+#undef read
+#pragma section(".CRT$XCU",read)
+#endif
+LIB_STARTUP_FUNC(init_fusion_mal)
+{ mal_module("fusion", NULL, fusion_init_funcs); }
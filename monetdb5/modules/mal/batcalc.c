@@ -1278,6 +1278,52 @@ CMDifthen(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return MAL_SUCCEED;
 }
 
+static str
+CMDbatEXPR(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	const char *expr = *getArgReference_str(stk, pci, 1);
+	int nargs = pci->argc - 2;
+	BAT **bats, *bn = NULL;
+	const ValRecord *vals = &stk->stk[0];
+	ValRecord *args;
+	str msg = MAL_SUCCEED;
+
+	(void) cntxt;
+
+	bats = GDKzalloc(nargs * sizeof(BAT *));
+	args = GDKmalloc(nargs * sizeof(ValRecord));
+	if (bats == NULL || args == NULL) {
+		GDKfree(bats);
+		GDKfree(args);
+		throw(MAL, "batcalc.fused", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	}
+	for (int i = 0; i < nargs; i++) {
+		int tp = getArgType(mb, pci, i + 2);
+		args[i] = vals[getArg(pci, i + 2)];
+		if (tp == TYPE_bat || isaBatType(tp)) {
+			if ((bats[i] = BATdescriptor(*getArgReference_bat(stk, pci, i + 2))) == NULL) {
+				msg = createException(MAL, "batcalc.fused",
+									  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+				goto bailout;
+			}
+		}
+	}
+	bn = BATcalcexpr(expr, bats, args, nargs,
+					 getBatType(getArgType(mb, pci, 0)));
+	if (bn == NULL)
+		msg = mythrow(MAL, "batcalc.fused", OPERATION_FAILED);
+	else {
+		*getArgReference_bat(stk, pci, 0) = bn->batCacheid;
+		BBPkeepref(bn);
+	}
+  bailout:
+	for (int i = 0; i < nargs; i++)
+		BBPreclaim(bats[i]);
+	GDKfree(bats);
+	GDKfree(args);
+	return msg;
+}
+
 #include "mel.h"
 
 static str
@@ -1975,6 +2021,7 @@ static mel_func batcalc_init_funcs[] = {
  pattern("batcalc", "ifthenelse", CMDifthen, false, "If-then-else operation to assemble a conditional result", args(1,4, batargany("",1),batarg("b",bit),batargany("b1",1),argany("v2",1))),
  pattern("batcalc", "ifthenelse", CMDifthen, false, "If-then-else operation to assemble a conditional result", args(1,4, batargany("",1),batarg("b",bit),argany("v1",1),batargany("b2",1))),
  pattern("batcalc", "ifthenelse", CMDifthen, false, "If-then-else operation to assemble a conditional result", args(1,4, batargany("",1),batarg("b",bit),batargany("b1",1),batargany("b2",1))),
+ pattern("batcalc", "fused", CMDbatEXPR, false, "Evaluate a postfix expression of arithmetic and comparison operators over the given columns and values in one pass", args(1,3, batargany("",1),arg("expr",str),varargany("arg",0))),
 
  { .imp=NULL }
 
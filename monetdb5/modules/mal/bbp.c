@@ -433,7 +433,7 @@ CMDbbp(bat *ID, bat *NS, bat *TT, bat *CNT, bat *REFCNT, bat *LREFCNT,
 			bn = BBP_desc(i);
 			if (bn) {
 				lng l = BATcount(bn);
-				int heat_ = 0, len;
+				int heat_ = BBP_clkuse(i), len;
 				char *loc = BBP_cache(i) ? "load" : "disk";
 				char *mode = "persistent";
 				int refs = BBP_refs(i);
@@ -511,6 +511,63 @@ CMDbbp(bat *ID, bat *NS, bat *TT, bat *CNT, bat *REFCNT, bat *LREFCNT,
 	return msg;
 }
 
+static str
+CMDbbpclock(bat *LOADED, bat *HITS, bat *MISSES, bat *EVICTIONS,
+			bat *SWEEPS, bat *BUDGET, bat *VMSIZE)
+{
+	BAT *loaded, *hits, *misses, *evictions, *sweeps, *budget, *vmsize;
+	bat nloaded;
+	lng nhits, nmisses, nevictions, nsweeps, nbudget;
+	lng nvmsize = (lng) GDKvm_cursize();
+	int iloaded;
+
+	BBPclockstats(&nloaded, &nhits, &nmisses, &nevictions, &nsweeps, &nbudget);
+	iloaded = (int) nloaded;
+	loaded = BATconstant(0, TYPE_int, &iloaded, 1, TRANSIENT);
+	hits = BATconstant(0, TYPE_lng, &nhits, 1, TRANSIENT);
+	misses = BATconstant(0, TYPE_lng, &nmisses, 1, TRANSIENT);
+	evictions = BATconstant(0, TYPE_lng, &nevictions, 1, TRANSIENT);
+	sweeps = BATconstant(0, TYPE_lng, &nsweeps, 1, TRANSIENT);
+	budget = BATconstant(0, TYPE_lng, &nbudget, 1, TRANSIENT);
+	vmsize = BATconstant(0, TYPE_lng, &nvmsize, 1, TRANSIENT);
+	if (!loaded || !hits || !misses || !evictions || !sweeps || !budget
+		|| !vmsize) {
+		BBPreclaim(loaded);
+		BBPreclaim(hits);
+		BBPreclaim(misses);
+		BBPreclaim(evictions);
+		BBPreclaim(sweeps);
+		BBPreclaim(budget);
+		BBPreclaim(vmsize);
+		throw(MAL, "bbp.clock", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	}
+	*LOADED = loaded->batCacheid;
+	BBPkeepref(loaded);
+	*HITS = hits->batCacheid;
+	BBPkeepref(hits);
+	*MISSES = misses->batCacheid;
+	BBPkeepref(misses);
+	*EVICTIONS = evictions->batCacheid;
+	BBPkeepref(evictions);
+	*SWEEPS = sweeps->batCacheid;
+	BBPkeepref(sweeps);
+	*BUDGET = budget->batCacheid;
+	BBPkeepref(budget);
+	*VMSIZE = vmsize->batCacheid;
+	BBPkeepref(vmsize);
+	return MAL_SUCCEED;
+}
+
+static str
+CMDbbpsetbudget(void *ret, const lng *budget)
+{
+	(void) ret;
+	if (is_lng_nil(*budget) || *budget < 0)
+		throw(MAL, "bbp.setbudget", SQLSTATE(42000) "Budget must be a non-negative number of bytes");
+	BBPsetbudget(*budget);
+	return MAL_SUCCEED;
+}
+
 static str
 CMDsetName(str *rname, const bat *bid, str *name)
 {
@@ -535,6 +592,8 @@ mel_func bbp_init_funcs[] = {
  command("bbp", "getIndex", CMDbbpgetIndex, false, "Retrieve the index in the BBP", args(1,2, arg("",int),batargany("b",2))),
  command("bbp", "getNames", CMDbbpNames, false, "Map BAT into its bbp name", args(1,1, batarg("",str))),
  command("bbp", "get", CMDbbp, false, "bpp", args(11,11, batarg("id",int),batarg("ns",str),batarg("tt",str),batarg("cnt",lng),batarg("refcnt",int),batarg("lrefcnt",int),batarg("location",str),batarg("heat",int),batarg("dirty",str),batarg("status",str),batarg("kind",str))),
+ command("bbp", "clock", CMDbbpclock, false, "buffer manager statistics", args(7,7, batarg("loaded",int),batarg("hits",lng),batarg("misses",lng),batarg("evictions",lng),batarg("sweeps",lng),batarg("budget",lng),batarg("vmsize",lng))),
+ command("bbp", "setbudget", CMDbbpsetbudget, true, "set the memory budget of the buffer manager in bytes, 0 for none", args(1,2, arg("",void),arg("budget",lng))),
  command("bbp", "getName", CMDbbpName, false, "Map a BAT into its internal name", args(1,2, arg("",str),batargany("b",1))),
  command("bbp", "setName", CMDsetName, false, "Rename a BAT", args(1,3, arg("",str),batargany("b",1),arg("n",str))),
  command("bbp", "getCount", CMDbbpCount, false, "Create a BAT with the cardinalities of all known BATs", args(1,1, batarg("",lng))),
@@ -2108,6 +2108,58 @@ re_likeselect(BAT *bn, BAT *b, BAT *s, struct canditer *ci, BUN p, BUN q,
 	return msg;
 }
 
+/* Prefilter the candidates of a LIKE select with the trigram index of
+ * b: every matching string contains the literal fragments between the
+ * wildcards of the pattern.  Returns NULL if the index cannot be
+ * used. */
+static BAT *
+like_trigram_filter(BAT *b, BAT *s, const char *pat, unsigned char esc)
+{
+	size_t len = strlen(pat);
+	char *buf, *q;
+	const char **frags;
+	int nfrags = 0;
+	bool escaped = false;
+	BAT *bn = NULL;
+
+	if (esc == '%' || esc == '_' || len < 3)
+		return NULL;
+	buf = GDKmalloc(len + 1);
+	frags = GDKmalloc((len + 1) * sizeof(const char *));
+	if (buf == NULL || frags == NULL) {
+		GDKfree(buf);
+		GDKfree(frags);
+		GDKclrerr();
+		return NULL;
+	}
+	q = buf;
+	frags[0] = q;
+	for (; *pat; pat++) {
+		if (escaped) {
+			*q++ = *pat;
+			escaped = false;
+		} else if ((unsigned char) *pat == esc) {
+			escaped = true;
+		} else if (*pat == '%' || *pat == '_') {
+			if (q > frags[nfrags]) {
+				*q++ = 0;
+				frags[++nfrags] = q;
+			}
+		} else {
+			*q++ = *pat;
+		}
+	}
+	if (q > frags[nfrags]) {
+		*q = 0;
+		nfrags++;
+	}
+	if (nfrags > 0)
+		bn = TRGMfilter(b, s, frags, nfrags, 0);
+	GDKfree(buf);
+	GDKfree(frags);
+	return bn;
+}
+
 static str
 PCRElikeselect(bat *ret, const bat *bid, const bat *sid, const str *pat,
 			   const str *esc, const bit *caseignore, const bit *anti)
@@ -2121,6 +2173,7 @@ PCRElikeselect(bat *ret, const bat *bid, const bat *sid, const str *pat,
 		ascii_pattern =	false;
 	bool with_strimps = false;
 	bool with_strimps_anti = false;
+	bool with_trigrams = false;
 	BUN p = 0, q = 0, rcnt = 0;
 	struct canditer ci;
 
@@ -2170,9 +2223,28 @@ PCRElikeselect(bat *ret, const bat *bid, const bat *sid, const str *pat,
 			GDKclrerr();
 		}
 	}
+	/* Otherwise use the trigram index.  It folds ASCII letters only,
+	 * so it cannot be used for case insensitive matching of non-ASCII
+	 * patterns, nor for the PCRE path, which may fold other
+	 * characters to ASCII letters. */
+	if (!with_strimps && !with_strimps_anti && !*anti
+		&& (!*caseignore || (use_re && ascii_pattern))) {
+		BAT *tmp_s = like_trigram_filter(b, s, *pat, (unsigned char) **esc);
+		if (tmp_s) {
+			old_s = s;
+			s = tmp_s;
+			with_trigrams = true;
+		}
+	}
 
 
-	MT_thread_setalgorithm(use_strcmp
+	MT_thread_setalgorithm(with_trigrams
+						   ? (use_strcmp ?
+							  "pcrelike: pattern matching using strcmp with trigrams"
+							  : use_re ?
+							  "pcrelike: pattern matching using RE with trigrams"
+							  : "pcrelike: pattern matching using pcre with trigrams") :
+						   use_strcmp
 						   ? (with_strimps ?
 							  "pcrelike: pattern matching using strcmp with strimps"
 							  : (with_strimps_anti ?
@@ -481,7 +481,7 @@ str_2_codepointseq(str_item *s)
 	str p = s->val;
 	int c;
 
-	s->cp_sequence = GDKmalloc(s->len * sizeof(int));
+	s->cp_sequence = GDKmalloc(MAX(s->len, 1) * sizeof(int));
 	if (s->cp_sequence == NULL)
 		throw(MAL, "str_2_byteseq", SQLSTATE(HY013) MAL_MALLOC_FAIL);
 
@@ -629,42 +629,47 @@ TXTSIMminjarowinkler(bit *res, str *x, str *y, const dbl *threshold)
 #define VALUE(s, x) (s##vars + VarHeapVal(s##vals, (x), s##width))
 #define APPEND(b, o) (((oid *) b->theap->base)[b->batCount++] = (o))
 
-#define PREP_BAT_STRITEM(B, CI, SI)										\
+/* NULL strings never match, they are left out of the CNT items */
+#define PREP_BAT_STRITEM(B, CI, SI, CNT)								\
 		do {															\
 			for (n = 0; n < CI.ncand; n++) {							\
-				SI[n].matches = 0;										\
-				SI[n].o = canditer_next(&CI);							\
-				SI[n].val = (str) VALUE(B, SI[n].o - B->hseqbase);		\
-				SI[n].cp_sequence = NULL;								\
-				SI[n].len = UTF8_strlen(SI[n].val);						\
-				SI[n].cp_seq_len = str_strlen(SI[n].val);				\
-				if ((msg = str_2_codepointseq(&SI[n])) != MAL_SUCCEED)	\
+				oid o = canditer_next(&CI);								\
+				str v = (str) VALUE(B, o - B->hseqbase);				\
+				if (strNil(v))											\
+					continue;											\
+				SI[CNT] = (str_item) {									\
+					.o = o,												\
+					.val = v,											\
+					.len = UTF8_strlen(v),								\
+					.cp_seq_len = str_strlen(v),						\
+				};														\
+				if ((msg = str_2_codepointseq(&SI[CNT++])) != MAL_SUCCEED) \
 					goto exit;											\
-				str_alphabet_bitmap(&SI[n]);							\
+				str_alphabet_bitmap(&SI[CNT - 1]);						\
 			}															\
 		} while (false)
 
-#define FINALIZE_BATS(L, R, LCI, RCI, LSI, RSI)	\
+#define FINALIZE_BATS(L, R, LCNT, RCNT, LSI, RSI)	\
 		do {									\
 			assert(BATcount(L) == BATcount(R));	\
 			BATsetcount(L, BATcount(L));		\
 			BATsetcount(R, BATcount(R));		\
-			for (n = 0; n < LCI.ncand; n++) {	\
+			for (n = 0; n < LCNT; n++) {		\
 				if (LSI[n].matches > 1) {		\
 					L->tkey = false;			\
 					break;						\
 				}								\
 			}									\
-			if (n == LCI.ncand) {				\
+			if (n == LCNT) {					\
 				L->tkey = true;					\
 			}									\
-			for (n = 0; n < RCI.ncand; n++) {	\
+			for (n = 0; n < RCNT; n++) {		\
 				if (RSI[n].matches > 1) {		\
 					R->tkey = false;			\
 					break;						\
 				}								\
 			}									\
-			if (n == RCI.ncand) {				\
+			if (n == RCNT) {					\
 				R->tkey = true;					\
 			}									\
 			BATordered(L);						\
@@ -695,7 +700,8 @@ maxlevenshtein_extcol_stritem(const str_item *si1, const str_item *si2,
 	for (x = 1; x <= s2len; x++) {
 		c2 = s2[x - 1];
 		column[0] = x;
-		min = INT_MAX;
+		/* the row starts with x, which also bounds an empty s1 */
+		min = x;
 		for (y = 1, lastdiag = x - 1; y <= s1len; y++) {
 			olddiag = column[y];
 			c1 = s1[y - 1];
@@ -710,6 +716,333 @@ maxlevenshtein_extcol_stritem(const str_item *si1, const str_item *si2,
 	return column[s1len];
 }
 
+/* The similarity joins are done in parallel.  The items of the right
+ * side are cut in chunks, which a number of threads claim one at a
+ * time, collecting the matching pairs of each chunk separately.  The
+ * pairs are added to the results in the order of the chunks, so the
+ * results are the same as those of doing the chunks one after the
+ * other. */
+#define SIMJOIN_CHUNK		256		/* right items per chunk */
+#define SIMJOIN_MAXTHREADS	64
+
+/* Levenshtein joins use an index on the left side.  The characters of
+ * each string are divided over k + 1 segments: k edits leave at least
+ * one of them intact, and that segment occurs in the other string,
+ * shifted by no more than the edits allow.  So only strings that have
+ * a segment in common with a substring at one of those positions need
+ * to be compared (cf. Li et al., "PASS-JOIN", VLDB 2011).  Strings
+ * with fewer characters than segments are always compared. */
+#define SIMJOIN_MAXSEGMENTS	8
+
+typedef struct {
+	BUN *pairs;					/* left and right item, interleaved */
+	BUN npairs, size;
+} simjoin_chunk;
+
+typedef struct {
+	BUN item;					/* the left item */
+	BUN next;					/* next entry in the bucket */
+	int seg;					/* the segment of it */
+} simjoin_segment;
+
+/* the buffers of one thread */
+typedef struct {
+	unsigned int *column;		/* Levenshtein */
+	BUN *stamps, *cands;
+	int *x_flags, *y_flags;		/* Jaro-Winkler */
+} simjoin_buffers;
+
+typedef struct simjoin simjoin;
+typedef gdk_return (*simjoin_func)(simjoin *job, simjoin_chunk *c, BUN lo,
+								   BUN hi, void *buf);
+
+struct simjoin {
+	str_item *lsi, *rsi;
+	BUN lcnt, rcnt;
+	bool jarowinkler;
+	int k;						/* Levenshtein: the distance */
+	double threshold;			/* Jaro-Winkler: the similarity */
+	simjoin_func func;
+	/* the index on the left side */
+	BUN *buckets, mask;
+	simjoin_segment *segments;
+	BUN *shorts, nshorts;
+	/* the chunks */
+	simjoin_chunk *chunks;
+	BUN nchunks;
+	simjoin_buffers bufs[SIMJOIN_MAXTHREADS];
+};
+
+static inline gdk_return
+simjoin_add(simjoin_chunk *c, BUN l, BUN r)
+{
+	if (c->npairs == c->size) {
+		BUN size = c->size == 0 ? 64 : 2 * c->size;
+		BUN *pairs = GDKrealloc(c->pairs, 2 * size * sizeof(BUN));
+		if (pairs == NULL)
+			return GDK_FAIL;
+		c->pairs = pairs;
+		c->size = size;
+	}
+	c->pairs[2 * c->npairs] = l;
+	c->pairs[2 * c->npairs + 1] = r;
+	c->npairs++;
+	return GDK_SUCCEED;
+}
+
+/* Join a chunk, with the buffers of thread t, which are allocated
+ * when it gets its first chunk. */
+static gdk_return
+simjoin_worker(void *arg, int t, BUN i)
+{
+	simjoin *job = arg;
+	simjoin_buffers *buf = &job->bufs[t];
+	int lmax = job->lsi[0].len, rmax = job->rsi[0].len;
+
+	if (job->jarowinkler) {
+		if (buf->y_flags == NULL) {
+			buf->x_flags = GDKmalloc(MAX(lmax, 1) * sizeof(int));
+			buf->y_flags = GDKmalloc(MAX(rmax, 1) * sizeof(int));
+			if (buf->x_flags == NULL || buf->y_flags == NULL)
+				return GDK_FAIL;
+		}
+	} else if (buf->column == NULL) {
+		buf->column = GDKmalloc((lmax + 1) * sizeof(unsigned int));
+		if (buf->column == NULL)
+			return GDK_FAIL;
+		if (job->segments) {
+			buf->stamps = GDKzalloc(job->lcnt * sizeof(BUN));
+			buf->cands = GDKmalloc(job->lcnt * sizeof(BUN));
+			if (buf->stamps == NULL || buf->cands == NULL)
+				return GDK_FAIL;
+		}
+	}
+	return job->func(job, &job->chunks[i], i * SIMJOIN_CHUNK,
+					 MIN((i + 1) * SIMJOIN_CHUNK, job->rcnt), buf);
+}
+
+/* Run the join on the chunks, then add the pairs to l and r. */
+static str
+simjoin_run(simjoin *job, BAT *l, BAT *r, const char *fname)
+{
+	int nthreads = GDKnr_threads;
+	BUN n = 0;
+	str msg = MAL_SUCCEED;
+
+	job->nchunks = (job->rcnt + SIMJOIN_CHUNK - 1) / SIMJOIN_CHUNK;
+	if ((job->chunks = GDKzalloc(job->nchunks * sizeof(simjoin_chunk))) == NULL)
+		throw(MAL, fname, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	memset(job->bufs, 0, sizeof(job->bufs));
+	if (nthreads > SIMJOIN_MAXTHREADS)
+		nthreads = SIMJOIN_MAXTHREADS;
+	if (GDKparallel("simjoin", nthreads, job->nchunks, simjoin_worker, job) != GDK_SUCCEED) {
+		msg = createException(MAL, fname, GDK_EXCEPTION);
+		goto exit;
+	}
+	for (BUN i = 0; i < job->nchunks; i++)
+		n += job->chunks[i].npairs;
+	if (BATextend(l, n) != GDK_SUCCEED ||
+		BATextend(r, n) != GDK_SUCCEED) {
+		msg = createException(MAL, fname, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto exit;
+	}
+	for (BUN i = 0; i < job->nchunks; i++) {
+		const BUN *p = job->chunks[i].pairs;
+		for (BUN j = 0; j < job->chunks[i].npairs; j++, p += 2) {
+			job->lsi[p[0]].matches++;
+			job->rsi[p[1]].matches++;
+			APPEND(l, job->lsi[p[0]].o);
+			APPEND(r, job->rsi[p[1]].o);
+		}
+	}
+
+  exit:
+	for (int t = 0; t < SIMJOIN_MAXTHREADS; t++) {
+		GDKfree(job->bufs[t].column);
+		GDKfree(job->bufs[t].stamps);
+		GDKfree(job->bufs[t].cands);
+		GDKfree(job->bufs[t].x_flags);
+		GDKfree(job->bufs[t].y_flags);
+	}
+	for (BUN i = 0; i < job->nchunks; i++)
+		GDKfree(job->chunks[i].pairs);
+	GDKfree(job->chunks);
+	job->chunks = NULL;
+	return msg;
+}
+
+/* the segment i of the k + 1 segments of a string of len characters:
+ * the shorter segments come first */
+static inline void
+levenshtein_segment(int len, int k, int i, int *start, int *seglen)
+{
+	int nseg = k + 1, base = len / nseg, nshort = nseg - len % nseg;
+
+	*start = i * base + (i > nshort ? i - nshort : 0);
+	*seglen = base + (i >= nshort);
+}
+
+static inline BUN
+levenshtein_segment_hash(int len, int i, const int *cp, int n)
+{
+	uint64_t h = (uint64_t) len * 0x9E3779B97F4A7C15ULL + (uint64_t) i;
+
+	for (int j = 0; j < n; j++)
+		h = (h ^ (uint64_t) (unsigned int) cp[j]) * 0x100000001B3ULL;
+	return (BUN) (h ^ (h >> 29));
+}
+
+static str
+levenshtein_index(simjoin *job, const char *fname)
+{
+	BUN nseg = 0, nbuckets = 1, e = 0;
+	int k = job->k;
+
+	for (BUN n = 0; n < job->lcnt; n++)
+		if (job->lsi[n].len > k)
+			nseg += k + 1;
+		else
+			job->nshorts++;
+	while (nbuckets < 2 * nseg)
+		nbuckets <<= 1;
+	job->mask = nbuckets - 1;
+	if ((job->buckets = GDKmalloc(nbuckets * sizeof(BUN))) == NULL ||
+		(job->segments = GDKmalloc(MAX(nseg, 1) * sizeof(simjoin_segment))) == NULL ||
+		(job->shorts = GDKmalloc(MAX(job->nshorts, 1) * sizeof(BUN))) == NULL)
+		throw(MAL, fname, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	for (BUN b = 0; b < nbuckets; b++)
+		job->buckets[b] = BUN_NONE;
+	job->nshorts = 0;
+	for (BUN n = 0; n < job->lcnt; n++) {
+		const str_item *si = &job->lsi[n];
+		if (si->len <= k) {
+			job->shorts[job->nshorts++] = n;
+			continue;
+		}
+		for (int i = 0; i <= k; i++) {
+			int start, seglen;
+			levenshtein_segment(si->len, k, i, &start, &seglen);
+			BUN b = levenshtein_segment_hash(si->len, i, si->cp_sequence + start, seglen) & job->mask;
+			job->segments[e] = (simjoin_segment) {
+				.item = n,
+				.next = job->buckets[b],
+				.seg = i,
+			};
+			job->buckets[b] = e++;
+		}
+	}
+	return MAL_SUCCEED;
+}
+
+static int
+bun_cmp(const void *a, const void *b)
+{
+	BUN x = *(const BUN *) a, y = *(const BUN *) b;
+	return (x > y) - (x < y);
+}
+
+/* join the right items lo to hi with the left items of the index that
+ * have a segment in common with them */
+static gdk_return
+maxlevenshtein_indexed(simjoin *job, simjoin_chunk *c, BUN lo, BUN hi,
+					   void *arg)
+{
+	simjoin_buffers *buf = arg;
+	const str_item *lsi = job->lsi;
+	int k = job->k;
+
+	for (BUN r = lo; r < hi; r++) {
+		const str_item *rsi = &job->rsi[r];
+		int rlen = rsi->len;
+		BUN ncands = 0, stamp = r + 1;
+
+		for (int len = MAX(rlen - k, k + 1); len <= rlen + k; len++) {
+			int delta = rlen - len;
+			for (int i = 0; i <= k; i++) {
+				int start, seglen, pos, last;
+				levenshtein_segment(len, k, i, &start, &seglen);
+				/* the edits before the segment move it, those
+				 * after it make up for the difference in length */
+				pos = MAX(start - (k - delta) / 2, 0);
+				last = MIN(start + (k + delta) / 2, rlen - seglen);
+				for (; pos <= last; pos++) {
+					const int *sub = rsi->cp_sequence + pos;
+					BUN b = levenshtein_segment_hash(len, i, sub, seglen) & job->mask;
+					for (BUN e = job->buckets[b]; e != BUN_NONE; e = job->segments[e].next) {
+						const simjoin_segment *s = &job->segments[e];
+						if (s->seg != i || lsi[s->item].len != len ||
+							buf->stamps[s->item] == stamp ||
+							memcmp(lsi[s->item].cp_sequence + start, sub,
+								   seglen * sizeof(int)) != 0)
+							continue;
+						buf->stamps[s->item] = stamp;
+						buf->cands[ncands++] = s->item;
+					}
+				}
+			}
+		}
+		for (BUN j = 0; j < job->nshorts; j++) {
+			BUN n = job->shorts[j];
+			if (abs(lsi[n].len - rlen) <= k)
+				buf->cands[ncands++] = n;
+		}
+		/* the order of the left side, as in the nested loop */
+		qsort(buf->cands, ncands, sizeof(BUN), bun_cmp);
+		for (BUN j = 0; j < ncands; j++) {
+			BUN n = buf->cands[j];
+			int d = MAX(lsi[n].abm_popcount, rsi->abm_popcount) -
+				popcount64(lsi[n].abm & rsi->abm);
+			if (d > k)
+				continue;
+			d = maxlevenshtein_extcol_stritem(&lsi[n], rsi, buf->column,
+											  (const unsigned int) k);
+			if (d > k)
+				continue;
+			if (simjoin_add(c, n, r) != GDK_SUCCEED)
+				return GDK_FAIL;
+		}
+	}
+	return GDK_SUCCEED;
+}
+
+/* join the right items lo to hi with all left items of about the
+ * same length */
+static gdk_return
+maxlevenshtein_nested(simjoin *job, simjoin_chunk *c, BUN lo, BUN hi,
+					  void *arg)
+{
+	simjoin_buffers *buf = arg;
+	const str_item *lsi = job->lsi, *rsi = job->rsi;
+	int k = job->k, d;
+
+	for (BUN lstart = 0, rstart = lo; rstart < hi; rstart++) {
+		for (BUN n = lstart; n < job->lcnt; n++) {
+			/* first and cheapest filter */
+			if ((lsi[n].len) > k + rsi[rstart].len) {
+				lstart++;
+				continue;		/* no possible matches yet for this r */
+			} else if (rsi[rstart].len > k + lsi[n].len) {
+				break;			/* no more possible matches from this r */
+			}
+			/* filter by comparing alphabet bitmaps (imprecise but fast filter) */
+			d = MAX(lsi[n].abm_popcount,
+					rsi[rstart].abm_popcount) -
+					popcount64(lsi[n].abm & rsi[rstart].abm);
+			if (d > k)
+				continue;
+			/* final and most expensive test: Levenshtein distance */
+			d = maxlevenshtein_extcol_stritem(&lsi[n], &rsi[rstart], buf->column,
+											  (const unsigned int) k);
+			if (d > k)
+				continue;
+			/* The match test succeeded */
+			if (simjoin_add(c, n, rstart) != GDK_SUCCEED)
+				return GDK_FAIL;
+		}
+	}
+	return GDK_SUCCEED;
+}
+
 static str
 maxlevenshteinjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr, int k)
 {
@@ -717,10 +1050,11 @@ maxlevenshteinjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr, int k)
 	BUN n;
 	struct canditer lci, rci;
 	const char *lvals, *rvals, *lvars, *rvars;;
-	int lwidth, rwidth, d;
+	int lwidth, rwidth;
 	str_item *lsi = NULL, *rsi = NULL;
+	BUN lcnt = 0, rcnt = 0;
 	str msg = MAL_SUCCEED;
-	unsigned int *buffer = NULL;
+	simjoin job = { 0 };
 
 	assert(ATOMtype(l->ttype) == ATOMtype(r->ttype));
 	assert(ATOMtype(l->ttype) == TYPE_str);
@@ -728,8 +1062,19 @@ maxlevenshteinjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr, int k)
 	canditer_init(&lci, l, sl);
 	canditer_init(&rci, r, sr);
 
-	if (lci.ncand == 0 || rci.ncand == 0)
+	if (lci.ncand == 0 || rci.ncand == 0) {
+		/* no pairs, but the caller still needs two results */
+		if ((r1t = BATdense(0, 0, 0)) == NULL ||
+			(r2t = BATdense(0, 0, 0)) == NULL) {
+			reclaim_bats(2, r1t, r2t);
+			msg = createException(MAL, "txtsim.maxlevenshteinjoin",
+								  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+			goto exit;
+		}
+		*r1 = r1t;
+		*r2 = r2t;
 		goto exit;
+	}
 
 	lvals = (const char *) Tloc(l, 0);
 	rvals = (const char *) Tloc(r, 0);
@@ -757,68 +1102,47 @@ maxlevenshteinjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr, int k)
 		goto exit;
 	}
 
-	PREP_BAT_STRITEM(l, lci, lsi);
-	PREP_BAT_STRITEM(r, rci, rsi);
-	qsort(lsi, lci.ncand, sizeof(str_item), str_item_lenrev_cmp);
-	qsort(rsi, rci.ncand, sizeof(str_item), str_item_lenrev_cmp);
-
-	if ((buffer = GDKmalloc((lsi[0].len + 1) * sizeof(int))) == NULL) {
-		msg = createException(MAL, "txtsim.maxlevenshteinjoin",
-							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
-		goto exit;
-	}
-
-	/* join loop */
-	for (BUN lstart = 0, rstart = 0; rstart < rci.ncand; rstart++) {
-		for (n = lstart; n < lci.ncand; n++) {
-			/* first and cheapest filter */
-			if ((lsi[n].len) > k + rsi[rstart].len) {
-				lstart++;
-				continue;		/* no possible matches yet for this r */
-			} else if (rsi[rstart].len > k + lsi[n].len) {
-				break;			/* no more possible matches from this r */
-			}
-			/* filter by comparing alphabet bitmaps (imprecise but fast filter) */
-			d = MAX(lsi[n].abm_popcount,
-					rsi[rstart].abm_popcount) -
-					popcount64(lsi[n].abm & rsi[rstart].abm);
-			if (d > k)
-				continue;
-			/* final and most expensive test: Levenshtein distance */
-			d = maxlevenshtein_extcol_stritem(&lsi[n], &rsi[rstart], buffer,
-											  (const unsigned int) k);
-			if (d > k)
-				continue;
-			/* The match test succeeded */
-			lsi[n].matches++;
-			rsi[rstart].matches++;
-			if (bunfastappTYPE(oid, r1t, &(lsi[n].o)) != GDK_SUCCEED) {
-				reclaim_bats(2, r1t, r2t);
-				msg = createException(MAL, "txtsim.maxlevenshteinjoin",
-									  OPERATION_FAILED "Failed bun append");
-				goto exit;
-			}
-			if (bunfastappTYPE(oid, r2t, &(rsi[rstart].o)) != GDK_SUCCEED) {
+	PREP_BAT_STRITEM(l, lci, lsi, lcnt);
+	PREP_BAT_STRITEM(r, rci, rsi, rcnt);
+	qsort(lsi, lcnt, sizeof(str_item), str_item_lenrev_cmp);
+	qsort(rsi, rcnt, sizeof(str_item), str_item_lenrev_cmp);
+
+	job = (simjoin) {
+		.lsi = lsi,
+		.rsi = rsi,
+		.lcnt = lcnt,
+		.rcnt = rcnt,
+		.k = k,
+		.func = maxlevenshtein_nested,
+	};
+	if (lcnt > 0 && rcnt > 0) {
+		if (k >= 0 && k < SIMJOIN_MAXSEGMENTS) {
+			if ((msg = levenshtein_index(&job, "txtsim.maxlevenshteinjoin")) != MAL_SUCCEED) {
 				reclaim_bats(2, r1t, r2t);
-				msg = createException(MAL, "txtsim.maxlevenshteinjoin",
-									  OPERATION_FAILED "Failed bun append");
 				goto exit;
 			}
+			job.func = maxlevenshtein_indexed;
+		}
+		if ((msg = simjoin_run(&job, r1t, r2t, "txtsim.maxlevenshteinjoin")) != MAL_SUCCEED) {
+			reclaim_bats(2, r1t, r2t);
+			goto exit;
 		}
 	}
 
-	FINALIZE_BATS(r1t, r2t, lci, rci, lsi, rsi);
+	FINALIZE_BATS(r1t, r2t, lcnt, rcnt, lsi, rsi);
 	*r1 = r1t;
 	*r2 = r2t;
 
   exit:
-	for (n = 0; lsi && n < lci.ncand; n++)
+	for (n = 0; n < lcnt; n++)
 		GDKfree(lsi[n].cp_sequence);
-	for (n = 0; rsi && n < rci.ncand; n++)
+	for (n = 0; n < rcnt; n++)
 		GDKfree(rsi[n].cp_sequence);
 	GDKfree(lsi);
 	GDKfree(rsi);
-	GDKfree(buffer);
+	GDKfree(job.buckets);
+	GDKfree(job.segments);
+	GDKfree(job.shorts);
 	return msg;
 }
 
@@ -873,6 +1197,116 @@ TXTSIMmaxlevenshteinjoin(bat *r1, bat *r2, const bat *lid, const bat *rid,
 	return msg;
 }
 
+/* Select the values of b within Levenshtein distance k of y.  A value
+ * within distance k of y contains all but k * (m + 2) of the trigrams
+ * of y, where m is the longest UTF-8 sequence in y, so the trigram
+ * index of b, if there is one, gives the candidates. */
+static str
+TXTSIMmaxlevenshteinselect(bat *ret, const bat *bid, const bat *sid,
+						   const str *y, const int *k, const bit *anti)
+{
+	BAT *b = NULL, *s = NULL, *c = NULL, *bn = NULL;
+	struct canditer ci;
+	BATiter bi;
+	str_item ysi = { 0 }, xsi = { 0 };
+	unsigned int *buffer = NULL;
+	int xsize = 0, m = 1, d;
+	str msg = MAL_SUCCEED;
+
+	if ((b = BATdescriptor(*bid)) == NULL ||
+		(sid && !is_bat_nil(*sid) && (s = BATdescriptor(*sid)) == NULL)) {
+		msg = createException(MAL, "txtsim.maxlevenshteinselect",
+							  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+		goto exit;
+	}
+	if (strNil(*y) || is_int_nil(*k) || *k < 0) {
+		if ((bn = BATdense(0, 0, 0)) == NULL)
+			msg = createException(MAL, "txtsim.maxlevenshteinselect",
+								  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto exit;
+	}
+
+	ysi.val = *y;
+	ysi.len = UTF8_strlen(*y);
+	if ((msg = str_2_codepointseq(&ysi)) != MAL_SUCCEED)
+		goto exit;
+	for (const unsigned char *p = (const unsigned char *) *y; *p; p++)
+		if ((*p & 0xF8) == 0xF0)
+			m = MAX(m, 4);
+		else if ((*p & 0xF0) == 0xE0)
+			m = MAX(m, 3);
+		else if ((*p & 0xE0) == 0xC0)
+			m = MAX(m, 2);
+	if (!*anti && (lng) *k * (m + 2) < INT_MAX)
+		c = TRGMfilter(b, s, (const char *const *) y, 1, *k * (m + 2));
+
+	canditer_init(&ci, b, c ? c : s);
+	if ((bn = COLnew(0, TYPE_oid, ci.ncand, TRANSIENT)) == NULL ||
+		(buffer = GDKmalloc((ysi.len + 1) * sizeof(unsigned int))) == NULL) {
+		msg = createException(MAL, "txtsim.maxlevenshteinselect",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto exit;
+	}
+	MT_thread_setalgorithm(c ? "maxlevenshteinselect with trigrams" : "maxlevenshteinselect");
+	oid *restrict o = Tloc(bn, 0);
+	BUN cnt = 0;
+	bi = bat_iterator(b);
+	for (BUN i = 0; i < ci.ncand; i++) {
+		oid x = canditer_next(&ci);
+		const char *v = BUNtvar(bi, x - b->hseqbase);
+		if (strNil(v))
+			continue;
+		xsi.len = UTF8_strlen(v);
+		if (abs(xsi.len - ysi.len) > *k) {
+			d = INT_MAX;
+		} else {
+			if (xsi.len > xsize) {
+				int *tmp = GDKrealloc(xsi.cp_sequence, xsi.len * sizeof(int));
+				if (tmp == NULL) {
+					bat_iterator_end(&bi);
+					msg = createException(MAL, "txtsim.maxlevenshteinselect",
+										  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+					goto exit;
+				}
+				xsi.cp_sequence = tmp;
+				xsize = xsi.len;
+			}
+			for (int j = 0; j < xsi.len; j++) {
+				int cp;
+				UTF8_GETCHAR(cp, v);
+				xsi.cp_sequence[j] = cp;
+			}
+			d = maxlevenshtein_extcol_stritem(&ysi, &xsi, buffer, *k);
+		}
+		if ((d <= *k) != (bool) *anti)
+			o[cnt++] = x;
+	}
+	bat_iterator_end(&bi);
+	BATsetcount(bn, cnt);
+	bn->tsorted = true;
+	bn->trevsorted = cnt <= 1;
+	bn->tkey = true;
+	bn->tnil = false;
+	bn->tnonil = true;
+	goto exit;
+  illegal:
+	bat_iterator_end(&bi);
+	msg = createException(MAL, "txtsim.maxlevenshteinselect",
+						  SQLSTATE(42000) "Illegal unicode code point");
+  exit:
+	GDKfree(ysi.cp_sequence);
+	GDKfree(xsi.cp_sequence);
+	GDKfree(buffer);
+	reclaim_bats(3, b, s, c);
+	if (msg == MAL_SUCCEED) {
+		*ret = bn->batCacheid;
+		BBPkeepref(bn);
+	} else {
+		BBPreclaim(bn);
+	}
+	return msg;
+}
+
 static inline void
 jarowinkler_rangebounds(int *lb, int *ub, const str_item *a, const double lp,
 						const double threshold)
@@ -894,6 +1328,61 @@ jarowinkler_lp_m_t0(const str_item *lsi, const str_item *rsi, double lp, int m)
 	return dw;
 }
 
+/* join the right items lo to hi with the left items whose length
+ * allows a similarity above the threshold */
+static gdk_return
+minjarowinkler_nested(simjoin *job, simjoin_chunk *c, BUN lo, BUN hi,
+					  void *arg)
+{
+	simjoin_buffers *buf = arg;
+	const str_item *ssl = job->lsi, *ssr = job->rsi, *shortest;
+	const double threshold = job->threshold;
+	const bool sliding_window_allowed = threshold > (2.01 + JARO_WINKLER_PREFIX_LEN * JARO_WINKLER_SCALING_FACTOR) / 3.0;
+	int lb = 0, ub = 0, m;
+	double s;
+	// lp used for filters. Use -1 for actual JW (forces to compute actual lp)
+	const double lp = JARO_WINKLER_PREFIX_LEN * JARO_WINKLER_SCALING_FACTOR;
+
+	for (BUN lstart = 0, rstart = lo; rstart < hi; rstart++) {
+		if (sliding_window_allowed)
+			jarowinkler_rangebounds(&lb, &ub, &ssr[rstart], lp, threshold);
+		for (BUN n = lstart; n < job->lcnt; n++) {
+			/* Update sliding window */
+			/* This is the first and cheapest filter */
+			if (sliding_window_allowed) {
+				if (ssl[n].len > ub) {	/* no possible matches yet for this r */
+					lstart++;
+					continue;
+				}
+				if (ssl[n].len < lb) {	/* no more possible matches from this r */
+					break;
+				}
+			}
+			/* filter by comparing alphabet bitmaps */
+			/* find the best possible m: the length of the shorter string
+			 * minus the number of characters that surely cannot match */
+			shortest = ssl[n].len < ssr[rstart].len ? &ssl[n] : &ssr[rstart];
+			m = shortest->len - popcount64(shortest->abm -
+										   (ssl[n].abm & ssr[rstart].abm));
+			/* equivalent to:
+			   m = shortest->len - popcount64(shortest->abm & (~(ssl[n].abm & ssr[rstart].abm))); */
+			s = jarowinkler_lp_m_t0(&ssl[n], &ssr[rstart], lp, m);
+			if (s < threshold) {
+				continue;
+			}
+			/* final and most expensive test: Jaro-Winkler similarity */
+			s = jarowinkler(&ssl[n], &ssr[rstart], -1, buf->x_flags, buf->y_flags);
+			if (s < threshold) {
+				continue;
+			}
+			/* The match test succeeded */
+			if (simjoin_add(c, n, rstart) != GDK_SUCCEED)
+				return GDK_FAIL;
+		}
+	}
+	return GDK_SUCCEED;
+}
+
 static str
 minjarowinklerjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr,
 				   const dbl threshold)
@@ -902,11 +1391,11 @@ minjarowinklerjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr,
 	BUN n;
 	struct canditer lci, rci;
 	const char *lvals, *rvals, *lvars, *rvars;
-	int lwidth, rwidth, lb = 0, ub = 0, m = -1, *x_flags = NULL, *y_flags = NULL;
-	str_item *ssl = NULL, *ssr = NULL, shortest;
+	int lwidth, rwidth;
+	str_item *ssl = NULL, *ssr = NULL;
+	BUN lcnt = 0, rcnt = 0;
 	str msg = MAL_SUCCEED;
-	const bool sliding_window_allowed = threshold > (2.01 + JARO_WINKLER_PREFIX_LEN * JARO_WINKLER_SCALING_FACTOR) / 3.0;
-	double s, lp = 0;
+	simjoin job = { 0 };
 
 	assert(ATOMtype(l->ttype) == ATOMtype(r->ttype));
 	assert(ATOMtype(l->ttype) == TYPE_str);
@@ -914,8 +1403,19 @@ minjarowinklerjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr,
 	canditer_init(&lci, l, sl);
 	canditer_init(&rci, r, sr);
 
-	if (lci.ncand == 0 || rci.ncand == 0)
+	if (lci.ncand == 0 || rci.ncand == 0) {
+		/* no pairs, but the caller still needs two results */
+		if ((r1t = BATdense(0, 0, 0)) == NULL ||
+			(r2t = BATdense(0, 0, 0)) == NULL) {
+			reclaim_bats(2, r1t, r2t);
+			msg = createException(MAL, "txtsim.minjarowinklerjoin",
+								  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+			goto exit;
+		}
+		*r1 = r1t;
+		*r2 = r2t;
 		goto exit;
+	}
 
 	lvals = (const char *) Tloc(l, 0);
 	rvals = (const char *) Tloc(r, 0);
@@ -944,84 +1444,35 @@ minjarowinklerjoin(BAT **r1, BAT **r2, BAT *l, BAT *r, BAT *sl, BAT *sr,
 		goto exit;
 	}
 
-	PREP_BAT_STRITEM(l, lci, ssl);
-	PREP_BAT_STRITEM(r, rci, ssr);
-	qsort(ssl, lci.ncand, sizeof(str_item), str_item_lenrev_cmp);
-	qsort(ssr, rci.ncand, sizeof(str_item), str_item_lenrev_cmp);
-
-	if ((x_flags = GDKmalloc(ssl[0].len * sizeof(int))) == NULL ||
-		(y_flags = GDKmalloc(ssr[0].len * sizeof(int))) == NULL) {
-		msg = createException(MAL, "txtsim.minjarowinklerjoin",
-							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	PREP_BAT_STRITEM(l, lci, ssl, lcnt);
+	PREP_BAT_STRITEM(r, rci, ssr, rcnt);
+	qsort(ssl, lcnt, sizeof(str_item), str_item_lenrev_cmp);
+	qsort(ssr, rcnt, sizeof(str_item), str_item_lenrev_cmp);
+
+	job = (simjoin) {
+		.lsi = ssl,
+		.rsi = ssr,
+		.lcnt = lcnt,
+		.rcnt = rcnt,
+		.jarowinkler = true,
+		.threshold = threshold,
+		.func = minjarowinkler_nested,
+	};
+	if (lcnt > 0 && rcnt > 0 &&
+		(msg = simjoin_run(&job, r1t, r2t, "txtsim.minjarowinklerjoin")) != MAL_SUCCEED) {
+		reclaim_bats(2, r1t, r2t);
 		goto exit;
 	}
-	// lp used for filters. Use -1 for actual JW (forces to compute actual lp)
-	lp = JARO_WINKLER_PREFIX_LEN * JARO_WINKLER_SCALING_FACTOR;
-
-	/* join loop */
-	for (BUN lstart = 0, rstart = 0; rstart < rci.ncand; rstart++) {
-		if (sliding_window_allowed)
-			jarowinkler_rangebounds(&lb, &ub, &ssr[rstart], lp, threshold);
-		for (n = lstart; n < lci.ncand; n++) {
-			/* Update sliding window */
-			/* This is the first and cheapest filter */
-			if (sliding_window_allowed) {
-				if (ssl[n].len > ub) {	/* no possible matches yet for this r */
-					lstart++;
-					continue;
-				}
-				if (ssl[n].len < lb) {	/* no more possible matches from this r */
-					break;
-				}
-			}
-			/* filter by comparing alphabet bitmaps */
-			/* find the best possible m: the length of the shorter string
-			 * minus the number of characters that surely cannot match */
-			shortest = ssl[n].len < ssr[rstart].len ? ssl[n] : ssr[rstart];
-			m = shortest.len - popcount64(shortest.abm -
-										  (ssl[n].abm & ssr[rstart].abm));
-			/* equivalent to:
-			   m = shortest.len - popcount64(shortest.abm & (~(ssl[n].abm & ssr[rstart].abm))); */
-			s = jarowinkler_lp_m_t0(&ssl[n], &ssr[rstart], lp, m);
-			if (s < threshold) {
-				continue;
-			}
-			/* final and most expensive test: Jaro-Winkler similarity */
-			s = jarowinkler(&ssl[n], &ssr[rstart], -1, x_flags, y_flags);
-			if (s < threshold) {
-				continue;
-			}
-			/* The match test succeeded */
-			ssl[n].matches++;
-			ssr[rstart].matches++;
-			if (bunfastappTYPE(oid, r1t, &(ssl[n].o)) != GDK_SUCCEED) {
-				reclaim_bats(2, r1t, r2t);
-				msg = createException(MAL, "txtsim.maxlevenshteinjoin",
-									  OPERATION_FAILED "Failed bun append");
-				goto exit;
-			}
-			if (bunfastappTYPE(oid, r2t, &(ssr[rstart].o)) != GDK_SUCCEED) {
-				reclaim_bats(2, r1t, r2t);
-				msg = createException(MAL, "txtsim.maxlevenshteinjoin",
-									  OPERATION_FAILED "Failed bun append");
-				goto exit;
-			}
-		}
-	}
 
-	FINALIZE_BATS(r1t, r2t, lci, rci, ssl, ssr);
+	FINALIZE_BATS(r1t, r2t, lcnt, rcnt, ssl, ssr);
 	*r1 = r1t;
 	*r2 = r2t;
 
   exit:
-	if (ssl)
-		for (n = 0; n < lci.ncand; n++)
-			GDKfree(ssl[n].cp_sequence);
-	if (ssr)
-		for (n = 0; n < rci.ncand; n++)
-			GDKfree(ssr[n].cp_sequence);
-	GDKfree(x_flags);
-	GDKfree(y_flags);
+	for (n = 0; n < lcnt; n++)
+		GDKfree(ssl[n].cp_sequence);
+	for (n = 0; n < rcnt; n++)
+		GDKfree(ssr[n].cp_sequence);
 	GDKfree(ssl);
 	GDKfree(ssr);
 	return msg;
@@ -1482,6 +1933,7 @@ mel_func txtsim_init_funcs[] = {
 	pattern("txtsim", "maxlevenshtein", TXTSIMmaxlevenshtein, false, "Levenshtein distance with variable costs but up to a MAX", args(1, 6, arg("",int), arg("l",str),arg("r",str),arg("k",int),arg("insdel_cost",int),arg("replace_cost",int))),
 	pattern("battxtsim", "maxlevenshtein", BATTXTSIMmaxlevenshtein, false, "Same as maxlevenshtein but for BATS", args(1, 4, batarg("",bit), batarg("l",str),batarg("r",str),arg("k",int))),
 	pattern("battxtsim", "maxlevenshtein", BATTXTSIMmaxlevenshtein, false, "Same as maxlevenshtein but for BATS", args(1, 6, batarg("",bit), batarg("l",str),batarg("r",str),arg("k",int),arg("insdel_cost",int),arg("replace_cost",int))),
+	command("txtsim", "maxlevenshteinselect", TXTSIMmaxlevenshteinselect, false, "Select the values of b within Levenshtein distance k (basic costs) of y", args(1,6, batarg("",oid),batarg("b",str),batarg("s",oid),arg("y",str),arg("k",int),arg("anti",bit))),
 	command("txtsim", "maxlevenshteinjoin", TXTSIMmaxlevenshteinjoin, false, "", args(2,10, batarg("",oid),batarg("",oid),batarg("l",str),batarg("r",str),batarg("k",int),batarg("sl",oid),batarg("sr",oid),arg("nil_matches",bit),arg("estimate",lng),arg("anti",bit))),
 	command("txtsim", "soundex", soundex, false, "Soundex function for phonetic matching", args(1,2, arg("",str),arg("name",str))),
 	command("txtsim", "stringdiff", stringdiff, false, "Calculate the soundexed editdistance", args(1,3, arg("",int),arg("s1",str),arg("s2",str))),
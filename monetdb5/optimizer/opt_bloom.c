@@ -0,0 +1,222 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/*
+ * Sideways information passing for equi-joins.
+ * A join of a large (fact) column with a small, filtered (dimension)
+ * column probes every fact row against the dimension.  This optimizer
+ * summarizes the small side in a Bloom filter with its value range
+ * (algebra.bloom) and restricts the candidates of the large side to
+ * the rows that may match (algebra.bloomselect) before the join runs.
+ * The filter has no false negatives, so the join result is unchanged.
+ * After mergetable the small side is typically shared by the joins of
+ * all mitosis pieces; its filter is then built once and used by all.
+ * The kernel stops filtering by itself when the filter turns out not
+ * to be selective (see gdk/gdk_bloom.c).
+ */
+#include "monetdb_config.h"
+#include "opt_bloom.h"
+
+#define BLOOM_MINROWS	65536	/* smallest probe side worth filtering */
+#define BLOOM_RATIO		4		/* probe side at least this times larger */
+#define BLOOM_MAXFILTERS 64
+
+static bool
+bloomtype(int tpe)
+{
+	switch (ATOMbasetype(getBatType(tpe))) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+#ifdef HAVE_HGE
+	case TYPE_hge:
+#endif
+		return isaBatType(tpe) && getBatType(tpe) != TYPE_oid;
+	default:
+		return false;
+	}
+}
+
+/* an inner equi-join without nil matching */
+static bool
+bloomjoin(MalBlkPtr mb, InstrPtr p)
+{
+	int a;
+
+	if (getModuleId(p) != algebraRef || getFunctionId(p) != joinRef
+		|| p->barrier || p->argc != p->retc + 6)
+		return false;
+	a = getArg(p, p->retc + 4);
+	return isVarConstant(mb, a) && getVarType(mb, a) == TYPE_bit
+		&& getVarConstant(mb, a).val.btval == 0
+		&& bloomtype(getArgType(mb, p, p->retc))
+		&& bloomtype(getArgType(mb, p, p->retc + 1));
+}
+
+/* the row estimate of v, else that of the largest input of its
+ * definition; variables from nvars on were added by us */
+static BUN
+bloomrows(MalBlkPtr mb, InstrPtr *old, const int *def, int nvars, int v,
+		  int depth)
+{
+	BUN rows = getRowCnt(mb, v), r;
+	InstrPtr p;
+
+	if (rows > 0 || depth == 0 || v >= nvars || def[v] < 0)
+		return rows;
+	p = old[def[v]];
+	for (int j = p->retc; j < p->argc; j++)
+		if (isaBatType(getArgType(mb, p, j))
+			&& (r = bloomrows(mb, old, def, nvars, getArg(p, j), depth - 1)) > rows)
+			rows = r;
+	return rows;
+}
+
+str
+OPTbloomImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int i, j, limit, slimit, nvars, actions = 0, nfilters = 0;
+	int *def = NULL;
+	struct {
+		int r, s;				/* the small side and its candidates */
+		int f, min, max;		/* its filter */
+	} filters[BLOOM_MAXFILTERS];
+	InstrPtr p, q, *old = NULL;
+	bool found = false;
+	str msg = MAL_SUCCEED;
+
+	(void) stk;
+	if (mb->inlineProp)
+		goto wrapup;
+
+	/* only straight line code, so look at the whole block */
+	for (i = 0; i < mb->stop; i++) {
+		p = getInstrPtr(mb, i);
+		if (p->barrier)
+			goto wrapup;
+		if (bloomjoin(mb, p))
+			found = true;
+	}
+	if (!found)
+		goto wrapup;
+
+	limit = mb->stop;
+	slimit = mb->ssize;
+	old = mb->stmt;
+	nvars = mb->vtop;
+	if ((def = GDKmalloc(nvars * sizeof(int))) == NULL) {
+		old = NULL;
+		msg = createException(MAL, "optimizer.bloom",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto wrapup;
+	}
+	for (i = 0; i < nvars; i++)
+		def[i] = -1;
+	for (i = 0; i < limit; i++)
+		for (j = 0; j < old[i]->retc; j++)
+			def[getArg(old[i], j)] = i;
+
+	if (newMalBlkStmt(mb, mb->ssize) < 0) {
+		mb->stmt = old;
+		old = NULL;
+		msg = createException(MAL, "optimizer.bloom",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto wrapup;
+	}
+	for (i = 0; i < limit; i++) {
+		BUN lrows, rrows;
+		int l, r, sl, sr, f;
+
+		p = old[i];
+		if (!bloomjoin(mb, p)) {
+			pushInstruction(mb, p);
+			continue;
+		}
+		l = getArg(p, p->retc);
+		r = getArg(p, p->retc + 1);
+		sl = getArg(p, p->retc + 2);
+		sr = getArg(p, p->retc + 3);
+		lrows = bloomrows(mb, old, def, nvars, l, 3);
+		rrows = bloomrows(mb, old, def, nvars, r, 3);
+		/* without an estimate of the small side we cannot tell
+		 * whether filtering pays off */
+		if (lrows < BLOOM_MINROWS || rrows == 0
+			|| rrows > lrows / BLOOM_RATIO) {
+			pushInstruction(mb, p);
+			continue;
+		}
+
+		/* one filter per small side */
+		for (f = 0; f < nfilters; f++)
+			if (filters[f].r == r && filters[f].s == sr)
+				break;
+		if (f == nfilters) {
+			if (nfilters == BLOOM_MAXFILTERS) {
+				pushInstruction(mb, p);
+				continue;
+			}
+			q = newInstructionArgs(mb, algebraRef, bloomRef, 5);
+			if (q == NULL) {
+				pushInstruction(mb, p);
+				continue;
+			}
+			getArg(q, 0) = newTmpVariable(mb, newBatType(TYPE_lng));
+			q = pushReturn(mb, q, newTmpVariable(mb, getBatType(getVarType(mb, r))));
+			q = pushReturn(mb, q, newTmpVariable(mb, getBatType(getVarType(mb, r))));
+			q = pushArgument(mb, q, r);
+			q = pushArgument(mb, q, sr);
+			pushInstruction(mb, q);
+			filters[f].r = r;
+			filters[f].s = sr;
+			filters[f].f = getArg(q, 0);
+			filters[f].min = getArg(q, 1);
+			filters[f].max = getArg(q, 2);
+			nfilters++;
+		}
+
+		q = newInstructionArgs(mb, algebraRef, bloomselectRef, 6);
+		if (q == NULL) {
+			pushInstruction(mb, p);
+			continue;
+		}
+		getArg(q, 0) = newTmpVariable(mb, newBatType(TYPE_oid));
+		q = pushArgument(mb, q, l);
+		q = pushArgument(mb, q, sl);
+		q = pushArgument(mb, q, filters[f].f);
+		q = pushArgument(mb, q, filters[f].min);
+		q = pushArgument(mb, q, filters[f].max);
+		pushInstruction(mb, q);
+		getArg(p, p->retc + 2) = getArg(q, 0);
+		pushInstruction(mb, p);
+		actions++;
+	}
+	for (; i < slimit; i++)
+		if (old[i])
+			pushInstruction(mb, old[i]);
+
+	/* Defense line against incorrect plans */
+	if (actions > 0) {
+		msg = chkTypes(cntxt->usermodule, mb, FALSE);
+		if (!msg)
+			msg = chkFlow(mb);
+		if (!msg)
+			msg = chkDeclarations(mb);
+	}
+
+  wrapup:
+	/* keep actions taken as a fake argument */
+	(void) pushInt(mb, pci, actions);
+	GDKfree(old);
+	GDKfree(def);
+	return msg;
+}
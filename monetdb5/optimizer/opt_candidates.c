@@ -52,6 +52,10 @@ OPTcandidatesImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 				setVarCList(mb, getArg(p, 0));
 			else if (getFunctionId(p) == firstnRef)
 				setVarCList(mb, getArg(p, 0));
+			else if (getFunctionId(p) == firstnboundRef) {
+				for (int j = 0; j < p->retc; j++)
+					setVarCList(mb, getArg(p, j));
+			}
 			else if (getFunctionId(p) == subsliceRef)
 				setVarCList(mb, getArg(p, 0));
 			else if (getFunctionId(p) == projectionRef
@@ -13,6 +13,7 @@
 #include "monetdb_config.h"
 #include "opt_fastpath.h"
 #include "opt_aliases.h"
+#include "opt_bloom.h"
 #include "opt_coercion.h"
 #include "opt_commonTerms.h"
 #include "opt_candidates.h"
@@ -24,6 +25,7 @@
 #include "opt_for.h"
 #include "opt_emptybind.h"
 #include "opt_evaluate.h"
+#include "opt_fusion.h"
 #include "opt_garbageCollector.h"
 #include "opt_generator.h"
 #include "opt_inline.h"
@@ -125,6 +127,8 @@ OPTdefaultfastImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 	optcall(true, OPTcommonTermsImplementation);
 	optcall(true, OPTprojectionpathImplementation);
 	optcall(true, OPTdeadcodeImplementation);
+	optcall(true, OPTbloomImplementation);
+	optcall(true, OPTfusionImplementation);
 	optcall(true, OPTreorderImplementation);
 	optcall(true, OPTmatpackImplementation);
 	optcall(true, OPTdataflowImplementation);
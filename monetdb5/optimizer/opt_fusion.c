@@ -0,0 +1,741 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/*
+ * Pipelined execution of selection chains.
+ * Each MAL instruction materializes its result, so a plan that
+ * filters, projects, calculates and aggregates writes and reads back
+ * several intermediates of the size of the selection.  This optimizer
+ * looks for such chains ending in a scalar aggregate (one per mitosis
+ * piece after mergetable) and replaces them by a single algebra.fused
+ * instruction, which evaluates the chain vector at a time with cache
+ * resident intermediates (see modules/kernel/fusion.c).
+ * Any other instruction is a pipeline breaker; chains whose
+ * intermediates are used elsewhere are left alone.
+ */
+#include "monetdb_config.h"
+#include "opt_fusion.h"
+
+#define FUSION_VECTORSIZE 65536	/* default number of candidates per vector */
+#define FUSION_MAXSTEPS 32		/* longest chain considered */
+#define FUSION_MAXPROG 4096
+#define FUSION_MAXPATHS 64		/* most path expressions per batjson.filter */
+
+enum fusionkind {
+	FUSION_NONE,
+	FUSION_SELECT,
+	FUSION_THETASELECT,
+	FUSION_PROJECTION,
+	FUSION_CALC,
+};
+
+struct fusion {
+	MalBlkPtr mb;
+	InstrPtr *old;
+	int *def;					/* pc of the assignment of a variable */
+	int *uses;					/* number of times a variable is used */
+	char *mark;					/* 1: in the current chain, 2: fused */
+	int steps[FUSION_MAXSTEPS];
+	int nsteps;
+	int drvb, drvs;				/* driving column and candidates */
+	bool driver, positional;
+};
+
+static enum fusionkind
+fusionkind(MalBlkPtr mb, InstrPtr p)
+{
+	if (p->retc != 1 || p->barrier)
+		return FUSION_NONE;
+	if (getModuleId(p) == algebraRef) {
+		if (getFunctionId(p) == selectRef && p->argc >= 7 && p->argc <= 9)
+			return FUSION_SELECT;
+		if (getFunctionId(p) == thetaselectRef && (p->argc == 4 || p->argc == 5))
+			return FUSION_THETASELECT;
+		if (getFunctionId(p) == projectionRef && p->argc == 3)
+			return FUSION_PROJECTION;
+	} else if (getModuleId(p) == batcalcRef
+			   && (getFunctionId(p) == plusRef || getFunctionId(p) == minusRef
+				   || getFunctionId(p) == mulRef || getFunctionId(p) == divRef)
+			   && p->argc >= 3 && p->argc <= 5
+			   && isaBatType(getArgType(mb, p, 0))) {
+		return FUSION_CALC;
+	}
+	return FUSION_NONE;
+}
+
+/* does the selection have a candidate list argument */
+static inline bool
+fusioncands(MalBlkPtr mb, InstrPtr p)
+{
+	int tpe = getArgType(mb, p, 2);
+	return p->argc > 2 && (isaBatType(tpe) || tpe == TYPE_bat);
+}
+
+/* the kind of the instruction that computes variable v */
+static enum fusionkind
+fusiondef(struct fusion *f, int v)
+{
+	int pc = f->def[v];
+
+	if (pc < 0 || f->mark[pc] == 2)
+		return FUSION_NONE;
+	return fusionkind(f->mb, f->old[pc]);
+}
+
+static bool
+fusiondriver(struct fusion *f, int b, int s)
+{
+	if (f->driver)
+		return f->drvb == b && f->drvs == s;
+	f->driver = true;
+	f->drvb = b;
+	f->drvs = s;
+	return true;
+}
+
+/* Add the instruction that computes v to the chain, together with
+ * the instructions computing its fusable operands. */
+static bool
+fusioncollect(struct fusion *f, int v)
+{
+	int pc = f->def[v], a;
+	InstrPtr p;
+	enum fusionkind kind = fusiondef(f, v);
+
+	if (kind == FUSION_NONE)
+		return false;
+	if (f->mark[pc] == 1)
+		return true;			/* a candidate list used twice */
+	if (f->nsteps == FUSION_MAXSTEPS)
+		return false;
+	p = f->old[pc];
+	f->mark[pc] = 1;
+	f->steps[f->nsteps++] = pc;
+
+	switch (kind) {
+	case FUSION_SELECT:
+	case FUSION_THETASELECT:
+		if (!fusioncands(f->mb, p))
+			return fusiondriver(f, getArg(p, 1), -1);
+		a = getArg(p, 2);
+		if (fusiondef(f, a) == FUSION_SELECT
+			|| fusiondef(f, a) == FUSION_THETASELECT)
+			return fusioncollect(f, a);
+		return fusiondriver(f, getArg(p, 1), a);
+	case FUSION_PROJECTION:
+		a = getArg(p, 1);
+		if (fusiondef(f, a) == FUSION_SELECT
+			|| fusiondef(f, a) == FUSION_THETASELECT)
+			return fusioncollect(f, a);
+		return fusiondriver(f, -1, a);
+	case FUSION_CALC:
+		for (int j = 1; j < 3; j++) {
+			a = getArg(p, j);
+			if (!isaBatType(getArgType(f->mb, p, j)))
+				continue;
+			if (fusiondef(f, a) == FUSION_PROJECTION
+				|| fusiondef(f, a) == FUSION_CALC) {
+				if (!fusioncollect(f, a))
+					return false;
+			} else {
+				/* a column that is sliced along */
+				f->positional = true;
+				if (f->drvb < 0)
+					f->drvb = a;
+			}
+		}
+		/* the candidate lists do not match the vectors */
+		for (int j = 3; j < p->argc; j++)
+			if (!isVarConstant(f->mb, getArg(p, j))
+				|| !is_bat_nil(getVarConstant(f->mb, getArg(p, j)).val.bval))
+				return false;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* can the scalar aggregate be computed from partial aggregates */
+static bool
+fusionaggr(MalBlkPtr mb, InstrPtr p)
+{
+	int tpe;
+
+	if (getModuleId(p) != aggrRef || p->retc != 1
+		|| (p->argc != 2 && p->argc != 3)
+		|| isaBatType(getArgType(mb, p, 0))
+		|| !isaBatType(getArgType(mb, p, 1))
+		|| (p->argc == 3 && getArgType(mb, p, 2) != TYPE_bit))
+		return false;
+	tpe = getBatType(getArgType(mb, p, 1));
+	if (getFunctionId(p) == countRef)
+		return true;
+	if (ATOMextern(tpe) || ATOMextern(getArgType(mb, p, 0)))
+		return false;
+	/* like mitosis, don't split floating point sums */
+	if (getFunctionId(p) == sumRef)
+		return tpe != TYPE_flt && tpe != TYPE_dbl;
+	return getFunctionId(p) == minRef || getFunctionId(p) == maxRef;
+}
+
+struct fusionprog {
+	char prog[FUSION_MAXPROG];
+	size_t len;
+	int args[FUSION_MAXSTEPS * 9 + 1];	/* the arguments referenced */
+	int nargs;
+};
+
+static bool
+fusionprint(struct fusionprog *fp, const char *fmt, ...)
+	__attribute__((__format__(__printf__, 2, 3)));
+
+static bool
+fusionprint(struct fusionprog *fp, const char *fmt, ...)
+{
+	va_list ap;
+	int n;
+
+	va_start(ap, fmt);
+	n = vsnprintf(fp->prog + fp->len, sizeof(fp->prog) - fp->len, fmt, ap);
+	va_end(ap);
+	if (n < 0 || (size_t) n >= sizeof(fp->prog) - fp->len)
+		return false;
+	fp->len += n;
+	return true;
+}
+
+/* append the operand token for variable a to the program */
+static bool
+fusionarg(struct fusion *f, struct fusionprog *fp, int a, char kind,
+		  bool first)
+{
+	const char *sep = first ? "" : ",";
+
+	for (int k = 0; k < f->nsteps; k++) {
+		if (getArg(f->old[f->steps[k]], 0) == a)
+			return fusionprint(fp, "%s$%d", sep, k);
+	}
+	if (kind == 'a' || kind == 'v') {
+		if (fp->nargs == (int) (sizeof(fp->args) / sizeof(fp->args[0])))
+			return false;
+		fp->args[fp->nargs++] = a;
+	}
+	return fusionprint(fp, "%s%c", sep, kind);
+}
+
+/* encode the chain and its aggregate p, see modules/kernel/fusion.c */
+static bool
+fusionencode(struct fusion *f, struct fusionprog *fp, InstrPtr p)
+{
+	int j;
+
+	for (int k = 0; k < f->nsteps; k++) {
+		InstrPtr r = f->old[f->steps[k]];
+
+		switch (fusionkind(f->mb, r)) {
+		case FUSION_SELECT:
+		case FUSION_THETASELECT:
+			if (!fusionprint(fp, "%s(", getFunctionId(r))
+				|| !fusionarg(f, fp, getArg(r, 1), 'a', true))
+				return false;
+			j = 2;
+			if (!fusioncands(f->mb, r)) {
+				/* the candidates of the vector are added */
+				if (!fusionarg(f, fp, -1, 'c', false))
+					return false;
+			} else if (!fusionarg(f, fp, getArg(r, j), getArg(r, j) == f->drvs ? 'c' : 'a', false))
+				return false;
+			else
+				j++;
+			break;
+		case FUSION_PROJECTION:
+			if (!fusionprint(fp, "%s(", getFunctionId(r))
+				|| !fusionarg(f, fp, getArg(r, 1),
+							  getArg(r, 1) == f->drvs ? 'c' : 'a', true))
+				return false;
+			j = 2;
+			break;
+		case FUSION_CALC:
+			if (!fusionprint(fp, "%s:%s(", getFunctionId(r),
+							 ATOMname(getBatType(getArgType(f->mb, r, 0)))))
+				return false;
+			for (j = 1; j < 3; j++)
+				if (!fusionarg(f, fp, getArg(r, j),
+							   isaBatType(getArgType(f->mb, r, j)) ? 'v' : 'a',
+							   j == 1))
+					return false;
+			break;
+		default:
+			return false;
+		}
+		for (; j < r->argc; j++)
+			if (!fusionarg(f, fp, getArg(r, j), 'a', false))
+				return false;
+		if (!fusionprint(fp, ");"))
+			return false;
+	}
+	if (!fusionprint(fp, "%s(", getFunctionId(p)))
+		return false;
+	for (j = 1; j < p->argc; j++)
+		if (!fusionarg(f, fp, getArg(p, j), 'a', j == 1))
+			return false;
+	return fusionprint(fp, ")");
+}
+
+/* Try to replace the aggregate p and its chain by one instruction.
+ * Returns the new instruction, or NULL if not applicable. */
+static InstrPtr
+fusionchain(struct fusion *f, InstrPtr p, int vectorsize)
+{
+	struct fusionprog *fp = NULL;
+	BUN rows = 0;
+	InstrPtr q = NULL;
+	int k, j;
+
+	f->nsteps = 0;
+	f->drvb = f->drvs = -1;
+	f->driver = f->positional = false;
+	if (!fusioncollect(f, getArg(p, 1)) || f->driver == f->positional)
+		goto failed;
+
+	/* sort the chain in plan order */
+	for (k = 1; k < f->nsteps; k++)
+		for (j = k; j > 0 && f->steps[j - 1] > f->steps[j]; j--) {
+			int t = f->steps[j];
+			f->steps[j] = f->steps[j - 1];
+			f->steps[j - 1] = t;
+		}
+
+	/* the intermediates should not be used outside the chain */
+	for (k = 0; k < f->nsteps; k++) {
+		int v = getArg(f->old[f->steps[k]], 0), n = 0;
+		for (j = k + 1; j <= f->nsteps; j++) {
+			InstrPtr r = j < f->nsteps ? f->old[f->steps[j]] : p;
+			for (int a = r->retc; a < r->argc; a++)
+				n += getArg(r, a) == v;
+		}
+		if (n != f->uses[v])
+			goto failed;
+	}
+
+	/* only worthwhile if there is more than one vector to process */
+	for (k = 0; k < f->nsteps; k++) {
+		InstrPtr r = f->old[f->steps[k]];
+		for (j = r->retc; j < r->argc; j++)
+			if (isaBatType(getArgType(f->mb, r, j))
+				&& getRowCnt(f->mb, getArg(r, j)) > rows)
+				rows = getRowCnt(f->mb, getArg(r, j));
+	}
+	if (rows <= (BUN) vectorsize)
+		goto failed;
+
+	if ((fp = GDKzalloc(sizeof(struct fusionprog))) == NULL
+		|| !fusionencode(f, fp, p))
+		goto failed;
+
+	q = newInstructionArgs(f->mb, algebraRef, fusedRef, fp->nargs + 5);
+	if (q == NULL)
+		goto failed;
+	getArg(q, 0) = getArg(p, 0);
+	q = pushStr(f->mb, q, fp->prog);
+	q = pushInt(f->mb, q, vectorsize);
+	if (f->drvb >= 0)
+		q = pushArgument(f->mb, q, f->drvb);
+	else
+		q = pushNil(f->mb, q, newBatType(TYPE_oid));
+	if (f->drvs >= 0)
+		q = pushArgument(f->mb, q, f->drvs);
+	else
+		q = pushNil(f->mb, q, newBatType(TYPE_oid));
+	for (j = 0; j < fp->nargs; j++)
+		q = pushArgument(f->mb, q, fp->args[j]);
+	if (f->mb->errors)
+		goto failed;
+	GDKfree(fp);
+	for (k = 0; k < f->nsteps; k++)
+		f->mark[f->steps[k]] = 2;
+	return q;
+
+  failed:
+	for (k = 0; k < f->nsteps; k++)
+		f->mark[f->steps[k]] = 0;
+	if (q)
+		freeInstruction(q);
+	GDKfree(fp);
+	return NULL;
+}
+
+/*
+ * Expression trees.
+ * The trees of batcalc arithmetic, comparison and conversion operators
+ * over large columns that are not part of a chain are replaced by a
+ * single batcalc.fused instruction, which evaluates the whole
+ * expression in one pass without column sized temporaries (see
+ * gdk/gdk_calc_expr.c).
+ */
+static inline bool
+fusioninteger(int tpe)
+{
+	switch (tpe) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+#ifdef HAVE_HGE
+	case TYPE_hge:
+#endif
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* the types BATcalcexpr can combine without changing values */
+static inline bool
+fusionwidens(int t1, int t2)
+{
+	if (fusioninteger(t1))
+		return (fusioninteger(t2) && ATOMsize(t1) <= ATOMsize(t2))
+			|| t2 == TYPE_flt || t2 == TYPE_dbl;
+	return (t1 == TYPE_flt || t1 == TYPE_dbl) && ATOMsize(t1) <= ATOMsize(t2)
+		&& (t2 == TYPE_flt || t2 == TYPE_dbl);
+}
+
+/* The operator token of a batcalc instruction that BATcalcexpr can
+ * evaluate (see gdk/gdk_calc_expr.c), or NULL. */
+static const char *
+fusionexprop(MalBlkPtr mb, InstrPtr p)
+{
+	static const char *cmps[] = { "<", "<=", ">", ">=", "==", "!=", NULL };
+	const char *fcn = getFunctionId(p);
+	int tpe, t1, t2, j, n = 2;
+	const char *op = NULL;
+
+	if (getModuleId(p) != batcalcRef || p->retc != 1 || p->barrier
+		|| p->argc < 3 || !isaBatType(getArgType(mb, p, 0)))
+		return NULL;
+	tpe = getBatType(getArgType(mb, p, 0));
+	t1 = getArgType(mb, p, 1);
+	t2 = getArgType(mb, p, 2);
+	if (fcn == plusRef || fcn == minusRef || fcn == mulRef || fcn == divRef) {
+		op = fcn;
+	} else if (tpe == TYPE_bit) {
+		for (j = 0; cmps[j]; j++)
+			if (strcmp(fcn, cmps[j]) == 0)
+				op = cmps[j];
+	} else if (strcmp(fcn, ATOMname(tpe)) == 0 && p->argc == 3) {
+		op = "conv";
+		n = 1;
+	}
+	if (op == NULL || p->argc > n + 3)
+		return NULL;
+	/* any candidate lists should be absent */
+	for (j = n + 1; j < p->argc; j++)
+		if ((getArgType(mb, p, j) != TYPE_bat
+			 && !isaBatType(getArgType(mb, p, j)))
+			|| !isVarConstant(mb, getArg(p, j))
+			|| !is_bat_nil(getVarConstant(mb, getArg(p, j)).val.bval))
+			return NULL;
+	if (n == 1) {
+		if (!isaBatType(t1) || getBatType(t1) == tpe
+			|| !fusionwidens(getBatType(t1), tpe))
+			return NULL;
+		return op;
+	}
+	if (!isaBatType(t1) && !isaBatType(t2))
+		return NULL;
+	t1 = getBatType(t1);
+	t2 = getBatType(t2);
+	if (tpe == TYPE_bit && op != fcn) {
+		if (t1 != t2 || !fusionwidens(t1, t1))
+			return NULL;
+	} else if (!fusioninteger(tpe) || op == divRef) {
+		if (t1 != tpe || t2 != tpe || !fusionwidens(tpe, tpe))
+			return NULL;
+	} else if (!fusioninteger(t1) || !fusioninteger(t2)
+			   || !fusionwidens(t1, tpe) || !fusionwidens(t2, tpe)) {
+		return NULL;
+	}
+	return op;
+}
+
+/* encode the expression tree computed by the instruction at pc */
+static bool
+fusionexprtree(struct fusion *f, struct fusionprog *fp, int pc)
+{
+	InstrPtr p = f->old[pc];
+	const char *op = fusionexprop(f->mb, p);
+	int n = strcmp(op, "conv") == 0 ? 1 : 2;
+
+	for (int j = 1; j <= n; j++) {
+		int a = getArg(p, j), d = f->def[a], k;
+
+		if (isaBatType(getArgType(f->mb, p, j)) && d >= 0 && f->mark[d] == 0
+			&& f->uses[a] == 1 && fusionexprop(f->mb, f->old[d])) {
+			if (f->nsteps == FUSION_MAXSTEPS)
+				return false;
+			f->mark[d] = 1;
+			f->steps[f->nsteps++] = d;
+			if (!fusionexprtree(f, fp, d))
+				return false;
+			continue;
+		}
+		for (k = 0; k < fp->nargs; k++)
+			if (fp->args[k] == a)
+				break;
+		if (k == fp->nargs) {
+			if (fp->nargs == (int) (sizeof(fp->args) / sizeof(fp->args[0])))
+				return false;
+			fp->args[fp->nargs++] = a;
+		}
+		if (!fusionprint(fp, "$%d;", k))
+			return false;
+	}
+	if (n == 1 || op == plusRef || op == minusRef || op == mulRef || op == divRef)
+		return fusionprint(fp, "%s:%s;", op,
+						   ATOMname(getBatType(getArgType(f->mb, p, 0))));
+	return fusionprint(fp, "%s;", op);
+}
+
+/* Estimate the number of rows of v.  Intermediates usually have no
+ * estimate, then use the largest input of the instruction computing
+ * it, which is an upper bound for the common operators. */
+static BUN
+fusionrows(struct fusion *f, int v, int depth)
+{
+	BUN rows = getRowCnt(f->mb, v), r;
+	InstrPtr p;
+
+	if (rows > 0 || depth == 0 || f->def[v] < 0)
+		return rows;
+	p = f->old[f->def[v]];
+	for (int j = p->retc; j < p->argc; j++)
+		if (isaBatType(getArgType(f->mb, p, j))
+			&& (r = fusionrows(f, getArg(p, j), depth - 1)) > rows)
+			rows = r;
+	return rows;
+}
+
+/* Try to replace the batcalc expression tree with root p by one
+ * batcalc.fused instruction.  Returns the new instruction, or NULL if
+ * not applicable. */
+static InstrPtr
+fusionexpr(struct fusion *f, int pc, int vectorsize)
+{
+	struct fusionprog *fp = NULL;
+	InstrPtr p = f->old[pc], q = NULL;
+	BUN rows = 0;
+	int k;
+
+	f->nsteps = 0;
+	if ((fp = GDKzalloc(sizeof(struct fusionprog))) == NULL
+		|| !fusionexprtree(f, fp, pc) || f->nsteps == 0)
+		goto failed;
+	fp->prog[--fp->len] = 0;	/* the trailing semicolon */
+
+	/* only worthwhile for large inputs */
+	for (k = 0; k < fp->nargs; k++) {
+		BUN r;
+		if (isaBatType(getVarType(f->mb, fp->args[k]))
+			&& (r = fusionrows(f, fp->args[k], 3)) > rows)
+			rows = r;
+	}
+	if (rows <= (BUN) vectorsize)
+		goto failed;
+
+	q = newInstructionArgs(f->mb, batcalcRef, fusedRef, fp->nargs + 2);
+	if (q == NULL)
+		goto failed;
+	getArg(q, 0) = getArg(p, 0);
+	q = pushStr(f->mb, q, fp->prog);
+	for (k = 0; k < fp->nargs; k++)
+		q = pushArgument(f->mb, q, fp->args[k]);
+	if (f->mb->errors)
+		goto failed;
+	GDKfree(fp);
+	for (k = 0; k < f->nsteps; k++)
+		f->mark[f->steps[k]] = 2;
+	return q;
+
+  failed:
+	for (k = 0; k < f->nsteps; k++)
+		f->mark[f->steps[k]] = 0;
+	if (q)
+		freeInstruction(q);
+	GDKfree(fp);
+	return NULL;
+}
+
+/*
+ * JSON path extraction.
+ * The batjson.filter calls with constant path expressions on the same
+ * column are combined into one, which parses each document only once.
+ */
+static inline bool
+fusionjson(MalBlkPtr mb, InstrPtr p)
+{
+	return getModuleId(p) == batjsonRef && getFunctionId(p) == filterRef
+		&& p->retc == 1 && p->argc == 3 && !p->barrier
+		&& isVarConstant(mb, getArg(p, 2))
+		&& getArgType(mb, p, 2) == TYPE_str;
+}
+
+/* Combine the path extractions from the same column as the one at pc
+ * into a single batjson.filter instruction. */
+static InstrPtr
+fusionpaths(struct fusion *f, InstrPtr *fused, int pc, int limit)
+{
+	InstrPtr p = f->old[pc], q;
+	int steps[FUSION_MAXPATHS], n = 1;
+
+	steps[0] = pc;
+	for (int i = pc + 1; i < limit && n < FUSION_MAXPATHS; i++)
+		if (f->mark[i] == 0 && fused[i] == NULL && fusionjson(f->mb, f->old[i])
+			&& getArg(f->old[i], 1) == getArg(p, 1))
+			steps[n++] = i;
+	if (n == 1)
+		return NULL;
+	q = newInstructionArgs(f->mb, batjsonRef, filterRef, 2 * n + 1);
+	if (q == NULL)
+		return NULL;
+	getArg(q, 0) = getArg(p, 0);
+	for (int k = 1; k < n; k++)
+		q = pushReturn(f->mb, q, getArg(f->old[steps[k]], 0));
+	q = pushArgument(f->mb, q, getArg(p, 1));
+	for (int k = 0; k < n; k++)
+		q = pushArgument(f->mb, q, getArg(f->old[steps[k]], 2));
+	if (f->mb->errors) {
+		freeInstruction(q);
+		return NULL;
+	}
+	for (int k = 0; k < n; k++)
+		f->mark[steps[k]] = 2;
+	return q;
+}
+
+str
+OPTfusionImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
+						InstrPtr pci)
+{
+	int i, j, limit, slimit, actions = 0;
+	int vectorsize = GDKgetenv_int("fusion_vectorsize", FUSION_VECTORSIZE);
+	InstrPtr p, *old = NULL, *fused = NULL;
+	struct fusion f = { .mb = mb };
+	bool found = false;
+	str msg = MAL_SUCCEED;
+
+	(void) stk;
+	if (mb->inlineProp)
+		goto wrapup;
+
+	/* only straight line code, so look at the whole block */
+	for (i = 0; i < mb->stop; i++) {
+		p = getInstrPtr(mb, i);
+		if (p->barrier)
+			goto wrapup;
+		if ((vectorsize > 0 && (fusionaggr(mb, p) || fusionexprop(mb, p)))
+			|| fusionjson(mb, p))
+			found = true;
+	}
+	if (!found)
+		goto wrapup;
+
+	limit = mb->stop;
+	slimit = mb->ssize;
+	f.def = GDKmalloc(mb->vtop * sizeof(int));
+	f.uses = GDKzalloc(mb->vtop * sizeof(int));
+	f.mark = GDKzalloc(limit);
+	fused = GDKzalloc(limit * sizeof(InstrPtr));
+	if (f.def == NULL || f.uses == NULL || f.mark == NULL || fused == NULL) {
+		msg = createException(MAL, "optimizer.fusion",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto wrapup;
+	}
+	old = f.old = mb->stmt;
+	for (i = 0; i < mb->vtop; i++)
+		f.def[i] = -1;
+	for (i = 0; i < limit; i++) {
+		p = old[i];
+		for (j = p->retc; j < p->argc; j++)
+			f.uses[getArg(p, j)]++;
+		for (j = 0; j < p->retc; j++) {
+			if (f.def[getArg(p, j)] >= 0)
+				goto wrapup;	/* not single assignment */
+			f.def[getArg(p, j)] = i;
+		}
+	}
+
+	/* fusion_vectorsize=0 disables the vectorized chains, the path
+	 * extractions are still combined */
+	for (i = 0; vectorsize > 0 && i < limit; i++) {
+		if (fusionaggr(mb, old[i])
+			&& (fused[i] = fusionchain(&f, old[i], vectorsize)) != NULL)
+			actions++;
+	}
+	/* the remaining calculations, from the root of each tree */
+	for (i = limit - 1; vectorsize > 0 && i >= 0; i--) {
+		if (f.mark[i] == 0 && fused[i] == NULL && fusionexprop(mb, old[i])
+			&& (fused[i] = fusionexpr(&f, i, vectorsize)) != NULL)
+			actions++;
+	}
+	for (i = 0; i < limit; i++) {
+		if (f.mark[i] == 0 && fused[i] == NULL && fusionjson(mb, old[i])
+			&& (fused[i] = fusionpaths(&f, fused, i, limit)) != NULL)
+			actions++;
+	}
+	if (actions == 0) {
+		old = NULL;
+		goto wrapup;
+	}
+
+	if (newMalBlkStmt(mb, mb->ssize) < 0) {
+		for (i = 0; i < limit; i++)
+			if (fused[i])
+				freeInstruction(fused[i]);
+		mb->stmt = old;
+		old = NULL;
+		msg = createException(MAL, "optimizer.fusion",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto wrapup;
+	}
+	for (i = 0; i < limit; i++) {
+		p = old[i];
+		if (fused[i]) {
+			pushInstruction(mb, fused[i]);
+			freeInstruction(p);
+		} else if (f.mark[i] == 2)
+			freeInstruction(p);
+		else
+			pushInstruction(mb, p);
+	}
+	for (; i < slimit; i++)
+		if (old[i])
+			pushInstruction(mb, old[i]);
+
+	/* Defense line against incorrect plans */
+	msg = chkTypes(cntxt->usermodule, mb, FALSE);
+	if (!msg)
+		msg = chkFlow(mb);
+	if (!msg)
+		msg = chkDeclarations(mb);
+	GDKfree(old);
+	old = NULL;
+
+  wrapup:
+	/* keep actions taken as a fake argument */
+	(void) pushInt(mb, pci, actions);
+	GDKfree(f.def);
+	GDKfree(f.uses);
+	GDKfree(f.mark);
+	GDKfree(fused);
+	return msg;
+}
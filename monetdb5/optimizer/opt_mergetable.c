@@ -1337,6 +1337,54 @@ mat_aggr(MalBlkPtr mb, InstrPtr p, mat_t *mat, int m)
 	return MAL_SUCCEED;
 }
 
+/* Distinct counts of the pieces cannot be added, but their sketches
+ * can be merged: v:=aggr.approx_count_distinct(b) becomes the estimate
+ * of the merged sketches of the pieces. */
+static str
+mat_approx_count_distinct(MalBlkPtr mb, InstrPtr p, mat_t *mat, int m)
+{
+	InstrPtr q, r, s;
+
+	r = newInstructionArgs(mb, matRef, packRef, mat[m].mi->argc);
+	if (r == NULL)
+		throw(MAL, "optimizer.mergetable", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	getArg(r, 0) = newTmpVariable(mb, newBatType(TYPE_blob));
+	for (int k = 1; mb->errors == NULL && k < mat[m].mi->argc; k++) {
+		q = newInstruction(mb, aggrRef, hll_sketchRef);
+		if (q == NULL) {
+			freeInstruction(r);
+			throw(MAL, "optimizer.mergetable", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		}
+		getArg(q, 0) = newTmpVariable(mb, TYPE_blob);
+		q = pushArgument(mb, q, getArg(mat[m].mi, k));
+		pushInstruction(mb, q);
+		r = pushArgument(mb, r, getArg(q, 0));
+	}
+	pushInstruction(mb, r);
+
+	if (mb->errors == NULL) {
+		s = newInstruction(mb, aggrRef, hll_mergeRef);
+		if (s == NULL)
+			throw(MAL, "optimizer.mergetable", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		getArg(s, 0) = newTmpVariable(mb, TYPE_blob);
+		s = pushArgument(mb, s, getArg(r, 0));
+		pushInstruction(mb, s);
+
+		q = newInstruction(mb, aggrRef, hll_estimateRef);
+		if (q == NULL)
+			throw(MAL, "optimizer.mergetable", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		getArg(q, 0) = getArg(p, 0);
+		q = pushArgument(mb, q, getArg(s, 0));
+		pushInstruction(mb, q);
+	}
+	if (mb->errors) {
+		str msg = mb->errors;
+		mb->errors = NULL;
+		return msg;
+	}
+	return MAL_SUCCEED;
+}
+
 static int
 chain_by_length(mat_t *mat, int g)
 {
@@ -2048,12 +2096,35 @@ mat_pack_topn(MalBlkPtr mb, InstrPtr slc, mat_t *mat, int m)
 	return 0;
 }
 
+/* a firstn of n values of a single column of fixed size values
+ * without candidates or groups, computed in pieces */
+static bool
+topn_bound(MalBlkPtr mb, InstrPtr p, InstrPtr mat)
+{
+	int tpe, a;
+
+	if (getModuleId(p) != algebraRef || getFunctionId(p) != firstnRef
+		|| p->retc != 1 || p->argc != 8 || mat->argc <= 2)
+		return false;
+	tpe = getBatType(getArgType(mb, p, p->retc));
+	if (tpe == TYPE_void || tpe == TYPE_msk || tpe == TYPE_any
+		|| ATOMvarsized(tpe))
+		return false;
+	for (a = p->retc + 1; a <= p->retc + 2; a++)
+		if (!isVarConstant(mb, getArg(p, a))
+			|| !is_bat_nil(getVarConstant(mb, getArg(p, a)).val.bval))
+			return false;
+	a = getArg(p, p->argc - 1);
+	return isVarConstant(mb, a) && getVarType(mb, a) == TYPE_bit
+		&& getVarConstant(mb, a).val.btval == 0;
+}
+
 static int
 mat_topn(MalBlkPtr mb, InstrPtr p, matlist_t *ml, int m, int n, int o)
 {
 	int tpe = getArgType(mb, p, 0), k, is_slice = isSlice(p), zero = -1;
 	InstrPtr pck, gpck = NULL, q, r;
-	int with_groups = (p->retc == 2), piv = 0, topn2 = (n >= 0);
+	int with_groups = (p->retc == 2), piv = 0, topn2 = (n >= 0), bound = 0;
 
 	assert(topn2 || o < 0);
 	/* dummy mat instruction (needed to share result of p) */
@@ -2086,7 +2157,31 @@ mat_topn(MalBlkPtr mb, InstrPtr p, matlist_t *ml, int m, int n, int o)
 		   || (ml->v[m].mi->argc == ml->v[n].mi->argc
 			   && ml->v[m].mi->argc == ml->v[o].mi->argc));
 
-	for (k = 1; mb->errors == NULL && k < ml->v[m].mi->argc; k++) {
+	/* the pieces of a topn on a single column are computed by a
+	 * single call, which lets the pieces share the value that the
+	 * pieces computed so far have proven to be good enough, so that
+	 * the others skip the values that are worse (see BATfirstnbound) */
+	if ((bound = topn_bound(mb, p, ml->v[m].mi))) {
+		q = newInstructionArgs(mb, algebraRef, firstnboundRef,
+							   2 * (ml->v[m].mi->argc - 1) + 3);
+		if (q == NULL) {
+			freeInstruction(pck);
+			return -1;
+		}
+		getArg(q, 0) = newTmpVariable(mb, tpe);
+		for (k = 2; k < ml->v[m].mi->argc; k++)
+			q = pushReturn(mb, q, newTmpVariable(mb, tpe));
+		q = pushArgument(mb, q, getArg(p, p->argc - 4));
+		q = pushArgument(mb, q, getArg(p, p->argc - 3));
+		q = pushArgument(mb, q, getArg(p, p->argc - 2));
+		for (k = 1; k < ml->v[m].mi->argc; k++)
+			q = pushArgument(mb, q, getArg(ml->v[m].mi, k));
+		pushInstruction(mb, q);
+		for (k = 0; k < q->retc; k++)
+			pck = pushArgument(mb, pck, getArg(q, k));
+	}
+
+	for (k = 1; !bound && mb->errors == NULL && k < ml->v[m].mi->argc; k++) {
 		if ((q = copyInstruction(p)) == NULL) {
 			freeInstruction(gpck);
 			freeInstruction(pck);
@@ -2266,6 +2361,13 @@ OPTmergetableImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 				|| getFunctionId(q) == groupdoneRef)
 				groupdone = 1;
 		}
+		/* a floating point sum of the sums per piece of a group
+		 * would depend on the number of pieces, so group the packed
+		 * input instead, which the kernel sums exactly in parallel */
+		if (getModuleId(p) == aggrRef && getFunctionId(p) == subsumRef
+			&& (getBatType(getArgType(mb, p, 0)) == TYPE_flt
+				|| getBatType(getArgType(mb, p, 0)) == TYPE_dbl))
+			groupdone = 1;
 		/* bail out if there is a input for a group, which has been used for a group already (solves problems with cube like groupings) */
 		if (getModuleId(p) == groupRef
 			&& (getFunctionId(p) == subgroupRef
@@ -2451,13 +2553,19 @@ OPTmergetableImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 		 * The simple cases are dealt with first.
 		 * Handle the rewrite v:=aggr.count(b) and sum()
 		 * And the min/max is as easy
+		 * A floating point sum of sums of the pieces would depend on
+		 * the number of pieces, so those are left to the packed
+		 * input, which the kernel sums exactly in parallel.
 		 */
 		if (match == 1 && p->argc >= 2 &&
 			((getModuleId(p) == aggrRef &&
 			  (getFunctionId(p) == countRef
 			   || getFunctionId(p) == count_no_nilRef
 			   || getFunctionId(p) == minRef || getFunctionId(p) == maxRef
-			   || getFunctionId(p) == avgRef || getFunctionId(p) == sumRef
+			   || getFunctionId(p) == avgRef
+			   || (getFunctionId(p) == sumRef
+				   && getArgType(mb, p, 0) != TYPE_flt
+				   && getArgType(mb, p, 0) != TYPE_dbl)
 			   || getFunctionId(p) == prodRef)))
 			&& (m = is_a_mat(getArg(p, p->retc + 0), &ml)) >= 0) {
 			if ((msg = mat_aggr(mb, p, ml.v, m)) != MAL_SUCCEED)
@@ -2465,6 +2573,14 @@ OPTmergetableImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 			actions++;
 			continue;
 		}
+		if (match == 1 && p->argc == 2 && getModuleId(p) == aggrRef
+			&& getFunctionId(p) == approx_count_distinctRef
+			&& (m = is_a_mat(getArg(p, p->retc + 0), &ml)) >= 0) {
+			if ((msg = mat_approx_count_distinct(mb, p, ml.v, m)) != MAL_SUCCEED)
+				goto cleanup;
+			actions++;
+			continue;
+		}
 
 		if (match == 1 && bats == 1 && p->argc == 4 && isSlice(p)
 			&& ((m = is_a_mat(getArg(p, p->retc), &ml)) >= 0)) {
@@ -15,7 +15,7 @@
 #include "mal_interpreter.h"
 #include "gdk_utils.h"
 
-#define MIN_PART_SIZE 100000	/* minimal record count per partition */
+#define MIN_PART_SIZE 100000	/* default record count per partition, see mito_morsel */
 #define MAX_PARTS2THREADS_RATIO 4	/* There should be at most this multiple more of partitions then threads */
 
 
@@ -24,10 +24,10 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 						 InstrPtr pci)
 {
 	int i, j, limit, slimit, estimate = 0, pieces = 1, mito_parts = 0,
-		mito_size = 0, row_size = 0, mt = -1, nr_cols = 0, nr_aggrs = 0,
+		mito_size = 0, mito_morsel = 0, row_size = 0, mt = -1, nr_cols = 0, nr_aggrs = 0,
 		nr_maps = 0;
 	str schema = 0, table = 0;
-	BUN r = 0, rowcnt = 0;		/* table should be sizeable to consider parallel execution */
+	BUN r = 0, rowcnt = 0, morsel;	/* table should be sizeable to consider parallel execution */
 	InstrPtr p, q, *old, target = 0;
 	size_t argsize = 6 * sizeof(lng), m = 0;
 	/*       estimate size per operator estimate:   4 args + 2 res */
@@ -85,14 +85,13 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 			goto bailout;
 		}
 
-		/* do not split up floating point bat that is being summed */
+		/* do not split up floating point bat that is being summed;
+		 * grouped sums are left to mergetable, which groups the
+		 * packed input for them */
 		if (p->retc == 1 &&
-			(((p->argc == 5 || p->argc == 6)
-			  && getModuleId(p) == aggrRef
-			  && getFunctionId(p) == subsumRef)
-			 || (p->argc == 4
-				 && getModuleId(p) == aggrRef
-				 && getFunctionId(p) == sumRef))
+			p->argc == 4
+			&& getModuleId(p) == aggrRef
+			&& getFunctionId(p) == sumRef
 			&& isaBatType(getArgType(mb, p, p->retc))
 			&& (getBatType(getArgType(mb, p, p->retc)) == TYPE_flt
 				|| getBatType(getArgType(mb, p, p->retc)) == TYPE_dbl)) {
@@ -182,6 +181,11 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 	else
 		m = m / argsize;
 
+	/* the number of rows per piece (morsel) when the table fits in
+	 * memory */
+	mito_morsel = GDKgetenv_int("mito_morsel", 0);
+	morsel = mito_morsel > 0 ? (BUN) mito_morsel : MIN_PART_SIZE;
+
 	/* if data exceeds memory size,
 	 * i.e., (rowcnt*argsize > GDK_mem_maxsize),
 	 * i.e., (rowcnt > GDK_mem_maxsize/argsize = m) */
@@ -190,19 +194,19 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 		 * |threads| partitions at a time fit in memory,
 		 * i.e., (threads*(rowcnt/pieces) <= m),
 		 * i.e., (rowcnt/pieces <= m/threads),
-		 * i.e., (pieces => rowcnt/(m/threads))
-		 * (assuming that (m > threads*MIN_PART_SIZE)) */
+		 * i.e., (pieces => rowcnt/(m/threads)) */
 		/* the number of pieces affects SF-100, going beyond 8x increases
 		 * the optimizer costs beyond the execution time
 		 */
-		pieces = ((int) ceil((double) rowcnt / (m / threads)));
+		morsel = m / threads;
+		pieces = (int) MIN((BUN) maxparts, (rowcnt + morsel - 1) / morsel);
 		if (pieces <= threads)
 			pieces = threads;
-	} else if (rowcnt > MIN_PART_SIZE) {
-		/* exploit parallelism, but ensure minimal partition size to
-		 * limit overhead */
-		pieces = MIN((int) ceil((double) rowcnt / MIN_PART_SIZE),
-					 MAX_PARTS2THREADS_RATIO * threads);
+	} else if (rowcnt > morsel) {
+		/* exploit parallelism, but limit the number of pieces per
+		 * thread to limit overhead */
+		pieces = (int) MIN((BUN) (MAX_PARTS2THREADS_RATIO * threads),
+						   (rowcnt + morsel - 1) / morsel);
 	}
 
 	/* when testing, always aim for full parallelism, but avoid
@@ -314,6 +318,7 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 			q = pushInt(mb, q, pieces);
 
 			qv = getArg(q, 0) = newTmpVariable(mb, qtpe);
+			setRowCnt(mb, qv, r / pieces);
 			if (upd) {
 				rv = getArg(q, 1) = newTmpVariable(mb, rtpe);
 			}
@@ -94,6 +94,8 @@ static struct pipeline {
 		 "commonTerms",
 		 "projectionpath",
 		 "deadcode",
+		 "bloom",
+		 "fusion",
 		 "matpack",
 		 "reorder",
 		 "dataflow",
@@ -144,6 +146,8 @@ static struct pipeline {
 		 "commonTerms",
 		 "projectionpath",
 		 "deadcode",
+		 "bloom",
+		 "fusion",
 		 "matpack",
 		 "reorder",
 		 "dataflow",
@@ -189,6 +193,8 @@ static struct pipeline {
 		 "commonTerms",
 		 "projectionpath",
 		 "deadcode",
+		 "bloom",
+		 "fusion",
 		 "matpack",
 		 "reorder",
 		 "querylog",
@@ -34,12 +34,14 @@ const char *alter_tableRef;
 const char *alter_userRef;
 const char *appendBulkRef;
 const char *appendRef;
+const char *approx_count_distinctRef;
 const char *assertRef;
 const char *avgRef;
 const char *bandjoinRef;
 const char *batalgebraRef;
 const char *batcalcRef;
 const char *batcapiRef;
+const char *batjsonRef;
 const char *batmalRef;
 const char *batmkeyRef;
 const char *batmmathRef;
@@ -55,6 +57,8 @@ const char *binddbatRef;
 const char *bindidxRef;
 const char *bindRef;
 const char *blockRef;
+const char *bloomRef;
+const char *bloomselectRef;
 const char *bstreamRef;
 const char *calcRef;
 const char *capiRef;
@@ -115,10 +119,13 @@ const char *export_bin_columnRef;
 const char *exportOperationRef;
 const char *export_tableRef;
 const char *fetchRef;
+const char *filterRef;
 const char *findRef;
 const char *firstnRef;
+const char *firstnboundRef;
 const char *first_valueRef;
 const char *forRef;
+const char *fusedRef;
 const char *generatorRef;
 const char *getRef;
 const char *getTraceRef;
@@ -131,6 +138,9 @@ const char *groupdoneRef;
 const char *groupRef;
 const char *growRef;
 const char *hgeRef;
+const char *hll_estimateRef;
+const char *hll_mergeRef;
+const char *hll_sketchRef;
 const char *identityRef;
 const char *ifthenelseRef;
 const char *importColumnRef;
@@ -294,12 +304,14 @@ optimizerInit(void)
 	alter_userRef = putName("alter_user");
 	appendBulkRef = putName("appendBulk");
 	appendRef = putName("append");
+	approx_count_distinctRef = putName("approx_count_distinct");
 	assertRef = putName("assert");
 	avgRef = putName("avg");
 	bandjoinRef = putName("bandjoin");
 	batalgebraRef = putName("batalgebra");
 	batcalcRef = putName("batcalc");
 	batcapiRef = putName("batcapi");
+	batjsonRef = putName("batjson");
 	batmalRef = putName("batmal");
 	batmkeyRef = putName("batmkey");
 	batmmathRef = putName("batmmath");
@@ -315,6 +327,8 @@ optimizerInit(void)
 	bindidxRef = putName("bind_idxbat");
 	bindRef = putName("bind");
 	blockRef = putName("block");
+	bloomRef = putName("bloom");
+	bloomselectRef = putName("bloomselect");
 	bstreamRef = putName("bstream");
 	calcRef = putName("calc");
 	capiRef = putName("capi");
@@ -375,10 +389,13 @@ optimizerInit(void)
 	exportOperationRef = putName("exportOperation");
 	export_tableRef = putName("export_table");
 	fetchRef = putName("fetch");
+	filterRef = putName("filter");
 	findRef = putName("find");
 	firstnRef = putName("firstn");
+	firstnboundRef = putName("firstnbound");
 	first_valueRef = putName("first_value");
 	forRef = putName("for");
+	fusedRef = putName("fused");
 	generatorRef = putName("generator");
 	getRef = putName("get");
 	getTraceRef = putName("getTrace");
@@ -391,6 +408,9 @@ optimizerInit(void)
 	groupRef = putName("group");
 	growRef = putName("grow");
 	hgeRef = putName("hge");
+	hll_estimateRef = putName("hll_estimate");
+	hll_mergeRef = putName("hll_merge");
+	hll_sketchRef = putName("hll_sketch");
 	identityRef = putName("identity");
 	ifthenelseRef = putName("ifthenelse");
 	importColumnRef = putName("importColumn");
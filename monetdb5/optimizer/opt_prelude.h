@@ -30,12 +30,14 @@ mal_export const char *alter_tableRef;
 mal_export const char *alter_userRef;
 mal_export const char *appendBulkRef;
 mal_export const char *appendRef;
+mal_export const char *approx_count_distinctRef;
 mal_export const char *assertRef;
 mal_export const char *avgRef;
 mal_export const char *bandjoinRef;
 mal_export const char *batalgebraRef;
 mal_export const char *batcalcRef;
 mal_export const char *batcapiRef;
+mal_export const char *batjsonRef;
 mal_export const char *batmalRef;
 mal_export const char *batmkeyRef;
 mal_export const char *batmmathRef;
@@ -51,6 +53,8 @@ mal_export const char *binddbatRef;
 mal_export const char *bindidxRef;
 mal_export const char *bindRef;
 mal_export const char *blockRef;
+mal_export const char *bloomRef;
+mal_export const char *bloomselectRef;
 mal_export const char *bstreamRef;
 mal_export const char *calcRef;
 mal_export const char *capiRef;
@@ -112,10 +116,13 @@ mal_export const char *export_bin_columnRef;
 mal_export const char *exportOperationRef;
 mal_export const char *export_tableRef;
 mal_export const char *fetchRef;
+mal_export const char *filterRef;
 mal_export const char *findRef;
 mal_export const char *firstnRef;
+mal_export const char *firstnboundRef;
 mal_export const char *first_valueRef;
 mal_export const char *forRef;
+mal_export const char *fusedRef;
 mal_export const char *generatorRef;
 mal_export const char *getRef;
 mal_export const char *getTraceRef;
@@ -128,6 +135,9 @@ mal_export const char *groupdoneRef;
 mal_export const char *groupRef;
 mal_export const char *growRef;
 mal_export const char *hgeRef;
+mal_export const char *hll_estimateRef;
+mal_export const char *hll_mergeRef;
+mal_export const char *hll_sketchRef;
 mal_export const char *identityRef;
 mal_export const char *ifthenelseRef;
 mal_export const char *importColumnRef;
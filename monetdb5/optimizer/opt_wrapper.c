@@ -25,6 +25,7 @@
  * The optimizer used so far
 */
 #include "opt_aliases.h"
+#include "opt_bloom.h"
 #include "opt_coercion.h"
 #include "opt_commonTerms.h"
 #include "opt_candidates.h"
@@ -34,6 +35,7 @@
 #include "opt_deadcode.h"
 #include "opt_emptybind.h"
 #include "opt_evaluate.h"
+#include "opt_fusion.h"
 #include "opt_garbageCollector.h"
 #include "opt_generator.h"
 #include "opt_inline.h"
@@ -63,6 +65,7 @@ static struct {
 	lng timing;
 } codes[] = {
 	{"aliases", &OPTaliasesImplementation, 0, 0},
+	{"bloom", &OPTbloomImplementation, 0, 0},
 	{"candidates", &OPTcandidatesImplementation, 0, 0},
 	{"coercions", &OPTcoercionImplementation, 0, 0},
 	{"commonTerms", &OPTcommonTermsImplementation, 0, 0},
@@ -75,6 +78,7 @@ static struct {
 	{"emptybind", &OPTemptybindImplementation, 0, 0},
 	{"evaluate", &OPTevaluateImplementation, 0, 0},
 	{"for", &OPTforImplementation, 0, 0},
+	{"fusion", &OPTfusionImplementation, 0, 0},
 	{"garbageCollector", &OPTgarbageCollectorImplementation, 0, 0},
 	{"generator", &OPTgeneratorImplementation, 0, 0},
 	{"inline", &OPTinlineImplementation, 0, 0},
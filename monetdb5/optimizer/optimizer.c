@@ -111,6 +111,8 @@ static mel_func optimizer_init_funcs[] = {
 			args(0, 2, arg("mod", str), arg("fcn", str))),
 	optwrapper_pattern("inline", "Expand inline functions"),
 	optwrapper_pattern("projectionpath", "Join path constructor"),
+	optwrapper_pattern("bloom", "Filter join inputs with Bloom filters of the other side"),
+	optwrapper_pattern("fusion", "Pipeline selection chains ending in an aggregate"),
 	optwrapper_pattern("mergetable", "Resolve the multi-table definitions"),
 	optwrapper_pattern("mitosis",
 					   "Modify the plan to exploit parallel processing on multiple cores"),
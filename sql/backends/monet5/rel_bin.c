@@ -1343,7 +1343,7 @@ is_const_func(sql_subfunc *f, list *attr)
 }
 
 static stmt*
-exp2bin_file_loader(backend *be, sql_exp *fe, stmt *left, stmt *right, stmt *sel)
+exp2bin_file_loader(backend *be, sql_exp *fe, stmt *left, stmt *right, stmt *sel, list *filters)
 {
 	assert(left == NULL); (void)left;
 	assert(right == NULL); (void)right;
@@ -1375,7 +1375,62 @@ exp2bin_file_loader(backend *be, sql_exp *fe, stmt *left, stmt *right, stmt *sel
 	sql_exp *topn = NULL;
 	if (list_length(arg_list) == 3)
 		topn = list_fetch(arg_list, 2);
-	return (stmt*)fl->load(be, f, filename, topn);
+	return (stmt*)fl->load(be, f, filename, topn, filters);
+}
+
+static bool
+rel_is_file_loader(sql_rel *rel)
+{
+	if (rel->op == op_table && rel->flag != TRIGGER_WRAPPER && !rel->l && rel->r) {
+		sql_exp *op = rel->r;
+		sql_subfunc *f = op->f;
+
+		return op->type == e_func && strcmp(f->func->base.name, "file_loader") == 0 &&
+			!sql_func_mod(f->func)[0] && !sql_func_imp(f->func)[0];
+	}
+	return false;
+}
+
+/* The comparisons of a selection on top of a file loader that the loader
+ * can use to skip data: column cmp atom, with the column renamed to the
+ * name the loader gave it.  Ranges are split into their two bounds. */
+static list *
+file_loader_filters(backend *be, sql_rel *sel, sql_rel *rel)
+{
+	mvc *sql = be->mvc;
+	sql_exp *op = rel->r;
+	sql_subfunc *f = op->f;
+	list *filters = NULL;
+
+	for (node *n = sel->exps->h; n; n = n->next) {
+		sql_exp *e = n->data, *c, *l, *h, *ce;
+		int i;
+
+		/* comparisons other than cmp_filter, cmp_or and the (not) in lists */
+		if (e->type != e_cmp || e->flag > cmp_equal || is_anti(e) || is_semantics(e) || is_symmetric(e))
+			continue;
+		c = e->l;
+		l = e->r;
+		h = e->f;
+		if (c->type != e_column || !is_atom(l->type) || l->f || (h && (!is_atom(h->type) || h->f)))
+			continue;
+		if (!(ce = c->l ? exps_bind_column2(rel->exps, c->l, c->r, NULL) : exps_bind_column(rel->exps, c->r, NULL, NULL, 0)) ||
+			(i = list_position(rel->exps, ce)) < 0 || i >= list_length(f->colnames))
+			continue;
+		sql_subtype *t = list_fetch(f->coltypes, i);
+		if (subtype_cmp(t, exp_subtype(l)) != 0 || (h && subtype_cmp(t, exp_subtype(h)) != 0))
+			continue;
+		sql_exp *col = exp_column(sql->sa, NULL, list_fetch(f->colnames, i), t, CARD_MULTI, 1, 0, 0);
+		if (!filters)
+			filters = sa_list(sql->sa);
+		if (h) {
+			append(filters, exp_compare(sql->sa, col, l, range2lcompare(e->flag)));
+			append(filters, exp_compare(sql->sa, col, h, range2rcompare(e->flag)));
+		} else {
+			append(filters, exp_compare(sql->sa, col, l, e->flag));
+		}
+	}
+	return filters;
 }
 
 stmt *
@@ -1556,7 +1611,7 @@ exp_bin(backend *be, sql_exp *e, stmt *left, stmt *right, stmt *grp, stmt *ext,
 			if (strcmp(fname, "copyfrombinary") == 0)
 				return exp2bin_copyfrombinary(be, e, left, right, sel);
 			if (strcmp(fname, "file_loader") == 0)
-				return exp2bin_file_loader(be, e, left, right, sel);
+				return exp2bin_file_loader(be, e, left, right, sel, NULL);
 			if (strcmp(fname, "-1") == 0) /* map arguments to A0 .. An */
 				return exp2bin_named_placeholders(be, e);
 		}
@@ -2305,7 +2360,7 @@ typedef struct trigger_input {
 } trigger_input;
 
 static stmt *
-rel2bin_table(backend *be, sql_rel *rel, list *refs)
+rel2bin_table(backend *be, sql_rel *rel, list *refs, list *filters)
 {
 	mvc *sql = be->mvc;
 	list *l;
@@ -2377,6 +2432,10 @@ rel2bin_table(backend *be, sql_rel *rel, list *refs)
 						ids = s;
 				}
 			}
+		} else if (filters) {
+			psub = exp2bin_file_loader(be, op, NULL, NULL, NULL, filters);
+			if (!psub)
+				return NULL;
 		} else {
 			psub = exp_bin(be, op, sub, NULL, NULL, NULL, NULL, NULL, 0, 0, 0); /* table function */
 			if (!psub)
@@ -4310,7 +4369,16 @@ rel2bin_select(backend *be, sql_rel *rel, list *refs)
 	stmt *predicate = NULL;
 
 	if (rel->l) { /* first construct the sub relation */
-		sub = subrel_bin(be, rel->l, refs);
+		sql_rel *l = rel->l;
+		list *filters;
+
+		/* let file loaders skip the data that cannot pass the selection */
+		if (!rel_is_ref(l) && rel_is_file_loader(l) && (filters = file_loader_filters(be, rel, l)) != NULL) {
+			sub = rel2bin_table(be, l, refs, filters);
+			sql->type = Q_TABLE;
+		} else {
+			sub = subrel_bin(be, rel->l, refs);
+		}
 		if (!sub)
 			return NULL;
 		sel = sub->cand;
@@ -6549,7 +6617,24 @@ rel2bin_output(backend *be, sql_rel *rel, list *refs)
 			fns = stmt_atom_string(be, sa_strdup(sql->sa, fn));
 			onclient = E_ATOM_INT(argnode->next->next->next->next->next->data);
 		}
-		stmt *export = stmt_export(be, sub, tsep, rsep, ssep, ns, onclient, fns);
+		/* file formats with a registered writer are written by it (on server only) */
+		file_loader_t *fl = NULL;
+		if (fn && !onclient && sub->type == st_list) {
+			char *lfn = mkLower(sa_strdup(sql->sa, fn)), *ext = strrchr(lfn, '.');
+			if (ext && !(fl = fl_find(ext + 1))) {
+				/* maybe compressed */
+				*ext = 0;
+				if ((ext = strrchr(lfn, '.')) != NULL)
+					fl = fl_find(ext + 1);
+			}
+		}
+		stmt *export;
+		if (fl && fl->dump) {
+			if (!(export = (stmt*)fl->dump(be, sub, sa_strdup(sql->sa, fn))))
+				return NULL;
+		} else {
+			export = stmt_export(be, sub, tsep, rsep, ssep, ns, onclient, fns);
+		}
 		list_append(slist, export);
 	} else if (tpe == TYPE_int) {
 		endianness endian = take_atom_arg(&argnode, TYPE_int)->val.ival;
@@ -7099,7 +7184,7 @@ subrel_bin(backend *be, sql_rel *rel, list *refs)
 		sql->type = Q_TABLE;
 		break;
 	case op_table:
-		s = rel2bin_table(be, rel, refs);
+		s = rel2bin_table(be, rel, refs, NULL);
 		sql->type = Q_TABLE;
 		break;
 	case op_join:
@@ -43,6 +43,7 @@
 #include "mal_resource.h"
 #include "mal_authorize.h"
 #include "gdk_cand.h"
+#include "gdk_logger.h"
 
 static inline void
 BBPnreclaim(int nargs, ...)
@@ -128,6 +129,17 @@ rel_need_distinct_query(sql_rel *rel)
 	return need_distinct;
 }
 
+/* mark the largest table of the plan for mitosis, unless the plan
+ * would not benefit from splitting */
+sql_rel *
+sql_partitionrelation(backend *be, sql_rel *rel)
+{
+	rel = rel_partition(be->mvc, rel);
+	if (rel && (rel_no_mitosis(be->mvc, rel) || rel_need_distinct_query(rel)))
+		be->no_mitosis = 1;
+	return rel;
+}
+
 sql_rel *
 sql_symbol2relation(backend *be, symbol *sym)
 {
@@ -151,9 +163,7 @@ sql_symbol2relation(backend *be, symbol *sym)
 	if (rel)
 		rel = sql_processrelation(be->mvc, rel, profile, 1, value_based_opt, storage_based_opt);
 	if (rel)
-		rel = rel_partition(be->mvc, rel);
-	if (rel && (rel_no_mitosis(be->mvc, rel) || rel_need_distinct_query(rel)))
-		be->no_mitosis = 1;
+		rel = sql_partitionrelation(be, rel);
 	if (rel /*&& (be->mvc->emode != m_plan || (ATOMIC_GET(&GDKdebug) & FORCEMITOMASK) == 0)*/)
 		rel = rel_physical(be->mvc, rel);
 	Tend = GDKusec();
@@ -5152,6 +5162,102 @@ SQLstr_column_stop_vacuum(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pc
 	return MAL_SUCCEED;
 }
 
+/* set the buffer manager priority of the column and index bats of a
+ * table: the number of clock sweeps they may stay unused before they
+ * are unloaded, or BBPPINNED to keep them loaded */
+static str
+SQLbbp_priority(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *m = NULL;
+	str msg = NULL;
+	char *sname = *getArgReference_str(stk, pci, 1);
+	char *tname = *getArgReference_str(stk, pci, 2);
+	int prio = *getArgReference_int(stk, pci, 3);
+
+	if ((msg = getSQLContext(cntxt, mb, &m, NULL)) != NULL)
+		return msg;
+	if ((msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+
+	sql_trans *tr = m->session->tr;
+	sqlstore *store = tr->store;
+	sql_schema *s = NULL;
+	sql_table *t = NULL;
+
+	if (strNil(sname))
+		throw(SQL, "sql.bbp_priority", SQLSTATE(42000) "Schema name cannot be NULL");
+	if (strNil(tname))
+		throw(SQL, "sql.bbp_priority", SQLSTATE(42000) "Table name cannot be NULL");
+	if (is_int_nil(prio) || prio < 0 || prio > BBPPINNED)
+		throw(SQL, "sql.bbp_priority", SQLSTATE(42000) "Priority must be between 0 and %d", BBPPINNED);
+	if ((s = mvc_bind_schema(m, sname)) == NULL)
+		throw(SQL, "sql.bbp_priority", SQLSTATE(3F000) "Invalid or missing schema %s",sname);
+	if ((t = mvc_bind_table(m, s, tname)) == NULL)
+		throw(SQL, "sql.bbp_priority", SQLSTATE(42S02) "Invalid or missing table %s.%s",sname,tname);
+	if (!isTable(t))
+		throw(SQL, "sql.bbp_priority", SQLSTATE(42000) "%s '%s' is not persistent",
+			  TABLE_TYPE_DESCRIPTION(t->type, t->properties), t->base.name);
+
+	for (node *n = ol_first_node(t->columns); n; n = n->next) {
+		sql_column *c = n->data;
+		BAT *b = store->storage_api.bind_col(tr, c, QUICK);
+
+		if (b && BBPsetpriority(b->batCacheid, prio) != GDK_SUCCEED)
+			throw(SQL, "sql.bbp_priority", GDK_EXCEPTION);
+	}
+	if (t->idxs) {
+		for (node *n = ol_first_node(t->idxs); n; n = n->next) {
+			sql_idx *i = n->data;
+			BAT *b;
+
+			if (!idx_has_column(i->type) || !ATOMIC_PTR_GET(&i->data))
+				continue;
+			b = store->storage_api.bind_idx(tr, i, QUICK);
+			if (b && BBPsetpriority(b->batCacheid, prio) != GDK_SUCCEED)
+				throw(SQL, "sql.bbp_priority", GDK_EXCEPTION);
+		}
+	}
+	return MAL_SUCCEED;
+}
+
+/* the group commit and replay statistics of the write-ahead log */
+static str
+SQLwal_statistics(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *m = NULL;
+	str msg = NULL;
+	log_stats st;
+	BAT *b[11] = {0};
+
+	if ((msg = getSQLContext(cntxt, mb, &m, NULL)) != NULL)
+		return msg;
+	if ((msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+
+	store_logstats(m->session->tr->store, &st);
+	lng vals[10] = {
+		st.commits, st.flushes, st.maxbatch, st.avglatency,
+		st.maxlatency, st.avgflush, st.replayfiles, st.replaytrans,
+		st.replaychanges, st.replaytime,
+	};
+	assert(pci->retc == 11);
+	for (int i = 0; i < 10; i++)
+		b[i] = BATconstant(0, TYPE_lng, &vals[i], 1, TRANSIENT);
+	b[10] = BATconstant(0, TYPE_int, &st.replayworkers, 1, TRANSIENT);
+	for (int i = 0; i < 11; i++) {
+		if (b[i] == NULL) {
+			for (int j = 0; j < 11; j++)
+				BBPreclaim(b[j]);
+			throw(SQL, "sql.wal_statistics", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		}
+	}
+	for (int i = 0; i < 11; i++) {
+		*getArgReference_bat(stk, pci, i) = b[i]->batCacheid;
+		BBPkeepref(b[i]);
+	}
+	return MAL_SUCCEED;
+}
+
 
 #include "sql_cat.h"
 #include "sql_rank.h"
@@ -6213,6 +6319,8 @@ pattern("sql", "decypher", SQLdecypher, false, "Return decyphered password", arg
 #endif
  pattern("sql", "vacuum", SQLstr_column_vacuum, true, "vacuum a string column", args(0,3, arg("sname",str),arg("tname",str),arg("cname",str))),
  pattern("sql", "vacuum", SQLstr_column_auto_vacuum, true, "auto vacuum string column with interval(sec)", args(0,4, arg("sname",str),arg("tname",str),arg("cname",str),arg("interval", int))),
+ pattern("sql", "wal_statistics", SQLwal_statistics, false, "write-ahead log group commit and replay statistics", args(11,11, batarg("commits",lng),batarg("flushes",lng),batarg("max_batch",lng),batarg("avg_latency",lng),batarg("max_latency",lng),batarg("avg_flush",lng),batarg("replay_files",lng),batarg("replay_transactions",lng),batarg("replay_changes",lng),batarg("replay_time",lng),batarg("replay_threads",int))),
+ pattern("sql", "bbp_priority", SQLbbp_priority, true, "set the buffer manager priority of the bats of a table", args(0,3, arg("sname",str),arg("tname",str),arg("priority",int))),
  pattern("sql", "stop_vacuum", SQLstr_column_stop_vacuum, true, "stop auto vacuum", args(0,3, arg("sname",str),arg("tname",str),arg("cname",str))),
  { .imp=NULL }
 };
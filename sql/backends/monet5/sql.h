@@ -56,6 +56,7 @@
 
 extern int sqlcleanup(backend *be, int err);
 extern sql_rel *sql_symbol2relation(backend *be, symbol *sym);
+extern sql_rel *sql_partitionrelation(backend *be, sql_rel *rel);
 
 extern BAT *mvc_bind(mvc *m, const char *sname, const char *tname, const char *cname, int access);
 extern BAT *mvc_bind_idxbat(mvc *m, const char *sname, const char *tname, const char *iname, int access);
@@ -1475,16 +1475,19 @@ backend_create_sql_func_body(backend *be, sql_func *f, list *restypes, list *ops
 	sql_rel *r;
 
 	r = rel_parse(m, f->s, f->query, prepare?m_prepare:m_instantiate);
-	if (r) {
+	if (r)
 		r = sql_processrelation(m, r, 0, 1, 1, 0);
+	backend_reset(be);
+	/* a prepared statement is split up like it was at PREPARE time,
+	 * now for the current table sizes */
+	if (r && prepare)
+		r = sql_partitionrelation(be, r);
+	if (r)
 		r = rel_physical(m, r);
-	}
 	if (!r) {
 		goto cleanup;
 	}
 
-	backend_reset(be);
-
 	if (f->res && !prepare) {
 		sql_arg *fres = f->res->h->data;
 		if (f->type == F_UNION) {
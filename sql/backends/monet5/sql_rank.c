@@ -40,6 +40,62 @@ finalize_output(bat *res, BAT *r, str msg)
 		BBPreclaim(r);
 }
 
+/* The window functions are evaluated by GDKanalyticalparallel, which
+ * calls one of the following for each piece of the input. */
+struct window_arg {
+	union {
+		gdk_return (*tpe)(BAT *, BAT *, BAT *, BAT *, BAT *, BAT *, int, int);
+		gdk_return (*sumprod)(BAT *, BAT *, BAT *, BAT *, BAT *, BAT *, int, int, int);
+		gdk_return (*covar)(BAT *, BAT *, BAT *, BAT *, BAT *, BAT *, BAT *, int, int);
+	} func;
+	int tp1, tp2, frame_type, unit;
+	bit ignore_nils;
+	const void *limit;
+	bool preceding;
+	oid second_half;
+};
+
+static gdk_return
+window_tpe(BAT *r, BAT *p, BAT *o, BAT *b, BAT *b2, BAT *s, BAT *e, const void *arg)
+{
+	const struct window_arg *a = arg;
+	(void) b2;
+	return a->func.tpe(r, p, o, b, s, e, a->tp1, a->frame_type);
+}
+
+static gdk_return
+window_sumprod(BAT *r, BAT *p, BAT *o, BAT *b, BAT *b2, BAT *s, BAT *e, const void *arg)
+{
+	const struct window_arg *a = arg;
+	(void) b2;
+	return a->func.sumprod(r, p, o, b, s, e, a->tp1, a->tp2, a->frame_type);
+}
+
+static gdk_return
+window_covar(BAT *r, BAT *p, BAT *o, BAT *b, BAT *b2, BAT *s, BAT *e, const void *arg)
+{
+	const struct window_arg *a = arg;
+	return a->func.covar(r, p, o, b, b2, s, e, a->tp1, a->frame_type);
+}
+
+static gdk_return
+window_count(BAT *r, BAT *p, BAT *o, BAT *b, BAT *b2, BAT *s, BAT *e, const void *arg)
+{
+	const struct window_arg *a = arg;
+	(void) b2;
+	return GDKanalyticalcount(r, p, o, b, s, e, a->ignore_nils, a->tp1, a->frame_type);
+}
+
+static gdk_return
+window_bounds(BAT *r, BAT *p, BAT *o, BAT *b, BAT *l, BAT *s, BAT *e, const void *arg)
+{
+	const struct window_arg *a = arg;
+	(void) o;
+	(void) s;
+	(void) e;
+	return GDKanalyticalwindowbounds(r, b, p, l, a->limit, a->tp1, a->tp2, a->unit, a->preceding, a->second_half);
+}
+
 str
 SQLdiff(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
@@ -178,7 +234,8 @@ SQLwindow_bound(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 		}
 
 		//On RANGE frame, when "CURRENT ROW" is not specified, the ranges are calculated with SQL intervals in mind
-		if (GDKanalyticalwindowbounds(r, b, p, l, limit, tp1, tp2, unit, preceding, second_half) != GDK_SUCCEED)
+		struct window_arg a = { .tp1 = tp1, .tp2 = tp2, .unit = unit, .limit = limit, .preceding = preceding, .second_half = second_half };
+		if (GDKanalyticalparallel(r, p, NULL, b, l, NULL, NULL, 5, true, window_bounds, &a) != GDK_SUCCEED)
 			msg = createException(SQL, "sql.window_bound", GDK_EXCEPTION);
 	} else {
 		oid *res = getArgReference_oid(stk, pci, 0);
@@ -881,7 +938,8 @@ SQLanalytical_func(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, cons
 	if (b) {
 		res = getArgReference_bat(stk, pci, 0);
 
-		if (func(r, p, o, b, s, e, getBatType(tpe), frame_type) != GDK_SUCCEED)
+		struct window_arg a = { .func.tpe = func, .tp1 = getBatType(tpe), .frame_type = frame_type };
+		if (GDKanalyticalparallel(r, p, o, b, NULL, s, e, frame_type, false, window_tpe, &a) != GDK_SUCCEED)
 			msg = createException(SQL, op, GDK_EXCEPTION);
 	} else {
 		ValRecord *res = &(stk)->stk[(pci)->argv[0]];
@@ -1346,7 +1404,8 @@ SQLcount(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	if (b) {
 		res = getArgReference_bat(stk, pci, 0);
 
-		if (GDKanalyticalcount(r, p, o, b, s, e, ignore_nils, tpe, frame_type) != GDK_SUCCEED)
+		struct window_arg a = { .tp1 = tpe, .frame_type = frame_type, .ignore_nils = ignore_nils };
+		if (GDKanalyticalparallel(r, p, o, b, NULL, s, e, frame_type, false, window_count, &a) != GDK_SUCCEED)
 			msg = createException(SQL, "sql.count", GDK_EXCEPTION);
 	} else {
 		lng *res = getArgReference_lng(stk, pci, 0);
@@ -1419,7 +1478,8 @@ do_analytical_sumprod(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, c
 			goto bailout;
 		}
 
-		if (func(r, p, o, b, s, e, tp1, tp2, frame_type) != GDK_SUCCEED)
+		struct window_arg a = { .func.sumprod = func, .tp1 = tp1, .tp2 = tp2, .frame_type = frame_type };
+		if (GDKanalyticalparallel(r, p, o, b, NULL, s, e, frame_type, false, window_sumprod, &a) != GDK_SUCCEED)
 			msg = createException(SQL, op, GDK_EXCEPTION);
 	} else {
 		/* the pointers here will always point from bte to dbl, so no strings are handled here */
@@ -1573,7 +1633,8 @@ SQLavg(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	if (b) {
 		res = getArgReference_bat(stk, pci, 0);
 
-		if (GDKanalyticalavg(r, p, o, b, s, e, tpe, frame_type) != GDK_SUCCEED)
+		struct window_arg a = { .func.tpe = GDKanalyticalavg, .tp1 = tpe, .frame_type = frame_type };
+		if (GDKanalyticalparallel(r, p, o, b, NULL, s, e, frame_type, false, window_tpe, &a) != GDK_SUCCEED)
 			msg = createException(SQL, "sql.avg", GDK_EXCEPTION);
 	} else {
 		/* the pointers here will always point from bte to dbl, so no strings are handled here */
@@ -1633,7 +1694,8 @@ SQLavginteger(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	if (b) {
 		res = getArgReference_bat(stk, pci, 0);
 
-		if (GDKanalyticalavginteger(r, p, o, b, s, e, tpe, frame_type) != GDK_SUCCEED)
+		struct window_arg a = { .func.tpe = GDKanalyticalavginteger, .tp1 = tpe, .frame_type = frame_type };
+		if (GDKanalyticalparallel(r, p, o, b, NULL, s, e, frame_type, false, window_tpe, &a) != GDK_SUCCEED)
 			msg = createException(SQL, "sql.avg", GDK_EXCEPTION);
 	} else {
 		ValRecord *res = &(stk)->stk[(pci)->argv[0]];
@@ -1678,7 +1740,8 @@ do_stddev_and_variance(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 	if (b) {
 		res = getArgReference_bat(stk, pci, 0);
 
-		if (func(r, p, o, b, s, e, tpe, frame_type) != GDK_SUCCEED)
+		struct window_arg a = { .func.tpe = func, .tp1 = tpe, .frame_type = frame_type };
+		if (GDKanalyticalparallel(r, p, o, b, NULL, s, e, frame_type, false, window_tpe, &a) != GDK_SUCCEED)
 			msg = createException(SQL, op, GDK_EXCEPTION);
 	} else {
 		dbl *res = getArgReference_dbl(stk, pci, 0);
@@ -1972,7 +2035,8 @@ do_covariance_and_correlation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPt
 		}
 
 		if (is_a_bat1 && is_a_bat2) {
-			if (func(r, p, o, b, c, s, e, tp1, frame_type) != GDK_SUCCEED)
+			struct window_arg a = { .func.covar = func, .tp1 = tp1, .frame_type = frame_type };
+			if (GDKanalyticalparallel(r, p, o, b, c, s, e, frame_type, false, window_covar, &a) != GDK_SUCCEED)
 				msg = createException(SQL, op, GDK_EXCEPTION);
 		} else {
 			/* corner case, second column is a constant, calculate it this way... */
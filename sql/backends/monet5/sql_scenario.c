@@ -1459,6 +1459,8 @@ SQLparser_body(Client c, backend *be)
 			if (be->q && backend_dumpproc(be, c, be->q, r) < 0) {
 				msg = handle_error(m, 0, msg);
 				err = 1;
+			} else if (be->q) {
+				qc_checkpoint(m, be->q);
 			}
 
 			/* passed over to query cache, used during dumpproc */
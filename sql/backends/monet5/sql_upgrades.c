@@ -7023,6 +7023,200 @@ sql_update_default(Client c, mvc *sql, sql_schema *s)
 		BBPunfix(b->batCacheid);
 	}
 	res_table_destroy(output);
+	if (err)
+		return err;
+
+	/* 25_debug.sql */
+	err = SQLstatementIntern(c, "SELECT id FROM sys.functions WHERE schema_id = 2000 AND name = 'bbp_clock';\n", "update", true, false, &output);
+	if (err)
+		return err;
+	b = BATdescriptor(output->cols[0].b);
+	if (b) {
+		if (BATcount(b) == 0) {
+			const char *query =
+				"create function sys.bbp_clock()\n"
+				" returns table (loaded int, hits bigint, misses bigint, evictions bigint, sweeps bigint, budget bigint, vmsize bigint)\n"
+				" external name bbp.clock;\n"
+				"create view sys.bbp_stats as select * from sys.bbp_clock();\n"
+				"create procedure sys.bbp_priority(sname string, tname string, priority int)\n"
+				" external name sql.bbp_priority;\n"
+				"create procedure sys.bbp_budget(budget bigint)\n"
+				" external name bbp.setbudget;\n"
+				"update sys.functions set system = true where not system and schema_id = 2000 and name in ('bbp_clock', 'bbp_priority', 'bbp_budget');\n"
+				"update sys._tables set system = true where not system and schema_id = 2000 and name = 'bbp_stats';\n";
+			printf("Running database upgrade commands:\n%s\n", query);
+			fflush(stdout);
+			err = SQLstatementIntern(c, query, "update", true, false, NULL);
+		}
+		BBPunfix(b->batCacheid);
+	}
+	res_table_destroy(output);
+	if (err)
+		return err;
+
+	err = SQLstatementIntern(c, "SELECT id FROM sys.functions WHERE schema_id = 2000 AND name = 'wal_statistics';\n", "update", true, false, &output);
+	if (err)
+		return err;
+	b = BATdescriptor(output->cols[0].b);
+	if (b) {
+		if (BATcount(b) == 0) {
+			const char *query =
+				"create function sys.wal_statistics()\n"
+				" returns table (commits bigint, flushes bigint, max_batch bigint, avg_latency bigint, max_latency bigint, avg_flush bigint, replay_files bigint, replay_transactions bigint, replay_changes bigint, replay_time bigint, replay_threads int)\n"
+				" external name sql.wal_statistics;\n"
+				"create view sys.wal_stats as select * from sys.wal_statistics();\n"
+				"update sys.functions set system = true where not system and schema_id = 2000 and name = 'wal_statistics';\n"
+				"update sys._tables set system = true where not system and schema_id = 2000 and name = 'wal_stats';\n";
+			printf("Running database upgrade commands:\n%s\n", query);
+			fflush(stdout);
+			err = SQLstatementIntern(c, query, "update", true, false, NULL);
+		}
+		BBPunfix(b->batCacheid);
+	}
+	res_table_destroy(output);
+	if (err)
+		return err;
+
+	/* 39_analytics.sql */
+	err = SQLstatementIntern(c, "SELECT id FROM sys.functions WHERE schema_id = 2000 AND name = 'approx_count_distinct';\n", "update", true, false, &output);
+	if (err)
+		return err;
+	b = BATdescriptor(output->cols[0].b);
+	if (b) {
+		if (BATcount(b) == 0) {
+			const char *query =
+				"create aggregate approx_count_distinct(val TINYINT) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(TINYINT) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val SMALLINT) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(SMALLINT) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val INTEGER) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTEGER) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val BIGINT) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(BIGINT) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val DECIMAL(2)) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(2)) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val DECIMAL(4)) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(4)) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val DECIMAL(9)) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(9)) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val DECIMAL(18)) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(18)) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val REAL) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(REAL) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val DOUBLE) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(DOUBLE) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val DATE) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(DATE) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val TIME) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(TIME) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val TIMESTAMP) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(TIMESTAMP) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val INTERVAL SECOND) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTERVAL SECOND) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val INTERVAL DAY) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTERVAL DAY) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val INTERVAL MONTH) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTERVAL MONTH) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val CLOB) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(CLOB) TO PUBLIC;\n"
+#ifdef HAVE_HGE
+				"create aggregate approx_count_distinct(val HUGEINT) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(HUGEINT) TO PUBLIC;\n"
+				"create aggregate approx_count_distinct(val DECIMAL(38)) returns BIGINT\n"
+				" external name \"aggr\".\"approx_count_distinct\";\n"
+				"GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(38)) TO PUBLIC;\n"
+#endif
+				"create aggregate hll_sketch(val TINYINT) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(TINYINT) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val SMALLINT) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(SMALLINT) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val INTEGER) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(INTEGER) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val BIGINT) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(BIGINT) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val DECIMAL(2)) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(2)) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val DECIMAL(4)) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(4)) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val DECIMAL(9)) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(9)) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val DECIMAL(18)) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(18)) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val REAL) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(REAL) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val DOUBLE) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(DOUBLE) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val DATE) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(DATE) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val TIME) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(TIME) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val TIMESTAMP) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(TIMESTAMP) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val INTERVAL SECOND) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(INTERVAL SECOND) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val INTERVAL DAY) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(INTERVAL DAY) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val INTERVAL MONTH) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(INTERVAL MONTH) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val CLOB) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(CLOB) TO PUBLIC;\n"
+#ifdef HAVE_HGE
+				"create aggregate hll_sketch(val HUGEINT) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(HUGEINT) TO PUBLIC;\n"
+				"create aggregate hll_sketch(val DECIMAL(38)) returns BLOB\n"
+				" external name \"aggr\".\"hll_sketch\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(38)) TO PUBLIC;\n"
+#endif
+				"create aggregate hll_merge(sketch BLOB) returns BLOB\n"
+				" external name \"aggr\".\"hll_merge\";\n"
+				"GRANT EXECUTE ON AGGREGATE hll_merge(BLOB) TO PUBLIC;\n"
+				"create function hll_estimate(sketch BLOB) returns BIGINT\n"
+				" external name \"aggr\".\"hll_estimate\";\n"
+				"GRANT EXECUTE ON FUNCTION hll_estimate(BLOB) TO PUBLIC;\n"
+				"update sys.functions set system = true where not system and schema_id = 2000 and name in ('approx_count_distinct', 'hll_sketch', 'hll_merge', 'hll_estimate');\n";
+			printf("Running database upgrade commands:\n%s\n", query);
+			fflush(stdout);
+			err = SQLstatementIntern(c, query, "update", true, false, NULL);
+		}
+		BBPunfix(b->batCacheid);
+	}
+	res_table_destroy(output);
 	return err;
 }
 
@@ -462,13 +462,14 @@ csv_relation(mvc *sql, sql_subfunc *f, char *filename, list *res_exps, char *tna
 }
 
 static void *
-csv_load(void *BE, sql_subfunc *f, char *filename, sql_exp *topn)
+csv_load(void *BE, sql_subfunc *f, char *filename, sql_exp *topn, list *filters)
 {
 	backend *be = (backend*)BE;
 	mvc *sql = be->mvc;
 	csv_t *r = (csv_t *)f->sname;
 	sql_table *t = NULL;
 
+	(void) filters;		/* csv files have no statistics to skip data with */
 	if (mvc_create_table( &t, be->mvc, be->mvc->session->tr->tmp/* misuse tmp schema */, f->tname /*gettable name*/, tt_table, false, SQL_DECLARED_TABLE, 0, 0, false) != LOG_OK)
 		//throw(SQL, SQLSTATE(42000), "csv" RUNTIME_FILE_NOT_FOUND);
 		/* alloc error */
@@ -0,0 +1,1062 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/*
+ * Reader and writer of MonetDB columnar files (see mcf.h).
+ *
+ * Files are read through the file_loader registry:
+ *	SELECT * FROM 'file.mcf'
+ * and written with
+ *	COPY SELECT ... INTO 'file.mcf'		(or 'file.mcf.lz4' to compress)
+ */
+
+#include "monetdb_config.h"
+#include "rel_file_loader.h"
+#include "rel_exp.h"
+
+#include "mal_instruction.h"
+#include "mal_interpreter.h"
+#include "mal_builder.h"
+#include "mal_exception.h"
+#include "mal_backend.h"
+#include "sql_types.h"
+#include "sql_statement.h"
+#include "rel_bin.h"
+#include "mutils.h"
+#include "mcf.h"
+
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
+
+#ifdef NATIVE_WIN32
+#define fseeko(f, o, w)	_fseeki64(f, (__int64) (o), w)
+#define ftello(f)	_ftelli64(f)
+#endif
+
+#ifdef WORDS_BIGENDIAN
+#define MCF_NATIVE	MCF_BIGENDIAN
+#else
+#define MCF_NATIVE	0
+#endif
+
+typedef struct mcf_file {
+	mcf_header h;
+	mcf_column *cols;
+	char **names;		/* per column: name, SQL type and atom */
+	char **types;
+	char **atoms;
+	mcf_chunk *chunks;	/* ncols * nrowgroups */
+	char *meta;		/* storage for the strings */
+} mcf_file;
+
+static void
+mcf_close(mcf_file *mf)
+{
+	if (mf) {
+		GDKfree(mf->cols);
+		GDKfree(mf->names);
+		GDKfree(mf->types);
+		GDKfree(mf->atoms);
+		GDKfree(mf->chunks);
+		GDKfree(mf->meta);
+		GDKfree(mf);
+	}
+}
+
+#define MCF_CHUNK(mf, c, g)	((mf)->chunks + (size_t) (c) * (mf)->h.nrowgroups + (g))
+
+static inline BUN
+mcf_rowgroup_count(const mcf_file *mf, uint32_t g)
+{
+	uint64_t lo = (uint64_t) g * mf->h.rowgroupsize;
+	return (BUN) MIN(mf->h.rowgroupsize, mf->h.nrows - lo);
+}
+
+/* read the header and metadata of file FNAME; returns an error message
+ * (static) or NULL */
+static const char *
+mcf_open(const char *fname, mcf_file **res)
+{
+	mcf_file *mf;
+	FILE *f;
+	const char *err = NULL;
+	char *p, *e;
+
+	*res = NULL;
+	if ((f = MT_fopen(fname, "rb")) == NULL)
+		return "File not found";
+	if ((mf = GDKzalloc(sizeof(mcf_file))) == NULL) {
+		fclose(f);
+		return MAL_MALLOC_FAIL;
+	}
+	if (fread(&mf->h, sizeof(mf->h), 1, f) != 1 ||
+	    memcmp(mf->h.magic, MCF_MAGIC, sizeof(mf->h.magic)) != 0) {
+		err = "Not a MonetDB columnar file";
+		goto bailout;
+	}
+	if (mf->h.version != MCF_VERSION) {
+		err = "Unsupported MonetDB columnar file version";
+		goto bailout;
+	}
+	if ((mf->h.flags & MCF_BIGENDIAN) != MCF_NATIVE) {
+		err = "MonetDB columnar file has the wrong byte order";
+		goto bailout;
+	}
+	if (fseeko(f, 0, SEEK_END) < 0) {
+		err = "Cannot determine file size";
+		goto bailout;
+	}
+	uint64_t fsize = (uint64_t) ftello(f);
+	if (mf->h.ncols == 0 || mf->h.rowgroupsize == 0 ||
+	    mf->h.nrows > (uint64_t) BUN_MAX ||
+	    (mf->h.nrows + mf->h.rowgroupsize - 1) / mf->h.rowgroupsize != mf->h.nrowgroups ||
+	    mf->h.metaoffset > fsize || mf->h.metalength > fsize - mf->h.metaoffset ||
+	    mf->h.metalength < (uint64_t) mf->h.ncols * (sizeof(mcf_column) + (uint64_t) mf->h.nrowgroups * sizeof(mcf_chunk))) {
+		err = "Corrupt MonetDB columnar file header";
+		goto bailout;
+	}
+	mf->meta = GDKmalloc((size_t) mf->h.metalength);
+	mf->cols = GDKmalloc(mf->h.ncols * sizeof(mcf_column));
+	mf->names = GDKmalloc(mf->h.ncols * sizeof(char *));
+	mf->types = GDKmalloc(mf->h.ncols * sizeof(char *));
+	mf->atoms = GDKmalloc(mf->h.ncols * sizeof(char *));
+	mf->chunks = GDKmalloc(MAX(1, (size_t) mf->h.ncols * mf->h.nrowgroups) * sizeof(mcf_chunk));
+	if (!mf->meta || !mf->cols || !mf->names || !mf->types || !mf->atoms || !mf->chunks) {
+		err = MAL_MALLOC_FAIL;
+		goto bailout;
+	}
+	if (fseeko(f, mf->h.metaoffset, SEEK_SET) < 0 ||
+	    fread(mf->meta, 1, (size_t) mf->h.metalength, f) != (size_t) mf->h.metalength) {
+		err = "Cannot read MonetDB columnar file metadata";
+		goto bailout;
+	}
+	p = mf->meta;
+	e = mf->meta + mf->h.metalength;
+	for (uint32_t c = 0; c < mf->h.ncols; c++) {
+		mcf_column *mc = &mf->cols[c];
+		if ((size_t) (e - p) < sizeof(mcf_column))
+			goto corrupt;
+		memcpy(mc, p, sizeof(mcf_column));
+		p += sizeof(mcf_column);
+		if ((uint64_t) (e - p) < (uint64_t) mc->namelen + mc->typelen + mc->atomlen + 3)
+			goto corrupt;
+		mf->names[c] = p;
+		p += mc->namelen;
+		mf->types[c] = p + 1;
+		p += mc->typelen + 1;
+		mf->atoms[c] = p + 1;
+		p += mc->atomlen + 1;
+		if (*p++ != 0 || mf->types[c][-1] != 0 || mf->atoms[c][-1] != 0)
+			goto corrupt;
+	}
+	if ((size_t) (e - p) != (size_t) mf->h.ncols * mf->h.nrowgroups * sizeof(mcf_chunk))
+		goto corrupt;
+	memcpy(mf->chunks, p, (size_t) mf->h.ncols * mf->h.nrowgroups * sizeof(mcf_chunk));
+	for (uint32_t c = 0; c < mf->h.ncols; c++) {
+		for (uint32_t g = 0; g < mf->h.nrowgroups; g++) {
+			mcf_chunk *ch = MCF_CHUNK(mf, c, g);
+			BUN cnt = mcf_rowgroup_count(mf, g);
+			if (ch->offset > mf->h.metaoffset ||
+			    ch->length > mf->h.metaoffset - ch->offset ||
+			    (ch->compression == MCF_NONE && ch->length != ch->rawlength) ||
+			    (ch->compression != MCF_NONE && ch->compression != MCF_LZ4) ||
+			    (mf->cols[c].width != 0 &&
+			     (ch->encoding != MCF_PLAIN || ch->rawlength != (uint64_t) cnt * mf->cols[c].width)) ||
+			    (mf->cols[c].width == 0 && ch->encoding != MCF_DICT))
+				goto corrupt;
+		}
+	}
+	fclose(f);
+	*res = mf;
+	return NULL;
+
+  corrupt:
+	err = "Corrupt MonetDB columnar file metadata";
+  bailout:
+	fclose(f);
+	mcf_close(mf);
+	return err;
+}
+
+/* read chunk CH of file F into a freshly allocated buffer of
+ * ch->rawlength bytes, decompressing if needed */
+static str
+mcf_read_chunk(FILE *f, const char *fname, const mcf_chunk *ch, char **res)
+{
+	char *buf, *raw;
+
+	*res = NULL;
+	if ((buf = GDKmalloc(MAX(1, (size_t) ch->length))) == NULL)
+		throw(MAL, "mcf.read", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	if (fseeko(f, ch->offset, SEEK_SET) < 0 ||
+	    fread(buf, 1, (size_t) ch->length, f) != (size_t) ch->length) {
+		GDKfree(buf);
+		throw(MAL, "mcf.read", SQLSTATE(42000) "Cannot read chunk from %s", fname);
+	}
+	if (ch->compression == MCF_NONE) {
+		*res = buf;
+		return MAL_SUCCEED;
+	}
+#ifdef HAVE_LIBLZ4
+	if (ch->length > (uint64_t) LZ4_MAX_INPUT_SIZE ||
+	    ch->rawlength > (uint64_t) LZ4_MAX_INPUT_SIZE) {
+		GDKfree(buf);
+		throw(MAL, "mcf.read", SQLSTATE(42000) "Corrupt compressed chunk in %s", fname);
+	}
+	if ((raw = GDKmalloc(MAX(1, (size_t) ch->rawlength))) == NULL) {
+		GDKfree(buf);
+		throw(MAL, "mcf.read", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	}
+	int n = LZ4_decompress_safe(buf, raw, (int) ch->length, (int) ch->rawlength);
+	GDKfree(buf);
+	if (n < 0 || (uint64_t) n != ch->rawlength) {
+		GDKfree(raw);
+		throw(MAL, "mcf.read", SQLSTATE(42000) "Corrupt compressed chunk in %s", fname);
+	}
+	*res = raw;
+	return MAL_SUCCEED;
+#else
+	(void) raw;
+	GDKfree(buf);
+	throw(MAL, "mcf.read", SQLSTATE(42000) "%s contains LZ4 compressed data but lz4 support is not available", fname);
+#endif
+}
+
+/* decode a dictionary encoded string chunk of CNT rows and append the
+ * strings to B */
+static str
+mcf_decode_dict(BAT *b, const char *buf, size_t len, BUN cnt, const char *fname)
+{
+	uint64_t ndict;
+	const uint64_t *offsets;
+	const char *strings, *codes;
+	BAT *d = NULL, *c = NULL, *r = NULL;
+	str msg = MAL_SUCCEED;
+
+	if (len < sizeof(uint64_t))
+		goto corrupt;
+	memcpy(&ndict, buf, sizeof(uint64_t));
+	if (ndict > cnt || (len - sizeof(uint64_t)) / sizeof(uint64_t) < ndict + 1)
+		goto corrupt;
+	offsets = (const uint64_t *) (buf + sizeof(uint64_t));
+	strings = (const char *) (offsets + ndict + 1);
+	size_t cw = ndict <= 1 << 8 ? 1 : ndict <= 1 << 16 ? 2 : 4;
+	uint64_t slen = (offsets[ndict] + 3) & ~(uint64_t) 3;
+	if (offsets[ndict] > slen || slen > (uint64_t) (buf + len - strings) ||
+	    (uint64_t) (buf + len - strings) - slen != (uint64_t) cnt * cw)
+		goto corrupt;
+	codes = strings + slen;
+
+	if ((d = COLnew(0, TYPE_str, (BUN) ndict, TRANSIENT)) == NULL ||
+	    (c = COLnew(0, TYPE_oid, cnt, TRANSIENT)) == NULL) {
+		msg = createException(MAL, "mcf.read", GDK_EXCEPTION);
+		goto bailout;
+	}
+	for (uint64_t i = 0; i < ndict; i++) {
+		if (offsets[i] >= offsets[i + 1] || offsets[i + 1] > offsets[ndict] ||
+		    strings[offsets[i + 1] - 1] != 0)
+			goto corrupt;
+		if (BUNappend(d, strings + offsets[i], false) != GDK_SUCCEED) {
+			msg = createException(MAL, "mcf.read", GDK_EXCEPTION);
+			goto bailout;
+		}
+	}
+	oid *o = Tloc(c, 0);
+	for (BUN i = 0; i < cnt; i++) {
+		switch (cw) {
+		case 1:
+			o[i] = ((const uint8_t *) codes)[i];
+			break;
+		case 2:
+			o[i] = ((const uint16_t *) codes)[i];
+			break;
+		default:
+			o[i] = ((const uint32_t *) codes)[i];
+			break;
+		}
+		if (o[i] >= ndict)
+			goto corrupt;
+	}
+	BATsetcount(c, cnt);
+	c->tnonil = true;
+	c->tnil = false;
+	c->tsorted = c->trevsorted = cnt <= 1;
+	c->tkey = cnt <= 1;
+	if ((r = BATproject(c, d)) == NULL ||
+	    BATappend(b, r, NULL, false) != GDK_SUCCEED)
+		msg = createException(MAL, "mcf.read", GDK_EXCEPTION);
+	goto bailout;
+
+  corrupt:
+	msg = createException(MAL, "mcf.read", SQLSTATE(42000) "Corrupt string chunk in %s", fname);
+  bailout:
+	BBPreclaim(d);
+	BBPreclaim(c);
+	BBPreclaim(r);
+	return msg;
+}
+
+/* read the row groups RGS[0..NRGS-1] of column COL */
+static str
+mcf_read_column(bat *ret, const char *fname, int col, const uint32_t *rgs, BUN nrgs)
+{
+	mcf_file *mf = NULL;
+	const char *err;
+	BAT *b = NULL;
+	FILE *f = NULL;
+	str msg = MAL_SUCCEED;
+	bool plain = true, nonil = true;
+	BUN cnt = 0;
+
+	if ((err = mcf_open(fname, &mf)) != NULL)
+		throw(MAL, "mcf.read", SQLSTATE(42000) "%s: %s", err, fname);
+	if (col < 0 || (uint32_t) col >= mf->h.ncols) {
+		mcf_close(mf);
+		throw(MAL, "mcf.read", SQLSTATE(42000) "Column %d does not exist in %s", col, fname);
+	}
+	int tt = ATOMindex(mf->atoms[col]);
+	if (tt < 0 || (mf->cols[col].width != 0 &&
+		       (ATOMvarsized(tt) || (uint32_t) ATOMsize(tt) != mf->cols[col].width)) ||
+	    (mf->cols[col].width == 0 && ATOMstorage(tt) != TYPE_str)) {
+		mcf_close(mf);
+		throw(MAL, "mcf.read", SQLSTATE(42000) "Unsupported type %s in %s", mf->atoms[col], fname);
+	}
+	for (BUN i = 0; i < nrgs; i++) {
+		const mcf_chunk *ch = MCF_CHUNK(mf, col, rgs[i]);
+		cnt += mcf_rowgroup_count(mf, rgs[i]);
+		nonil &= (ch->flags & MCF_NONIL) != 0;
+		plain &= ch->encoding == MCF_PLAIN && ch->compression == MCF_NONE &&
+			(i == 0 || ch->offset == MCF_CHUNK(mf, col, rgs[i - 1])->offset + MCF_CHUNK(mf, col, rgs[i - 1])->length);
+	}
+
+	if (plain && nrgs > 0) {
+		/* one contiguous uncompressed range: use it as the heap */
+		b = BATattachrange(tt, fname, (size_t) MCF_CHUNK(mf, col, rgs[0])->offset, cnt);
+		if (b == NULL)
+			msg = createException(MAL, "mcf.read", GDK_EXCEPTION);
+		goto bailout;
+	}
+	if ((b = COLnew(0, tt, ATOMvarsized(tt) ? 0 : cnt, TRANSIENT)) == NULL) {
+		msg = createException(MAL, "mcf.read", GDK_EXCEPTION);
+		goto bailout;
+	}
+	if ((f = MT_fopen(fname, "rb")) == NULL) {
+		msg = createException(MAL, "mcf.read", SQLSTATE(42000) "Cannot open %s", fname);
+		goto bailout;
+	}
+	BUN pos = 0;
+	for (BUN i = 0; i < nrgs && msg == MAL_SUCCEED; i++) {
+		const mcf_chunk *ch = MCF_CHUNK(mf, col, rgs[i]);
+		BUN n = mcf_rowgroup_count(mf, rgs[i]);
+		char *buf;
+
+		if ((msg = mcf_read_chunk(f, fname, ch, &buf)) != MAL_SUCCEED)
+			break;
+		if (ch->encoding == MCF_PLAIN) {
+			memcpy(Tloc(b, pos), buf, (size_t) ch->rawlength);
+		} else {
+			msg = mcf_decode_dict(b, buf, (size_t) ch->rawlength, n, fname);
+		}
+		GDKfree(buf);
+		pos += n;
+	}
+	if (msg == MAL_SUCCEED && !ATOMvarsized(tt))
+		BATsetcount(b, cnt);
+
+  bailout:
+	if (f)
+		fclose(f);
+	mcf_close(mf);
+	if (msg != MAL_SUCCEED) {
+		BBPreclaim(b);
+		return msg;
+	}
+	b->tnonil = nonil;
+	b->tnil = false;
+	if (BATcount(b) > 1) {
+		b->tsorted = b->trevsorted = false;
+		b->tkey = false;
+	}
+	*ret = b->batCacheid;
+	BBPkeepref(b);
+	return MAL_SUCCEED;
+}
+
+/* mcf.read(fname, col, nrows): read only the row groups needed for the
+ * first nrows rows (all if nrows is nil or negative) */
+static str
+MCFread(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	bat *ret = getArgReference_bat(stk, pci, 0);
+	const char *fname = *getArgReference_str(stk, pci, 1);
+	int col = *getArgReference_int(stk, pci, 2);
+	mcf_file *mf;
+	const char *err;
+	uint32_t *rgs;
+	uint32_t nrgs;
+	str msg;
+
+	(void) cntxt;
+	if ((err = mcf_open(fname, &mf)) != NULL)
+		throw(MAL, "mcf.read", SQLSTATE(42000) "%s: %s", err, fname);
+	nrgs = mf->h.nrowgroups;
+	if (isaBatType(getArgType(mb, pci, 3))) {
+		/* explicit list of row groups */
+		BAT *g = BATdescriptor(*getArgReference_bat(stk, pci, 3));
+		if (g == NULL) {
+			mcf_close(mf);
+			throw(MAL, "mcf.read", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+		}
+		BATiter gi = bat_iterator(g);
+		const int *gv = gi.base;
+		if ((rgs = GDKmalloc(MAX(1, gi.count) * sizeof(uint32_t))) == NULL) {
+			bat_iterator_end(&gi);
+			BBPunfix(g->batCacheid);
+			mcf_close(mf);
+			throw(MAL, "mcf.read", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		}
+		for (BUN i = 0; i < gi.count; i++) {
+			if (is_int_nil(gv[i]) || gv[i] < 0 || (uint32_t) gv[i] >= nrgs ||
+			    (i > 0 && gv[i] <= gv[i - 1])) {
+				bat_iterator_end(&gi);
+				BBPunfix(g->batCacheid);
+				mcf_close(mf);
+				GDKfree(rgs);
+				throw(MAL, "mcf.read", SQLSTATE(42000) "Row groups must be ascending and exist in %s", fname);
+			}
+			rgs[i] = (uint32_t) gv[i];
+		}
+		nrgs = (uint32_t) gi.count;
+		bat_iterator_end(&gi);
+		BBPunfix(g->batCacheid);
+	} else {
+		lng nrows = *getArgReference_lng(stk, pci, 3);
+		if (!is_lng_nil(nrows) && nrows >= 0 && (uint64_t) nrows < mf->h.nrows)
+			nrgs = (uint32_t) (((uint64_t) nrows + mf->h.rowgroupsize - 1) / mf->h.rowgroupsize);
+		if ((rgs = GDKmalloc(MAX(1, nrgs) * sizeof(uint32_t))) == NULL) {
+			mcf_close(mf);
+			throw(MAL, "mcf.read", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		}
+		for (uint32_t i = 0; i < nrgs; i++)
+			rgs[i] = i;
+	}
+	mcf_close(mf);
+	msg = mcf_read_column(ret, fname, col, rgs, nrgs);
+	GDKfree(rgs);
+	return msg;
+}
+
+/* mcf.rowgroups(fname, col, low, high, li, hi[, rowgroups]): the row
+ * groups of column col (out of the given ascending list, if any) that
+ * may contain values in the range low..high (nil meaning unbounded),
+ * judged by the min/max recorded per chunk */
+static str
+MCFrowgroups(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	bat *ret = getArgReference_bat(stk, pci, 0);
+	const char *fname = *getArgReference_str(stk, pci, 1);
+	int col = *getArgReference_int(stk, pci, 2);
+	const void *low = getArgReference(stk, pci, 3);
+	const void *high = getArgReference(stk, pci, 4);
+	bit li = *getArgReference_bit(stk, pci, 5);
+	bit hi = *getArgReference_bit(stk, pci, 6);
+	mcf_file *mf;
+	const char *err;
+	BAT *bn, *rg = NULL;
+	const int *rgs = NULL;
+	uint32_t nrgs;
+
+	(void) cntxt;
+	if ((err = mcf_open(fname, &mf)) != NULL)
+		throw(MAL, "mcf.rowgroups", SQLSTATE(42000) "%s: %s", err, fname);
+	nrgs = mf->h.nrowgroups;
+	if (pci->argc > 7) {
+		if ((rg = BATdescriptor(*getArgReference_bat(stk, pci, 7))) == NULL) {
+			mcf_close(mf);
+			throw(MAL, "mcf.rowgroups", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+		}
+		/* we produced it, so no need to check it */
+		assert(rg->ttype == TYPE_int && (BATcount(rg) <= 1 || rg->tsorted));
+		rgs = Tloc(rg, 0);
+		nrgs = (uint32_t) BATcount(rg);
+	}
+	if (col < 0 || (uint32_t) col >= mf->h.ncols) {
+		mcf_close(mf);
+		BBPreclaim(rg);
+		throw(MAL, "mcf.rowgroups", SQLSTATE(42000) "Column %d does not exist in %s", col, fname);
+	}
+	int tt = ATOMindex(mf->atoms[col]);
+	if (tt < 0 || getArgType(mb, pci, 3) != tt || getArgType(mb, pci, 4) != tt) {
+		mcf_close(mf);
+		BBPreclaim(rg);
+		throw(MAL, "mcf.rowgroups", SQLSTATE(42000) "Range type does not match column type %s", mf->atoms[col]);
+	}
+	if (ATOMextern(tt)) {
+		low = *(const void **) low;
+		high = *(const void **) high;
+	}
+	bool lnil = ATOMcmp(tt, low, ATOMnilptr(tt)) == 0;
+	bool hnil = ATOMcmp(tt, high, ATOMnilptr(tt)) == 0;
+	if ((bn = COLnew(0, TYPE_int, nrgs, TRANSIENT)) == NULL) {
+		mcf_close(mf);
+		BBPreclaim(rg);
+		throw(MAL, "mcf.rowgroups", GDK_EXCEPTION);
+	}
+	int *o = Tloc(bn, 0);
+	BUN n = 0;
+	for (uint32_t i = 0; i < nrgs; i++) {
+		uint32_t g = rgs ? (uint32_t) rgs[i] : i;
+		if (g >= mf->h.nrowgroups)
+			continue;
+		const mcf_chunk *ch = MCF_CHUNK(mf, col, g);
+		if ((ch->flags & MCF_MINMAX) && !ATOMvarsized(tt)) {
+			int c;
+			if (!lnil && ((c = ATOMcmp(tt, ch->max, low)) < 0 || (c == 0 && !li)))
+				continue;
+			if (!hnil && ((c = ATOMcmp(tt, ch->min, high)) > 0 || (c == 0 && !hi)))
+				continue;
+		}
+		o[n++] = (int) g;
+	}
+	mcf_close(mf);
+	BBPreclaim(rg);
+	BATsetcount(bn, n);
+	bn->tsorted = true;
+	bn->trevsorted = n <= 1;
+	bn->tkey = true;
+	bn->tnonil = true;
+	bn->tnil = false;
+	*ret = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
+/* writer */
+
+typedef struct mcf_writer {
+	FILE *f;
+	const char *fname;
+	uint64_t pos;
+	bool compress;
+} mcf_writer;
+
+static str
+mcf_write(mcf_writer *w, const void *buf, size_t len)
+{
+	if (len > 0 && fwrite(buf, 1, len, w->f) != len)
+		throw(MAL, "mcf.export", SQLSTATE(42000) "Write to %s failed", w->fname);
+	w->pos += len;
+	return MAL_SUCCEED;
+}
+
+static str
+mcf_pad(mcf_writer *w, uint64_t align)
+{
+	static const char zeros[1024];
+	str msg = MAL_SUCCEED;
+
+	while (w->pos % align != 0 && msg == MAL_SUCCEED)
+		msg = mcf_write(w, zeros, (size_t) MIN(sizeof(zeros), align - w->pos % align));
+	return msg;
+}
+
+/* write one chunk, compressing it if requested and worthwhile */
+static str
+mcf_write_chunk(mcf_writer *w, mcf_chunk *ch, const char *buf, size_t len)
+{
+	ch->offset = w->pos;
+	ch->rawlength = ch->length = len;
+	ch->compression = MCF_NONE;
+#ifdef HAVE_LIBLZ4
+	if (w->compress && len > 0 && len <= (size_t) LZ4_MAX_INPUT_SIZE) {
+		int bound = LZ4_compressBound((int) len);
+		char *cbuf = GDKmalloc(bound);
+		if (cbuf == NULL)
+			throw(MAL, "mcf.export", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		int clen = LZ4_compress_default(buf, cbuf, (int) len, bound);
+		if (clen > 0 && (size_t) clen < len - len / 8) {
+			str msg = mcf_write(w, cbuf, (size_t) clen);
+			GDKfree(cbuf);
+			ch->length = (uint64_t) clen;
+			ch->compression = MCF_LZ4;
+			return msg;
+		}
+		GDKfree(cbuf);
+	}
+#endif
+	return mcf_write(w, buf, len);
+}
+
+/* dictionary encode the strings of B in one chunk */
+static str
+mcf_write_dict(mcf_writer *w, mcf_chunk *ch, BAT *b)
+{
+	BAT *grp = NULL, *ext = NULL, *dict = NULL;
+	char *buf = NULL;
+	str msg = MAL_SUCCEED;
+	BUN cnt = BATcount(b);
+
+	if (BATgroup(&grp, &ext, NULL, b, NULL, NULL, NULL, NULL) != GDK_SUCCEED ||
+	    (dict = BATproject(ext, b)) == NULL) {
+		msg = createException(MAL, "mcf.export", GDK_EXCEPTION);
+		goto bailout;
+	}
+	uint64_t ndict = BATcount(dict);
+	size_t cw = ndict <= 1 << 8 ? 1 : ndict <= 1 << 16 ? 2 : 4;
+	BATiter di = bat_iterator(dict);
+	size_t slen = 0;
+	for (BUN i = 0; i < ndict; i++)
+		slen += strlen(BUNtvar(di, i)) + 1;
+	slen = (slen + 3) & ~(size_t) 3;	/* align the codes */
+	size_t len = sizeof(uint64_t) * (ndict + 2) + slen + cnt * cw;
+	if ((buf = GDKmalloc(len)) == NULL) {
+		bat_iterator_end(&di);
+		msg = createException(MAL, "mcf.export", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	memcpy(buf, &ndict, sizeof(uint64_t));
+	uint64_t *offsets = (uint64_t *) (buf + sizeof(uint64_t));
+	char *strings = (char *) (offsets + ndict + 1);
+	uint64_t off = 0;
+	for (BUN i = 0; i < ndict; i++) {
+		const char *s = BUNtvar(di, i);
+		size_t l = strlen(s) + 1;
+		offsets[i] = off;
+		memcpy(strings + off, s, l);
+		off += l;
+	}
+	offsets[ndict] = off;
+	bat_iterator_end(&di);
+	memset(strings + off, 0, slen - off);
+	char *codes = strings + slen;
+	BATiter gi = bat_iterator(grp);
+	const oid *g = gi.base;
+	for (BUN i = 0; i < cnt; i++) {
+		oid o = grp->ttype == TYPE_void ? grp->tseqbase + i : g[i];
+		switch (cw) {
+		case 1:
+			((uint8_t *) codes)[i] = (uint8_t) o;
+			break;
+		case 2:
+			((uint16_t *) codes)[i] = (uint16_t) o;
+			break;
+		default:
+			((uint32_t *) codes)[i] = (uint32_t) o;
+			break;
+		}
+	}
+	bat_iterator_end(&gi);
+	ch->encoding = MCF_DICT;
+	msg = mcf_write_chunk(w, ch, buf, len);
+
+  bailout:
+	GDKfree(buf);
+	BBPreclaim(grp);
+	BBPreclaim(ext);
+	BBPreclaim(dict);
+	return msg;
+}
+
+static str
+mcf_write_column(mcf_writer *w, mcf_chunk *chunks, BAT *b, uint64_t rowgroupsize)
+{
+	BUN cnt = BATcount(b);
+	int tt = b->ttype;
+	str msg = MAL_SUCCEED;
+
+	if ((msg = mcf_pad(w, MCF_ALIGN)) != MAL_SUCCEED)
+		return msg;
+	for (BUN lo = 0, g = 0; lo < cnt && msg == MAL_SUCCEED; lo += (BUN) rowgroupsize, g++) {
+		BUN hi = MIN(cnt, lo + (BUN) rowgroupsize);
+		mcf_chunk *ch = &chunks[g];
+		BAT *s = BATslice(b, lo, hi);
+
+		if (s == NULL)
+			throw(MAL, "mcf.export", GDK_EXCEPTION);
+		memset(ch, 0, sizeof(*ch));
+		if (ATOMvarsized(tt)) {
+			msg = mcf_write_dict(w, ch, s);
+		} else {
+			BATiter si = bat_iterator(s);
+			ch->encoding = MCF_PLAIN;
+			msg = mcf_write_chunk(w, ch, si.base, (size_t) (hi - lo) << si.shift);
+			bat_iterator_end(&si);
+			if (msg == MAL_SUCCEED && ATOMlinear(tt) && ATOMsize(tt) <= (int) sizeof(ch->min)) {
+				if (BATmin(s, ch->min) == NULL || BATmax(s, ch->max) == NULL)
+					msg = createException(MAL, "mcf.export", GDK_EXCEPTION);
+				else if (ATOMcmp(tt, ch->min, ATOMnilptr(tt)) != 0)
+					ch->flags |= MCF_MINMAX;
+			}
+		}
+		if (msg == MAL_SUCCEED) {
+			MT_lock_set(&s->theaplock);
+			if (s->tnonil)
+				ch->flags |= MCF_NONIL;
+			MT_lock_unset(&s->theaplock);
+		}
+		BBPunfix(s->batCacheid);
+	}
+	return msg;
+}
+
+/* mcf.export(fname, compress, attr, tpe, len, scale, cols...) */
+static str
+MCFexport(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	lng *ret = getArgReference_lng(stk, pci, 0);
+	const char *fname = *getArgReference_str(stk, pci, 1);
+	bit compress = *getArgReference_bit(stk, pci, 2);
+	int ncols = pci->argc - 7;
+	BAT *attr = NULL, *tpe = NULL, *len = NULL, *scale = NULL;
+	BAT **cols = NULL;
+	mcf_chunk *chunks = NULL;
+	mcf_writer w = { .fname = fname, .compress = compress };
+	mcf_header h = { .magic = MCF_MAGIC, .version = MCF_VERSION, .flags = MCF_NATIVE, .rowgroupsize = MCF_ROWGROUP };
+	BUN cnt = 1;
+	str msg = MAL_SUCCEED;
+
+	(void) cntxt;
+#ifndef HAVE_LIBLZ4
+	if (compress)
+		throw(MAL, "mcf.export", SQLSTATE(42000) "lz4 support is not available");
+#endif
+	if ((attr = BATdescriptor(*getArgReference_bat(stk, pci, 3))) == NULL ||
+	    (tpe = BATdescriptor(*getArgReference_bat(stk, pci, 4))) == NULL ||
+	    (len = BATdescriptor(*getArgReference_bat(stk, pci, 5))) == NULL ||
+	    (scale = BATdescriptor(*getArgReference_bat(stk, pci, 6))) == NULL) {
+		msg = createException(MAL, "mcf.export", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+		goto bailout;
+	}
+	if ((cols = GDKzalloc(ncols * sizeof(BAT *))) == NULL) {
+		msg = createException(MAL, "mcf.export", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	/* the row count is given by the BAT arguments, constant
+	 * arguments are repeated */
+	for (int i = 0; i < ncols; i++) {
+		if (isaBatType(getArgType(mb, pci, 7 + i))) {
+			if ((cols[i] = BATdescriptor(*getArgReference_bat(stk, pci, 7 + i))) == NULL) {
+				msg = createException(MAL, "mcf.export", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+				goto bailout;
+			}
+			cnt = BATcount(cols[i]);
+		}
+	}
+	for (int i = 0; i < ncols; i++) {
+		int tt = getArgType(mb, pci, 7 + i);
+		BAT *b = cols[i];
+		if (b == NULL) {
+			const void *v = getArgReference(stk, pci, 7 + i);
+			if (ATOMextern(tt))
+				v = *(const void **) v;
+			b = BATconstant(0, tt, v, cnt, TRANSIENT);
+		} else if (b->ttype == TYPE_void) {
+			b = COLcopy(b, TYPE_oid, true, TRANSIENT);
+			BBPunfix(cols[i]->batCacheid);
+		} else if (BATcount(b) != cnt) {
+			msg = createException(MAL, "mcf.export", SQLSTATE(42000) "Columns differ in length");
+			goto bailout;
+		}
+		cols[i] = b;
+		if (b == NULL) {
+			msg = createException(MAL, "mcf.export", GDK_EXCEPTION);
+			goto bailout;
+		}
+		if ((ATOMvarsized(b->ttype) && ATOMstorage(b->ttype) != TYPE_str) ||
+		    ATOMstorage(b->ttype) == TYPE_msk) {
+			msg = createException(MAL, "mcf.export", SQLSTATE(42000) "Type %s not supported", ATOMname(b->ttype));
+			goto bailout;
+		}
+	}
+
+	h.ncols = (uint32_t) ncols;
+	h.nrows = cnt;
+	h.nrowgroups = (uint32_t) ((cnt + h.rowgroupsize - 1) / h.rowgroupsize);
+	if ((chunks = GDKmalloc(MAX(1, (size_t) ncols * h.nrowgroups) * sizeof(mcf_chunk))) == NULL) {
+		msg = createException(MAL, "mcf.export", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	if ((w.f = MT_fopen(fname, "wb")) == NULL) {
+		msg = createException(MAL, "mcf.export", SQLSTATE(42000) "Cannot create %s", fname);
+		goto bailout;
+	}
+	if ((msg = mcf_write(&w, &h, sizeof(h))) != MAL_SUCCEED)
+		goto bailout;
+	for (int i = 0; i < ncols && msg == MAL_SUCCEED; i++)
+		msg = mcf_write_column(&w, chunks + (size_t) i * h.nrowgroups, cols[i], h.rowgroupsize);
+	if (msg != MAL_SUCCEED)
+		goto bailout;
+
+	/* the metadata */
+	BATiter ai = bat_iterator(attr), ti = bat_iterator(tpe);
+	const int *lv = Tloc(len, 0), *sv = Tloc(scale, 0);
+	h.metaoffset = w.pos;
+	for (int i = 0; i < ncols && msg == MAL_SUCCEED; i++) {
+		const char *nme = BUNtvar(ai, i), *sqltpe = BUNtvar(ti, i);
+		const char *atom = ATOMname(cols[i]->ttype);
+		mcf_column mc = {
+			.namelen = (uint32_t) strlen(nme),
+			.typelen = (uint32_t) strlen(sqltpe),
+			.atomlen = (uint32_t) strlen(atom),
+			.digits = (uint32_t) lv[i],
+			.scale = (uint32_t) sv[i],
+			.width = ATOMvarsized(cols[i]->ttype) ? 0 : (uint32_t) ATOMsize(cols[i]->ttype),
+		};
+		if ((msg = mcf_write(&w, &mc, sizeof(mc))) == MAL_SUCCEED &&
+		    (msg = mcf_write(&w, nme, mc.namelen + 1)) == MAL_SUCCEED &&
+		    (msg = mcf_write(&w, sqltpe, mc.typelen + 1)) == MAL_SUCCEED)
+			msg = mcf_write(&w, atom, mc.atomlen + 1);
+	}
+	bat_iterator_end(&ai);
+	bat_iterator_end(&ti);
+	if (msg != MAL_SUCCEED ||
+	    (msg = mcf_write(&w, chunks, (size_t) ncols * h.nrowgroups * sizeof(mcf_chunk))) != MAL_SUCCEED)
+		goto bailout;
+	h.metalength = w.pos - h.metaoffset;
+	if (fseeko(w.f, 0, SEEK_SET) < 0 || fwrite(&h, sizeof(h), 1, w.f) != 1 ||
+	    fflush(w.f) != 0) {
+		msg = createException(MAL, "mcf.export", SQLSTATE(42000) "Write to %s failed", fname);
+		goto bailout;
+	}
+	*ret = (lng) cnt;
+
+  bailout:
+	if (w.f) {
+		fclose(w.f);
+		if (msg != MAL_SUCCEED)
+			(void) MT_remove(fname);
+	}
+	if (cols) {
+		for (int i = 0; i < ncols; i++)
+			BBPreclaim(cols[i]);
+		GDKfree(cols);
+	}
+	GDKfree(chunks);
+	BBPreclaim(attr);
+	BBPreclaim(tpe);
+	BBPreclaim(len);
+	BBPreclaim(scale);
+	return msg;
+}
+
+/* file_loader interface */
+
+/*
+ * returns an error string (static or via tmp sa_allocator allocated), NULL on success
+ *
+ * Extend the subfunc f with the result columns described by the file
+ * metadata and fill res_exps with one expression per column.
+ */
+static str
+mcf_relation(mvc *sql, sql_subfunc *f, char *filename, list *res_exps, char *tname)
+{
+	mcf_file *mf;
+	const char *err;
+
+	if ((err = mcf_open(filename, &mf)) != NULL)
+		return (str) err;
+	list *typelist = sa_list(sql->sa);
+	list *nameslist = sa_list(sql->sa);
+	for (uint32_t c = 0; c < mf->h.ncols; c++) {
+		sql_subtype *t = sql_bind_subtype(sql->sa, mf->types[c], mf->cols[c].digits, mf->cols[c].scale);
+		const char *name = sa_strdup(sql->sa, mf->names[c]);
+		if (t == NULL) {
+			str msg = sa_message(sql->ta, "Type %s not found", mf->types[c]);
+			mcf_close(mf);
+			return msg;
+		}
+		append(nameslist, (char *) name);
+		append(typelist, t);
+		append(res_exps, exp_column(sql->sa, NULL, name, t, CARD_MULTI, 1, 0, 0));
+	}
+	mcf_close(mf);
+	f->tname = tname ? tname : "mcf";
+	f->res = typelist;
+	f->coltypes = typelist;
+	f->colnames = nameslist;
+	return MAL_SUCCEED;
+}
+
+/* the row groups that may hold rows passing the filters, one
+ * mcf.rowgroups per filter each narrowing the list of the previous one;
+ * returns the variable holding the list, 0 if no filter could be used
+ * and -1 on error */
+static int
+mcf_filter(backend *be, sql_subfunc *f, char *filename, list *filters)
+{
+	MalBlkPtr mb = be->mb;
+	int rgs = 0;
+
+	for (node *n = filters->h; n; n = n->next) {
+		sql_exp *e = n->data, *c = e->l;
+		int col = 0;
+		node *m;
+
+		for (m = f->colnames->h; m; m = m->next, col++)
+			if (strcmp(m->data, exp_name(c)) == 0)
+				break;
+		if (m == NULL)
+			continue;
+		sql_subtype *t = list_fetch(f->coltypes, col);
+		int tt = t->type->localtype;
+		if (ATOMvarsized(tt))	/* no min/max kept */
+			continue;
+		stmt *v = exp_bin(be, e->r, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, 0);
+		if (v == NULL)
+			return -1;
+		InstrPtr q = newStmt(mb, "mcf", "rowgroups");
+		if (q == NULL)
+			return -1;
+		setVarType(mb, getArg(q, 0), newBatType(TYPE_int));
+		q = pushStr(mb, q, filename);
+		q = pushInt(mb, q, col);
+		if (e->flag == cmp_lt || e->flag == cmp_lte)
+			q = pushNil(mb, q, tt);
+		else
+			q = pushArgument(mb, q, v->nr);
+		if (e->flag == cmp_gt || e->flag == cmp_gte)
+			q = pushNil(mb, q, tt);
+		else
+			q = pushArgument(mb, q, v->nr);
+		q = pushBit(mb, q, e->flag != cmp_gt);
+		q = pushBit(mb, q, e->flag != cmp_lt);
+		if (rgs)
+			q = pushArgument(mb, q, rgs);
+		pushInstruction(mb, q);
+		rgs = getArg(q, 0);
+	}
+	return rgs;
+}
+
+/* one mcf.read per column; a LIMIT (topn) restricts the row groups
+ * read, as do the filters through the min/max of the chunks */
+static void *
+mcf_load(void *BE, sql_subfunc *f, char *filename, sql_exp *topn, list *filters)
+{
+	backend *be = (backend*)BE;
+	mvc *sql = be->mvc;
+	MalBlkPtr mb = be->mb;
+	list *cols = sa_list(sql->sa);
+	stmt *nrows = topn ? exp_bin(be, topn, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, 0) : stmt_atom_lng_nil(be);
+	int i = 0, rgs = filters ? mcf_filter(be, f, filename, filters) : 0;
+
+	if (!nrows || !cols || rgs < 0)
+		return NULL;
+	for (node *n = f->coltypes->h; n; n = n->next, i++) {
+		sql_subtype *t = n->data;
+		InstrPtr q = newStmt(mb, "mcf", "read");
+		if (q == NULL)
+			return sql_error(sql, 10, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		setVarType(mb, getArg(q, 0), newBatType(t->type->localtype));
+		q = pushStr(mb, q, filename);
+		q = pushInt(mb, q, i);
+		q = pushArgument(mb, q, rgs ? rgs : nrows->nr);
+		pushInstruction(mb, q);
+		list_append(cols, stmt_blackbox_result(be, q, 0, t));
+	}
+	return stmt_list(be, cols);
+}
+
+#define meta(P, Tpe)							\
+	do {								\
+		P = newStmtArgs(mb, "bat", "pack", args);		\
+		if (P) {						\
+			setVarType(mb, getArg(P, 0), newBatType(Tpe));	\
+			setVarFixed(mb, getArg(P, 0));			\
+			q = pushArgument(mb, q, getArg(P, 0));		\
+			pushInstruction(mb, P);				\
+		}							\
+	} while (0)
+
+/* COPY SELECT ... INTO 'file.mcf': a single mcf.export of all columns */
+static void *
+mcf_dump(void *BE, void *COLS, char *filename)
+{
+	backend *be = (backend*)BE;
+	mvc *sql = be->mvc;
+	MalBlkPtr mb = be->mb;
+	stmt *sub = COLS;
+	list *l = sub->op4.lval;
+	int args = list_length(l) + 1;
+	InstrPtr q, nme, tpe, len, scale;
+	size_t flen = strlen(filename);
+
+	q = newInstructionArgs(mb, putName("mcf"), putName("export"), args + 7);
+	if (q == NULL)
+		return sql_error(sql, 10, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	getArg(q, 0) = newTmpVariable(mb, TYPE_lng);
+	q = pushStr(mb, q, filename);
+	q = pushBit(mb, q, flen > 4 && strcasecmp(filename + flen - 4, ".lz4") == 0);
+	meta(nme, TYPE_str);
+	meta(tpe, TYPE_str);
+	meta(len, TYPE_int);
+	meta(scale, TYPE_int);
+	if (nme == NULL || tpe == NULL || len == NULL || scale == NULL) {
+		freeInstruction(q);
+		return sql_error(sql, 10, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	}
+	for (node *n = l->h; n; n = n->next) {
+		stmt *c = n->data;
+		sql_subtype *t = tail_type(c);
+
+		nme = pushStr(mb, nme, column_name(sql->sa, c));
+		tpe = pushStr(mb, tpe, t->type->base.name);
+		len = pushInt(mb, len, t->digits);
+		scale = pushInt(mb, scale, t->scale);
+		q = pushArgument(mb, q, c->nr);
+	}
+	pushInstruction(mb, q);
+	if (mb->errors)
+		return sql_error(sql, 10, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	return stmt_direct_func(be, q);
+}
+
+static str
+MCFprelude(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void)cntxt; (void)mb; (void)stk; (void)pci;
+
+	fl_register("mcf", &mcf_relation, &mcf_load);
+	fl_register_dump("mcf", &mcf_dump);
+	return MAL_SUCCEED;
+}
+
+static str
+MCFepilogue(void *ret)
+{
+	fl_unregister("mcf");
+	(void)ret;
+	return MAL_SUCCEED;
+}
+
+#include "sql_scenario.h"
+#include "mel.h"
+
+static mel_func mcf_init_funcs[] = {
+	pattern("mcf", "prelude", MCFprelude, false, "", noargs),
+	command("mcf", "epilogue", MCFepilogue, false, "", noargs),
+	pattern("mcf", "read", MCFread, false, "Read a column of a MonetDB columnar file, only the row groups needed for the first nrows rows (all if nil)", args(1,4, batargany("",1),arg("fname",str),arg("col",int),arg("nrows",lng))),
+	pattern("mcf", "read", MCFread, false, "Read the given (ascending) row groups of a column of a MonetDB columnar file", args(1,4, batargany("",1),arg("fname",str),arg("col",int),batarg("rowgroups",int))),
+	pattern("mcf", "rowgroups", MCFrowgroups, false, "The row groups of a column whose min/max statistics overlap the range low..high", args(1,7, batarg("",int),arg("fname",str),arg("col",int),argany("low",1),argany("high",1),arg("li",bit),arg("hi",bit))),
+	pattern("mcf", "rowgroups", MCFrowgroups, false, "The row groups out of the given ones whose min/max statistics overlap the range low..high", args(1,8, batarg("",int),arg("fname",str),arg("col",int),argany("low",1),argany("high",1),arg("li",bit),arg("hi",bit),batarg("rowgroups",int))),
+	pattern("mcf", "export", MCFexport, true, "Write the columns to a new MonetDB columnar file", args(1,8, arg("",lng),arg("fname",str),arg("compress",bit),batarg("attr",str),batarg("tpe",str),batarg("len",int),batarg("scale",int),varargany("cols",0))),
+{ .imp=NULL }
+};
+
+#include "mal_import.h"
+#ifdef _MSC_VER
+#undef read
+#pragma section(".CRT$XCU",read)
+#endif
+LIB_STARTUP_FUNC(init_mcf_mal)
+{ mal_module("mcf", NULL, mcf_init_funcs); }
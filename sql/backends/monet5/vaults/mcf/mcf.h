@@ -0,0 +1,97 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2024 MonetDB Foundation;
+ * Copyright August 2008 - 2023 MonetDB B.V.;
+ * Copyright 1997 - July 2008 CWI.
+ */
+
+/*
+ * The MonetDB columnar file (.mcf) format.
+ *
+ * A file holds a complete table: a fixed size header, the column data
+ * and the metadata describing the columns and their chunks.  All
+ * integers and values are stored in native byte order; the header
+ * records the byte order and readers refuse files written with a
+ * different one.
+ *
+ *	header		mcf_header at offset 0
+ *	column data	per column the chunks of all its row groups, the
+ *			first chunk of each column starting at a multiple
+ *			of MCF_ALIGN
+ *	metadata	per column an mcf_column followed by its name, its
+ *			SQL type name and its GDK atom name (each NUL
+ *			terminated), followed by nrowgroups mcf_chunk
+ *			descriptors per column
+ *
+ * All row groups hold rowgroupsize rows, except for the last one.
+ * Fixed-width values are stored as is (MCF_PLAIN), nils included, so
+ * that the uncompressed chunks of a column form one array that can be
+ * memory mapped directly as the tail heap of a BAT.  String columns
+ * are dictionary encoded per row group (MCF_DICT): the chunk holds the
+ * number of distinct strings, their offsets, the string data and the
+ * code of each row, 1, 2 or 4 bytes wide depending on the size of the
+ * dictionary.  Any chunk can additionally be LZ4 compressed.
+ */
+
+#ifndef _MCF_H_
+#define _MCF_H_
+
+#define MCF_MAGIC	"MonetCF"	/* including the NUL: 8 bytes */
+#define MCF_VERSION	1
+#define MCF_ALIGN	((uint64_t) 1 << 16) /* >= page size and Windows' allocation granularity */
+#define MCF_ROWGROUP	((uint64_t) 1 << 20) /* rows per row group, keeps chunks MCF_ALIGNed */
+
+/* mcf_header.flags */
+#define MCF_BIGENDIAN	1
+
+/* mcf_chunk.encoding */
+#define MCF_PLAIN	0
+#define MCF_DICT	1
+
+/* mcf_chunk.compression */
+#define MCF_NONE	0
+#define MCF_LZ4		1
+
+/* mcf_chunk.flags */
+#define MCF_NONIL	1		/* chunk has no nils */
+#define MCF_MINMAX	2		/* min and max are valid */
+
+typedef struct mcf_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t nrows;
+	uint64_t rowgroupsize;
+	uint32_t ncols;
+	uint32_t nrowgroups;
+	uint64_t metaoffset;	/* start and size of the metadata */
+	uint64_t metalength;
+} mcf_header;
+
+typedef struct mcf_column {
+	uint32_t namelen;	/* lengths of the strings following, */
+	uint32_t typelen;	/* excluding their NUL bytes */
+	uint32_t atomlen;
+	uint32_t digits;	/* of the SQL type */
+	uint32_t scale;
+	uint32_t width;		/* bytes per value, 0 for strings */
+} mcf_column;
+
+typedef struct mcf_chunk {
+	uint64_t offset;	/* in the file */
+	uint64_t length;	/* as stored */
+	uint64_t rawlength;	/* after decompression */
+	uint32_t encoding;
+	uint32_t compression;
+	uint32_t flags;
+	uint32_t unused[3];	/* keeps min and max 16 byte aligned */
+	unsigned char min[16];	/* native representation of the values */
+	unsigned char max[16];
+} mcf_chunk;
+
+#endif /* _MCF_H_ */
@@ -754,6 +754,8 @@ typedef struct sql_session {
 	char ac_on_commit;	/* if 1, auto_commit should be enabled on
 	                           commit, rollback, etc. */
 	char auto_commit;
+	char synchronous_commit;	/* if 0, commit without waiting for the
+					   write-ahead log to be on disk */
 	int level;		/* TRANSACTION isolation level */
 	int status;		/* status, ok/error */
 	backend_stack stk;
@@ -49,6 +49,25 @@ create function sys.bbp ()
 		status string, kind string)
 	external name bbp.get;
 
+create function sys.bbp_clock()
+	returns table (loaded int, hits bigint, misses bigint,
+		evictions bigint, sweeps bigint, budget bigint, vmsize bigint)
+	external name bbp.clock;
+create view sys.bbp_stats as select * from sys.bbp_clock();
+
+create function sys.wal_statistics()
+	returns table (commits bigint, flushes bigint, max_batch bigint,
+		avg_latency bigint, max_latency bigint, avg_flush bigint,
+		replay_files bigint, replay_transactions bigint,
+		replay_changes bigint, replay_time bigint, replay_threads int)
+	external name sql.wal_statistics;
+create view sys.wal_stats as select * from sys.wal_statistics();
+
+create procedure sys.bbp_priority(sname string, tname string, priority int)
+	external name sql.bbp_priority;
+create procedure sys.bbp_budget(budget bigint)
+	external name bbp.setbudget;
+
 create function sys.malfunctions()
 	returns table("module" string, "function" string, "signature" string, "address" string, "comment" string)
 	external name "manual"."functions";
@@ -445,3 +445,113 @@ GRANT EXECUTE ON WINDOW corr(REAL, REAL) TO PUBLIC;
 create window corr(e1 DOUBLE, e2 DOUBLE) returns DOUBLE
 	external name "sql"."corr";
 GRANT EXECUTE ON WINDOW corr(DOUBLE, DOUBLE) TO PUBLIC;
+
+create aggregate approx_count_distinct(val TINYINT) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(TINYINT) TO PUBLIC;
+create aggregate approx_count_distinct(val SMALLINT) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(SMALLINT) TO PUBLIC;
+create aggregate approx_count_distinct(val INTEGER) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTEGER) TO PUBLIC;
+create aggregate approx_count_distinct(val BIGINT) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(BIGINT) TO PUBLIC;
+create aggregate approx_count_distinct(val DECIMAL(2)) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(2)) TO PUBLIC;
+create aggregate approx_count_distinct(val DECIMAL(4)) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(4)) TO PUBLIC;
+create aggregate approx_count_distinct(val DECIMAL(9)) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(9)) TO PUBLIC;
+create aggregate approx_count_distinct(val DECIMAL(18)) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(18)) TO PUBLIC;
+create aggregate approx_count_distinct(val REAL) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(REAL) TO PUBLIC;
+create aggregate approx_count_distinct(val DOUBLE) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(DOUBLE) TO PUBLIC;
+create aggregate approx_count_distinct(val DATE) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(DATE) TO PUBLIC;
+create aggregate approx_count_distinct(val TIME) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(TIME) TO PUBLIC;
+create aggregate approx_count_distinct(val TIMESTAMP) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(TIMESTAMP) TO PUBLIC;
+create aggregate approx_count_distinct(val INTERVAL SECOND) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTERVAL SECOND) TO PUBLIC;
+create aggregate approx_count_distinct(val INTERVAL DAY) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTERVAL DAY) TO PUBLIC;
+create aggregate approx_count_distinct(val INTERVAL MONTH) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(INTERVAL MONTH) TO PUBLIC;
+create aggregate approx_count_distinct(val CLOB) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(CLOB) TO PUBLIC;
+
+create aggregate hll_sketch(val TINYINT) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(TINYINT) TO PUBLIC;
+create aggregate hll_sketch(val SMALLINT) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(SMALLINT) TO PUBLIC;
+create aggregate hll_sketch(val INTEGER) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(INTEGER) TO PUBLIC;
+create aggregate hll_sketch(val BIGINT) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(BIGINT) TO PUBLIC;
+create aggregate hll_sketch(val DECIMAL(2)) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(2)) TO PUBLIC;
+create aggregate hll_sketch(val DECIMAL(4)) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(4)) TO PUBLIC;
+create aggregate hll_sketch(val DECIMAL(9)) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(9)) TO PUBLIC;
+create aggregate hll_sketch(val DECIMAL(18)) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(18)) TO PUBLIC;
+create aggregate hll_sketch(val REAL) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(REAL) TO PUBLIC;
+create aggregate hll_sketch(val DOUBLE) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(DOUBLE) TO PUBLIC;
+create aggregate hll_sketch(val DATE) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(DATE) TO PUBLIC;
+create aggregate hll_sketch(val TIME) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(TIME) TO PUBLIC;
+create aggregate hll_sketch(val TIMESTAMP) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(TIMESTAMP) TO PUBLIC;
+create aggregate hll_sketch(val INTERVAL SECOND) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(INTERVAL SECOND) TO PUBLIC;
+create aggregate hll_sketch(val INTERVAL DAY) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(INTERVAL DAY) TO PUBLIC;
+create aggregate hll_sketch(val INTERVAL MONTH) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(INTERVAL MONTH) TO PUBLIC;
+create aggregate hll_sketch(val CLOB) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(CLOB) TO PUBLIC;
+create aggregate hll_merge(sketch BLOB) returns BLOB
+	external name "aggr"."hll_merge";
+GRANT EXECUTE ON AGGREGATE hll_merge(BLOB) TO PUBLIC;
+create function hll_estimate(sketch BLOB) returns BIGINT
+	external name "aggr"."hll_estimate";
+GRANT EXECUTE ON FUNCTION hll_estimate(BLOB) TO PUBLIC;
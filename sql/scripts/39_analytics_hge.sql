@@ -88,3 +88,17 @@ GRANT EXECUTE ON AGGREGATE corr(HUGEINT, HUGEINT) TO PUBLIC;
 create window corr(e1 HUGEINT, e2 HUGEINT) returns DOUBLE
 	external name "sql"."corr";
 GRANT EXECUTE ON WINDOW corr(HUGEINT, HUGEINT) TO PUBLIC;
+
+create aggregate approx_count_distinct(val HUGEINT) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(HUGEINT) TO PUBLIC;
+create aggregate approx_count_distinct(val DECIMAL(38)) returns BIGINT
+	external name "aggr"."approx_count_distinct";
+GRANT EXECUTE ON AGGREGATE approx_count_distinct(DECIMAL(38)) TO PUBLIC;
+
+create aggregate hll_sketch(val HUGEINT) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(HUGEINT) TO PUBLIC;
+create aggregate hll_sketch(val DECIMAL(38)) returns BLOB
+	external name "aggr"."hll_sketch";
+GRANT EXECUTE ON AGGREGATE hll_sketch(DECIMAL(38)) TO PUBLIC;
@@ -50,6 +50,7 @@ fl_register(char *name, fl_add_types_fptr add_types, fl_load_fptr load)
 			file_loaders[i].name = GDKstrdup(name);
 			file_loaders[i].add_types = add_types;
 			file_loaders[i].load = load;
+			file_loaders[i].dump = NULL;
 			return 0;
 		}
 	}
@@ -58,6 +59,16 @@ fl_register(char *name, fl_add_types_fptr add_types, fl_load_fptr load)
 	return -1;	/* could not register file_loader */
 }
 
+int
+fl_register_dump(char *name, fl_dump_fptr dump)
+{
+	file_loader_t *fl = fl_find(name);
+	if (!fl)
+		return -1;	/* register the loader first */
+	fl->dump = dump;
+	return 0;
+}
+
 file_loader_t*
 fl_find(char *name)
 {
@@ -17,16 +17,24 @@
 #include "sql_mvc.h"
 
 typedef str (*fl_add_types_fptr)(mvc *sql, sql_subfunc *f, char *filename, list *res_exps, char *name);
-typedef void *(*fl_load_fptr)(void *be, sql_subfunc *f, char *filename, sql_exp *topn); /* use void * as both return type and be
+typedef void *(*fl_load_fptr)(void *be, sql_subfunc *f, char *filename, sql_exp *topn, list *filters); /* use void * as both return type and be
 																			argument are unknown types at this layer */
+/* filters (may be NULL) holds simple comparisons (column cmp atom, the
+ * column named as in f->colnames) that the rows of the result must pass.
+ * A loader may use them to skip data, the selection is done afterwards
+ * anyway. */
+typedef void *(*fl_dump_fptr)(void *be, void *cols, char *filename); /* cols is the stmt list of the query to export,
+																			returns the export stmt */
 
 typedef struct file_loader_t {
 	char *name;
 	fl_add_types_fptr add_types;
 	fl_load_fptr load;
+	fl_dump_fptr dump;	/* optional, used by COPY ... INTO file */
 } file_loader_t;
 
 sql_export int fl_register(char *name, fl_add_types_fptr add_types, fl_load_fptr fl_load);
+sql_export int fl_register_dump(char *name, fl_dump_fptr fl_dump);
 sql_export void fl_unregister(char *name);
 extern file_loader_t* fl_find(char *name);
 
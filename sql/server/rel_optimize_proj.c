@@ -1871,7 +1871,9 @@ rel_push_aggr_down(visitor *v, sql_rel *rel)
 		if (ul->op == op_groupby || ur->op == op_groupby)
 			return rel;
 
-		/* distinct should be done over the full result */
+		/* distinct should be done over the full result, and so
+		 * should floating point sums, whose sum of sums would depend
+		 * on how the input is split */
 		for (n = g->exps->h; n; n = n->next) {
 			sql_exp *e = n->data;
 			sql_subfunc *af = e->f;
@@ -1883,6 +1885,8 @@ rel_push_aggr_down(visitor *v, sql_rel *rel)
 			     strcmp(af->func->base.name, "count") &&
 			     strcmp(af->func->base.name, "min") &&
 			     strcmp(af->func->base.name, "max")) ||
+			   (strcmp(af->func->base.name, "sum") == 0 &&
+			    exp_subtype(e)->type->eclass == EC_FLT) ||
 			   need_distinct(e))))
 				return rel;
 		}
@@ -3150,6 +3150,9 @@ rel_nop(sql_query *query, sql_rel **rel, symbol *se, int fs, exp_kind ek)
 			sql_func *f = q?q->f:inplace_func(sql);
 			list *ops = q?f->ops:sql->params;
 
+			if (q) /* the cached plan may be stale by now */
+				qc_reoptimize(sql->qc, sql, q);
+
 			tl = sa_list(sql->sa);
 			if (list_length(ops) != list_length(exps))
 				return sql_error(sql, 02, SQLSTATE(42000) "EXEC called with wrong number of arguments: expected %d, got %d", list_length(ops), list_length(exps));
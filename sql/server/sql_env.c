@@ -78,6 +78,10 @@ sql_update_var(mvc *m, sql_schema *s, const char *name, ValPtr ptr)
 				throw(SQL,"sql.update_var", SQLSTATE(3F000) "Schema (%s) missing\n", ptr->val.sval);
 			else if (strcmp(name, "current_role") == 0 && !mvc_set_role(m, ptr->val.sval))
 				throw(SQL,"sql.update_var", SQLSTATE(42000) "Role (%s) missing\n", ptr->val.sval);
+		} else if (strcmp(name, "synchronous_commit") == 0) {
+			if (VALisnil(ptr))
+				throw(SQL,"sql.update_var", SQLSTATE(42000) "Variable '%s.%s' cannot be NULL\n", s->base.name, name);
+			m->session->synchronous_commit = ptr->val.btval != 0;
 		}
 	}
 	return NULL;
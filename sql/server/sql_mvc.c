@@ -578,7 +578,7 @@ mvc_commit(mvc *m, int chain, const char *name, bool enabling_auto_commit)
 	/* commit and cleanup nested transactions */
 	if (tr->parent) {
 		while (tr->parent != NULL && ok == SQL_OK) {
-			if ((ok = sql_trans_commit(tr)) == SQL_ERR)
+			if ((ok = sql_trans_commit(tr, true)) == SQL_ERR)
 				GDKfatal("%s transaction commit failed; exiting (kernel error: %s)", operation, GDKerrbuf);
 			m->session->tr = tr = sql_trans_destroy(tr);
 		}
@@ -745,7 +745,7 @@ mvc_release(mvc *m, const char *name)
 	tr = m->session->tr;
 	while (!tr->name || strcmp(tr->name, name) != 0) {
 		/* commit all intermediate savepoints */
-		if (sql_trans_commit(tr) != SQL_OK)
+		if (sql_trans_commit(tr, true) != SQL_OK)
 			GDKfatal("release savepoints should not fail");
 		m->session->tr = tr = sql_trans_destroy(tr);
 	}
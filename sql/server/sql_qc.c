@@ -16,6 +16,7 @@
 #include "sql_mvc.h"
 #include "sql_atom.h"
 #include "rel_exp.h"
+#include "rel_rel.h"
 #include "gdk_time.h"
 
 qc *
@@ -190,6 +191,86 @@ qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, symbol *s, list *params, map
 	return n;
 }
 
+/* The plan of a prepared statement is made for the table sizes seen at
+ * PREPARE time, its mitosis split and join order depend on them.
+ * qc_checkpoint records the row count of every base table of the plan;
+ * qc_reoptimize compares them with the current counts on each EXEC and
+ * throws the MAL plan away when a table grew or shrank by more than
+ * reoptimize_factor, so that the EXEC plans the statement again.  Only
+ * base table counts are compared: the sizes of intermediate results are
+ * not estimated against, and a plan that is already running is not
+ * changed.  Other queries are planned each time they are run and do
+ * not need this. */
+#define REOPT_FACTOR	100
+#define REOPT_MINROWS	100000	/* don't bother re-planning for small tables */
+
+static BUN
+cq_table_count(mvc *sql, sqlid id)
+{
+	sql_trans *tr = sql->session->tr;
+	sqlstore *store = tr->store;
+	sql_table *t = sql_trans_find_table(tr, id);
+
+	if (!t || !isTable(t) || isDeclaredTable(t) || ol_length(t->columns) == 0)
+		return BUN_NONE;
+	return (BUN) store->storage_api.count_col(tr, ol_first_node(t->columns)->data, 10); /* count active rows only */
+}
+
+void
+qc_checkpoint(mvc *sql, cq *q)
+{
+	if (!q->tids) {
+		list *deps = q->rel ? rel_dependencies(sql, q->rel) : NULL;
+		int nr = 0;
+
+		if (!deps)
+			return;
+		q->tids = SA_NEW_ARRAY(q->sa, sqlid, list_length(deps));
+		q->cards = SA_NEW_ARRAY(q->sa, BUN, list_length(deps));
+		if (!q->tids || !q->cards) {
+			q->tids = NULL;
+			return;
+		}
+		for (node *n = deps->h; n; n = n->next) {
+			sql_base *b = n->data;
+
+			if (cq_table_count(sql, b->id) != BUN_NONE)
+				q->tids[nr++] = b->id;
+		}
+		q->ntables = nr;
+	}
+	for (int i = 0; i < q->ntables; i++)
+		q->cards[i] = cq_table_count(sql, q->tids[i]);
+}
+
+void
+qc_reoptimize(qc *cache, mvc *sql, cq *q)
+{
+	int factor = GDKgetenv_int("reoptimize_factor", REOPT_FACTOR);
+
+	if (!q->f->instantiated) {	/* the plan will be remade anyway */
+		qc_checkpoint(sql, q);
+		return;
+	}
+	if (factor <= 1)
+		return;
+	for (int i = 0; i < q->ntables; i++) {
+		BUN cnt = cq_table_count(sql, q->tids[i]), lo, hi;
+
+		if (cnt == BUN_NONE || q->cards[i] == BUN_NONE)
+			continue;
+		lo = MIN(cnt, q->cards[i]);
+		hi = MAX(cnt, q->cards[i]);
+		if (hi >= REOPT_MINROWS && hi / MAX(lo, 1) >= (BUN) factor) {
+			TRC_INFO(SQL_PARSER, "Re-optimizing cached query %s: table %d changed from " BUNFMT " to " BUNFMT " rows\n",
+					 q->name, q->tids[i], q->cards[i], cnt);
+			cq_restart(cache->clientid, q);
+			qc_checkpoint(sql, q);
+			return;
+		}
+	}
+}
+
 int
 qc_size(qc *cache)
 {
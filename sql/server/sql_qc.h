@@ -33,6 +33,9 @@ typedef struct cq {
 	int count;			/* number of times the query is matched */
 	timestamp created;	/* when the query was created */
 	sql_func *f;
+	int ntables;		/* base tables the plan was made for */
+	sqlid *tids;		/* their ids */
+	BUN *cards;			/* and their row counts at that time */
 } cq;
 
 typedef struct qc {
@@ -49,6 +52,8 @@ extern void qc_destroy(qc *cache);
 sql_export cq *qc_find(qc *cache, int id);
 sql_export cq *qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, symbol *s, list *params, mapi_query_t type, char *codedstr, int no_mitosis);
 sql_export void qc_delete(qc *cache, cq *q);
+extern void qc_checkpoint(mvc *sql, cq *q);
+extern void qc_reoptimize(qc *cache, mvc *sql, cq *q);
 extern int qc_size(qc *cache);
 
 #endif /*_SQL_QC_H_*/
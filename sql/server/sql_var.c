@@ -78,6 +78,9 @@ init_global_variables(mvc *sql)
 	sql_find_subtype(&ctype, "bigint", 0, 0);
 	SQLglobal(sname, "last_id", &sec);
 	SQLglobal(sname, "rowcnt", &sec);
+
+	sql_find_subtype(&ctype, "boolean", 0, 0);
+	SQLglobal(sname, "synchronous_commit", &(bit){1});
 	return 0;
 }
 
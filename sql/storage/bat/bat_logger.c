@@ -3299,15 +3299,15 @@ bl_tstart(sqlstore *store, bool flush, ulng *log_file_id)
 }
 
 static int
-bl_tend(sqlstore *store)
+bl_tend(sqlstore *store, bool sync)
 {
-	return log_tend(store->logger) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
+	return log_tend(store->logger, sync) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
 }
 
 static int
-bl_tflush(sqlstore *store, ulng log_file_id, ulng commit_ts)
+bl_tflush(sqlstore *store, ulng log_file_id, ulng commit_ts, bool sync)
 {
-	return log_tflush(store->logger, log_file_id, commit_ts) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
+	return log_tflush(store->logger, log_file_id, commit_ts, sync) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
 }
 
 static int
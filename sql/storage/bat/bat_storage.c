@@ -2116,7 +2116,9 @@ delta_append_bat(sql_trans *tr, sql_delta **batp, sqlid id, BUN offset, BAT *off
 			bat_destroy(oi);
 		return LOG_ERR;
 	}
-	if (istemp && !offsets && offset == 0 && BATcount(b) == 0 && bat->cs.ucnt == 0) {
+	if (istemp && !offsets && offset == 0 && BATcount(b) == 0 && bat->cs.ucnt == 0 &&
+	    i->theap->storage != STORE_NOWN) {
+		/* use i itself, unless it borrows its memory */
 		bat_set_access(i, BAT_READ);
 		if (bat->cs.bid)
 			temp_destroy(bat->cs.bid);
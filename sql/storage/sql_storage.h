@@ -292,8 +292,8 @@ typedef int (*logger_get_sequence_fptr) (struct sqlstore *store, int seq, lng *i
 
 typedef int (*log_isnew_fptr)(struct sqlstore *store);
 typedef int (*log_tstart_fptr) (struct sqlstore *store, bool flush, ulng *log_file_id);
-typedef int (*log_tend_fptr) (struct sqlstore *store);
-typedef int (*log_tflush_fptr) (struct sqlstore *store, ulng log_file_id, ulng commit_tis);
+typedef int (*log_tend_fptr) (struct sqlstore *store, bool sync);
+typedef int (*log_tflush_fptr) (struct sqlstore *store, ulng log_file_id, ulng commit_tis, bool sync);
 typedef lng (*log_save_id_fptr) (struct sqlstore *store);
 typedef int (*log_tsequence_fptr) (struct sqlstore *store, int seq, lng id);
 
@@ -365,7 +365,7 @@ extern int store_readonly(struct sqlstore *store);
 extern sql_trans *sql_trans_create(struct sqlstore *store, sql_trans *parent, const char *name);
 extern sql_trans *sql_trans_destroy(sql_trans *tr);
 //extern bool sql_trans_validate(sql_trans *tr);
-extern int sql_trans_commit(sql_trans *tr);
+extern int sql_trans_commit(sql_trans *tr, bool sync);
 
 extern int sql_trans_create_type(sql_trans *tr, sql_schema *s, const char *sqlname, unsigned int digits, unsigned int scale, int radix, const char *impl);
 extern int sql_trans_drop_type(sql_trans *tr, sql_schema * s, sqlid id, int drop_action);
@@ -567,5 +567,7 @@ extern int FORprepare4append(BAT **noffsets, BAT *vals, lng minval, int tt);
 extern int FORprepare4append_vals(void **noffsets, void *vals, BUN cnt, lng minval, int vtype, int ft);
 
 extern void store_printinfo(sqlstore *store);
+struct log_stats;
+extern void store_logstats(sqlstore *store, struct log_stats *st);
 
 #endif /*SQL_STORAGE_H */
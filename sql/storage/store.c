@@ -2127,7 +2127,7 @@ store_load(sqlstore *store, sql_allocator *pa)
 		tr->active = 0;
 	}
 
-	if (sql_trans_commit(tr) != SQL_OK) {
+	if (sql_trans_commit(tr, true) != SQL_OK) {
 		TRC_CRITICAL(SQL_STORE, "Cannot commit initial transaction\n");
 		sql_trans_destroy(tr);
 		return NULL;
@@ -2146,7 +2146,7 @@ store_load(sqlstore *store, sql_allocator *pa)
 		sql_trans_destroy(tr);
 		return NULL;
 	}
-	if (sql_trans_commit(tr) != SQL_OK) {
+	if (sql_trans_commit(tr, true) != SQL_OK) {
 		TRC_CRITICAL(SQL_STORE, "Cannot commit loaded objects transaction\n");
 		sql_trans_destroy(tr);
 		return NULL;
@@ -2457,6 +2457,12 @@ store_manager(sqlstore *store)
 		}
 		MT_lock_unset(&store->commit);
 
+		/* write most of the checkpoint to disk before taking the
+		 * locks the committers need */
+		MT_lock_unset(&store->flush);
+		BBPsyncahead();
+		MT_lock_set(&store->flush);
+
 		MT_thread_setworking("flushing");
 		if (store_apply_deltas(store) != LOG_OK) {
 			MT_lock_unset(&store->flush);
@@ -4011,7 +4017,7 @@ transaction_check_dependencies_and_removals(sql_trans *tr)
 }
 
 int
-sql_trans_commit(sql_trans *tr)
+sql_trans_commit(sql_trans *tr, bool sync)
 {
 	int ok = LOG_OK;
 	sqlstore *store = tr->store;
@@ -4028,6 +4034,13 @@ sql_trans_commit(sql_trans *tr)
 
 		bool flush = false;
 		ulng commit_ts = 0, oldest = 0, log_file_id = 0;
+		const int min_changes = ATOMIC_GET(&GDKdebug) & FORCEMITOMASK ? 5 : 1000000;
+
+		/* a transaction this large is probably written by a
+		 * checkpoint below, write its data ahead while not
+		 * holding up the other committers */
+		if (!tr->parent && tr->logchanges > min_changes)
+			BBPsyncahead();
 
 		MT_lock_set(&store->commit);
 
@@ -4054,7 +4067,6 @@ sql_trans_commit(sql_trans *tr)
 		const bool log = !tr->parent && tr->logchanges > 0;
 
 		if (log) {
-			const int min_changes = ATOMIC_GET(&GDKdebug) & FORCEMITOMASK ? 5 : 1000000;
 			flush = (tr->logchanges > min_changes && list_empty(store->changes));
 		}
 
@@ -4090,7 +4102,7 @@ sql_trans_commit(sql_trans *tr)
 
 
 			if (ok == LOG_OK)
-				ok = store->logger_api.log_tend(store); /* wal end */
+				ok = store->logger_api.log_tend(store, sync || flush); /* wal end */
 		}
 		store_lock(store);
 
@@ -4156,7 +4168,7 @@ sql_trans_commit(sql_trans *tr)
 			if (!flush)
 				MT_lock_unset(&store->commit); /* release the commit log when flushing to disk */
 			if (ok == LOG_OK)
-				ok = store->logger_api.log_tflush(store, log_file_id, commit_ts); /* flush/sync */
+				ok = store->logger_api.log_tflush(store, log_file_id, commit_ts, sync || flush); /* flush/sync */
 			if (!flush)
 				MT_lock_set(&store->commit); /* release the commit log when flushing to disk */
 			if (flush)
@@ -7242,6 +7254,7 @@ sql_session_reset(sql_session *s, int ac)
 	s->schema_name = def_schema_name;
 	s->schema = NULL;
 	s->auto_commit = s->ac_on_commit = ac;
+	s->synchronous_commit = 1;
 	s->level = tr_serializable;
 	return 1;
 }
@@ -7277,7 +7290,7 @@ sql_trans_end(sql_session *s, int ok)
 	int res = SQL_OK;
 	TRC_DEBUG(SQL_STORE, "End of transaction: " ULLFMT "\n", s->tr->tid);
 	if (ok == SQL_OK) {
-		res = sql_trans_commit(s->tr);
+		res = sql_trans_commit(s->tr, s->synchronous_commit);
 	}
 	if (ok == SQL_ERR || res != SQL_OK) /* if a conflict happened, it was already rollbacked */
 		sql_trans_rollback(s->tr, false);
@@ -7424,3 +7437,9 @@ store_printinfo(sqlstore *store)
 	log_printinfo(store->logger);
 	MT_lock_unset(&store->commit);
 }
+
+void
+store_logstats(sqlstore *store, struct log_stats *st)
+{
+	log_statistics(store->logger, st);
+}
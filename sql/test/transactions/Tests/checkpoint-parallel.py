@@ -0,0 +1,98 @@
+# a checkpoint saves the dirty columns of many tables with several
+# threads and a limited write bandwidth; kill the server right after it
+# and check that the saved columns, not the write-ahead log, restore
+# everything; the throttling must not hold up other commits
+
+import os, sys, tempfile, threading, time, pymonetdb
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+NTABLES = 8
+# MiB/s
+BANDWIDTH = 4
+
+def contents(port):
+    cli = pymonetdb.connect(port=port, database='db1', autocommit=True)
+    cur = cli.cursor()
+    res = []
+    for t in range(NTABLES):
+        cur.execute(f'SELECT count(*), sum(i), sum(b), count(s), count(distinct s), min(s), max(s) FROM t{t}')
+        res.append(cur.fetchall())
+    cur.execute('SELECT count(*), sum(i), sum(b) FROM big')
+    res.append(cur.fetchall())
+    cur.execute('SELECT count(*), sum(i) FROM small')
+    res.append(cur.fetchall())
+    cur.close()
+    cli.close()
+    return res
+
+def logsize(dbfarm):
+    logdir = os.path.join(dbfarm, 'db1', 'sql_logs', 'sql')
+    return sum(os.path.getsize(os.path.join(logdir, f)) for f in os.listdir(logdir) if f.startswith('log.'))
+
+args = ['--set', 'gdk_nr_threads=4',
+        '--set', 'gdk_checkpoint_threads=3',
+        '--set', f'gdk_checkpoint_bandwidth={BANDWIDTH}',
+        # only memory mapped heaps are written ahead at the limited
+        # bandwidth
+        '--set', 'gdk_mmap_minsize_persistent=65536']
+
+with tempfile.TemporaryDirectory() as farm_dir:
+    dbfarm = os.path.join(farm_dir, 'db1')
+    os.mkdir(dbfarm)
+    with process.server(mapiport='0', dbname='db1', dbfarm=dbfarm, args=args,
+                        stdin=process.PIPE,
+                        stdout=process.PIPE, stderr=process.PIPE) as s:
+        cli = pymonetdb.connect(port=s.dbport, database='db1', autocommit=True)
+        cur = cli.cursor()
+        # small transactions, only written to the log
+        for t in range(NTABLES):
+            cur.execute(f'CREATE TABLE t{t} (i INT, b BIGINT, s VARCHAR(20))')
+            cur.execute(f"INSERT INTO t{t} SELECT value, value * {t + 1}, 'v' || (value % 1000) FROM generate_series(0, 100000)")
+            cur.execute(f"UPDATE t{t} SET b = -b, s = 'u' || s WHERE i % 7 = {t}")
+        if logsize(dbfarm) < 1000000:
+            sys.stderr.write('Expected the changes to be in the write-ahead log\n')
+        # a transaction with more than a million changes is not logged,
+        # it saves all dirty columns instead, those of the tables above
+        # included
+        cur.execute('CREATE TABLE big (i INT, b BIGINT)')
+        cur.execute('CREATE TABLE small (i INT)')
+        # meanwhile, small transactions on another connection
+        small = []
+        def smallcommits():
+            cli2 = pymonetdb.connect(port=s.dbport, database='db1', autocommit=True)
+            cur2 = cli2.cursor()
+            time.sleep(1)
+            for i in range(5):
+                t1 = time.time()
+                cur2.execute(f'INSERT INTO small VALUES ({i})')
+                small.append(time.time() - t1)
+            cur2.close()
+            cli2.close()
+        thr = threading.Thread(target=smallcommits)
+        thr.start()
+        t0 = time.time()
+        cur.execute('INSERT INTO big SELECT value, -value FROM generate_series(0, 1000000)')
+        elapsed = time.time() - t0
+        thr.join()
+        if max(small) > elapsed / 2:
+            sys.stderr.write(f'Expected small commits not to wait for the checkpoint, they took up to {max(small):.1f}s\n')
+        cur.close()
+        cli.close()
+        if logsize(dbfarm) >= 1000000:
+            sys.stderr.write('Expected the checkpoint to empty the write-ahead log\n')
+        # big alone is more than 11 MiB
+        if elapsed < 11 / BANDWIDTH / 2:
+            sys.stderr.write(f'Expected the checkpoint to be throttled, it took {elapsed:.1f}s\n')
+        expected = contents(s.dbport)
+        s.kill()
+        s.communicate()
+
+    with process.server(mapiport='0', dbname='db1', dbfarm=dbfarm, args=args,
+                        stdin=process.PIPE,
+                        stdout=process.PIPE, stderr=process.PIPE) as s:
+        if contents(s.dbport) != expected:
+            sys.stderr.write('Expected the checkpoint to have saved all changes\n')
+        s.communicate()
@@ -0,0 +1,75 @@
+# kill a server before it has saved its changes and check that replaying
+# the write-ahead log with several threads restores them all: appends,
+# updates and deletes to many columns, and a table created in the same
+# log
+
+import os, sys, tempfile, pymonetdb
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+NTABLES = 6
+
+def contents(port):
+    cli = pymonetdb.connect(port=port, database='db1', autocommit=True)
+    cur = cli.cursor()
+    res = []
+    for t in range(NTABLES + 1):
+        cur.execute(f'SELECT count(*), sum(i), sum(b), count(s), count(distinct s), min(s), max(s) FROM t{t}')
+        res.append(cur.fetchall())
+    cur.execute('SELECT i, b, s FROM t0 WHERE i % 9973 = 0 ORDER BY i')
+    res.append(cur.fetchall())
+    cur.close()
+    cli.close()
+    return res
+
+def logsize(dbfarm):
+    logdir = os.path.join(dbfarm, 'db1', 'sql_logs', 'sql')
+    return sum(os.path.getsize(os.path.join(logdir, f)) for f in os.listdir(logdir) if f.startswith('log.'))
+
+with tempfile.TemporaryDirectory() as farm_dir:
+    dbfarm = os.path.join(farm_dir, 'db1')
+    os.mkdir(dbfarm)
+    with process.server(mapiport='0', dbname='db1', dbfarm=dbfarm,
+                        args=['--set', 'gdk_nr_threads=4'],
+                        stdin=process.PIPE,
+                        stdout=process.PIPE, stderr=process.PIPE) as s:
+        cli = pymonetdb.connect(port=s.dbport, database='db1', autocommit=True)
+        cur = cli.cursor()
+        for t in range(NTABLES):
+            cur.execute(f'CREATE TABLE t{t} (i INT, b BIGINT, s VARCHAR(20))')
+            cur.execute(f"INSERT INTO t{t} SELECT value, value * {t + 1}, 'v' || (value % 1000) FROM generate_series(0, 100000)")
+        cur.close()
+        cli.close()
+        s.communicate()
+
+    with process.server(mapiport='0', dbname='db1', dbfarm=dbfarm,
+                        args=['--set', 'gdk_nr_threads=4'],
+                        stdin=process.PIPE,
+                        stdout=process.PIPE, stderr=process.PIPE) as s:
+        cli = pymonetdb.connect(port=s.dbport, database='db1', autocommit=True)
+        cur = cli.cursor()
+        for t in range(NTABLES):
+            cur.execute(f"UPDATE t{t} SET b = -b, s = 'u' || s WHERE i % 7 = {t}")
+            cur.execute(f'DELETE FROM t{t} WHERE i % 11 = {t}')
+            cur.execute(f"INSERT INTO t{t} SELECT value, value + 1, NULL FROM generate_series(200000, 210000)")
+        cur.execute(f'CREATE TABLE t{NTABLES} (i INT, b BIGINT, s VARCHAR(20))')
+        cur.execute(f"INSERT INTO t{NTABLES} SELECT value, value % 3, 'new' FROM generate_series(0, 50000)")
+        cur.execute(f'DELETE FROM t{NTABLES} WHERE i < 10')
+        cur.close()
+        cli.close()
+        expected = contents(s.dbport)
+        # the changes are still only in the log
+        if logsize(dbfarm) < 1000000:
+            sys.stderr.write('Expected the changes to be in the write-ahead log\n')
+        s.kill()
+        s.communicate()
+
+    with process.server(mapiport='0', dbname='db1', dbfarm=dbfarm,
+                        args=['--set', 'gdk_nr_threads=4'],
+                        stdin=process.PIPE,
+                        stdout=process.PIPE, stderr=process.PIPE) as s:
+        if contents(s.dbport) != expected:
+            sys.stderr.write('Expected the replayed log to restore all changes\n')
+        s.communicate()
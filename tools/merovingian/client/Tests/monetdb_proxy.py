@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+
+# connections forwarded by monetdbd in proxy mode: results and queries
+# larger than the proxy buffers, concurrent connections, and servers or
+# clients that hang up while the proxy still holds data for the other side
+
+import glob
+import os
+import socket
+import struct
+import subprocess
+import threading
+import time
+
+from monetdbd import MonetDBD, Runner
+from MonetDBtesting import malmapi
+
+gdk_farmdir = os.environ.get('TSTTRGDIR') or '/tmp/'
+# databases in a farm with a path this long cannot have a UNIX socket,
+# so monetdbd connects to them over TCP and proxies the connections
+# instead of passing the client's socket on
+farmdir = os.path.join(gdk_farmdir, 'monetdbd-proxy-test')
+farmdir += '-' * max(0, 110 - len(farmdir))
+
+def cputime(pid, thread):
+    """User plus system time used by the thread with the given name in
+    process pid, in clock ticks, or None if that cannot be determined."""
+    for task in glob.glob(f'/proc/{pid}/task/*'):
+        try:
+            with open(os.path.join(task, 'comm')) as f:
+                if f.read().strip() != thread:
+                    continue
+            with open(os.path.join(task, 'stat')) as f:
+                fields = f.read().rsplit(')', 1)[1].split()
+        except OSError:
+            continue
+        return int(fields[11]) + int(fields[12])
+    return None
+
+with Runner(False, timeout=100) as run:
+
+    def header(text):
+        run.print()
+        run.print('-- ', text)
+
+    def note(*args, **kwargs):
+        run.print('NOTE ', sep='', end='')
+        run.print(*args, **kwargs)
+
+    header('CREATE FARM')
+    with MonetDBD(run, farmdir) as m:
+        m.run_monetdbd('set', 'forward=proxy')
+        out = m.run_monetdbd('get', 'forward', output=True)
+        assert 'proxy' in out
+        note("""'proxy' in output as expected""")
+
+        header('SIMPLE QUERIES')
+        for db in ['foo1', 'foo2', 'bar']:
+            out = m.run_mclient('-s', 'select * from t', '-fcsv', output=True, db=db)
+            assert out.strip() == db
+        note('all databases answered through the proxy')
+
+        header('LARGE RESULT')
+        # much more than fits in the proxy buffer or the splice pipe
+        out = m.run_mclient('-s', "select value, 'row ' || value from generate_series(0, 200000)",
+                            '-fcsv', output=True, db='foo1')
+        lines = out.rstrip('\n').split('\n')
+        assert len(lines) == 200000 and lines[-1] == '199999,row 199999'
+        note('got all 200000 rows')
+
+        header('LARGE QUERY')
+        sqlfile = os.path.join(gdk_farmdir, 'monetdb_proxy.sql')
+        with open(sqlfile, 'w') as f:
+            values = ','.join(f"('{i:08d}')" for i in range(100000))
+            f.write(f'insert into t values {values};\n')
+        m.run_mclient(sqlfile, db='foo2')
+        os.remove(sqlfile)
+        out = m.run_mclient('-s', 'select count(*), max(s) from t', '-fcsv', output=True, db='foo2')
+        assert out.strip() == '100001,foo2', out
+        note('the 100000 row insert arrived intact')
+
+        header('CONCURRENT CONNECTIONS')
+        results = {}
+        def query(i):
+            cmd = ['mclient', '-p', str(m.port), '-d', 'bar', '-fcsv',
+                   '-s', f'select count(*) + {i} from generate_series(0, 50000)']
+            results[i] = subprocess.check_output(cmd, timeout=100, text=True).strip()
+        threads = [threading.Thread(target=query, args=(i,)) for i in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        assert all(results.get(i) == str(50000 + i) for i in range(8)), results
+        note('8 concurrent connections got their own results')
+
+        header('SERVER GONE WITH UNSENT DATA')
+        # the client does not read its result, so the proxy still holds
+        # data for it when the server is killed; that hang up must not
+        # keep the proxy busy
+        c = malmapi.Connection()
+        c.connect('bar', 'monetdb', 'monetdb', 'sql', hostname='localhost', port=m.port)
+        c.set_reply_size(-1)
+        c._putblock("sselect value, 'row ' || value from generate_series(0, 2000000);\n")
+        time.sleep(2)
+        m.run_monetdb('kill', 'bar')
+        before = cputime(m.proc.pid, 'proxyThread')
+        time.sleep(2)
+        after = cputime(m.proc.pid, 'proxyThread')
+        if before is not None:
+            # a busy loop would use most of these two seconds
+            ticks = os.sysconf('SC_CLK_TCK')
+            assert after - before < ticks / 4, f'the proxy used {(after - before) / ticks:.2f}s of CPU'
+            note('the proxy is idle after the server disappeared')
+
+        c.socket.close()
+        c.socket = None
+
+        header('CLIENT GONE WITH UNSENT DATA')
+        # the server sleeps and does not read, so the proxy still holds
+        # data for it when the client hangs up; over a UNIX socket that
+        # hang up is reported until the proxy stops waiting for it
+        m.run_mclient('-s', 'create procedure sleep(i int) external name alarm.sleep', db='foo2')
+        usock = f'/tmp/.s.monetdb.{m.port}'
+        c = malmapi.Connection()
+        if os.path.exists(usock):
+            c.connect('foo2', 'monetdb', 'monetdb', 'sql', unix_socket=usock)
+        else:
+            c.connect('foo2', 'monetdb', 'monetdb', 'sql', hostname='localhost', port=m.port)
+        c._putblock('scall sys.sleep(10000);\n')
+        time.sleep(1)
+        # send until nothing is taken for a second
+        c.socket.settimeout(1)
+        query = b'sselect 1;\n'
+        block = struct.pack('<H', (len(query) << 1) | 1) + query
+        try:
+            while True:
+                c.socket.sendall(block * 4096)
+        except socket.timeout:
+            pass
+        c.socket.shutdown(socket.SHUT_RDWR)
+        before = cputime(m.proc.pid, 'proxyThread')
+        time.sleep(2)
+        after = cputime(m.proc.pid, 'proxyThread')
+        if before is not None:
+            ticks = os.sysconf('SC_CLK_TCK')
+            assert after - before < ticks / 4, f'the proxy used {(after - before) / ticks:.2f}s of CPU'
+            note('the proxy is idle after the client disappeared')
+        c.socket.close()
+        c.socket = None
+
+        out = m.run_mclient('-s', 'select * from t', '-fcsv', output=True, db='bar')
+        assert out.strip() == 'bar'
+        note('the proxy still serves new connections')
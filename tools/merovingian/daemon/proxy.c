@@ -23,6 +23,9 @@
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+# include <sys/epoll.h>
+#endif
 
 #include "mstring.h"
 #include "stream.h"
@@ -31,6 +34,334 @@
 #include "merovingian.h"
 #include "proxy.h"
 
+#ifdef HAVE_SYS_EPOLL_H
+/* All proxied connections are served by a single thread that waits
+ * for any of the sockets to become readable or writable and then moves
+ * whatever is available to the other side.  Where possible the data is
+ * moved with splice(2) through a pipe shared by all connections, so
+ * that it never has to be copied to user space.  Only when the
+ * receiving side cannot take all of it, the remainder is kept in a
+ * buffer of the connection until that side becomes writable again;
+ * reading from the sending side is suspended in the mean time.  An
+ * idle connection therefore costs two sockets and a small struct. */
+
+#define PROXY_CHUNK	(64 * 1024)
+#define PROXY_EVENTS	64
+
+typedef struct _merovingian_proxy merovingian_proxy;
+
+typedef struct _proxy_dir {
+	int from;        /* socket to read from */
+	int to;          /* socket to write to */
+	char *buf;       /* data read from from, not yet written to to */
+	size_t pos;      /* start of the unwritten data in buf */
+	size_t len;      /* amount of unwritten data in buf */
+	bool eof;        /* from has hung up, close once buf is written */
+} proxy_dir;
+
+typedef struct _proxy_end {
+	merovingian_proxy *p;
+	int fd;
+	uint32_t events; /* events currently waited for */
+} proxy_end;
+
+struct _merovingian_proxy {
+	stream *cfdin;   /* client streams, to close the socket with */
+	stream *cfout;
+	proxy_dir ctos;  /* client to server */
+	proxy_dir stoc;  /* server to client */
+	proxy_end client;
+	proxy_end server;
+	char *name;      /* the client, to log when the connection ends */
+	bool dead;
+	merovingian_proxy *next; /* in the list of connections to free */
+};
+
+static pthread_mutex_t proxy_lock = PTHREAD_MUTEX_INITIALIZER;
+static int proxy_epoll = -1;
+#ifdef HAVE_SPLICE
+static int proxy_pipe[2] = {-1, -1};
+static bool proxy_splice = true;
+#endif
+
+static void
+proxyClose(merovingian_proxy *p, bool client_gone, merovingian_proxy **deadlist)
+{
+	if (p->dead)
+		return;
+	if (client_gone) {
+		Mlevelfprintf(DEBUG, stdout, "client %s has disconnected from proxy\n",
+				p->name);
+	} else {
+		Mlevelfprintf(WARNING, stdout, "server has terminated proxy connection, "
+				"disconnecting client %s\n", p->name);
+	}
+	epoll_ctl(proxy_epoll, EPOLL_CTL_DEL, p->client.fd, NULL);
+	epoll_ctl(proxy_epoll, EPOLL_CTL_DEL, p->server.fd, NULL);
+	shutdown(p->server.fd, SHUT_RDWR);
+	closesocket(p->server.fd);
+	/* the read stream closes the client socket */
+	close_stream(p->cfout);
+	close_stream(p->cfdin);
+	/* events for this connection may still be pending in the current
+	 * batch, so only free it once the batch has been handled */
+	p->dead = true;
+	p->next = *deadlist;
+	*deadlist = p;
+}
+
+/* write the buffered data of d; returns -1 on error, 0 if not all data
+ * could be written, 1 if the buffer is empty */
+static int
+proxyFlush(proxy_dir *d)
+{
+	while (d->len > 0) {
+		ssize_t n = send(d->to, d->buf + d->pos, d->len, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EAGAIN)
+				return 0;
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		d->pos += (size_t) n;
+		d->len -= (size_t) n;
+	}
+	d->pos = 0;
+	return 1;
+}
+
+#ifdef HAVE_SPLICE
+/* throw away the left bytes still in the shared pipe after an error,
+ * so that they are not passed on to the next connection using it; if
+ * that fails, stop using the pipe altogether */
+static void
+proxyDrain(size_t left)
+{
+	char drain[1024];
+	ssize_t n;
+
+	while (left > 0) {
+		n = read(proxy_pipe[0], drain, left < sizeof(drain) ? left : sizeof(drain));
+		if (n > 0)
+			left -= (size_t) n;
+		else if (n < 0 && errno == EINTR)
+			continue;
+		else
+			break;
+	}
+	if (left > 0) {
+		Mlevelfprintf(WARNING, stderr, "cannot empty the proxy pipe, "
+				"no longer using splice\n");
+		proxy_splice = false;
+	}
+}
+#endif
+
+/* move one chunk of data from d->from to d->to; returns -1 on end of
+ * input or error, 0 otherwise */
+static int
+proxyTransfer(proxy_dir *d)
+{
+	ssize_t n;
+
+	if (d->len > 0)
+		return 0;	/* wait until the buffer can be flushed */
+#ifdef HAVE_SPLICE
+	if (proxy_splice) {
+		n = splice(d->from, NULL, proxy_pipe[1], NULL, PROXY_CHUNK,
+				   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+		if (n == 0)
+			return -1;
+		if (n < 0) {
+			if (errno == EAGAIN || errno == EINTR)
+				return 0;
+			if (errno != EINVAL && errno != ENOSYS)
+				return -1;
+			/* not supported on these file descriptors: copy */
+			proxy_splice = false;
+		} else {
+			size_t left = (size_t) n;
+			while (left > 0) {
+				n = splice(proxy_pipe[0], NULL, d->to, NULL, left,
+						   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+				if (n > 0) {
+					left -= (size_t) n;
+				} else if (n < 0 && errno == EINTR) {
+					continue;
+				} else if (n < 0 && (errno == EAGAIN)) {
+					/* the pipe is shared: move what is left
+					 * to the buffer of this connection */
+					if (d->buf == NULL &&
+						(d->buf = malloc(PROXY_CHUNK)) == NULL) {
+						proxyDrain(left);
+						return -1;
+					}
+					while (d->len < left) {
+						n = read(proxy_pipe[0], d->buf + d->len, left - d->len);
+						if (n > 0) {
+							d->len += (size_t) n;
+						} else if (n == 0 || errno != EINTR) {
+							proxyDrain(left - d->len);
+							return -1;
+						}
+					}
+					return 0;
+				} else {
+					proxyDrain(left);
+					return -1;
+				}
+			}
+			return 0;
+		}
+	}
+#endif
+	if (d->buf == NULL && (d->buf = malloc(PROXY_CHUNK)) == NULL)
+		return -1;
+	n = recv(d->from, d->buf, PROXY_CHUNK, 0);
+	if (n == 0)
+		return -1;
+	if (n < 0)
+		return errno == EAGAIN || errno == EINTR ? 0 : -1;
+	d->pos = 0;
+	d->len = (size_t) n;
+	return proxyFlush(d) < 0 ? -1 : 0;
+}
+
+/* wait for input on a socket unless the data read from it earlier is
+ * still pending, and for output if data for it is pending */
+static int
+proxyUpdate(proxy_end *e, proxy_dir *rd, proxy_dir *wr)
+{
+	uint32_t events = (rd->len == 0 ? EPOLLIN : 0) | (wr->len > 0 ? EPOLLOUT : 0);
+
+	if (rd->eof || events == e->events)	/* no longer in the epoll set */
+		return 0;
+	e->events = events;
+	return epoll_ctl(proxy_epoll, EPOLL_CTL_MOD, e->fd,
+					 &(struct epoll_event) {.events = events, .data.ptr = e});
+}
+
+static void *
+proxyThread(void *d)
+{
+	struct epoll_event events[PROXY_EVENTS];
+
+	(void) d;
+#ifdef HAVE_PTHREAD_SETNAME_NP
+	pthread_setname_np(
+#ifndef __APPLE__
+		pthread_self(),
+#endif
+		__func__);
+#endif
+
+	for (;;) {
+		merovingian_proxy *deadlist = NULL;
+		int n = epoll_wait(proxy_epoll, events, PROXY_EVENTS, -1);
+
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			Mlevelfprintf(ERROR, stderr, "proxy event loop failed: %s\n",
+					strerror(errno));
+			break;
+		}
+		for (int i = 0; i < n; i++) {
+			proxy_end *e = events[i].data.ptr;
+			merovingian_proxy *p = e->p;
+			bool isclient = e == &p->client;
+			proxy_dir *rd = isclient ? &p->ctos : &p->stoc;
+			proxy_dir *wr = isclient ? &p->stoc : &p->ctos;
+			uint32_t ev = events[i].events;
+
+			if (p->dead)
+				continue;
+			if ((ev & EPOLLERR) ||
+				((ev & EPOLLHUP) && !(ev & EPOLLIN) && rd->len == 0)) {
+				proxyClose(p, isclient, &deadlist);
+				continue;
+			}
+			if ((ev & EPOLLHUP) && rd->len > 0) {
+				/* the peer is gone, but not all of its data has
+				 * been passed on yet: a hang up cannot be masked,
+				 * so stop waiting for this socket altogether and
+				 * close the connection once the data is written */
+				rd->eof = true;
+				epoll_ctl(proxy_epoll, EPOLL_CTL_DEL, e->fd, NULL);
+				continue;
+			}
+			if (ev & EPOLLOUT) {
+				int r = proxyFlush(wr);
+				if (r < 0 || (r > 0 && wr->eof)) {
+					proxyClose(p, !isclient, &deadlist);
+					continue;
+				}
+			}
+			if ((ev & (EPOLLIN | EPOLLHUP)) && proxyTransfer(rd) < 0) {
+				proxyClose(p, isclient, &deadlist);
+				continue;
+			}
+			if (proxyUpdate(&p->client, &p->ctos, &p->stoc) < 0 ||
+				proxyUpdate(&p->server, &p->stoc, &p->ctos) < 0)
+				proxyClose(p, isclient, &deadlist);
+		}
+		while (deadlist) {
+			merovingian_proxy *p = deadlist;
+			deadlist = p->next;
+			free(p->ctos.buf);
+			free(p->stoc.buf);
+			free(p->name);
+			free(p);
+		}
+	}
+	return NULL;
+}
+
+/* start the thread serving all proxied connections, if not done yet */
+static err
+proxyInit(void)
+{
+	err e = NO_ERR;
+	pthread_t ptid;
+	pthread_attr_t detachattr;
+	int thret;
+
+	pthread_mutex_lock(&proxy_lock);
+	if (proxy_epoll >= 0) {
+		pthread_mutex_unlock(&proxy_lock);
+		return NO_ERR;
+	}
+	if ((proxy_epoll = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+		e = newErr("cannot create epoll instance: %s", strerror(errno));
+		pthread_mutex_unlock(&proxy_lock);
+		return e;
+	}
+#ifdef HAVE_SPLICE
+	if (pipe2(proxy_pipe, O_NONBLOCK | O_CLOEXEC) < 0)
+		proxy_splice = false;
+#endif
+	pthread_attr_init(&detachattr);
+	pthread_attr_setdetachstate(&detachattr, PTHREAD_CREATE_DETACHED);
+	if ((thret = pthread_create(&ptid, &detachattr, proxyThread, NULL)) != 0) {
+		e = newErr("failed to create proxy thread: %s", strerror(thret));
+		close(proxy_epoll);
+		proxy_epoll = -1;
+#ifdef HAVE_SPLICE
+		if (proxy_splice) {
+			close(proxy_pipe[0]);
+			close(proxy_pipe[1]);
+		}
+		proxy_splice = true;
+#endif
+	}
+	pthread_attr_destroy(&detachattr);
+	pthread_mutex_unlock(&proxy_lock);
+	return e;
+}
+
+#else
+
 typedef struct _merovingian_proxy {
 	stream *in;      /* the input to read from and to dispatch to out */
 	stream *out;     /* where to write the read input to */
@@ -96,17 +427,21 @@ proxyThread(void *d)
 	return NULL;
 }
 
+#endif
+
 err
 startProxy(int psock, stream *cfdin, stream *cfout, char *url, char *client)
 {
 	int ssock = -1;
 	char *port, *t, *conn, *endipv6;
 	struct stat statbuf;
+#ifndef HAVE_SYS_EPOLL_H
 	stream *sfdin, *sfout;
 	merovingian_proxy *pctos, *pstoc;
 	pthread_t ptid;
 	pthread_attr_t detachattr;
 	int thret;
+#endif
 
 	/* quick 'n' dirty parsing */
 	if (strncmp(url, "mapi:monetdb://", sizeof("mapi:monetdb://") - 1) == 0) {
@@ -258,6 +593,53 @@ startProxy(int psock, stream *cfdin, stream *cfout, char *url, char *client)
 			return(newErr("cannot open socket: %s", strerror(errno)));
 	}
 
+#ifdef HAVE_SYS_EPOLL_H
+	err e;
+	merovingian_proxy *p;
+	char *name;
+	int cflags, sflags;
+
+	if ((e = proxyInit()) != NO_ERR) {
+		closesocket(ssock);
+		return e;
+	}
+	if ((name = strdup(client)) == NULL ||
+		(p = malloc(sizeof(merovingian_proxy))) == NULL) {
+		free(name);
+		closesocket(ssock);
+		return(newErr("cannot allocate proxy: %s", strerror(errno)));
+	}
+	*p = (merovingian_proxy) {
+		.cfdin = cfdin,
+		.cfout = cfout,
+		.ctos = (proxy_dir) {.from = psock, .to = ssock},
+		.stoc = (proxy_dir) {.from = ssock, .to = psock},
+		.client = (proxy_end) {.p = p, .fd = psock, .events = EPOLLIN},
+		.server = (proxy_end) {.p = p, .fd = ssock, .events = EPOLLIN},
+		.name = name,
+	};
+	/* the server socket is added first: once the client socket is
+	 * added, the proxy thread may close the connection at any time */
+	if ((cflags = fcntl(psock, F_GETFL)) < 0 ||
+		(sflags = fcntl(ssock, F_GETFL)) < 0 ||
+		fcntl(ssock, F_SETFL, sflags | O_NONBLOCK) < 0 ||
+		fcntl(psock, F_SETFL, cflags | O_NONBLOCK) < 0 ||
+		epoll_ctl(proxy_epoll, EPOLL_CTL_ADD, ssock,
+				  &(struct epoll_event) {.events = EPOLLIN, .data.ptr = &p->server}) < 0 ||
+		epoll_ctl(proxy_epoll, EPOLL_CTL_ADD, psock,
+				  &(struct epoll_event) {.events = EPOLLIN, .data.ptr = &p->client}) < 0) {
+		e = newErr("cannot add proxy connection to event loop: %s", strerror(errno));
+		epoll_ctl(proxy_epoll, EPOLL_CTL_DEL, ssock, NULL);
+		if (cflags >= 0)
+			(void) fcntl(psock, F_SETFL, cflags); /* the caller still uses it */
+		free(name);
+		free(p);
+		closesocket(ssock);
+		return e;
+	}
+
+	return(NO_ERR);
+#else
 	sfdin = block_stream(socket_rstream(ssock, "merovingian<-server (proxy read)"));
 	if (sfdin == 0) {
 		return(newErr("merovingian-server inputstream or outputstream problems: %s", mnstr_peek_error(NULL)));
@@ -318,4 +700,5 @@ startProxy(int psock, stream *cfdin, stream *cfout, char *url, char *client)
 	}
 
 	return(NO_ERR);
+#endif
 }
@@ -91,7 +91,6 @@ embedded_type(int t) {
 typedef struct {
 	Client c;
 	char *msg;
-	int registered_thread;	/* 1 = registered in monetdbe_open, 2 = done by GDK (also deregister done there) */
 	monetdbe_data_blob blob_null;
 	monetdbe_data_date date_null;
 	monetdbe_data_time time_null;
@@ -104,6 +103,7 @@ typedef struct {
 	int type;
 	res_table *monetdbe_resultset;
 	monetdbe_column **converted_columns;
+	BAT **pinned_bats;	/* BATs whose heaps converted columns point into */
 	monetdbe_database_internal *mdbe;
 } monetdbe_result_internal;
 
@@ -227,6 +227,31 @@ validate_database_handle_noerror(monetdbe_database_internal *mdbe)
 	return 1;
 }
 
+/* Every API call that works on the database runs between
+ * monetdbe_enter and monetdbe_leave.  The calling thread is registered
+ * with GDK for the duration of the call, so that a handle can be used
+ * from any thread and not only from the one that opened it, and it
+ * works in the query context of the handle (if there is one).
+ * monetdbe_enter returns whether monetdbe_leave must deregister the
+ * thread; monetdbe_leave passes msg through. */
+static int
+monetdbe_enter(monetdbe_database_internal *mdbe)
+{
+	int registered = monetdbe_embedded_initialized && MT_thread_register();
+
+	if (registered && mdbe && mdbe->c)
+		MT_thread_set_qry_ctx(&mdbe->c->qryctx);
+	return registered;
+}
+
+static char *
+monetdbe_leave(int registered, char *msg)
+{
+	if (registered)
+		MT_thread_deregister();
+	return msg;
+}
+
 // Call this function always inside the embedded_lock
 static char*
 validate_database_handle(monetdbe_database_internal *mdbe, const char* call)
@@ -239,15 +264,31 @@ validate_database_handle(monetdbe_database_internal *mdbe, const char* call)
 	return MAL_SUCCEED;
 }
 
+/* The heaps of a result BAT may only be handed out to the caller if
+ * nothing else can see them: the BAT must be transient, own its heaps
+ * and only be referred to by the result.  The columns of (temporary)
+ * tables and views on them are copied. */
+static inline bool
+monetdbe_private_heaps(BAT *b)
+{
+	return !isVIEW(b) && b->batRole == TRANSIENT && BBP_lrefs(b->batCacheid) <= 1;
+}
+
+/* if b is not NULL, the column data points into the heaps of b, which
+ * is unfixed here */
 static void
-monetdbe_destroy_column(monetdbe_column* column)
+monetdbe_destroy_column(monetdbe_column* column, BAT *b)
 {
 	size_t j;
 
 	if (!column)
 		return;
 
-	if (column->type == monetdbe_str) {
+	if (b) {
+		if (column->type != monetdbe_str)
+			column->data = NULL;
+		BBPunfix(b->batCacheid);
+	} else if (column->type == monetdbe_str) {
 		// FIXME: clean up individual strings
 		char** data = (char**)column->data;
 		for(j = 0; j < column->count; j++) {
@@ -277,14 +318,16 @@ monetdbe_cleanup_result_internal(monetdbe_database_internal *mdbe, monetdbe_resu
 	if ((mdbe->msg = getSQLContext(mdbe->c, NULL, &m, NULL)) != MAL_SUCCEED)
 		goto cleanup;
 
-	if (result->monetdbe_resultset)
-		res_tables_destroy(result->monetdbe_resultset);
-
 	if (result->converted_columns) {
 		for (size_t i = 0; i < result->res.ncols; i++)
-			monetdbe_destroy_column(result->converted_columns[i]);
+			monetdbe_destroy_column(result->converted_columns[i], result->pinned_bats ? result->pinned_bats[i] : NULL);
 		GDKfree(result->converted_columns);
 	}
+	GDKfree(result->pinned_bats);
+
+	if (result->monetdbe_resultset)
+		res_tables_destroy(result->monetdbe_resultset);
+
 	GDKfree(result);
 cleanup:
 	return commit_action(m, mdbe, NULL, NULL);
@@ -319,7 +362,10 @@ monetdbe_get_results(monetdbe_result** result, monetdbe_database_internal *mdbe)
 			res_internal->res.nrows = be->results->nr_rows;
 		be->results = NULL;
 		res_internal->converted_columns = GDKzalloc(sizeof(monetdbe_column*) * res_internal->res.ncols);
-		if (!res_internal->converted_columns) {
+		res_internal->pinned_bats = GDKzalloc(sizeof(BAT*) * res_internal->res.ncols);
+		if (!res_internal->converted_columns || !res_internal->pinned_bats) {
+			GDKfree(res_internal->converted_columns);
+			GDKfree(res_internal->pinned_bats);
 			GDKfree(res_internal);
 			*result = NULL;
 			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_get_results", MAL_MALLOC_FAIL));
@@ -550,13 +596,6 @@ monetdbe_open_internal(monetdbe_database_internal *mdbe, monetdbe_options *opts
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_open_internal", "Embedded MonetDB is not started"));
 		goto cleanup;
 	}
-	if (!mdbe->registered_thread) {
-		if (!MT_thread_register()) {
-			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_open_internal", "Embedded MonetDB is not started"));
-			goto cleanup;
-		}
-		mdbe->registered_thread = 1;
-	}
 	mdbe->c = MCinitClient((oid) 0, 0, 0);
 	if (!MCvalid(mdbe->c)) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_open_internal", "Failed to initialize client"));
@@ -932,15 +971,17 @@ monetdbe_open(monetdbe_database *dbhdl, char *url, monetdbe_options *opts)
 		 */
 		assert(!is_remote||url==NULL);
 		monetdbe_startup(mdbe, url, opts);
-		mdbe->registered_thread = 2;
 	} else if (!is_remote && !urls_matches(monetdbe_embedded_url, url)) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_open", "monetdbe_open currently only one active database is supported"));
 	}
-	if (!mdbe->msg)
+	if (!mdbe->msg) {
+		int registered = monetdbe_enter(NULL);
 		res = monetdbe_open_internal(mdbe, opts);
 
-	if (res == 0 && is_remote && !mdbe->msg)
-		res = monetdbe_open_remote(mdbe, opts);
+		if (res == 0 && is_remote && !mdbe->msg)
+			res = monetdbe_open_remote(mdbe, opts);
+		monetdbe_leave(registered, NULL);
+	}
 
 	MT_lock_unset(&embedded_lock);
 	if (mdbe->msg)
@@ -948,6 +989,48 @@ monetdbe_open(monetdbe_database *dbhdl, char *url, monetdbe_options *opts)
 	return res;
 }
 
+int
+monetdbe_open_session(monetdbe_database dbhdl, monetdbe_database *session)
+{
+	int res = 0;
+
+	if (!dbhdl || !session)
+		return -1;
+	*session = NULL;
+
+	monetdbe_database_internal *parent = (monetdbe_database_internal*)dbhdl;
+
+	MT_lock_set(&embedded_lock);
+	if (parent->mid) {
+		set_error(parent, createException(MAL, "monetdbe.monetdbe_open_session", "Sessions are not supported on remote databases"));
+		MT_lock_unset(&embedded_lock);
+		return -2;
+	}
+	if ((parent->msg = validate_database_handle(parent, "monetdbe.monetdbe_open_session")) != MAL_SUCCEED) {
+		MT_lock_unset(&embedded_lock);
+		return -2;
+	}
+	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)GDKzalloc(sizeof(monetdbe_database_internal));
+	if (!mdbe) {
+		MT_lock_unset(&embedded_lock);
+		return -1;
+	}
+	*session = (monetdbe_database)mdbe;
+
+	int registered = monetdbe_enter(NULL);
+	res = monetdbe_open_internal(mdbe, NULL);
+	if (res == 0) {
+		/* a session shares the limits of the handle it was opened from */
+		mdbe->c->workerlimit = parent->c->workerlimit;
+		mdbe->c->memorylimit = parent->c->memorylimit;
+		mdbe->c->querytimeout = parent->c->querytimeout;
+		mdbe->c->sessiontimeout = parent->c->sessiontimeout;
+	}
+	monetdbe_leave(registered, NULL);
+	MT_lock_unset(&embedded_lock);
+	return res;
+}
+
 int
 monetdbe_close(monetdbe_database dbhdl)
 {
@@ -957,19 +1040,15 @@ monetdbe_close(monetdbe_database dbhdl)
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
 
 	int err = 0;
-	int registered_thread = mdbe->registered_thread;
 
-	if (mdbe->c)
-		MT_thread_set_qry_ctx(&mdbe->c->qryctx);
 	MT_lock_set(&embedded_lock);
+	int registered = monetdbe_enter(mdbe);
 	if (mdbe->mid)
 		err = monetdbe_close_remote(mdbe);
 
 	err = (monetdbe_close_internal(mdbe) || err);
 
-	if (registered_thread == 1) {
-		MT_thread_deregister();
-	}
+	monetdbe_leave(registered, NULL);
 	if (!open_dbs)
 		monetdbe_shutdown_internal();
 	MT_lock_unset(&embedded_lock);
@@ -998,19 +1077,20 @@ monetdbe_dump_database(monetdbe_database dbhdl, const char *filename)
 		return NULL;
 
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
+	int registered = monetdbe_enter(mdbe);
 
 	if (mdbe->mid) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_dump_database", PROGRAM_NYI));
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 
 	if ((mdbe->msg = validate_database_handle(mdbe, "embedded.monetdbe_dump_database")) != MAL_SUCCEED) {
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 
 	mdbe->msg = monetdbe_mapi_dump_database(dbhdl, filename);
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 char*
@@ -1020,20 +1100,21 @@ monetdbe_dump_table(monetdbe_database dbhdl, const char *sname, const char *tnam
 		return NULL;
 
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
+	int registered = monetdbe_enter(mdbe);
 
 	if (mdbe->mid) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_dump_database", PROGRAM_NYI));
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 
 	if ((mdbe->msg = validate_database_handle(mdbe, "embedded.monetdbe_dump_table")) != MAL_SUCCEED) {
 
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 
 	mdbe->msg = monetdbe_mapi_dump_table(dbhdl, sname, tname, filename);
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 char*
@@ -1066,10 +1147,11 @@ monetdbe_set_autocommit(monetdbe_database dbhdl, int value)
 		return NULL;
 
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
+	int registered = monetdbe_enter(mdbe);
 
 	if (!validate_database_handle_noerror(mdbe)) {
 
-		return NULL;
+		return monetdbe_leave(registered, NULL);
 	}
 
 	mvc *m = ((backend *) mdbe->c->sqlcontext)->mvc;
@@ -1085,7 +1167,7 @@ monetdbe_set_autocommit(monetdbe_database dbhdl, int value)
 		}
 	}
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 int
@@ -1567,9 +1649,9 @@ monetdbe_query(monetdbe_database dbhdl, char* query, monetdbe_result** result, m
 	if (!dbhdl)
 		return NULL;
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
+	int registered = monetdbe_enter(mdbe);
 
 	assert(mdbe->c);
-	MT_thread_set_qry_ctx(&mdbe->c->qryctx);
 	if (mdbe->mid) {
 		mdbe->msg = monetdbe_query_remote(mdbe, query, result, affected_rows, NULL);
 	}
@@ -1577,7 +1659,7 @@ monetdbe_query(monetdbe_database dbhdl, char* query, monetdbe_result** result, m
 		mdbe->msg = monetdbe_query_internal(mdbe, query, result, affected_rows, NULL, 'S');
 	}
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 char*
@@ -1588,9 +1670,9 @@ monetdbe_prepare(monetdbe_database dbhdl, char* query, monetdbe_statement **stmt
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
 
 	int prepare_id = 0;
+	int registered = monetdbe_enter(mdbe);
 
 	assert(mdbe->c);
-	MT_thread_set_qry_ctx(&mdbe->c->qryctx);
 	if (!stmt) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_prepare", "Parameter stmt is NULL"));
 		assert(mdbe->msg != MAL_SUCCEED); /* help Coverity */
@@ -1641,16 +1723,17 @@ monetdbe_prepare(monetdbe_database dbhdl, char* query, monetdbe_statement **stmt
 		}
 	}
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 char*
 monetdbe_bind(monetdbe_statement *stmt, void *data, size_t i)
 {
 	monetdbe_stmt_internal *stmt_internal = (monetdbe_stmt_internal*)stmt;
+	int registered = monetdbe_enter(stmt_internal->mdbe);
 
 	if (i >= stmt->nparam)
-		return createException(MAL, "monetdbe.monetdbe_bind", "Parameter %zu not bound to a value", i);
+		return monetdbe_leave(registered, createException(MAL, "monetdbe.monetdbe_bind", "Parameter %zu not bound to a value", i));
 	sql_arg *a = (sql_arg*)list_fetch(stmt_internal->q->f->ops, (int) i);
 	assert(a);
 	int tpe = a->type.type->localtype;
@@ -1686,7 +1769,7 @@ monetdbe_bind(monetdbe_statement *stmt, void *data, size_t i)
 			b = (blob*) GDKmalloc(blobsize(len));
 			if (b == NULL) {
 				set_error(stmt_internal->mdbe, createException(MAL, "monetdbe.monetdbe_bind", MAL_MALLOC_FAIL));
-				return stmt_internal->mdbe->msg;
+				return monetdbe_leave(registered, stmt_internal->mdbe->msg);
 			}
 			b->nitems = len;
 			memcpy(b->data, be->data, len);
@@ -1697,13 +1780,13 @@ monetdbe_bind(monetdbe_statement *stmt, void *data, size_t i)
 
 		if (val == NULL) {
 			set_error(stmt_internal->mdbe, createException(MAL, "monetdbe.monetdbe_bind", MAL_MALLOC_FAIL));
-			return stmt_internal->mdbe->msg;
+			return monetdbe_leave(registered, stmt_internal->mdbe->msg);
 		}
 		VALset(&stmt_internal->data[i], tpe, val);
 	} else {
 		VALset(&stmt_internal->data[i], tpe, data);
 	}
-	return MAL_SUCCEED;
+	return monetdbe_leave(registered, MAL_SUCCEED);
 }
 
 char*
@@ -1717,11 +1800,11 @@ monetdbe_execute(monetdbe_statement *stmt, monetdbe_result **result, monetdbe_cn
 	MalStkPtr glb = NULL;
 	cq *q = stmt_internal->q;
 	Symbol s = NULL;
+	int registered = monetdbe_enter(mdbe);
 
 	assert(mdbe->c);
-	MT_thread_set_qry_ctx(&mdbe->c->qryctx);
 	if ((mdbe->msg = SQLtrans(m)) != MAL_SUCCEED)
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 
 	/* check if all inputs are bound */
 	for(int i = 0; i< list_length(stmt_internal->q->f->ops); i++){
@@ -1749,7 +1832,7 @@ monetdbe_execute(monetdbe_statement *stmt, monetdbe_result **result, monetdbe_cn
 
 cleanup:
 	GDKfree(glb);
-	return commit_action(m, stmt_internal->mdbe, result, res_internal);
+	return monetdbe_leave(registered, commit_action(m, stmt_internal->mdbe, result, res_internal));
 }
 
 char*
@@ -1759,11 +1842,11 @@ monetdbe_cleanup_statement(monetdbe_database dbhdl, monetdbe_statement *stmt)
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
 	mvc *m = ((backend *) mdbe->c->sqlcontext)->mvc;
 	cq *q = stmt_internal->q;
+	int registered = monetdbe_enter(mdbe);
 
 	assert(!stmt_internal->mdbe || mdbe == stmt_internal->mdbe);
 
 	assert(mdbe->c);
-	MT_thread_set_qry_ctx(&mdbe->c->qryctx);
 	for (size_t i = 0; i < stmt_internal->res.nparam + 1; i++) {
 		ValPtr data = &stmt_internal->data[i];
 		VALclear(data);
@@ -1776,7 +1859,7 @@ monetdbe_cleanup_statement(monetdbe_database dbhdl, monetdbe_statement *stmt)
 
 	if (q)
 		qc_delete(m->qc, q);
-	return MAL_SUCCEED;
+	return monetdbe_leave(registered, MAL_SUCCEED);
 }
 
 char*
@@ -1784,16 +1867,16 @@ monetdbe_cleanup_result(monetdbe_database dbhdl, monetdbe_result* result)
 {
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
 	monetdbe_result_internal* res = (monetdbe_result_internal *) result;
+	int registered = monetdbe_enter(mdbe);
 
 	assert(mdbe->c);
-	MT_thread_set_qry_ctx(&mdbe->c->qryctx);
 	if (!result) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_cleanup_result", "Parameter result is NULL"));
 	} else {
 		mdbe->msg = monetdbe_cleanup_result_internal(mdbe, res);
 	}
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 static inline void
@@ -1913,31 +1996,32 @@ monetdbe_get_columns(monetdbe_database dbhdl, const char* schema_name, const cha
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
 	mvc *m = NULL;
 	sql_table *t = NULL;
+	int registered = monetdbe_enter(mdbe);
 
 	if ((mdbe->msg = validate_database_handle(mdbe, "monetdbe.monetdbe_get_columns")) != MAL_SUCCEED) {
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 	if (!column_count) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_get_columns", "Parameter column_count is NULL"));
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 	if (!columns) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_get_columns", "Parameter columns is NULL"));
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 	if (!table_name) {
 		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_get_columns", "Parameter table_name is NULL"));
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 
 	if (mdbe->mid) {
-		return monetdbe_get_columns_remote(mdbe, schema_name, table_name, column_count, columns);
+		return monetdbe_leave(registered, monetdbe_get_columns_remote(mdbe, schema_name, table_name, column_count, columns));
 	}
 
 	if ((mdbe->msg = getSQLContext(mdbe->c, NULL, &m, NULL)) != MAL_SUCCEED)
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	if ((mdbe->msg = SQLtrans(m)) != MAL_SUCCEED)
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	if (!(t = find_table_or_view_on_scope(m, NULL, schema_name, table_name, "CATALOG", false))) {
 		set_error(mdbe, createException(SQL, "monetdbe.monetdbe_get_columns", "%s", m->errstr + 6)); /* Skip error code */
 		goto cleanup;
@@ -1961,7 +2045,7 @@ monetdbe_get_columns(monetdbe_database dbhdl, const char* schema_name, const cha
 cleanup:
 	mdbe->msg = commit_action(m, mdbe, NULL, NULL);
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 #define GENERATE_BASE_HEADERS(type, tpename) \
@@ -2012,23 +2096,27 @@ GENERATE_BASE_HEADERS(monetdbe_data_timestamp, timestamp);
 	if (sqltpe->type->radix == 10) bat_data->scale = pow(10, sqltpe->scale); \
 	column_result = (monetdbe_column*) bat_data;
 
+/* the tail of b has the layout of the column data, including the nil
+ * representation: if the heap is private to the result, point into it
+ * and keep b fixed until the result is cleaned up, else copy it */
 #define GENERATE_BAT_INPUT(b, tpe, tpe_name, mtype)						\
 	{																	\
+		static_assert(sizeof(tpe) == sizeof(mtype), "layout mismatch");	\
 		GENERATE_BAT_INPUT_BASE(tpe_name);								\
 		bat_data->count = (size_t) mres->nrows;							\
 		bat_data->null_value = mtype##_nil;								\
-		if (bat_data->count) {											\
-			bat_data->data = GDKzalloc(bat_data->count * sizeof(bat_data->null_value)); \
+		assert(bat_data->count <= BATcount(b));							\
+		if (bat_data->count && monetdbe_private_heaps(b)) {				\
+			bat_data->data = (tpe *) Tloc(b, 0);						\
+			pinned = 1;												\
+		} else if (bat_data->count) {									\
+			bat_data->data = GDKmalloc(bat_data->count * sizeof(tpe));	\
 			if (!bat_data->data) {										\
 				set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_fetch", MAL_MALLOC_FAIL)); \
 				goto cleanup;											\
 			}															\
+			memcpy(bat_data->data, Tloc(b, 0), bat_data->count * sizeof(tpe)); \
 		}																\
-		size_t it = 0;													\
-		mtype* val = (mtype*)Tloc(b, 0);								\
-		/* bat is dense, materialize it */								\
-		for (it = 0; it < bat_data->count; it++, val++)					\
-			bat_data->data[it] = (tpe) *val;							\
 	}
 
 static char*
@@ -2190,8 +2278,10 @@ cleanup:
 	return msg;
 }
 
-char*
-monetdbe_append(monetdbe_database dbhdl, const char *schema, const char *table, monetdbe_column **input, size_t column_count)
+/* if owned is set, the data of fixed-width columns was allocated with
+ * malloc and is handed over to the database, which frees it */
+static char*
+monetdbe_append_internal(monetdbe_database dbhdl, const char *schema, const char *table, monetdbe_column **input, size_t column_count, int owned)
 {
 	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
 	mvc *m = NULL;
@@ -2201,14 +2291,15 @@ monetdbe_append(monetdbe_database dbhdl, const char *schema, const char *table,
 	Symbol remote_prg = NULL;
 	BAT *pos = NULL;
 	BUN offset;
+	int registered = monetdbe_enter(mdbe);
 
 	if ((mdbe->msg = validate_database_handle(mdbe, "monetdbe.monetdbe_append")) != MAL_SUCCEED) {
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 
 	if ((mdbe->msg = getSQLContext(mdbe->c, NULL, &m, NULL)) != MAL_SUCCEED) {
 		mdbe->msg = commit_action(m, mdbe, NULL, NULL);
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 	sqlstore *store = m->session->tr->store;
 
@@ -2361,46 +2452,22 @@ remote_cleanup:
 				goto cleanup;
 			}
 
-			if ((bn = COLnew(0, mtype, 0, TRANSIENT)) == NULL) {
+			/* the input is used as the heap of bn: borrowed, in
+			 * which case the storage layer copies it, or owned,
+			 * in which case it keeps bn as is for an empty column
+			 * of a temporary table, and copies it otherwise */
+			if ((bn = BATattachmem(mtype, input[i]->data, cnt, owned)) == NULL) {
 				set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append", "Cannot create append column"));
 				goto cleanup;
 			}
-
-			//save prev heap pointer
-			char *prev_base;
-			size_t prev_size;
-			prev_base = bn->theap->base;
-			prev_size = bn->theap->free;
-
-			//BAT heap base to input[i]->data
-			bn->theap->base = input[i]->data;
-			bn->theap->free = tailsize(bn, cnt);
-
-			//BATsetdims(bn); called in COLnew
-			BATsetcapacity(bn, cnt);
-			BATsetcount(bn, cnt);
-
-			//set default flags
-			BATsettrivprop(bn);
-
-			if (cnt > 1) {
-				bn->tsorted = bn->trevsorted = false;
-				bn->tnosorted = bn->tnorevsorted = 0;
-				bn->tkey = false;
-				bn->tnonil = false;
-				bn->tnil = false;
-			}
+			if (owned)
+				input[i]->data = NULL;
 
 			if (store->storage_api.append_col(m->session->tr, c, offset, pos, bn, cnt, TYPE_bat) != 0) {
-				bn->theap->base = prev_base;
-				bn->theap->free = prev_size;
 				BBPreclaim(bn);
 				set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append", "Cannot append BAT"));
 				goto cleanup;
 			}
-
-			bn->theap->base = prev_base;
-			bn->theap->free = prev_size;
 			BBPreclaim(bn);
 		} else if (mtype == TYPE_str) {
 			char **d = (char**)v;
@@ -2629,7 +2696,19 @@ cleanup:
 	if (pos)
 		BBPreclaim(pos);
 	mdbe->msg = commit_action(m, mdbe, NULL, NULL);
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
+}
+
+char*
+monetdbe_append(monetdbe_database dbhdl, const char *schema, const char *table, monetdbe_column **input, size_t column_count)
+{
+	return monetdbe_append_internal(dbhdl, schema, table, input, column_count, 0);
+}
+
+char*
+monetdbe_append_owned(monetdbe_database dbhdl, const char *schema, const char *table, monetdbe_column **input, size_t column_count)
+{
+	return monetdbe_append_internal(dbhdl, schema, table, input, column_count, 1);
 }
 
 const void *
@@ -2672,13 +2751,15 @@ monetdbe_result_fetch(monetdbe_result* mres, monetdbe_column** res, size_t colum
 	sql_subtype* sqltpe = NULL;
 	monetdbe_column* column_result = NULL;
 	size_t j = 0;
+	int pinned = 0;
 	monetdbe_database_internal *mdbe = result->mdbe;
 	Client c = mdbe->c;
+	int registered = monetdbe_enter(mdbe);
 
 
 	if ((mdbe->msg = validate_database_handle(mdbe, "monetdbe.monetdbe_result_fetch")) != MAL_SUCCEED) {
 
-		return mdbe->msg;
+		return monetdbe_leave(registered, mdbe->msg);
 	}
 
 	if ((mdbe->msg = getSQLContext(c, NULL, &m, NULL)) != MAL_SUCCEED)
@@ -2695,7 +2776,7 @@ monetdbe_result_fetch(monetdbe_result* mres, monetdbe_column** res, size_t colum
 	if (result->converted_columns[column_index]) {
 		*res = result->converted_columns[column_index];
 
-		return MAL_SUCCEED;
+		return monetdbe_leave(registered, MAL_SUCCEED);
 	}
 
 	// otherwise we have to convert the column
@@ -2741,20 +2822,23 @@ monetdbe_result_fetch(monetdbe_result* mres, monetdbe_column** res, size_t colum
 			}
 		}
 
+		/* if the string heap is private to the result, the strings
+		 * are not copied: the pointers refer to the string heap of b,
+		 * which stays fixed until the result is cleaned up */
+		pinned = bat_data->count > 0 && monetdbe_private_heaps(b);
 		j = 0;
 		li = bat_iterator(b);
 		BATloop(b, p, q)
 		{
 			const char *t = (const char*)BUNtvar(li, p);
-			if (strcmp(t, str_nil) == 0) {
+			if (strNil(t)) {
 				bat_data->data[j] = NULL;
-			} else {
-				bat_data->data[j] = GDKstrdup(t);
-				if (!bat_data->data[j]) {
-					bat_iterator_end(&li);
-					set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_fetch", MAL_MALLOC_FAIL));
-					goto cleanup;
-				}
+			} else if (pinned) {
+				bat_data->data[j] = (char *) t;
+			} else if ((bat_data->data[j] = GDKstrdup(t)) == NULL) {
+				bat_iterator_end(&li);
+				set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_fetch", MAL_MALLOC_FAIL));
+				goto cleanup;
 			}
 			j++;
 		}
@@ -2882,18 +2966,25 @@ monetdbe_result_fetch(monetdbe_result* mres, monetdbe_column** res, size_t colum
 	if (column_result)
 		column_result->name = result->monetdbe_resultset->cols[column_index].name;
 cleanup:
-	BBPreclaim(b);
 	if (mdbe->msg) {
 		if (res)
 			*res = NULL;
-		monetdbe_destroy_column(column_result);
+		monetdbe_destroy_column(column_result, pinned ? b : NULL);
+		if (!pinned)
+			BBPreclaim(b);
 	} else if (res) {
 		result->converted_columns[column_index] = column_result;
 		*res = result->converted_columns[column_index];
+		if (pinned)
+			result->pinned_bats[column_index] = b;
+		else
+			BBPreclaim(b);
+	} else {
+		BBPreclaim(b);
 	}
 	mdbe->msg = commit_action(m, mdbe, NULL, NULL);
 
-	return mdbe->msg;
+	return monetdbe_leave(registered, mdbe->msg);
 }
 
 static void
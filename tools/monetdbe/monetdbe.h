@@ -161,6 +161,11 @@ monetdbe_export const char *monetdbe_version(void);
 monetdbe_export int   monetdbe_open(monetdbe_database *db, char *url, monetdbe_options *opts);
 /* 0 ok, -1 (allocation failed),  -2 error in db */
 monetdbe_export int   monetdbe_close(monetdbe_database db);
+/* open another session on the database of db, with its own transaction
+ * context; sessions are closed with monetdbe_close.  A handle should be
+ * used by one thread at a time, different sessions can be used from
+ * different threads concurrently */
+monetdbe_export int   monetdbe_open_session(monetdbe_database db, monetdbe_database *session);
 
 monetdbe_export char* monetdbe_error(monetdbe_database db);
 
@@ -169,6 +174,9 @@ monetdbe_export char* monetdbe_set_autocommit(monetdbe_database dbhdl, int value
 monetdbe_export int   monetdbe_in_transaction(monetdbe_database dbhdl);
 
 monetdbe_export char* monetdbe_query(monetdbe_database dbhdl, char* query, monetdbe_result** result, monetdbe_cnt* affected_rows);
+/* the data of fetched columns may point directly into the result; it
+ * is never shared with the tables queried, so modifying it cannot
+ * change the database, and it stays valid until monetdbe_cleanup_result */
 monetdbe_export char* monetdbe_result_fetch(monetdbe_result *mres, monetdbe_column** res, size_t column_index);
 monetdbe_export char* monetdbe_cleanup_result(monetdbe_database dbhdl, monetdbe_result* result);
 
@@ -178,6 +186,16 @@ monetdbe_export char* monetdbe_execute(monetdbe_statement *stmt, monetdbe_result
 monetdbe_export char* monetdbe_cleanup_statement(monetdbe_database dbhdl, monetdbe_statement *stmt);
 
 monetdbe_export char* monetdbe_append(monetdbe_database dbhdl, const char* schema, const char* table, monetdbe_column **input, size_t column_count);
+/* like monetdbe_append, but the database takes over the data of the
+ * fixed-width columns, which must have been allocated with malloc; the
+ * data pointers of these columns are set to NULL once taken over.
+ * Only the first append into an empty column of a temporary table uses
+ * the data without copying it; appends into persistent tables copy it
+ * (and free it) as monetdbe_append does, since their data goes through
+ * the write-ahead log.  The append is part of the
+ * current transaction: other sessions see a batch only once it is
+ * committed. */
+monetdbe_export char* monetdbe_append_owned(monetdbe_database dbhdl, const char* schema, const char* table, monetdbe_column **input, size_t column_count);
 monetdbe_export const void* monetdbe_null(monetdbe_database dbhdl, monetdbe_types t);
 
 monetdbe_export char* monetdbe_get_columns(monetdbe_database dbhdl, const char* schema_name, const char *table_name, size_t *column_count, monetdbe_column **columns);
@@ -373,6 +373,7 @@ main(int argc, char **av)
 	modules[mods++] = "netcdf";
 #endif
 	modules[mods++] = "csv";
+	modules[mods++] = "mcf";
 #ifdef HAVE_SHP
 	modules[mods++] = "shp";
 #endif